@@ -0,0 +1,443 @@
+/**
+ * @file <argos3/benchmarks/benchmark_arena.cpp>
+ *
+ * @author Jyotsna Bellary <jyotsnabellary@gmail.com>
+ */
+
+#include "benchmark_arena.h"
+
+#include <argos3/core/simulator/simulator.h>
+#include <argos3/core/simulator/space/space.h>
+#include <argos3/core/simulator/sensor.h>
+#include <argos3/core/simulator/loop_functions.h>
+#include <argos3/core/simulator/entity/controllable_entity.h>
+#include <argos3/core/control_interface/ci_controller.h>
+#include <argos3/core/utility/configuration/argos_exception.h>
+#include <argos3/core/utility/logging/argos_log.h>
+
+#include <cerrno>
+#include <chrono>
+#include <csignal>
+#include <cmath>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+#include <sys/wait.h>
+#include <unistd.h>
+
+namespace argos {
+
+   /****************************************/
+   /****************************************/
+
+   /* Floor area per robot, in square meters */
+   static const Real TURTLEBOT4_CELL = 1.0;
+   static const Real NEW_EPUCK_CELL  = 0.1;
+
+   /* Side of the boxes */
+   static const Real BOX_SIDE = 0.3;
+
+   /****************************************/
+   /****************************************/
+
+   /**
+    * The controller of the benchmark robots. The benchmarks update the
+    * sensors themselves, the controller has nothing to do.
+    */
+   class CBenchmarkController : public CCI_Controller {
+   public:
+      virtual void Init(TConfigurationNode& t_node) {}
+      virtual void ControlStep() {}
+   };
+
+   REGISTER_CONTROLLER(CBenchmarkController, "benchmark_controller")
+
+   /****************************************/
+   /****************************************/
+
+   /**
+    * Gives the floor a checkered pattern, so that the ground sensors see
+    * both colors.
+    */
+   class CBenchmarkLoopFunctions : public CLoopFunctions {
+   public:
+      virtual CColor GetFloorColor(const CVector2& c_position_on_plane) {
+         SInt32 nX = static_cast<SInt32>(std::floor(c_position_on_plane.GetX() * 2.0));
+         SInt32 nY = static_cast<SInt32>(std::floor(c_position_on_plane.GetY() * 2.0));
+         return ((nX + nY) % 2 == 0) ? CColor::WHITE : CColor::BLACK;
+      }
+   };
+
+   REGISTER_LOOP_FUNCTIONS(CBenchmarkLoopFunctions, "benchmark_loop_functions")
+
+   /****************************************/
+   /****************************************/
+
+   /* The requests to the arena process */
+   enum ERequest {
+      REQUEST_QUIT = 0,
+      REQUEST_SELECT,
+      REQUEST_UPDATE
+   };
+
+   struct SRequest {
+      UInt32 Type;
+      /** Length of the sensor name that follows, for REQUEST_SELECT */
+      UInt32 Length;
+   };
+
+   /****************************************/
+   /****************************************/
+
+   static bool WriteAll(int n_fd,
+                        const void* pt_data,
+                        size_t un_size) {
+      const char* pchData = static_cast<const char*>(pt_data);
+      while(un_size > 0) {
+         ssize_t nWritten = ::write(n_fd, pchData, un_size);
+         if(nWritten < 0 && errno == EINTR) continue;
+         if(nWritten <= 0) return false;
+         pchData += nWritten;
+         un_size -= nWritten;
+      }
+      return true;
+   }
+
+   static bool ReadAll(int n_fd,
+                       void* pt_data,
+                       size_t un_size) {
+      char* pchData = static_cast<char*>(pt_data);
+      while(un_size > 0) {
+         ssize_t nRead = ::read(n_fd, pchData, un_size);
+         if(nRead < 0 && errno == EINTR) continue;
+         if(nRead <= 0) return false;
+         pchData += nRead;
+         un_size -= nRead;
+      }
+      return true;
+   }
+
+   /****************************************/
+   /****************************************/
+
+   /*
+    * Returns the sensors with the given name of all the robots, enabled.
+    */
+   static std::vector<CSimulatedSensor*> GetSensors(const std::string& str_name) {
+      std::vector<CSimulatedSensor*> vecSensors;
+      std::vector<CControllableEntity*>& vecRobots =
+         CSimulator::GetInstance().GetSpace().GetControllableEntityVector();
+      for(size_t i = 0; i < vecRobots.size(); ++i) {
+         std::map<std::string, CCI_Sensor*, std::less<std::string> >& mapSensors =
+            vecRobots[i]->GetController().GetAllSensors();
+         std::map<std::string, CCI_Sensor*, std::less<std::string> >::iterator it =
+            mapSensors.find(str_name);
+         if(it == mapSensors.end()) {
+            continue;
+         }
+         CSimulatedSensor* pcSensor = dynamic_cast<CSimulatedSensor*>(it->second);
+         if(pcSensor != NULL) {
+            /* Some sensors, like the cameras, start disabled */
+            it->second->Enable();
+            vecSensors.push_back(pcSensor);
+         }
+      }
+      return vecSensors;
+   }
+
+   /****************************************/
+   /****************************************/
+
+   CBenchmarkArena* CBenchmarkArena::m_pcCurrent = NULL;
+
+   /****************************************/
+   /****************************************/
+
+   CBenchmarkArena& CBenchmarkArena::Get(const SConfig& s_config) {
+      if(m_pcCurrent != NULL && m_pcCurrent->m_sConfig == s_config) {
+         return *m_pcCurrent;
+      }
+      Destroy();
+      m_pcCurrent = new CBenchmarkArena(s_config);
+      return *m_pcCurrent;
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CBenchmarkArena::Destroy() {
+      delete m_pcCurrent;
+      m_pcCurrent = NULL;
+   }
+
+   /****************************************/
+   /****************************************/
+
+   size_t CBenchmarkArena::SelectSensors(const std::string& str_name) {
+      SRequest sRequest = { REQUEST_SELECT, static_cast<UInt32>(str_name.size()) };
+      UInt64 unSensors;
+      if(!WriteAll(m_nRequests, &sRequest, sizeof(sRequest)) ||
+         !WriteAll(m_nRequests, str_name.data(), str_name.size()) ||
+         !ReadAll(m_nReplies, &unSensors, sizeof(unSensors))) {
+         THROW_ARGOSEXCEPTION("The process of the benchmark arena is gone");
+      }
+      return unSensors;
+   }
+
+   /****************************************/
+   /****************************************/
+
+   Real CBenchmarkArena::UpdateSensors() {
+      SRequest sRequest = { REQUEST_UPDATE, 0 };
+      double fSeconds;
+      if(!WriteAll(m_nRequests, &sRequest, sizeof(sRequest)) ||
+         !ReadAll(m_nReplies, &fSeconds, sizeof(fSeconds))) {
+         THROW_ARGOSEXCEPTION("The process of the benchmark arena is gone");
+      }
+      return fSeconds;
+   }
+
+   /****************************************/
+   /****************************************/
+
+   CBenchmarkArena::CBenchmarkArena(const SConfig& s_config) :
+      m_sConfig(s_config),
+      m_tChild(-1),
+      m_nRequests(-1),
+      m_nReplies(-1) {
+      int pnRequests[2];
+      int pnReplies[2];
+      if(::pipe(pnRequests) != 0) {
+         THROW_ARGOSEXCEPTION("Can't create a pipe to the benchmark arena");
+      }
+      if(::pipe(pnReplies) != 0) {
+         ::close(pnRequests[0]);
+         ::close(pnRequests[1]);
+         THROW_ARGOSEXCEPTION("Can't create a pipe to the benchmark arena");
+      }
+      /* Writing to an arena process that is gone must fail, not kill the benchmark */
+      ::signal(SIGPIPE, SIG_IGN);
+      std::cout.flush();
+      m_tChild = ::fork();
+      if(m_tChild == 0) {
+         /* Child */
+         ::close(pnRequests[1]);
+         ::close(pnReplies[0]);
+         Serve(s_config, pnRequests[0], pnReplies[1]);
+      }
+      /* Parent */
+      ::close(pnRequests[0]);
+      ::close(pnReplies[1]);
+      m_nRequests = pnRequests[1];
+      m_nReplies = pnReplies[0];
+      if(m_tChild < 0) {
+         Stop();
+         THROW_ARGOSEXCEPTION("Can't fork the benchmark arena");
+      }
+      /* The child tells whether the arena loaded, with the error if not */
+      UInt32 unErrorLength;
+      std::string strError;
+      if(!ReadAll(m_nReplies, &unErrorLength, sizeof(unErrorLength))) {
+         strError = "the process of the arena is gone";
+      }
+      else if(unErrorLength > 0) {
+         strError.resize(unErrorLength);
+         if(!ReadAll(m_nReplies, &strError[0], unErrorLength)) {
+            strError = "the process of the arena is gone";
+         }
+      }
+      if(!strError.empty()) {
+         Stop();
+         THROW_ARGOSEXCEPTION("Can't load the benchmark arena with " <<
+                              s_config.Robots << " robots: " << strError);
+      }
+   }
+
+   /****************************************/
+   /****************************************/
+
+   CBenchmarkArena::~CBenchmarkArena() {
+      Stop();
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CBenchmarkArena::Stop() {
+      if(m_nRequests >= 0) {
+         SRequest sRequest = { REQUEST_QUIT, 0 };
+         WriteAll(m_nRequests, &sRequest, sizeof(sRequest));
+         ::close(m_nRequests);
+         m_nRequests = -1;
+      }
+      if(m_nReplies >= 0) {
+         ::close(m_nReplies);
+         m_nReplies = -1;
+      }
+      if(m_tChild > 0) {
+         int nStatus;
+         ::waitpid(m_tChild, &nStatus, 0);
+         m_tChild = -1;
+      }
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CBenchmarkArena::Serve(const SConfig& s_config,
+                               int n_requests,
+                               int n_replies) {
+      /* Load the arena, and tell the parent how it went */
+      std::string strError;
+      std::string strFileName;
+      try {
+         strFileName = MakeConfiguration(s_config);
+         CSimulator& cSimulator = CSimulator::GetInstance();
+         cSimulator.SetExperimentFileName(strFileName);
+         cSimulator.LoadExperiment();
+         /* One step, so that the positional indices know about every entity */
+         cSimulator.UpdateSpace();
+      }
+      catch(std::exception& ex) {
+         strError = ex.what();
+      }
+      if(!strFileName.empty()) {
+         std::remove(strFileName.c_str());
+      }
+      UInt32 unErrorLength = strError.size();
+      if(!WriteAll(n_replies, &unErrorLength, sizeof(unErrorLength)) ||
+         !WriteAll(n_replies, strError.data(), strError.size()) ||
+         !strError.empty()) {
+         ::_exit(1);
+      }
+      /* Answer the requests until the parent is done with the arena */
+      std::vector<CSimulatedSensor*> vecSensors;
+      SRequest sRequest;
+      try {
+         while(ReadAll(n_requests, &sRequest, sizeof(sRequest)) &&
+               sRequest.Type != REQUEST_QUIT) {
+            if(sRequest.Type == REQUEST_SELECT) {
+               std::string strName(sRequest.Length, '\0');
+               if(!ReadAll(n_requests, &strName[0], sRequest.Length)) break;
+               vecSensors = GetSensors(strName);
+               UInt64 unSensors = vecSensors.size();
+               if(!WriteAll(n_replies, &unSensors, sizeof(unSensors))) break;
+            }
+            else if(sRequest.Type == REQUEST_UPDATE) {
+               std::chrono::steady_clock::time_point tStart = std::chrono::steady_clock::now();
+               for(size_t i = 0; i < vecSensors.size(); ++i) {
+                  vecSensors[i]->Update();
+               }
+               double fSeconds =
+                  std::chrono::duration<double>(std::chrono::steady_clock::now() - tStart).count();
+               if(!WriteAll(n_replies, &fSeconds, sizeof(fSeconds))) break;
+            }
+         }
+      }
+      catch(std::exception& ex) {
+         /* The parent sees the pipe close */
+         LOGERR << "[WARNING] " << ex.what() << std::endl;
+         LOGERR.Flush();
+         ::_exit(1);
+      }
+      /* Skip the destructors of the objects inherited from the parent */
+      ::_exit(0);
+   }
+
+   /****************************************/
+   /****************************************/
+
+   std::string CBenchmarkArena::MakeConfiguration(const SConfig& s_config) {
+      bool bTurtlebot4 = (s_config.Robot == TURTLEBOT4);
+      /* The arena grows with the robots, keeping the same crowding */
+      Real fCell = bTurtlebot4 ? TURTLEBOT4_CELL : NEW_EPUCK_CELL;
+      Real fSide = Max<Real>(4.0, std::ceil(std::sqrt(s_config.Robots * fCell)) + 2.0);
+      Real fHalf = fSide * 0.5 - 0.5;
+      UInt32 unBoxes = static_cast<UInt32>(
+         s_config.ObstaclePercent * 0.01 * fSide * fSide / (BOX_SIDE * BOX_SIDE));
+      std::ostringstream cXML;
+      cXML << "<?xml version=\"1.0\" ?>\n"
+           << "<argos-configuration>\n"
+           << "  <framework>\n"
+           << "    <system threads=\"0\" />\n"
+           << "    <experiment length=\"0\" ticks_per_second=\"10\" random_seed=\"1\" />\n"
+           << "  </framework>\n"
+           << "  <controllers>\n"
+           << "    <benchmark_controller id=\"bc\">\n";
+      if(bTurtlebot4) {
+         cXML << "      <actuators>\n"
+              << "        <leds implementation=\"default\" medium=\"leds\" />\n"
+              << "      </actuators>\n"
+              << "      <sensors>\n"
+              << "        <turtlebot4_lidar implementation=\"default\" num_readings=\"" << s_config.Rays << "\" />\n"
+              << "        <turtlebot4_proximity implementation=\"default\" />\n"
+              << "        <turtlebot4_light implementation=\"rot_z_only\" />\n"
+              << "        <turtlebot4_ground implementation=\"rot_z_only\" />\n"
+              << "        <turtlebot4_colored_blob_omnidirectional_camera implementation=\"rot_z_only\" medium=\"leds\" />\n"
+              << "      </sensors>\n";
+      }
+      else {
+         cXML << "      <actuators />\n"
+              << "      <sensors>\n"
+              << "        <newepuck_lidar implementation=\"default\" num_readings=\"" << s_config.Rays << "\" />\n"
+              << "        <newepuck_proximity implementation=\"default\" />\n"
+              << "        <newepuck_light implementation=\"rot_z_only\" />\n"
+              << "        <newepuck_ground implementation=\"rot_z_only\" />\n"
+              << "      </sensors>\n";
+      }
+      cXML << "      <params />\n"
+           << "    </benchmark_controller>\n"
+           << "  </controllers>\n"
+           << "  <loop_functions label=\"benchmark_loop_functions\" />\n"
+           << "  <arena size=\"" << fSide << "," << fSide << ",2\" center=\"0,0,0.5\">\n"
+           << "    <floor id=\"floor\" source=\"loop_functions\" pixels_per_meter=\"10\" />\n"
+           << "    <light id=\"light\" position=\"0,0,0.5\" orientation=\"0,0,0\""
+           << " color=\"yellow\" intensity=\"3.0\" medium=\"leds\" />\n"
+           << "    <distribute>\n"
+           << "      <position method=\"uniform\" min=\"" << -fHalf << "," << -fHalf << ",0\""
+           << " max=\"" << fHalf << "," << fHalf << ",0\" />\n"
+           << "      <orientation method=\"uniform\" min=\"0,0,0\" max=\"360,0,0\" />\n"
+           << "      <entity quantity=\"" << s_config.Robots << "\" max_trials=\"100\">\n"
+           << "        <" << (bTurtlebot4 ? "turtlebot4" : "new_e-puck") << " id=\"r\">\n"
+           << "          <controller config=\"bc\" />\n"
+           << "        </" << (bTurtlebot4 ? "turtlebot4" : "new_e-puck") << ">\n"
+           << "      </entity>\n"
+           << "    </distribute>\n";
+      if(unBoxes > 0) {
+         cXML << "    <distribute>\n"
+              << "      <position method=\"uniform\" min=\"" << -fHalf << "," << -fHalf << ",0\""
+              << " max=\"" << fHalf << "," << fHalf << ",0\" />\n"
+              << "      <orientation method=\"uniform\" min=\"0,0,0\" max=\"360,0,0\" />\n"
+              << "      <entity quantity=\"" << unBoxes << "\" max_trials=\"100\">\n"
+              << "        <box id=\"b\" size=\"" << BOX_SIDE << "," << BOX_SIDE << ",0.5\" movable=\"false\" />\n"
+              << "      </entity>\n"
+              << "    </distribute>\n";
+      }
+      cXML << "  </arena>\n"
+           << "  <physics_engines>\n"
+           << "    <dynamics2d id=\"dyn2d\" />\n"
+           << "  </physics_engines>\n"
+           << "  <media>\n"
+           << "    <led id=\"leds\" />\n"
+           << "  </media>\n"
+           << "</argos-configuration>\n";
+      /* One file per arena process */
+      std::ostringstream cFileName;
+      cFileName << "argos3_benchmark_arena_" << ::getpid() << ".argos";
+      std::string strFileName =
+         (std::filesystem::temp_directory_path() / cFileName.str()).string();
+      std::ofstream cFile(strFileName.c_str(), std::ios::out | std::ios::trunc);
+      if(cFile.fail()) {
+         THROW_ARGOSEXCEPTION("Can't write the benchmark arena to \"" << strFileName << "\"");
+      }
+      cFile << cXML.str();
+      return strFileName;
+   }
+
+   /****************************************/
+   /****************************************/
+
+}
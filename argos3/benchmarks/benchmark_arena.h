@@ -0,0 +1,135 @@
+/**
+ * @file <argos3/benchmarks/benchmark_arena.h>
+ *
+ * @brief This file provides the synthetic arenas of the sensor benchmarks.
+ *
+ * An arena is a square with robots of one type and static boxes, both
+ * placed uniformly at random, a light in the center and a checkered floor.
+ * The robots run a controller that does nothing, so that only the sensors
+ * being measured do any work.
+ *
+ * ARGoS can't load a second experiment in a process that already loaded
+ * one, so each arena is loaded, without visualization, in its own child
+ * process. The benchmark process never loads an experiment: it forks a
+ * child when the arena changes, and asks it to update the sensors and to
+ * send back the time this took.
+ *
+ * The robot plugins are found in ARGOS_PLUGIN_PATH, like with argos3. They
+ * must be loaded before the first arena, so that the children inherit them.
+ *
+ * @author Jyotsna Bellary <jyotsnabellary@gmail.com>
+ */
+
+#ifndef BENCHMARK_ARENA_H
+#define BENCHMARK_ARENA_H
+
+namespace argos {
+   class CBenchmarkArena;
+}
+
+#include <argos3/core/utility/datatypes/datatypes.h>
+#include <string>
+#include <sys/types.h>
+
+namespace argos {
+
+   class CBenchmarkArena {
+
+   public:
+
+      enum ERobot {
+         TURTLEBOT4 = 0,
+         NEW_EPUCK
+      };
+
+      struct SConfig {
+         ERobot Robot;
+         /** Number of robots */
+         UInt32 Robots;
+         /** Percentage of the floor covered by boxes */
+         UInt32 ObstaclePercent;
+         /** Readings of the LIDARs */
+         UInt32 Rays;
+
+         SConfig(ERobot e_robot,
+                 UInt32 un_robots,
+                 UInt32 un_obstacle_percent,
+                 UInt32 un_rays) :
+            Robot(e_robot),
+            Robots(un_robots),
+            ObstaclePercent(un_obstacle_percent),
+            Rays(un_rays) {}
+
+         bool operator==(const SConfig& s_other) const {
+            return
+               Robot == s_other.Robot &&
+               Robots == s_other.Robots &&
+               ObstaclePercent == s_other.ObstaclePercent &&
+               Rays == s_other.Rays;
+         }
+      };
+
+   public:
+
+      /**
+       * Returns the arena with the given configuration. The current arena
+       * is kept if it matches, otherwise its process is stopped and a new
+       * one loads the arena.
+       * @throws CARGoSException if the arena can't be loaded
+       */
+      static CBenchmarkArena& Get(const SConfig& s_config);
+
+      /**
+       * Stops the process of the current arena, if any.
+       */
+      static void Destroy();
+
+      /**
+       * Selects the sensors with the given name (the XML tag, such as
+       * "turtlebot4_lidar") of all the robots, and enables them.
+       * @return the number of robots with the sensor
+       * @throws CARGoSException if the arena process is gone
+       */
+      size_t SelectSensors(const std::string& str_name);
+
+      /**
+       * Calls the Update() of the selected sensors of all the robots once.
+       * @return the time taken by the updates, in seconds
+       * @throws CARGoSException if the arena process is gone
+       */
+      Real UpdateSensors();
+
+   private:
+
+      CBenchmarkArena(const SConfig& s_config);
+
+      ~CBenchmarkArena();
+
+      CBenchmarkArena(const CBenchmarkArena&);
+      CBenchmarkArena& operator=(const CBenchmarkArena&);
+
+      /** Asks the arena process to quit and waits for it */
+      void Stop();
+
+      /** Loads the arena and answers the requests, in the child process */
+      static void Serve(const SConfig& s_config,
+                        int n_requests,
+                        int n_replies);
+
+      /** Writes the .argos file of the arena */
+      static std::string MakeConfiguration(const SConfig& s_config);
+
+   private:
+
+      SConfig m_sConfig;
+      /* The arena process and the pipes to it */
+      pid_t m_tChild;
+      int m_nRequests;
+      int m_nReplies;
+
+      static CBenchmarkArena* m_pcCurrent;
+   };
+
+}
+
+#endif
@@ -0,0 +1,527 @@
+/**
+ * @file <argos3/benchmarks/scaling_benchmark.cpp>
+ *
+ * @brief Runs turtlebot4_test.argos-style experiments over a sweep of
+ * robot counts, thread counts, physics engines and sensor sets.
+ *
+ * Each point of the sweep runs in its own child process, so that the peak
+ * RSS is the one of that experiment alone and no state leaks from one
+ * experiment to the next. The robots run the Turtlebot4 test controller
+ * with logging disabled, and there is no visualization.
+ *
+ * For each point, a line is written to the CSV file with:
+ *
+ * - ticks_per_s and ms_per_tick, measured over the timed ticks;
+ * - act_physics_ms, the time of the actuators, the physics engines and
+ *   the media, which ARGoS runs as one phase;
+ * - sense_ms and control_ms, the time of the sensors and of the
+ *   controllers. The controllers are timed one by one, and their total is
+ *   divided by the number of threads to get their share of the phase;
+ * - peak_rss_mb, the peak resident memory of the experiment.
+ *
+ * Example:
+ *
+ * <pre>
+ *   ./scaling_benchmark --robots 10,100,1000 --threads 0,8 \
+ *                       --engines dynamics2d --sensors proximity,full \
+ *                       --output scaling.csv
+ * </pre>
+ *
+ * @author Jyotsna Bellary <jyotsnabellary@gmail.com>
+ */
+
+#include <argos3/testing/controllers/turtlebot4_test/turtlebot4_test.h>
+
+#include <argos3/core/simulator/simulator.h>
+#include <argos3/core/simulator/space/space.h>
+#include <argos3/core/simulator/loop_functions.h>
+#include <argos3/core/simulator/entity/controllable_entity.h>
+#include <argos3/core/utility/configuration/argos_exception.h>
+#include <argos3/core/utility/configuration/command_line_arg_parser.h>
+#include <argos3/core/utility/logging/argos_log.h>
+#include <argos3/core/utility/plugins/dynamic_loading.h>
+#include <argos3/core/utility/string_utilities.h>
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <thread>
+
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+using namespace argos;
+
+typedef std::chrono::steady_clock TClock;
+
+/****************************************/
+/****************************************/
+
+/* Floor area per robot, in square meters */
+static const Real ROBOT_CELL = 1.0;
+
+/****************************************/
+/****************************************/
+
+/*
+ * The Turtlebot4 test controller, with the time spent in ControlStep().
+ * Each robot keeps its own total, so the threads share nothing.
+ */
+class CScalingBenchmarkController : public CTurtlebot4Test {
+
+public:
+
+   CScalingBenchmarkController() :
+      m_unControlNs(0) {}
+
+   virtual void ControlStep() {
+      TClock::time_point tStart = TClock::now();
+      CTurtlebot4Test::ControlStep();
+      m_unControlNs += std::chrono::duration_cast<std::chrono::nanoseconds>(
+         TClock::now() - tStart).count();
+   }
+
+   inline UInt64 GetControlNs() const {
+      return m_unControlNs;
+   }
+
+   inline void ResetControlNs() {
+      m_unControlNs = 0;
+   }
+
+private:
+
+   UInt64 m_unControlNs;
+};
+
+REGISTER_CONTROLLER(CScalingBenchmarkController, "scaling_benchmark_controller")
+
+/****************************************/
+/****************************************/
+
+/*
+ * ARGoS calls PreStep() between the physics and the sense+step phase, and
+ * PostStep() after it: the time stamps split each tick in phases.
+ */
+class CScalingBenchmarkLoopFunctions : public CLoopFunctions {
+
+public:
+
+   virtual void PreStep() {
+      PreStepTime = TClock::now();
+   }
+
+   virtual void PostStep() {
+      PostStepTime = TClock::now();
+   }
+
+   /* Same floor as the test loop functions */
+   virtual CColor GetFloorColor(const CVector2& c_position_on_plane) {
+      if(c_position_on_plane.GetX() < -1.0f) {
+         return CColor::GRAY50;
+      }
+      return CColor::WHITE;
+   }
+
+   static TClock::time_point PreStepTime;
+   static TClock::time_point PostStepTime;
+};
+
+TClock::time_point CScalingBenchmarkLoopFunctions::PreStepTime;
+TClock::time_point CScalingBenchmarkLoopFunctions::PostStepTime;
+
+REGISTER_LOOP_FUNCTIONS(CScalingBenchmarkLoopFunctions, "scaling_benchmark_loop_functions")
+
+/****************************************/
+/****************************************/
+
+/*
+ * One point of the sweep.
+ */
+struct SPoint {
+   UInt32 Robots;
+   UInt32 Threads;
+   std::string Engine;
+   std::string Sensors;
+};
+
+/*
+ * The measures of one point, in seconds.
+ */
+struct SResult {
+   UInt32 Ticks;
+   Real Wall;
+   Real ActPhysics;
+   Real SenseStep;
+   Real Control;
+};
+
+/****************************************/
+/****************************************/
+
+static void WriteSensors(std::ostream& c_xml,
+                         const std::string& str_sensors) {
+   c_xml << "        <turtlebot4_proximity implementation=\"default\" />\n";
+   if(str_sensors == "proximity") {
+      return;
+   }
+   c_xml << "        <turtlebot4_ground implementation=\"rot_z_only\" />\n"
+         << "        <turtlebot4_light implementation=\"rot_z_only\" />\n";
+   if(str_sensors == "basic") {
+      return;
+   }
+   c_xml << "        <turtlebot4_lidar implementation=\"default\" num_readings=\"360\" update_period=\"0.2s\" />\n"
+         << "        <turtlebot4_colored_blob_omnidirectional_camera implementation=\"rot_z_only\" medium=\"leds\" />\n";
+}
+
+/****************************************/
+/****************************************/
+
+static void WritePhysicsEngine(std::ostream& c_xml,
+                               const std::string& str_engine) {
+   if(str_engine == "dynamics3d") {
+      c_xml << "    <dynamics3d id=\"dyn3d\">\n"
+            << "      <floor />\n"
+            << "      <gravity g=\"9.8\" />\n"
+            << "    </dynamics3d>\n";
+   }
+   else {
+      c_xml << "    <" << str_engine << " id=\"engine\" />\n";
+   }
+}
+
+/****************************************/
+/****************************************/
+
+/*
+ * Writes the .argos file of a point: the arena of turtlebot4_test.argos,
+ * grown so that each robot has the same floor area, with one box and one
+ * cylinder per robot.
+ */
+static std::string MakeConfiguration(const SPoint& s_point) {
+   Real fSide = Max<Real>(7.0, std::ceil(std::sqrt(s_point.Robots * ROBOT_CELL)) + 2.0);
+   Real fHalf = fSide * 0.5 - 0.5;
+   std::ostringstream cXML;
+   cXML << "<?xml version=\"1.0\" ?>\n"
+        << "<argos-configuration>\n"
+        << "  <framework>\n"
+        << "    <system threads=\"" << s_point.Threads << "\" />\n"
+        << "    <experiment length=\"0\" ticks_per_second=\"10\" random_seed=\"124\" />\n"
+        << "  </framework>\n"
+        << "  <controllers>\n"
+        << "    <scaling_benchmark_controller id=\"sbc\">\n"
+        << "      <actuators>\n"
+        << "        <differential_steering implementation=\"default\" />\n"
+        << "        <leds implementation=\"default\" medium=\"leds\" />\n"
+        << "      </actuators>\n"
+        << "      <sensors>\n";
+   WriteSensors(cXML, s_point.Sensors);
+   cXML << "      </sensors>\n"
+        << "      <params velocity=\"6.0\" logging=\"false\" />\n"
+        << "    </scaling_benchmark_controller>\n"
+        << "  </controllers>\n"
+        << "  <loop_functions label=\"scaling_benchmark_loop_functions\" />\n"
+        << "  <arena size=\"" << fSide << "," << fSide << ",2\" center=\"0,0,0.5\">\n"
+        << "    <floor id=\"floor\" source=\"loop_functions\" pixels_per_meter=\"50\" />\n"
+        << "    <light id=\"light1\" position=\"0,0,0.5\" orientation=\"0,0,0\""
+        << " color=\"yellow\" intensity=\"3.0\" medium=\"leds\" />\n"
+        << "    <light id=\"light2\" position=\"0,2,0.5\" orientation=\"0,0,0\""
+        << " color=\"red\" intensity=\"3.0\" medium=\"leds\" />\n"
+        << "    <distribute>\n"
+        << "      <position method=\"uniform\" min=\"" << -fHalf << "," << -fHalf << ",0\""
+        << " max=\"" << fHalf << "," << fHalf << ",0\" />\n"
+        << "      <orientation method=\"uniform\" min=\"0,0,0\" max=\"360,0,0\" />\n"
+        << "      <entity quantity=\"" << s_point.Robots << "\" max_trials=\"100\">\n"
+        << "        <turtlebot4 id=\"fb\">\n"
+        << "          <controller config=\"sbc\" />\n"
+        << "        </turtlebot4>\n"
+        << "      </entity>\n"
+        << "    </distribute>\n"
+        << "    <distribute>\n"
+        << "      <position method=\"uniform\" min=\"" << -fHalf << "," << -fHalf << ",0\""
+        << " max=\"" << fHalf << "," << fHalf << ",0\" />\n"
+        << "      <orientation method=\"uniform\" min=\"0,0,0\" max=\"360,0,0\" />\n"
+        << "      <entity quantity=\"" << s_point.Robots << "\" max_trials=\"100\">\n"
+        << "        <box id=\"b\" size=\"0.3,0.3,0.5\" movable=\"false\" />\n"
+        << "      </entity>\n"
+        << "    </distribute>\n"
+        << "    <distribute>\n"
+        << "      <position method=\"uniform\" min=\"" << -fHalf << "," << -fHalf << ",0\""
+        << " max=\"" << fHalf << "," << fHalf << ",0\" />\n"
+        << "      <orientation method=\"constant\" values=\"0,0,0\" />\n"
+        << "      <entity quantity=\"" << s_point.Robots << "\" max_trials=\"100\">\n"
+        << "        <cylinder id=\"c\" height=\"0.5\" radius=\"0.15\" movable=\"false\" />\n"
+        << "      </entity>\n"
+        << "    </distribute>\n"
+        << "  </arena>\n"
+        << "  <physics_engines>\n";
+   WritePhysicsEngine(cXML, s_point.Engine);
+   cXML << "  </physics_engines>\n"
+        << "  <media>\n"
+        << "    <led id=\"leds\" />\n"
+        << "  </media>\n"
+        << "</argos-configuration>\n";
+   std::ostringstream cFileName;
+   cFileName << "argos3_scaling_benchmark_" << ::getpid() << ".argos";
+   std::string strFileName =
+      (std::filesystem::temp_directory_path() / cFileName.str()).string();
+   std::ofstream cFile(strFileName.c_str(), std::ios::out | std::ios::trunc);
+   if(cFile.fail()) {
+      THROW_ARGOSEXCEPTION("Can't write the experiment to \"" << strFileName << "\"");
+   }
+   cFile << cXML.str();
+   return strFileName;
+}
+
+/****************************************/
+/****************************************/
+
+static UInt64 GetControlNs(bool b_reset) {
+   UInt64 unTotal = 0;
+   std::vector<CControllableEntity*>& vecRobots =
+      CSimulator::GetInstance().GetSpace().GetControllableEntityVector();
+   for(size_t i = 0; i < vecRobots.size(); ++i) {
+      CScalingBenchmarkController* pcController =
+         dynamic_cast<CScalingBenchmarkController*>(&vecRobots[i]->GetController());
+      if(pcController != NULL) {
+         unTotal += pcController->GetControlNs();
+         if(b_reset) {
+            pcController->ResetControlNs();
+         }
+      }
+   }
+   return unTotal;
+}
+
+/****************************************/
+/****************************************/
+
+/*
+ * Runs one point of the sweep in the current process.
+ */
+static SResult RunPoint(const SPoint& s_point,
+                        UInt32 un_warmup,
+                        UInt32 un_ticks) {
+   std::string strFileName = MakeConfiguration(s_point);
+   CSimulator& cSimulator = CSimulator::GetInstance();
+   try {
+      cSimulator.SetExperimentFileName(strFileName);
+      cSimulator.LoadExperiment();
+   }
+   catch(CARGoSException& ex) {
+      std::remove(strFileName.c_str());
+      THROW_ARGOSEXCEPTION_NESTED("Can't load the experiment", ex);
+   }
+   std::remove(strFileName.c_str());
+   for(UInt32 i = 0; i < un_warmup; ++i) {
+      cSimulator.UpdateSpace();
+   }
+   GetControlNs(true);
+   SResult sResult = { un_ticks, 0.0, 0.0, 0.0, 0.0 };
+   for(UInt32 i = 0; i < un_ticks; ++i) {
+      TClock::time_point tStart = TClock::now();
+      cSimulator.UpdateSpace();
+      TClock::time_point tEnd = TClock::now();
+      sResult.Wall +=
+         std::chrono::duration<Real>(tEnd - tStart).count();
+      sResult.ActPhysics +=
+         std::chrono::duration<Real>(CScalingBenchmarkLoopFunctions::PreStepTime - tStart).count();
+      sResult.SenseStep +=
+         std::chrono::duration<Real>(CScalingBenchmarkLoopFunctions::PostStepTime -
+                                     CScalingBenchmarkLoopFunctions::PreStepTime).count();
+   }
+   /* The share of the controllers in the sense+step phase */
+   UInt32 unWorkers = Max<UInt32>(1, Min<UInt32>(s_point.Threads, s_point.Robots));
+   sResult.Control = Min<Real>(GetControlNs(false) * 1e-9 / unWorkers, sResult.SenseStep);
+   cSimulator.Destroy();
+   return sResult;
+}
+
+/****************************************/
+/****************************************/
+
+/*
+ * Runs one point of the sweep in a child process.
+ * @return true if the point ran, false otherwise
+ */
+static bool ForkPoint(const SPoint& s_point,
+                      UInt32 un_warmup,
+                      UInt32 un_ticks,
+                      SResult& s_result,
+                      Real& f_peak_rss_mb) {
+   int pnPipe[2];
+   if(::pipe(pnPipe) != 0) {
+      THROW_ARGOSEXCEPTION("Can't create a pipe to the experiment");
+   }
+   std::cout.flush();
+   pid_t tChild = ::fork();
+   if(tChild < 0) {
+      THROW_ARGOSEXCEPTION("Can't fork the experiment");
+   }
+   if(tChild == 0) {
+      /* Child */
+      ::close(pnPipe[0]);
+      int nStatus = 0;
+      try {
+         SResult sResult = RunPoint(s_point, un_warmup, un_ticks);
+         if(::write(pnPipe[1], &sResult, sizeof(sResult)) != sizeof(sResult)) {
+            nStatus = 1;
+         }
+      }
+      catch(CARGoSException& ex) {
+         LOGERR << "[WARNING] " << ex.what() << std::endl;
+         LOGERR.Flush();
+         nStatus = 1;
+      }
+      ::close(pnPipe[1]);
+      /* Skip the destructors of the objects inherited from the parent */
+      ::_exit(nStatus);
+   }
+   /* Parent */
+   ::close(pnPipe[1]);
+   ssize_t nRead = ::read(pnPipe[0], &s_result, sizeof(s_result));
+   ::close(pnPipe[0]);
+   int nStatus;
+   struct rusage tUsage;
+   ::wait4(tChild, &nStatus, 0, &tUsage);
+   /* ru_maxrss is in kilobytes on Linux */
+   f_peak_rss_mb = tUsage.ru_maxrss / 1024.0;
+   return
+      nRead == sizeof(s_result) &&
+      WIFEXITED(nStatus) &&
+      WEXITSTATUS(nStatus) == 0;
+}
+
+/****************************************/
+/****************************************/
+
+template <typename T>
+static std::vector<T> ParseList(const std::string& str_list) {
+   std::vector<std::string> vecTokens;
+   Tokenize(str_list, vecTokens, ",");
+   std::vector<T> vecValues;
+   for(size_t i = 0; i < vecTokens.size(); ++i) {
+      vecValues.push_back(FromString<T>(vecTokens[i]));
+   }
+   return vecValues;
+}
+
+/****************************************/
+/****************************************/
+
+int main(int argc, char** argv) {
+   bool bHelp = false;
+   std::string strRobots = "10,100,1000,5000";
+   std::string strThreads = "0," + ToString(std::thread::hardware_concurrency());
+   std::string strEngines = "dynamics2d,dynamics3d";
+   std::string strSensors = "proximity,full";
+   UInt32 unWarmup = 10;
+   UInt32 unTicks = 100;
+   std::string strOutput = "scaling_benchmark.csv";
+   CCommandLineArgParser cArgs;
+   cArgs.AddFlag('h', "--help", "shows this help", bHelp);
+   cArgs.AddArgument<std::string>('r', "--robots", "robot counts [" + strRobots + "]", strRobots);
+   cArgs.AddArgument<std::string>('t', "--threads", "values of <system threads> [" + strThreads + "]", strThreads);
+   cArgs.AddArgument<std::string>('e', "--engines", "dynamics2d, dynamics3d or kinematics2d [" + strEngines + "]", strEngines);
+   cArgs.AddArgument<std::string>('s', "--sensors", "proximity, basic (+ground, light) or full (+lidar, camera) [" + strSensors + "]", strSensors);
+   cArgs.AddArgument<UInt32>('w', "--warmup", "ticks before the measures [10]", unWarmup);
+   cArgs.AddArgument<UInt32>('n', "--ticks", "ticks measured [100]", unTicks);
+   cArgs.AddArgument<std::string>('o', "--output", "CSV file [" + strOutput + "]", strOutput);
+   std::vector<UInt32> vecRobots;
+   std::vector<UInt32> vecThreads;
+   std::vector<std::string> vecEngines;
+   std::vector<std::string> vecSensors;
+   try {
+      cArgs.Parse(argc, argv);
+      if(bHelp) {
+         cArgs.PrintUsage(LOG);
+         LOG.Flush();
+         return 0;
+      }
+      vecRobots = ParseList<UInt32>(strRobots);
+      vecThreads = ParseList<UInt32>(strThreads);
+      vecEngines = ParseList<std::string>(strEngines);
+      vecSensors = ParseList<std::string>(strSensors);
+      for(size_t i = 0; i < vecSensors.size(); ++i) {
+         if(vecSensors[i] != "proximity" && vecSensors[i] != "basic" && vecSensors[i] != "full") {
+            THROW_ARGOSEXCEPTION("Unknown sensor set \"" << vecSensors[i] << "\"");
+         }
+      }
+      if(unTicks == 0) {
+         THROW_ARGOSEXCEPTION("At least one tick must be measured");
+      }
+      /* Use the plugins of this build, unless told otherwise */
+      if(::getenv("ARGOS_PLUGIN_PATH") == NULL) {
+         ::setenv("ARGOS_PLUGIN_PATH", BENCHMARK_PLUGIN_PATH, 1);
+      }
+      /* The children inherit the plugins */
+      CDynamicLoading::LoadAllLibraries();
+   }
+   catch(CARGoSException& ex) {
+      LOGERR << ex.what() << std::endl;
+      LOGERR.Flush();
+      return 1;
+   }
+   std::ofstream cCSV(strOutput.c_str(), std::ios::out | std::ios::trunc);
+   if(cCSV.fail()) {
+      LOGERR << "Can't write \"" << strOutput << "\"" << std::endl;
+      LOGERR.Flush();
+      return 1;
+   }
+   cCSV << std::fixed << std::setprecision(4);
+   cCSV << "robots,threads,engine,sensors,ticks,wall_s,ticks_per_s,ms_per_tick,"
+        << "act_physics_ms,sense_ms,control_ms,peak_rss_mb\n";
+   UInt32 unFailed = 0;
+   for(size_t e = 0; e < vecEngines.size(); ++e) {
+      for(size_t s = 0; s < vecSensors.size(); ++s) {
+         for(size_t t = 0; t < vecThreads.size(); ++t) {
+            for(size_t r = 0; r < vecRobots.size(); ++r) {
+               SPoint sPoint = { vecRobots[r], vecThreads[t], vecEngines[e], vecSensors[s] };
+               LOG << "[INFO] " << sPoint.Robots << " robots, "
+                   << sPoint.Threads << " threads, "
+                   << sPoint.Engine << ", "
+                   << sPoint.Sensors << " sensors" << std::endl;
+               LOG.Flush();
+               SResult sResult;
+               Real fPeakRSS;
+               try {
+                  if(! ForkPoint(sPoint, unWarmup, unTicks, sResult, fPeakRSS)) {
+                     LOGERR << "[WARNING] The experiment failed, skipping it" << std::endl;
+                     LOGERR.Flush();
+                     ++unFailed;
+                     continue;
+                  }
+               }
+               catch(CARGoSException& ex) {
+                  LOGERR << ex.what() << std::endl;
+                  LOGERR.Flush();
+                  return 1;
+               }
+               Real fPerTick = 1000.0 / sResult.Ticks;
+               cCSV << sPoint.Robots << ','
+                    << sPoint.Threads << ','
+                    << sPoint.Engine << ','
+                    << sPoint.Sensors << ','
+                    << sResult.Ticks << ','
+                    << sResult.Wall << ','
+                    << sResult.Ticks / sResult.Wall << ','
+                    << sResult.Wall * fPerTick << ','
+                    << sResult.ActPhysics * fPerTick << ','
+                    << (sResult.SenseStep - sResult.Control) * fPerTick << ','
+                    << sResult.Control * fPerTick << ','
+                    << fPeakRSS << '\n';
+               cCSV.flush();
+            }
+         }
+      }
+   }
+   LOG << "[INFO] Results written to \"" << strOutput << "\"" << std::endl;
+   LOG.Flush();
+   return (unFailed == 0) ? 0 : 2;
+}
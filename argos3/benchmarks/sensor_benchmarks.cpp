@@ -0,0 +1,144 @@
+/**
+ * @file <argos3/benchmarks/sensor_benchmarks.cpp>
+ *
+ * @brief Microbenchmarks of the sensor updates.
+ *
+ * Each benchmark loads a synthetic arena and times one Update() of the
+ * given sensor on every robot. The arguments are the number of robots,
+ * the percentage of the floor covered by boxes and, for the LIDARs, the
+ * number of readings. Items per second are sensor updates per second.
+ *
+ * Each arena runs in its own child process (see CBenchmarkArena), which
+ * times the updates itself. The Time column is that time, without the
+ * round trip to the child; the CPU column is only the time of the
+ * benchmark process and is not meaningful.
+ *
+ * To keep a result that can be compared with another build:
+ *
+ * <pre>
+ *   ./sensor_benchmarks --benchmark_out=sensors.json --benchmark_out_format=json
+ * </pre>
+ *
+ * @author Jyotsna Bellary <jyotsnabellary@gmail.com>
+ */
+
+#include "benchmark_arena.h"
+
+#include <argos3/core/utility/configuration/argos_exception.h>
+#include <argos3/core/utility/logging/argos_log.h>
+#include <argos3/core/utility/plugins/dynamic_loading.h>
+
+#include <benchmark/benchmark.h>
+
+#include <cstdlib>
+
+using namespace argos;
+
+/****************************************/
+/****************************************/
+
+/* Readings of the LIDARs when the benchmark does not vary them */
+static const int64_t DEFAULT_RAYS = 360;
+
+static const std::vector<int64_t> ROBOTS    = { 10, 100, 1000 };
+static const std::vector<int64_t> OBSTACLES = { 0, 5, 20 };
+static const std::vector<int64_t> RAYS      = { 360, 1800 };
+
+/****************************************/
+/****************************************/
+
+/*
+ * Times the update of the sensors with the given name on all the robots.
+ */
+static void BM_SensorUpdate(benchmark::State& c_state,
+                            CBenchmarkArena::ERobot e_robot,
+                            const std::string& str_sensor) {
+   CBenchmarkArena::SConfig sConfig(e_robot,
+                                    c_state.range(0),
+                                    c_state.range(1),
+                                    c_state.range(2));
+   CBenchmarkArena* pcArena;
+   size_t unSensors;
+   try {
+      pcArena = &CBenchmarkArena::Get(sConfig);
+      unSensors = pcArena->SelectSensors(str_sensor);
+   }
+   catch(CARGoSException& ex) {
+      c_state.SkipWithError(ex.what());
+      return;
+   }
+   if(unSensors == 0) {
+      c_state.SkipWithError(("No robot has the sensor " + str_sensor).c_str());
+      return;
+   }
+   for(auto _ : c_state) {
+      try {
+         c_state.SetIterationTime(pcArena->UpdateSensors());
+      }
+      catch(CARGoSException& ex) {
+         c_state.SkipWithError(ex.what());
+         break;
+      }
+   }
+   c_state.SetItemsProcessed(c_state.iterations() * unSensors);
+   c_state.counters["robots"] = unSensors;
+}
+
+/****************************************/
+/****************************************/
+
+/*
+ * Registers a benchmark of a sensor, with or without the ray count as
+ * argument.
+ */
+static benchmark::internal::Benchmark* Register(const std::string& str_name,
+                                                CBenchmarkArena::ERobot e_robot,
+                                                const std::string& str_sensor,
+                                                bool b_vary_rays) {
+   benchmark::internal::Benchmark* pcBenchmark =
+      benchmark::RegisterBenchmark(str_name.c_str(), BM_SensorUpdate, e_robot, str_sensor);
+   pcBenchmark->
+      ArgsProduct({ ROBOTS, OBSTACLES, b_vary_rays ? RAYS : std::vector<int64_t>{ DEFAULT_RAYS } })->
+      ArgNames({ "robots", "obstacles_pct", "rays" })->
+      UseManualTime()->
+      Unit(benchmark::kMicrosecond);
+   return pcBenchmark;
+}
+
+/****************************************/
+/****************************************/
+
+int main(int argc, char** argv) {
+   benchmark::Initialize(&argc, argv);
+   if(benchmark::ReportUnrecognizedArguments(argc, argv)) {
+      return 1;
+   }
+   /* Use the plugins of this build, unless told otherwise */
+   if(::getenv("ARGOS_PLUGIN_PATH") == NULL) {
+      ::setenv("ARGOS_PLUGIN_PATH", BENCHMARK_PLUGIN_PATH, 1);
+   }
+   /* The messages of the arenas would mix with the results */
+   LOG.GetStream().setstate(std::ios::failbit);
+   try {
+      /* The arena processes inherit the plugins */
+      CDynamicLoading::LoadAllLibraries();
+   }
+   catch(CARGoSException& ex) {
+      LOGERR << ex.what() << std::endl;
+      return 1;
+   }
+   /* The turtlebot4 sensors */
+   Register("Turtlebot4LIDAR",      CBenchmarkArena::TURTLEBOT4, "turtlebot4_lidar",     true);
+   Register("Turtlebot4OmnicamLED", CBenchmarkArena::TURTLEBOT4, "turtlebot4_colored_blob_omnidirectional_camera", false);
+   Register("Turtlebot4Proximity",  CBenchmarkArena::TURTLEBOT4, "turtlebot4_proximity", false);
+   Register("Turtlebot4Light",      CBenchmarkArena::TURTLEBOT4, "turtlebot4_light",     false);
+   Register("Turtlebot4Ground",     CBenchmarkArena::TURTLEBOT4, "turtlebot4_ground",    false);
+   /* The e-puck sensors */
+   Register("NewEPuckLIDAR",        CBenchmarkArena::NEW_EPUCK,  "newepuck_lidar",       true);
+   Register("NewEPuckProximity",    CBenchmarkArena::NEW_EPUCK,  "newepuck_proximity",   false);
+   Register("NewEPuckLight",        CBenchmarkArena::NEW_EPUCK,  "newepuck_light",       false);
+   Register("NewEPuckGround",       CBenchmarkArena::NEW_EPUCK,  "newepuck_ground",      false);
+   benchmark::RunSpecifiedBenchmarks();
+   CBenchmarkArena::Destroy();
+   return 0;
+}
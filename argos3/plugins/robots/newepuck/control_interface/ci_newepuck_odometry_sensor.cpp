@@ -0,0 +1,65 @@
+/**
+ * @file <argos3/plugins/robots/newepuck/control_interface/ci_newepuck_odometry_sensor.cpp>
+ *
+ * @author Jyotsna Bellary <jyotsnabellary@gmail.com>
+ */
+
+#include "ci_newepuck_odometry_sensor.h"
+
+#ifdef ARGOS_WITH_LUA
+#include <argos3/core/wrappers/lua/lua_utility.h>
+#endif
+
+namespace argos {
+
+   /****************************************/
+   /****************************************/
+
+   const CCI_NewEPuckOdometrySensor::SReading& CCI_NewEPuckOdometrySensor::GetReading() const {
+     return m_sReading;
+   }
+
+   /****************************************/
+   /****************************************/
+
+#ifdef ARGOS_WITH_LUA
+   void CCI_NewEPuckOdometrySensor::CreateLuaState(lua_State* pt_lua_state) {
+      CLuaUtility::OpenRobotStateTable(pt_lua_state, "odometry");
+      CLuaUtility::AddToTable(pt_lua_state, "position",         m_sReading.Position       );
+      CLuaUtility::AddToTable(pt_lua_state, "orientation",      m_sReading.Orientation    );
+      CLuaUtility::AddToTable(pt_lua_state, "linear_velocity",  m_sReading.LinearVelocity );
+      CLuaUtility::AddToTable(pt_lua_state, "angular_velocity", m_sReading.AngularVelocity);
+      CLuaUtility::CloseRobotStateTable(pt_lua_state);
+   }
+#endif
+
+   /****************************************/
+   /****************************************/
+
+#ifdef ARGOS_WITH_LUA
+   void CCI_NewEPuckOdometrySensor::ReadingsToLuaState(lua_State* pt_lua_state) {
+      lua_getfield(pt_lua_state, -1, "odometry");
+      CLuaUtility::AddToTable(pt_lua_state, "position",         m_sReading.Position       );
+      CLuaUtility::AddToTable(pt_lua_state, "orientation",      m_sReading.Orientation    );
+      CLuaUtility::AddToTable(pt_lua_state, "linear_velocity",  m_sReading.LinearVelocity );
+      CLuaUtility::AddToTable(pt_lua_state, "angular_velocity", m_sReading.AngularVelocity);
+      lua_pop(pt_lua_state, 1);
+   }
+#endif
+
+   /****************************************/
+   /****************************************/
+
+   std::ostream& operator<<(std::ostream& c_os,
+                            const CCI_NewEPuckOdometrySensor::SReading& s_reading) {
+      c_os << "Position=<" << s_reading.Position
+           << ">, Orientation=<" << s_reading.Orientation
+           << ">, LinearVelocity=<" << s_reading.LinearVelocity
+           << ">, AngularVelocity=<" << s_reading.AngularVelocity << ">";
+      return c_os;
+   }
+
+   /****************************************/
+   /****************************************/
+
+}
@@ -0,0 +1,74 @@
+/**
+ * @file <argos3/plugins/robots/newepuck/control_interface/ci_newepuck_odometry_sensor.h>
+ *
+ * @brief This file provides the definition of the NewEPuck odometry sensor.
+ *
+ * The sensor integrates the motion of the robot into a pose estimate. The
+ * estimate starts at the origin, with orientation zero, where the robot is
+ * at the beginning of the experiment (or after a reset): X points forward
+ * and Y to the left of the robot. Like a real odometer, the estimate drifts
+ * when the wheels slip or the sensor is noisy.
+ *
+ * @author Jyotsna Bellary <jyotsnabellary@gmail.com>
+ */
+
+#ifndef CCI_NEWEPUCK_ODOMETRY_SENSOR_H
+#define CCI_NEWEPUCK_ODOMETRY_SENSOR_H
+
+namespace argos {
+   class CCI_NewEPuckOdometrySensor;
+}
+
+#include <argos3/core/control_interface/ci_sensor.h>
+#include <argos3/core/utility/math/angles.h>
+#include <argos3/core/utility/math/vector2.h>
+
+namespace argos {
+
+   class CCI_NewEPuckOdometrySensor : public CCI_Sensor {
+
+   public:
+
+      /**
+       * The DTO of the odometry sensor.
+       */
+      struct SReading {
+         /** Estimated position in the odometry frame, in meters */
+         CVector2 Position;
+         /** Estimated orientation in the odometry frame */
+         CRadians Orientation;
+         /** Linear velocity measured in the last step, in m/s */
+         Real LinearVelocity;
+         /** Angular velocity measured in the last step, in rad/s */
+         Real AngularVelocity;
+
+         SReading() :
+            LinearVelocity(0.0f),
+            AngularVelocity(0.0f) {}
+      };
+
+   public:
+
+      virtual ~CCI_NewEPuckOdometrySensor() {}
+
+      /**
+       * Returns the reading of this sensor
+       */
+      const SReading& GetReading() const;
+
+#ifdef ARGOS_WITH_LUA
+      virtual void CreateLuaState(lua_State* pt_lua_state);
+
+      virtual void ReadingsToLuaState(lua_State* pt_lua_state);
+#endif
+
+   protected:
+
+      SReading m_sReading;
+   };
+
+   std::ostream& operator<<(std::ostream& c_os, const CCI_NewEPuckOdometrySensor::SReading& s_reading);
+
+}
+
+#endif
@@ -23,16 +23,8 @@ namespace argos {
          links, however, setting it to 7 makes the newepuck less stable for reasons. */
       CDynamics3DMultiBodyObjectModel(c_engine, c_newepuck, 3, false),
       m_cWheeledEntity(c_newepuck.GetWheeledEntity()) {
-      /* get the required collision shapes */
-      std::shared_ptr<btCollisionShape> ptrBodyShape =
-         CDynamics3DShapeManager::RequestCylinder(m_cBodyHalfExtents);
-      std::shared_ptr<btCollisionShape> ptrWheelShape =
-         CDynamics3DShapeManager::RequestCylinder(m_cWheelHalfExtents);
-      /* calculate the inertia of the collision objects */
-      btVector3 cBodyInertia;
-      btVector3 cWheelInertia;
-      ptrBodyShape->calculateLocalInertia(m_fBodyMass, cBodyInertia);
-      ptrWheelShape->calculateLocalInertia(m_fWheelMass, cWheelInertia);
+      /* the collision shapes and their inertia are the same for every robot */
+      const SSharedData& sShared = GetSharedData();
       /* calculate a btTransform that moves us from the global coordinate system to the
          local coordinate system */
       const SAnchor& sOriginAnchor = c_newepuck.GetEmbodiedEntity().GetOriginAnchor();
@@ -50,28 +42,28 @@ namespace argos {
       CAbstractBody::SData sBodyData(
          cStartTransform * m_cBodyOffset,
          m_cBodyGeometricOffset,
-         cBodyInertia,
+         sShared.BodyInertia,
          m_fBodyMass,
          GetEngine().GetDefaultFriction());
       CAbstractBody::SData sLeftWheelData(
          cStartTransform * m_cLeftWheelOffset,
          m_cWheelGeometricOffset,
-         cWheelInertia,
+         sShared.WheelInertia,
          m_fWheelMass,
          m_fWheelFriction);
       CAbstractBody::SData sRightWheelData(
          cStartTransform * m_cRightWheelOffset,
          m_cWheelGeometricOffset,
-         cWheelInertia,
+         sShared.WheelInertia,
          m_fWheelMass,
          m_fWheelFriction);
       /* create an anchor for the body (not strictly necessary but easier than
          overloading CDynamics3DMultiBodyObjectModel::UpdateOriginAnchor) */
       SAnchor* psBodyAnchor = &c_newepuck.GetEmbodiedEntity().AddAnchor("body", {0.0, 0.0, 0.00125});
       /* create the bodies */
-      m_ptrBody = std::make_shared<CBase>(*this, psBodyAnchor, ptrBodyShape, sBodyData);
-      m_ptrLeftWheel = std::make_shared<CLink>(*this, 0, nullptr, ptrWheelShape, sLeftWheelData);
-      m_ptrRightWheel = std::make_shared<CLink>(*this, 1, nullptr, ptrWheelShape, sRightWheelData);
+      m_ptrBody = std::make_shared<CBase>(*this, psBodyAnchor, sShared.BodyShape, sBodyData);
+      m_ptrLeftWheel = std::make_shared<CLink>(*this, 0, nullptr, sShared.WheelShape, sLeftWheelData);
+      m_ptrRightWheel = std::make_shared<CLink>(*this, 1, nullptr, sShared.WheelShape, sRightWheelData);
       /* copy the bodies to the base class */
       m_vecBodies = {m_ptrBody, m_ptrLeftWheel, m_ptrRightWheel};
       /* synchronize with the entity with the space */
@@ -81,9 +73,40 @@ namespace argos {
    /****************************************/
    /****************************************/
    
+   CDynamics3DNewEPuckModel::SSharedData::SSharedData() :
+      BodyShape(CDynamics3DShapeManager::RequestCylinder(m_cBodyHalfExtents)),
+      WheelShape(CDynamics3DShapeManager::RequestCylinder(m_cWheelHalfExtents)) {
+      BodyShape->calculateLocalInertia(m_fBodyMass, BodyInertia);
+      WheelShape->calculateLocalInertia(m_fWheelMass, WheelInertia);
+   }
+
+   /****************************************/
+   /****************************************/
+
+   const CDynamics3DNewEPuckModel::SSharedData& CDynamics3DNewEPuckModel::GetSharedData() {
+      /* built by the first robot, kept until the end of the process */
+      static const SSharedData sSharedData;
+      return sSharedData;
+   }
+
+   /****************************************/
+   /****************************************/
+
    void CDynamics3DNewEPuckModel::Reset() {
       /* reset the base class */
       CDynamics3DMultiBodyObjectModel::Reset();
+      /* after the first reset, the joints and motors already exist: only
+         bring them back to their initial state, without reallocating */
+      if(m_ptrLeftMotor) {
+         m_cMultiBody.setJointPos(m_ptrLeftWheel->GetIndex(), 0.0);
+         m_cMultiBody.setJointPos(m_ptrRightWheel->GetIndex(), 0.0);
+         m_cMultiBody.setJointVel(m_ptrLeftWheel->GetIndex(), 0.0);
+         m_cMultiBody.setJointVel(m_ptrRightWheel->GetIndex(), 0.0);
+         m_ptrLeftMotor->setVelocityTarget(0.0);
+         m_ptrRightMotor->setVelocityTarget(0.0);
+         UpdateEntityStatus();
+         return;
+      }
       /* set up wheels */
       m_cMultiBody.setupRevolute(m_ptrLeftWheel->GetIndex(),
                                  m_ptrLeftWheel->GetData().Mass,
@@ -40,6 +40,23 @@ namespace argos {
 
       virtual void RemoveFromWorld(btMultiBodyDynamicsWorld& c_world);
 
+   private:
+
+      /*
+       * Collision shapes and inertias, computed once and shared by all
+       * the instances of the model.
+       */
+      struct SSharedData {
+         std::shared_ptr<btCollisionShape> BodyShape;
+         std::shared_ptr<btCollisionShape> WheelShape;
+         btVector3 BodyInertia;
+         btVector3 WheelInertia;
+
+         SSharedData();
+      };
+
+      static const SSharedData& GetSharedData();
+
    private:
       /* joint constraints */
       std::unique_ptr<btMultiBodyJointMotor> m_ptrLeftMotor;
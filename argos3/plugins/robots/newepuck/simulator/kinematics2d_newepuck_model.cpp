@@ -0,0 +1,38 @@
+/**
+ * @file <argos3/plugins/robots/newepuck/simulator/kinematics2d_newepuck_model.cpp>
+ *
+ * @author Jyotsna Bellary <jyotsnabellary@gmail.com>
+ */
+
+#include "kinematics2d_newepuck_model.h"
+
+namespace argos {
+
+   /****************************************/
+   /****************************************/
+
+   static const Real NEWEPUCK_RADIUS              = 0.035f;
+   static const Real NEWEPUCK_INTERWHEEL_DISTANCE = 0.053f;
+   static const Real NEWEPUCK_HEIGHT              = 0.086f;
+
+   /****************************************/
+   /****************************************/
+
+   CKinematics2DNewEPuckModel::CKinematics2DNewEPuckModel(CKinematics2DEngine& c_engine,
+                                                          CNewEPuckEntity& c_entity) :
+      CKinematics2DModel(c_engine,
+                         c_entity.GetEmbodiedEntity(),
+                         c_entity.GetWheeledEntity(),
+                         NEWEPUCK_RADIUS,
+                         NEWEPUCK_HEIGHT,
+                         NEWEPUCK_INTERWHEEL_DISTANCE) {}
+
+   /****************************************/
+   /****************************************/
+
+   REGISTER_STANDARD_KINEMATICS2D_OPERATIONS_ON_ENTITY(CNewEPuckEntity, CKinematics2DNewEPuckModel);
+
+   /****************************************/
+   /****************************************/
+
+}
@@ -0,0 +1,32 @@
+/**
+ * @file <argos3/plugins/robots/newepuck/simulator/kinematics2d_newepuck_model.h>
+ *
+ * @author Jyotsna Bellary <jyotsnabellary@gmail.com>
+ */
+
+#ifndef KINEMATICS2D_NEWEPUCK_MODEL_H
+#define KINEMATICS2D_NEWEPUCK_MODEL_H
+
+namespace argos {
+   class CKinematics2DNewEPuckModel;
+}
+
+#include <argos3/plugins/simulator/physics_engines/kinematics2d/kinematics2d_model.h>
+#include <argos3/plugins/robots/newepuck/simulator/newepuck_entity.h>
+
+namespace argos {
+
+   class CKinematics2DNewEPuckModel : public CKinematics2DModel {
+
+   public:
+
+      CKinematics2DNewEPuckModel(CKinematics2DEngine& c_engine,
+                                 CNewEPuckEntity& c_entity);
+
+      virtual ~CKinematics2DNewEPuckModel() {}
+
+   };
+
+}
+
+#endif
@@ -28,12 +28,14 @@ namespace argos {
       m_pcGroundSensorEntity(nullptr),
       m_pcRNG(nullptr),
       m_bAddNoise(false),
-      m_cSpace(CSimulator::GetInstance().GetSpace()) {}
+      m_cSpace(CSimulator::GetInstance().GetSpace()),
+      m_cProfiler("ground") {}
 
    /****************************************/
    /****************************************/
 
    void CNewEPuckBaseGroundRotZOnlySensor::SetRobot(CComposableEntity& c_entity) {
+      m_cProfiler.SetRobot(c_entity.GetId());
       m_pcEmbodiedEntity = &(c_entity.GetComponent<CEmbodiedEntity>("body"));
       m_pcGroundSensorEntity = &(c_entity.GetComponent<CGroundSensorEquippedEntity>("ground_sensors"));
       m_pcGroundSensorEntity->Enable();
@@ -46,6 +48,10 @@ namespace argos {
    void CNewEPuckBaseGroundRotZOnlySensor::Init(TConfigurationNode& t_tree) {
       try {
          CCI_NewEPuckBaseGroundSensor::Init(t_tree);
+         /* Parse the update period */
+         m_cUpdatePeriod.Init(t_tree);
+         /* Profile the updates? */
+         m_cProfiler.Init(t_tree);
          /* Parse noise level */
          Real fNoiseLevel = 0.0f;
          GetNodeAttributeOrDefault(t_tree, "noise_level", fNoiseLevel, fNoiseLevel);
@@ -70,10 +76,16 @@ namespace argos {
    /****************************************/
 
    void CNewEPuckBaseGroundRotZOnlySensor::Update() {
+      /* Measure the whole update */
+      CNewEPuckSensorProfiler::CScope cProfile(m_cProfiler);
       /* sensor is disabled--nothing to do */
       if (IsDisabled()) {
         return;
       }
+      /* readings are not due yet--keep the last ones */
+      if(! m_cUpdatePeriod.IsDue()) {
+         return;
+      }
       /*
        * We make the assumption that the robot is rotated only wrt to Z
        */
@@ -110,6 +122,7 @@ namespace argos {
    /****************************************/
 
    void CNewEPuckBaseGroundRotZOnlySensor::Reset() {
+      m_cUpdatePeriod.Reset();
       for(UInt32 i = 0; i < GetReadings().size(); ++i) {
          m_tReadings[i].Value = 0.0f;
       }
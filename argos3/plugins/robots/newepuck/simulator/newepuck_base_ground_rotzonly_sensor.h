@@ -17,6 +17,8 @@ namespace argos {
 }
 
 #include <argos3/plugins/robots/newepuck/control_interface/ci_newepuck_base_ground_sensor.h>
+#include <argos3/plugins/simulator/sensors/robot_sensors/sensor_update_period.h>
+#include <argos3/plugins/robots/newepuck/simulator/newepuck_sensor_profiler.h>
 #include <argos3/core/utility/math/range.h>
 #include <argos3/core/utility/math/rng.h>
 #include <argos3/core/simulator/space/space.h>
@@ -63,6 +65,12 @@ namespace argos {
 
       /** Reference to the space */
       CSpace& m_cSpace;
+
+      /** Limits how often the readings are computed */
+      CSensorUpdatePeriod m_cUpdatePeriod;
+
+      /** Measures the updates, if profiling is on */
+      CNewEPuckSensorProfiler m_cProfiler;
    };
 
 }
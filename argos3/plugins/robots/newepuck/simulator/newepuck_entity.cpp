@@ -16,6 +16,10 @@
 #include <argos3/plugins/simulator/entities/light_sensor_equipped_entity.h>
 #include <argos3/plugins/simulator/entities/proximity_sensor_equipped_entity.h>
 #include <argos3/plugins/simulator/entities/battery_equipped_entity.h>
+#include <argos3/core/simulator/simulator.h>
+#include <initializer_list>
+#include <map>
+#include <set>
 
 namespace argos {
 
@@ -46,6 +50,107 @@ namespace argos {
    /****************************************/
    /****************************************/
 
+   /*
+    * Tells which optional components a robot needs, looking at the <sensors>
+    * and <actuators> sections of its controller. When the devices can't be
+    * known in advance, everything is needed: this happens when the controller
+    * is not found and with Lua controllers, which may ask for any device at
+    * runtime.
+    */
+   class CNewEPuckComponentDemand {
+
+   public:
+
+      /**
+       * Returns the demand for the controller with the given id. The
+       * controller configuration is inspected only once per experiment, and
+       * the result is shared by all the robots with that controller.
+       */
+      static const CNewEPuckComponentDemand& Get(const std::string& str_controller_id) {
+         std::map<std::string, CNewEPuckComponentDemand>& mapDemands = GetCache();
+         auto it = mapDemands.find(str_controller_id);
+         if(it == mapDemands.end()) {
+            it = mapDemands.emplace(str_controller_id,
+                                    CNewEPuckComponentDemand(str_controller_id)).first;
+         }
+         return it->second;
+      }
+
+      /**
+       * Forgets the demands, so the next robot inspects the controller
+       * configuration again. The next experiment may reuse the controller
+       * ids with other devices.
+       */
+      static void Clear() {
+         GetCache().clear();
+      }
+
+      CNewEPuckComponentDemand(const std::string& str_controller_id) :
+         m_bAll(true) {
+         TConfigurationNode& tRoot = CSimulator::GetInstance().GetConfigurationRoot();
+         if(! NodeExists(tRoot, "controllers")) {
+            return;
+         }
+         TConfigurationNodeIterator itController;
+         for(itController = itController.begin(&GetNode(tRoot, "controllers"));
+             itController != itController.end();
+             ++itController) {
+            std::string strId;
+            GetNodeAttributeOrDefault(*itController, "id", strId, strId);
+            if(strId == str_controller_id) {
+               if(itController->Value() != "lua_controller") {
+                  m_bAll = false;
+                  AddDevices(*itController, "sensors");
+                  AddDevices(*itController, "actuators");
+               }
+               return;
+            }
+         }
+      }
+
+      /**
+       * Returns true if any of the given devices is used by the controller.
+       */
+      bool Needs(std::initializer_list<const char*> lst_devices) const {
+         if(m_bAll) {
+            return true;
+         }
+         for(const char* pchDevice : lst_devices) {
+            if(m_setDevices.count(pchDevice) > 0) {
+               return true;
+            }
+         }
+         return false;
+      }
+
+   private:
+
+      static std::map<std::string, CNewEPuckComponentDemand>& GetCache() {
+         static std::map<std::string, CNewEPuckComponentDemand> mapDemands;
+         return mapDemands;
+      }
+
+      void AddDevices(TConfigurationNode& t_controller,
+                      const std::string& str_section) {
+         if(NodeExists(t_controller, str_section)) {
+            TConfigurationNodeIterator itDevice;
+            for(itDevice = itDevice.begin(&GetNode(t_controller, str_section));
+                itDevice != itDevice.end();
+                ++itDevice) {
+               m_setDevices.insert(itDevice->Value());
+            }
+         }
+      }
+
+   private:
+
+      bool m_bAll;
+      std::set<std::string> m_setDevices;
+   };
+
+   /****************************************/
+   /****************************************/
+
    CNewEPuckEntity::CNewEPuckEntity() :
       CComposableEntity(nullptr),
       m_pcControllableEntity(nullptr),
@@ -54,6 +159,7 @@ namespace argos {
       m_pcLEDEquippedEntity(nullptr),
       m_pcLightSensorEquippedEntity(nullptr),
       m_pcProximitySensorEquippedEntity(nullptr),
+      m_pcLIDARSensorEquippedEntity(nullptr),
       m_pcRABEquippedEntity(nullptr),
       m_pcWheeledEntity(nullptr),
       m_pcBatteryEquippedEntity(nullptr)
@@ -78,11 +184,14 @@ namespace argos {
       m_pcLEDEquippedEntity(nullptr),
       m_pcLightSensorEquippedEntity(nullptr),
       m_pcProximitySensorEquippedEntity(nullptr),
+      m_pcLIDARSensorEquippedEntity(nullptr),
       m_pcRABEquippedEntity(nullptr),
       m_pcWheeledEntity(nullptr),
       m_pcBatteryEquippedEntity(nullptr)
        {
       try {
+         /* Find out which components the controller needs */
+         const CNewEPuckComponentDemand& cDemand = CNewEPuckComponentDemand::Get(str_controller_id);
          /*
           * Create and init components
           */
@@ -95,118 +204,132 @@ namespace argos {
          m_pcWheeledEntity->SetWheel(0, CVector3(0.0f,  HALF_INTERWHEEL_DISTANCE, 0.0f), WHEEL_RADIUS);
          m_pcWheeledEntity->SetWheel(1, CVector3(0.0f, -HALF_INTERWHEEL_DISTANCE, 0.0f), WHEEL_RADIUS);
          /* LED equipped entity */
-         m_pcLEDEquippedEntity = new CLEDEquippedEntity(this, "leds_0");
-         AddComponent(*m_pcLEDEquippedEntity);
-         m_pcLEDEquippedEntity->AddLEDRing(
-            CVector3(0.0f, 0.0f, LED_RING_ELEVATION),
-            LED_RING_RADIUS,
-            LED_RING_START_ANGLE,
-            8,
-            m_pcEmbodiedEntity->GetOriginAnchor());
+         if(cDemand.Needs({ "leds" })) {
+            m_pcLEDEquippedEntity = new CLEDEquippedEntity(this, "leds_0");
+            AddComponent(*m_pcLEDEquippedEntity);
+            m_pcLEDEquippedEntity->AddLEDRing(
+               CVector3(0.0f, 0.0f, LED_RING_ELEVATION),
+               LED_RING_RADIUS,
+               LED_RING_START_ANGLE,
+               8,
+               m_pcEmbodiedEntity->GetOriginAnchor());
+         }
 
          /* LIDAR sensor equipped entity */
-         m_pcLIDARSensorEquippedEntity =
-            new CProximitySensorEquippedEntity(this,
-                                               "lidar");
-         AddComponent(*m_pcLIDARSensorEquippedEntity);
+         if(cDemand.Needs({ "newepuck_lidar" })) {
+            m_pcLIDARSensorEquippedEntity =
+               new CProximitySensorEquippedEntity(this,
+                                                  "lidar");
+            AddComponent(*m_pcLIDARSensorEquippedEntity);
+         }
 
          /* Proximity sensor equipped entity */
-         m_pcProximitySensorEquippedEntity =
-            new CProximitySensorEquippedEntity(this,
-                                               "proximity_0");
-         AddComponent(*m_pcProximitySensorEquippedEntity);
-
-         /* Either of these */
-         // Manually set the 8 proximity sensors to match the real e-puck robot.
-         CRadians sensor_angle[8];
-         sensor_angle[0] = CRadians::PI / 10.5884f;
-         sensor_angle[1] = CRadians::PI / 3.5999f;
-         sensor_angle[2] = CRadians::PI_OVER_TWO; //side sensor
-         sensor_angle[3] = CRadians::PI / 1.2f;   // back sensor
-         sensor_angle[4] = CRadians::PI / 0.8571f; // back sensor
-         sensor_angle[5] = CRadians::PI / 0.6667f; //side sensor
-         sensor_angle[6] = CRadians::PI / 0.5806f;
-         sensor_angle[7] = CRadians::PI / 0.5247f;
-
-         CRadians cAngle;
-         CVector3 cOff, cDir, c_center = CVector3(0.0f, 0.0f, PROXIMITY_SENSOR_RING_ELEVATION);
-         for(UInt32 i = 0; i < 8; ++i)
-         {
-            cAngle = sensor_angle[i];
-            cAngle.SignedNormalize();
-            cOff.Set(PROXIMITY_SENSOR_RING_RADIUS, 0.0f, 0.0f);
-            cOff.RotateZ(cAngle);
-            cOff += c_center;
-            cDir.Set(PROXIMITY_SENSOR_RING_RANGE, 0.0f, 0.0f);
-            cDir.RotateZ(cAngle);
-            m_pcProximitySensorEquippedEntity->AddSensor(cOff, cDir, PROXIMITY_SENSOR_RING_RANGE, m_pcEmbodiedEntity->GetOriginAnchor());
+         if(cDemand.Needs({ "newepuck_proximity", "proximity" })) {
+            m_pcProximitySensorEquippedEntity =
+               new CProximitySensorEquippedEntity(this,
+                                                  "proximity_0");
+            AddComponent(*m_pcProximitySensorEquippedEntity);
+
+            /* Either of these */
+            // Manually set the 8 proximity sensors to match the real e-puck robot.
+            CRadians sensor_angle[8];
+            sensor_angle[0] = CRadians::PI / 10.5884f;
+            sensor_angle[1] = CRadians::PI / 3.5999f;
+            sensor_angle[2] = CRadians::PI_OVER_TWO; //side sensor
+            sensor_angle[3] = CRadians::PI / 1.2f;   // back sensor
+            sensor_angle[4] = CRadians::PI / 0.8571f; // back sensor
+            sensor_angle[5] = CRadians::PI / 0.6667f; //side sensor
+            sensor_angle[6] = CRadians::PI / 0.5806f;
+            sensor_angle[7] = CRadians::PI / 0.5247f;
+
+            CRadians cAngle;
+            CVector3 cOff, cDir, c_center = CVector3(0.0f, 0.0f, PROXIMITY_SENSOR_RING_ELEVATION);
+            for(UInt32 i = 0; i < 8; ++i)
+            {
+               cAngle = sensor_angle[i];
+               cAngle.SignedNormalize();
+               cOff.Set(PROXIMITY_SENSOR_RING_RADIUS, 0.0f, 0.0f);
+               cOff.RotateZ(cAngle);
+               cOff += c_center;
+               cDir.Set(PROXIMITY_SENSOR_RING_RANGE, 0.0f, 0.0f);
+               cDir.RotateZ(cAngle);
+               m_pcProximitySensorEquippedEntity->AddSensor(cOff, cDir, PROXIMITY_SENSOR_RING_RANGE, m_pcEmbodiedEntity->GetOriginAnchor());
+            }
          }
 
-         m_pcLightSensorEquippedEntity =
-            new CLightSensorEquippedEntity(this,
-                                           "light_0");
-         AddComponent(*m_pcLightSensorEquippedEntity);
-         m_pcLightSensorEquippedEntity->AddSensorRing(
-            CVector3(0.0f, 0.0f, LIGHT_RING_Z),
-            LIGHT_RING_RADIUS,
-            CRadians::PI_OVER_FOUR, // 45 degrees 
-            PROXIMITY_SENSOR_RING_RANGE,
-            4,
-            m_pcEmbodiedEntity->GetOriginAnchor());
+         /* Light sensor equipped entity */
+         if(cDemand.Needs({ "newepuck_light", "light" })) {
+            m_pcLightSensorEquippedEntity =
+               new CLightSensorEquippedEntity(this,
+                                              "light_0");
+            AddComponent(*m_pcLightSensorEquippedEntity);
+            m_pcLightSensorEquippedEntity->AddSensorRing(
+               CVector3(0.0f, 0.0f, LIGHT_RING_Z),
+               LIGHT_RING_RADIUS,
+               CRadians::PI_OVER_FOUR, // 45 degrees 
+               PROXIMITY_SENSOR_RING_RANGE,
+               4,
+               m_pcEmbodiedEntity->GetOriginAnchor());
+         }
 
          /* Ground sensor equipped entity */
-         /* Ground sensor equipped entity */
-         m_pcGroundSensorEquippedEntity =
-            new CGroundSensorEquippedEntity(this, "ground_0");
-         AddComponent(*m_pcGroundSensorEquippedEntity);
-         m_pcGroundSensorEquippedEntity->AddSensor(CVector2(0.063, 0.0116),
-                                                   CGroundSensorEquippedEntity::TYPE_GRAYSCALE,
-                                                   m_pcEmbodiedEntity->GetOriginAnchor());
-         m_pcGroundSensorEquippedEntity->AddSensor(CVector2(-0.063, 0.0116),
-                                                   CGroundSensorEquippedEntity::TYPE_GRAYSCALE,
-                                                   m_pcEmbodiedEntity->GetOriginAnchor());
-         m_pcGroundSensorEquippedEntity->AddSensor(CVector2(-0.063, -0.0116),
-                                                   CGroundSensorEquippedEntity::TYPE_GRAYSCALE,
-                                                   m_pcEmbodiedEntity->GetOriginAnchor());
-         m_pcGroundSensorEquippedEntity->AddSensor(CVector2(0.063, -0.0116),
-                                                   CGroundSensorEquippedEntity::TYPE_GRAYSCALE,
-                                                   m_pcEmbodiedEntity->GetOriginAnchor());
-         m_pcGroundSensorEquippedEntity->AddSensor(CVector2(0.08, 0.0),
-                                                   CGroundSensorEquippedEntity::TYPE_BLACK_WHITE,
-                                                   m_pcEmbodiedEntity->GetOriginAnchor());
-         m_pcGroundSensorEquippedEntity->AddSensor(CVector2(0.042, 0.065),
-                                                   CGroundSensorEquippedEntity::TYPE_BLACK_WHITE,
-                                                   m_pcEmbodiedEntity->GetOriginAnchor());
-         m_pcGroundSensorEquippedEntity->AddSensor(CVector2(0.0, 0.08),
-                                                   CGroundSensorEquippedEntity::TYPE_BLACK_WHITE,
-                                                   m_pcEmbodiedEntity->GetOriginAnchor());
-         m_pcGroundSensorEquippedEntity->AddSensor(CVector2(-0.042, 0.065),
-                                                   CGroundSensorEquippedEntity::TYPE_BLACK_WHITE,
-                                                   m_pcEmbodiedEntity->GetOriginAnchor());
-         m_pcGroundSensorEquippedEntity->AddSensor(CVector2(-0.08, 0.0),
-                                                   CGroundSensorEquippedEntity::TYPE_BLACK_WHITE,
-                                                   m_pcEmbodiedEntity->GetOriginAnchor());
-         m_pcGroundSensorEquippedEntity->AddSensor(CVector2(-0.042, -0.065),
-                                                   CGroundSensorEquippedEntity::TYPE_BLACK_WHITE,
-                                                   m_pcEmbodiedEntity->GetOriginAnchor());
-         m_pcGroundSensorEquippedEntity->AddSensor(CVector2(0.0, -0.08),
-                                                   CGroundSensorEquippedEntity::TYPE_BLACK_WHITE,
-                                                   m_pcEmbodiedEntity->GetOriginAnchor());
-         m_pcGroundSensorEquippedEntity->AddSensor(CVector2(0.042, -0.065),
-                                                   CGroundSensorEquippedEntity::TYPE_BLACK_WHITE,
-                                                   m_pcEmbodiedEntity->GetOriginAnchor());
+         if(cDemand.Needs({ "newepuck_ground", "ground" })) {
+            m_pcGroundSensorEquippedEntity =
+               new CGroundSensorEquippedEntity(this, "ground_0");
+            AddComponent(*m_pcGroundSensorEquippedEntity);
+            m_pcGroundSensorEquippedEntity->AddSensor(CVector2(0.063, 0.0116),
+                                                      CGroundSensorEquippedEntity::TYPE_GRAYSCALE,
+                                                      m_pcEmbodiedEntity->GetOriginAnchor());
+            m_pcGroundSensorEquippedEntity->AddSensor(CVector2(-0.063, 0.0116),
+                                                      CGroundSensorEquippedEntity::TYPE_GRAYSCALE,
+                                                      m_pcEmbodiedEntity->GetOriginAnchor());
+            m_pcGroundSensorEquippedEntity->AddSensor(CVector2(-0.063, -0.0116),
+                                                      CGroundSensorEquippedEntity::TYPE_GRAYSCALE,
+                                                      m_pcEmbodiedEntity->GetOriginAnchor());
+            m_pcGroundSensorEquippedEntity->AddSensor(CVector2(0.063, -0.0116),
+                                                      CGroundSensorEquippedEntity::TYPE_GRAYSCALE,
+                                                      m_pcEmbodiedEntity->GetOriginAnchor());
+            m_pcGroundSensorEquippedEntity->AddSensor(CVector2(0.08, 0.0),
+                                                      CGroundSensorEquippedEntity::TYPE_BLACK_WHITE,
+                                                      m_pcEmbodiedEntity->GetOriginAnchor());
+            m_pcGroundSensorEquippedEntity->AddSensor(CVector2(0.042, 0.065),
+                                                      CGroundSensorEquippedEntity::TYPE_BLACK_WHITE,
+                                                      m_pcEmbodiedEntity->GetOriginAnchor());
+            m_pcGroundSensorEquippedEntity->AddSensor(CVector2(0.0, 0.08),
+                                                      CGroundSensorEquippedEntity::TYPE_BLACK_WHITE,
+                                                      m_pcEmbodiedEntity->GetOriginAnchor());
+            m_pcGroundSensorEquippedEntity->AddSensor(CVector2(-0.042, 0.065),
+                                                      CGroundSensorEquippedEntity::TYPE_BLACK_WHITE,
+                                                      m_pcEmbodiedEntity->GetOriginAnchor());
+            m_pcGroundSensorEquippedEntity->AddSensor(CVector2(-0.08, 0.0),
+                                                      CGroundSensorEquippedEntity::TYPE_BLACK_WHITE,
+                                                      m_pcEmbodiedEntity->GetOriginAnchor());
+            m_pcGroundSensorEquippedEntity->AddSensor(CVector2(-0.042, -0.065),
+                                                      CGroundSensorEquippedEntity::TYPE_BLACK_WHITE,
+                                                      m_pcEmbodiedEntity->GetOriginAnchor());
+            m_pcGroundSensorEquippedEntity->AddSensor(CVector2(0.0, -0.08),
+                                                      CGroundSensorEquippedEntity::TYPE_BLACK_WHITE,
+                                                      m_pcEmbodiedEntity->GetOriginAnchor());
+            m_pcGroundSensorEquippedEntity->AddSensor(CVector2(0.042, -0.065),
+                                                      CGroundSensorEquippedEntity::TYPE_BLACK_WHITE,
+                                                      m_pcEmbodiedEntity->GetOriginAnchor());
+         }
          /* RAB equipped entity */
-         m_pcRABEquippedEntity = new CRABEquippedEntity(this,
-                                                        "rab_0",
-                                                        un_rab_data_size,
-                                                        f_rab_range,
-                                                        m_pcEmbodiedEntity->GetOriginAnchor(),
-                                                        *m_pcEmbodiedEntity,
-                                                        CVector3(0.0f, 0.0f, RAB_ELEVATION));
-         AddComponent(*m_pcRABEquippedEntity);
+         if(cDemand.Needs({ "range_and_bearing" })) {
+            m_pcRABEquippedEntity = new CRABEquippedEntity(this,
+                                                           "rab_0",
+                                                           un_rab_data_size,
+                                                           f_rab_range,
+                                                           m_pcEmbodiedEntity->GetOriginAnchor(),
+                                                           *m_pcEmbodiedEntity,
+                                                           CVector3(0.0f, 0.0f, RAB_ELEVATION));
+            AddComponent(*m_pcRABEquippedEntity);
+         }
          /* Battery equipped entity */
-         m_pcBatteryEquippedEntity = new CBatteryEquippedEntity(this, "battery_0", str_bat_model);
-         AddComponent(*m_pcBatteryEquippedEntity);
+         if(cDemand.Needs({ "battery" })) {
+            m_pcBatteryEquippedEntity = new CBatteryEquippedEntity(this, "battery_0", str_bat_model);
+            AddComponent(*m_pcBatteryEquippedEntity);
+         }
          /* Controllable entity
             It must be the last one, for actuators/sensors to link to composing entities correctly */
          m_pcControllableEntity = new CControllableEntity(this, "controller_0");
@@ -229,6 +352,10 @@ namespace argos {
           * Init parent
           */
          CComposableEntity::Init(t_tree);
+         /* Find out which components the controller needs */
+         std::string strControllerId;
+         GetNodeAttribute(GetNode(t_tree, "controller"), "config", strControllerId);
+         const CNewEPuckComponentDemand& cDemand = CNewEPuckComponentDemand::Get(strControllerId);
          /*
           * Create and init components
           */
@@ -242,123 +369,138 @@ namespace argos {
          AddComponent(*m_pcWheeledEntity);
          m_pcWheeledEntity->SetWheel(0, CVector3(0.0f,  HALF_INTERWHEEL_DISTANCE, 0.0f), WHEEL_RADIUS);
          m_pcWheeledEntity->SetWheel(1, CVector3(0.0f, -HALF_INTERWHEEL_DISTANCE, 0.0f), WHEEL_RADIUS);
-         /* LED equipped entity, with LEDs [0-11] and beacon [12] */
-         m_pcLEDEquippedEntity = new CLEDEquippedEntity(this, "leds_0");
-         AddComponent(*m_pcLEDEquippedEntity);
-         m_pcLEDEquippedEntity->AddLEDRing(
-            CVector3(0.0f, 0.0f, LED_RING_ELEVATION),
-            LED_RING_RADIUS,
-            LED_RING_START_ANGLE,
-            8,
-            m_pcEmbodiedEntity->GetOriginAnchor());
+         /* LED equipped entity */
+         if(cDemand.Needs({ "leds" })) {
+            m_pcLEDEquippedEntity = new CLEDEquippedEntity(this, "leds_0");
+            AddComponent(*m_pcLEDEquippedEntity);
+            m_pcLEDEquippedEntity->AddLEDRing(
+               CVector3(0.0f, 0.0f, LED_RING_ELEVATION),
+               LED_RING_RADIUS,
+               LED_RING_START_ANGLE,
+               8,
+               m_pcEmbodiedEntity->GetOriginAnchor());
+         }
          
          /* LIDAR sensor equipped entity */
-         m_pcLIDARSensorEquippedEntity =
-            new CProximitySensorEquippedEntity(this,
-                                               "lidar");
-         AddComponent(*m_pcLIDARSensorEquippedEntity);
+         if(cDemand.Needs({ "newepuck_lidar" })) {
+            m_pcLIDARSensorEquippedEntity =
+               new CProximitySensorEquippedEntity(this,
+                                                  "lidar");
+            AddComponent(*m_pcLIDARSensorEquippedEntity);
+         }
          
          /* Proximity sensor equipped entity */
-         m_pcProximitySensorEquippedEntity =
-            new CProximitySensorEquippedEntity(this,
-                                               "proximity");
-         AddComponent(*m_pcProximitySensorEquippedEntity);
-
-	      CRadians sensor_angle[8];
-         sensor_angle[0] = CRadians::PI / 10.5884f;
-         sensor_angle[1] = CRadians::PI / 3.5999f;
-         sensor_angle[2] = CRadians::PI_OVER_TWO; //side sensor
-         sensor_angle[3] = CRadians::PI / 1.2f;   // back sensor
-         sensor_angle[4] = CRadians::PI / 0.8571f; // back sensor
-         sensor_angle[5] = CRadians::PI / 0.6667f; //side sensor
-         sensor_angle[6] = CRadians::PI / 0.5806f;
-         sensor_angle[7] = CRadians::PI / 0.5247f;
-
-         CRadians cAngle;
-         CVector3 cOff, cDir, c_center = CVector3(0.0f, 0.0f, PROXIMITY_SENSOR_RING_ELEVATION);
-         for(UInt32 i = 0; i < 8; ++i)
-         {
-            cAngle = sensor_angle[i];
-            cAngle.SignedNormalize();
-            cOff.Set(PROXIMITY_SENSOR_RING_RADIUS, 0.0f, 0.0f);
-            cOff.RotateZ(cAngle);
-            cOff += c_center;
-            cDir.Set(PROXIMITY_SENSOR_RING_RANGE, 0.0f, 0.0f);
-            cDir.RotateZ(cAngle);
-            m_pcProximitySensorEquippedEntity->AddSensor(cOff, cDir, PROXIMITY_SENSOR_RING_RANGE, m_pcEmbodiedEntity->GetOriginAnchor());
+         if(cDemand.Needs({ "newepuck_proximity", "proximity" })) {
+            m_pcProximitySensorEquippedEntity =
+               new CProximitySensorEquippedEntity(this,
+                                                  "proximity");
+            AddComponent(*m_pcProximitySensorEquippedEntity);
+
+            CRadians sensor_angle[8];
+            sensor_angle[0] = CRadians::PI / 10.5884f;
+            sensor_angle[1] = CRadians::PI / 3.5999f;
+            sensor_angle[2] = CRadians::PI_OVER_TWO; //side sensor
+            sensor_angle[3] = CRadians::PI / 1.2f;   // back sensor
+            sensor_angle[4] = CRadians::PI / 0.8571f; // back sensor
+            sensor_angle[5] = CRadians::PI / 0.6667f; //side sensor
+            sensor_angle[6] = CRadians::PI / 0.5806f;
+            sensor_angle[7] = CRadians::PI / 0.5247f;
+
+            CRadians cAngle;
+            CVector3 cOff, cDir, c_center = CVector3(0.0f, 0.0f, PROXIMITY_SENSOR_RING_ELEVATION);
+            for(UInt32 i = 0; i < 8; ++i)
+            {
+               cAngle = sensor_angle[i];
+               cAngle.SignedNormalize();
+               cOff.Set(PROXIMITY_SENSOR_RING_RADIUS, 0.0f, 0.0f);
+               cOff.RotateZ(cAngle);
+               cOff += c_center;
+               cDir.Set(PROXIMITY_SENSOR_RING_RANGE, 0.0f, 0.0f);
+               cDir.RotateZ(cAngle);
+               m_pcProximitySensorEquippedEntity->AddSensor(cOff, cDir, PROXIMITY_SENSOR_RING_RANGE, m_pcEmbodiedEntity->GetOriginAnchor());
+            }
          }
          
-         m_pcLightSensorEquippedEntity =
-            new CLightSensorEquippedEntity(this,
-                                           "light_0");
-         AddComponent(*m_pcLightSensorEquippedEntity);
-         m_pcLightSensorEquippedEntity->AddSensorRing(
-            CVector3(0.0f, 0.0f, LIGHT_RING_Z),
-            LIGHT_RING_RADIUS,
-            CRadians::PI_OVER_FOUR, // 45 degrees 
-            PROXIMITY_SENSOR_RING_RANGE,
-            4,
-            m_pcEmbodiedEntity->GetOriginAnchor());
+         /* Light sensor equipped entity */
+         if(cDemand.Needs({ "newepuck_light", "light" })) {
+            m_pcLightSensorEquippedEntity =
+               new CLightSensorEquippedEntity(this,
+                                              "light_0");
+            AddComponent(*m_pcLightSensorEquippedEntity);
+            m_pcLightSensorEquippedEntity->AddSensorRing(
+               CVector3(0.0f, 0.0f, LIGHT_RING_Z),
+               LIGHT_RING_RADIUS,
+               CRadians::PI_OVER_FOUR, // 45 degrees 
+               PROXIMITY_SENSOR_RING_RANGE,
+               4,
+               m_pcEmbodiedEntity->GetOriginAnchor());
+         }
 
          /* Ground sensor equipped entity */
-         m_pcGroundSensorEquippedEntity =
-            new CGroundSensorEquippedEntity(this, "ground_0");
-         AddComponent(*m_pcGroundSensorEquippedEntity);
-         m_pcGroundSensorEquippedEntity->AddSensor(CVector2(0.063, 0.0116),
-                                                   CGroundSensorEquippedEntity::TYPE_GRAYSCALE,
-                                                   m_pcEmbodiedEntity->GetOriginAnchor());
-         m_pcGroundSensorEquippedEntity->AddSensor(CVector2(-0.063, 0.0116),
-                                                   CGroundSensorEquippedEntity::TYPE_GRAYSCALE,
-                                                   m_pcEmbodiedEntity->GetOriginAnchor());
-         m_pcGroundSensorEquippedEntity->AddSensor(CVector2(-0.063, -0.0116),
-                                                   CGroundSensorEquippedEntity::TYPE_GRAYSCALE,
-                                                   m_pcEmbodiedEntity->GetOriginAnchor());
-         m_pcGroundSensorEquippedEntity->AddSensor(CVector2(0.063, -0.0116),
-                                                   CGroundSensorEquippedEntity::TYPE_GRAYSCALE,
-                                                   m_pcEmbodiedEntity->GetOriginAnchor());
-         m_pcGroundSensorEquippedEntity->AddSensor(CVector2(0.08, 0.0),
-                                                   CGroundSensorEquippedEntity::TYPE_BLACK_WHITE,
-                                                   m_pcEmbodiedEntity->GetOriginAnchor());
-         m_pcGroundSensorEquippedEntity->AddSensor(CVector2(0.042, 0.065),
-                                                   CGroundSensorEquippedEntity::TYPE_BLACK_WHITE,
-                                                   m_pcEmbodiedEntity->GetOriginAnchor());
-         m_pcGroundSensorEquippedEntity->AddSensor(CVector2(0.0, 0.08),
-                                                   CGroundSensorEquippedEntity::TYPE_BLACK_WHITE,
-                                                   m_pcEmbodiedEntity->GetOriginAnchor());
-         m_pcGroundSensorEquippedEntity->AddSensor(CVector2(-0.042, 0.065),
-                                                   CGroundSensorEquippedEntity::TYPE_BLACK_WHITE,
-                                                   m_pcEmbodiedEntity->GetOriginAnchor());
-         m_pcGroundSensorEquippedEntity->AddSensor(CVector2(-0.08, 0.0),
-                                                   CGroundSensorEquippedEntity::TYPE_BLACK_WHITE,
-                                                   m_pcEmbodiedEntity->GetOriginAnchor());
-         m_pcGroundSensorEquippedEntity->AddSensor(CVector2(-0.042, -0.065),
-                                                   CGroundSensorEquippedEntity::TYPE_BLACK_WHITE,
-                                                   m_pcEmbodiedEntity->GetOriginAnchor());
-         m_pcGroundSensorEquippedEntity->AddSensor(CVector2(0.0, -0.08),
-                                                   CGroundSensorEquippedEntity::TYPE_BLACK_WHITE,
-                                                   m_pcEmbodiedEntity->GetOriginAnchor());
-         m_pcGroundSensorEquippedEntity->AddSensor(CVector2(0.042, -0.065),
-                                                   CGroundSensorEquippedEntity::TYPE_BLACK_WHITE,
-                                                   m_pcEmbodiedEntity->GetOriginAnchor());
+         if(cDemand.Needs({ "newepuck_ground", "ground" })) {
+            m_pcGroundSensorEquippedEntity =
+               new CGroundSensorEquippedEntity(this, "ground_0");
+            AddComponent(*m_pcGroundSensorEquippedEntity);
+            m_pcGroundSensorEquippedEntity->AddSensor(CVector2(0.063, 0.0116),
+                                                      CGroundSensorEquippedEntity::TYPE_GRAYSCALE,
+                                                      m_pcEmbodiedEntity->GetOriginAnchor());
+            m_pcGroundSensorEquippedEntity->AddSensor(CVector2(-0.063, 0.0116),
+                                                      CGroundSensorEquippedEntity::TYPE_GRAYSCALE,
+                                                      m_pcEmbodiedEntity->GetOriginAnchor());
+            m_pcGroundSensorEquippedEntity->AddSensor(CVector2(-0.063, -0.0116),
+                                                      CGroundSensorEquippedEntity::TYPE_GRAYSCALE,
+                                                      m_pcEmbodiedEntity->GetOriginAnchor());
+            m_pcGroundSensorEquippedEntity->AddSensor(CVector2(0.063, -0.0116),
+                                                      CGroundSensorEquippedEntity::TYPE_GRAYSCALE,
+                                                      m_pcEmbodiedEntity->GetOriginAnchor());
+            m_pcGroundSensorEquippedEntity->AddSensor(CVector2(0.08, 0.0),
+                                                      CGroundSensorEquippedEntity::TYPE_BLACK_WHITE,
+                                                      m_pcEmbodiedEntity->GetOriginAnchor());
+            m_pcGroundSensorEquippedEntity->AddSensor(CVector2(0.042, 0.065),
+                                                      CGroundSensorEquippedEntity::TYPE_BLACK_WHITE,
+                                                      m_pcEmbodiedEntity->GetOriginAnchor());
+            m_pcGroundSensorEquippedEntity->AddSensor(CVector2(0.0, 0.08),
+                                                      CGroundSensorEquippedEntity::TYPE_BLACK_WHITE,
+                                                      m_pcEmbodiedEntity->GetOriginAnchor());
+            m_pcGroundSensorEquippedEntity->AddSensor(CVector2(-0.042, 0.065),
+                                                      CGroundSensorEquippedEntity::TYPE_BLACK_WHITE,
+                                                      m_pcEmbodiedEntity->GetOriginAnchor());
+            m_pcGroundSensorEquippedEntity->AddSensor(CVector2(-0.08, 0.0),
+                                                      CGroundSensorEquippedEntity::TYPE_BLACK_WHITE,
+                                                      m_pcEmbodiedEntity->GetOriginAnchor());
+            m_pcGroundSensorEquippedEntity->AddSensor(CVector2(-0.042, -0.065),
+                                                      CGroundSensorEquippedEntity::TYPE_BLACK_WHITE,
+                                                      m_pcEmbodiedEntity->GetOriginAnchor());
+            m_pcGroundSensorEquippedEntity->AddSensor(CVector2(0.0, -0.08),
+                                                      CGroundSensorEquippedEntity::TYPE_BLACK_WHITE,
+                                                      m_pcEmbodiedEntity->GetOriginAnchor());
+            m_pcGroundSensorEquippedEntity->AddSensor(CVector2(0.042, -0.065),
+                                                      CGroundSensorEquippedEntity::TYPE_BLACK_WHITE,
+                                                      m_pcEmbodiedEntity->GetOriginAnchor());
+         }
          /* RAB equipped entity */
-         Real fRange = 0.8f;
-         GetNodeAttributeOrDefault(t_tree, "rab_range", fRange, fRange);
-         UInt32 unDataSize = 2;
-         GetNodeAttributeOrDefault(t_tree, "rab_data_size", unDataSize, unDataSize);
-         m_pcRABEquippedEntity = new CRABEquippedEntity(this,
-                                                        "rab_0",
-                                                        unDataSize,
-                                                        fRange,
-                                                        m_pcEmbodiedEntity->GetOriginAnchor(),
-                                                        *m_pcEmbodiedEntity,
-                                                        CVector3(0.0f, 0.0f, RAB_ELEVATION));
-         AddComponent(*m_pcRABEquippedEntity);
+         if(cDemand.Needs({ "range_and_bearing" })) {
+            Real fRange = 0.8f;
+            GetNodeAttributeOrDefault(t_tree, "rab_range", fRange, fRange);
+            UInt32 unDataSize = 2;
+            GetNodeAttributeOrDefault(t_tree, "rab_data_size", unDataSize, unDataSize);
+            m_pcRABEquippedEntity = new CRABEquippedEntity(this,
+                                                           "rab_0",
+                                                           unDataSize,
+                                                           fRange,
+                                                           m_pcEmbodiedEntity->GetOriginAnchor(),
+                                                           *m_pcEmbodiedEntity,
+                                                           CVector3(0.0f, 0.0f, RAB_ELEVATION));
+            AddComponent(*m_pcRABEquippedEntity);
+         }
          
          /* Battery equipped entity */
-         m_pcBatteryEquippedEntity = new CBatteryEquippedEntity(this, "battery_0");
-         if(NodeExists(t_tree, "battery"))
-            m_pcBatteryEquippedEntity->Init(GetNode(t_tree, "battery"));
-         AddComponent(*m_pcBatteryEquippedEntity);
+         if(cDemand.Needs({ "battery" })) {
+            m_pcBatteryEquippedEntity = new CBatteryEquippedEntity(this, "battery_0");
+            if(NodeExists(t_tree, "battery"))
+               m_pcBatteryEquippedEntity->Init(GetNode(t_tree, "battery"));
+            AddComponent(*m_pcBatteryEquippedEntity);
+         }
          /* Controllable entity
             It must be the last one, for actuators/sensors to link to composing entities correctly */
          m_pcControllableEntity = new CControllableEntity(this);
@@ -387,12 +529,22 @@ namespace argos {
 
    void CNewEPuckEntity::Destroy() {
       CComposableEntity::Destroy();
+      /* The demands belong to the configuration of this experiment */
+      CNewEPuckComponentDemand::Clear();
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CNewEPuckEntity::ThrowMissingComponent(const std::string& str_device) const {
+      THROW_ARGOSEXCEPTION("The new e-puck \"" << GetId() << "\" has no component for the " << str_device <<
+                           " (its controller does not declare the device).");
    }
 
    /****************************************/
    /****************************************/
 
-#define UPDATE(COMPONENT) if(COMPONENT->IsEnabled()) COMPONENT->Update();
+#define UPDATE(COMPONENT) if(COMPONENT != nullptr && COMPONENT->IsEnabled()) COMPONENT->Update();
 
    void CNewEPuckEntity::UpdateComponents() {
       UPDATE(m_pcRABEquippedEntity);
@@ -440,7 +592,10 @@ namespace argos {
                    "is oriented along the X axis.\n"
                    "The 'controller/config' attribute is used to assign a controller to the\n"
                    "new_e-puck. The value of the attribute must be set to the id of a previously\n"
-                   "defined controller. Controllers are defined in the <controllers> XML subtree.\n\n"
+                   "defined controller. Controllers are defined in the <controllers> XML subtree.\n"
+                   "Only the components needed by the sensors and actuators listed in the\n"
+                   "controller configuration are created. With Lua controllers, which can ask for\n"
+                   "any device at runtime, all the components are created.\n\n"
                    "OPTIONAL XML CONFIGURATION\n\n"
                    "You can set the emission range of the range-and-bearing system. By default, a\n"
                    "message sent by an new_e-puck can be received up to 80cm. By using the 'rab_range'\n"
@@ -49,6 +49,13 @@ namespace argos {
       virtual void Destroy();
 
       virtual void UpdateComponents();
+
+      /*
+       * The body, wheels and controller are always present. The other
+       * components are created only if the controller uses a device that
+       * needs them: check with the Has*() methods, as their getters throw
+       * a CARGoSException naming the missing device.
+       */
       
       inline CControllableEntity& GetControllableEntity() {
          return *m_pcControllableEntity;
@@ -58,27 +65,69 @@ namespace argos {
          return *m_pcEmbodiedEntity;
       }
 
+      inline bool HasGroundSensorEquippedEntity() const {
+         return m_pcGroundSensorEquippedEntity != nullptr;
+      }
+
       inline CGroundSensorEquippedEntity& GetGroundSensorEquippedEntity() {
+         if(m_pcGroundSensorEquippedEntity == nullptr) {
+            ThrowMissingComponent("ground sensors");
+         }
          return *m_pcGroundSensorEquippedEntity;
       }
 
+      inline bool HasLEDEquippedEntity() const {
+         return m_pcLEDEquippedEntity != nullptr;
+      }
+
       inline CLEDEquippedEntity& GetLEDEquippedEntity() {
+         if(m_pcLEDEquippedEntity == nullptr) {
+            ThrowMissingComponent("LEDs");
+         }
          return *m_pcLEDEquippedEntity;
       }
 
+      inline bool HasLightSensorEquippedEntity() const {
+         return m_pcLightSensorEquippedEntity != nullptr;
+      }
+
       inline CLightSensorEquippedEntity& GetLightSensorEquippedEntity() {
+         if(m_pcLightSensorEquippedEntity == nullptr) {
+            ThrowMissingComponent("light sensors");
+         }
          return *m_pcLightSensorEquippedEntity;
       }
 
+      inline bool HasLidarSensorEquippedEntity() const {
+         return m_pcLIDARSensorEquippedEntity != nullptr;
+      }
+
       inline CProximitySensorEquippedEntity& GetLidarSensorEquippedEntity() {
+         if(m_pcLIDARSensorEquippedEntity == nullptr) {
+            ThrowMissingComponent("LIDAR");
+         }
          return *m_pcLIDARSensorEquippedEntity;
       }
 
+      inline bool HasProximitySensorEquippedEntity() const {
+         return m_pcProximitySensorEquippedEntity != nullptr;
+      }
+
       inline CProximitySensorEquippedEntity& GetProximitySensorEquippedEntity() {
+         if(m_pcProximitySensorEquippedEntity == nullptr) {
+            ThrowMissingComponent("proximity sensors");
+         }
          return *m_pcProximitySensorEquippedEntity;
       }
 
+      inline bool HasRABEquippedEntity() const {
+         return m_pcRABEquippedEntity != nullptr;
+      }
+
       inline CRABEquippedEntity& GetRABEquippedEntity() {
+         if(m_pcRABEquippedEntity == nullptr) {
+            ThrowMissingComponent("range and bearing");
+         }
          return *m_pcRABEquippedEntity;
       }
 
@@ -86,8 +135,15 @@ namespace argos {
          return *m_pcWheeledEntity;
       }
 
+      inline bool HasBatterySensorEquippedEntity() const {
+         return m_pcBatteryEquippedEntity != nullptr;
+      }
+
       inline CBatteryEquippedEntity& GetBatterySensorEquippedEntity() {
-          return *m_pcBatteryEquippedEntity;
+         if(m_pcBatteryEquippedEntity == nullptr) {
+            ThrowMissingComponent("battery");
+         }
+         return *m_pcBatteryEquippedEntity;
       }
 
       virtual std::string GetTypeDescription() const {
@@ -102,6 +158,12 @@ namespace argos {
 
       void SetLEDPosition();
 
+      /*
+       * Throws a CARGoSException telling that the robot has no component
+       * for the given device.
+       */
+      void ThrowMissingComponent(const std::string& str_device) const;
+
    private:
 
       CControllableEntity*                   m_pcControllableEntity;
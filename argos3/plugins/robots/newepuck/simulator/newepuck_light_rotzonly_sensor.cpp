@@ -18,18 +18,10 @@ namespace argos {
    /****************************************/
 
    static CRange<Real> SENSOR_RANGE(0.0f, 1.0f);
-   static CRadians SENSOR_SPACING      = CRadians(ARGOS_PI / 12.0f);
-   static CRadians SENSOR_HALF_SPACING = SENSOR_SPACING * 0.5;
 
    /****************************************/
    /****************************************/
 
-   static SInt32 Modulo(SInt32 n_value, SInt32 un_modulo) {
-      while(n_value < 0) n_value += un_modulo;
-      while(n_value >= un_modulo) n_value -= un_modulo;
-      return n_value;
-   }
-
    static Real ComputeReading(Real f_distance) {
       if(f_distance > 2.5f) {
          return 0.0f;
@@ -39,12 +31,16 @@ namespace argos {
       }
    }
 
-   static Real ScaleReading(const CRadians& c_angular_distance) {
-      if(c_angular_distance > CRadians::PI_OVER_TWO) {
-         return 0.0f;
-      }
-      else {
-         return (1.0f - 2.0f * c_angular_distance / CRadians::PI);
+   /****************************************/
+   /****************************************/
+
+   void CNewEPuckLightRotZOnlySensor::DistributeReading(SLanes& s_lanes,
+                                                        Real f_light_x,
+                                                        Real f_light_y,
+                                                        Real f_reading) {
+      for(UInt32 i = 0; i < NUM_LANES; ++i) {
+         Real fDot = s_lanes.DirX[i] * f_light_x + s_lanes.DirY[i] * f_light_y;
+         s_lanes.Value[i] += f_reading * (fDot > 0.0f ? fDot : 0.0f);
       }
    }
 
@@ -52,16 +48,26 @@ namespace argos {
    /****************************************/
 
    CNewEPuckLightRotZOnlySensor::CNewEPuckLightRotZOnlySensor() :
+      CSensorRays("light"),
       m_pcEmbodiedEntity(nullptr),
       m_bShowRays(false),
       m_pcRNG(nullptr),
       m_bAddNoise(false),
-      m_cSpace(CSimulator::GetInstance().GetSpace()) {}
+      m_cSpace(CSimulator::GetInstance().GetSpace()),
+      m_cProfiler("light") {
+      /* The sensor angles are fixed by the control interface */
+      for(UInt32 i = 0; i < NUM_LANES; ++i) {
+         m_sLanes.DirX[i] = Cos(m_tReadings[i].Angle);
+         m_sLanes.DirY[i] = Sin(m_tReadings[i].Angle);
+         m_sLanes.Value[i] = 0.0f;
+      }
+   }
 
    /****************************************/
    /****************************************/
 
    void CNewEPuckLightRotZOnlySensor::SetRobot(CComposableEntity& c_entity) {
+      m_cProfiler.SetRobot(c_entity.GetId());
       try {
          m_pcEmbodiedEntity = &(c_entity.GetComponent<CEmbodiedEntity>("body"));
          m_pcControllableEntity = &(c_entity.GetComponent<CControllableEntity>("controller"));
@@ -81,6 +87,10 @@ namespace argos {
 
    void CNewEPuckLightRotZOnlySensor::Init(TConfigurationNode& t_tree) {
       try {
+         /* Parse the update period */
+         m_cUpdatePeriod.Init(t_tree);
+         /* Profile the updates? */
+         m_cProfiler.Init(t_tree);
          /* Show rays? */
          GetNodeAttributeOrDefault(t_tree, "show_rays", m_bShowRays, m_bShowRays);
          /* Parse noise level */
@@ -94,7 +104,6 @@ namespace argos {
             m_cNoiseRange.Set(-fNoiseLevel, fNoiseLevel);
             m_pcRNG = CRandom::CreateRNG("argos");
          }
-         m_tReadings.resize(m_pcLightEntity->GetNumSensors());
       }
       catch(CARGoSException& ex) {
          THROW_ARGOSEXCEPTION_NESTED("Initialization error in rot_z_only light sensor", ex);
@@ -105,23 +114,32 @@ namespace argos {
    /****************************************/
    
    void CNewEPuckLightRotZOnlySensor::Update() {
+      /* Measure the whole update */
+      CNewEPuckSensorProfiler::CScope cProfile(m_cProfiler);
+      /* Remember which rays are from this sensor */
+      CSensorRays::CRecorder cRays(*this, *m_pcControllableEntity);
       /* sensor is disabled--nothing to do */
       if (IsDisabled()) {
         return;
       }
+      /* readings are not due yet--keep the last ones */
+      if(! m_cUpdatePeriod.IsDue()) {
+         return;
+      }
       /* Erase readings */
-      for(size_t i = 0; i < m_tReadings.size(); ++i) {
-         m_tReadings[i].Value = 0.0f;
+      for(UInt32 i = 0; i < NUM_LANES; ++i) {
+         m_sLanes.Value[i] = 0.0f;
       }
       /* Get new_e-puck orientation */
       CRadians cTmp1, cTmp2, cOrientationZ;
       m_pcEmbodiedEntity->GetOriginAnchor().Orientation.ToEulerAngles(cOrientationZ, cTmp1, cTmp2);
+      /* Rotation from the world frame to the robot frame */
+      Real fCosOrientation = Cos(cOrientationZ);
+      Real fSinOrientation = Sin(cOrientationZ);
       /* Ray used for scanning the environment for obstacles */
       CRay3 cOcclusionCheckRay;
       cOcclusionCheckRay.SetStart(m_pcEmbodiedEntity->GetOriginAnchor().Position);
       CVector3 cRobotToLight;
-      /* Buffer for the angle of the light wrt to the e-puck */
-      CRadians cAngleLightWrtNewEpuck;
       /* Buffers to contain data about the intersection */
       SEmbodiedEntityIntersectionItem sIntersection;
       /* List of light entities */
@@ -157,33 +175,21 @@ namespace argos {
                 * The greater the intensity, the smaller the distance
                 */
                cRobotToLight /= cLight.GetIntensity();
-               /* Get the angle wrt to e-puck rotation */
-               cAngleLightWrtNewEpuck = cRobotToLight.GetZAngle();
-               cAngleLightWrtNewEpuck -= cOrientationZ;
-               /*
-                * Find closest sensor index to point at which ray hits newepuck body
-                * Rotate whole body by half a sensor spacing (corresponding to placement of first sensor)
-                * Division says how many sensor spacings there are between first sensor and point at which ray hits newepuck body
-                * Increase magnitude of result of division to ensure correct rounding
-                */
-               Real fIdx = (cAngleLightWrtNewEpuck - SENSOR_HALF_SPACING) / SENSOR_SPACING;
-               SInt32 nReadingIdx = static_cast<SInt32>((fIdx > 0) ? fIdx + 0.5f : fIdx - 0.5f);
-               /* Set the actual readings */
-               Real fReading = cRobotToLight.Length();
-               /*
-                * Take 6 readings before closest sensor and 6 readings after - thus we
-                * process sensors that are with 180 degrees of intersection of light
-                * ray with robot body
-                */
-               for(SInt32 nIndexOffset = -6; nIndexOffset < 7; ++nIndexOffset) {
-                  UInt32 unIdx = Modulo(nReadingIdx + nIndexOffset, 24);
-                  CRadians cAngularDistanceFromOptimalLightReceptionPoint = Abs((cAngleLightWrtNewEpuck - m_tReadings[unIdx].Angle).SignedNormalize());
+               /* Direction of the light on the XY plane, in the robot frame */
+               Real fPlanarLength = ::sqrt(cRobotToLight.GetX() * cRobotToLight.GetX() +
+                                           cRobotToLight.GetY() * cRobotToLight.GetY());
+               if(fPlanarLength > 0.0f) {
+                  Real fLightX = ( fCosOrientation * cRobotToLight.GetX() +
+                                   fSinOrientation * cRobotToLight.GetY()) / fPlanarLength;
+                  Real fLightY = (-fSinOrientation * cRobotToLight.GetX() +
+                                   fCosOrientation * cRobotToLight.GetY()) / fPlanarLength;
                   /*
                    * ComputeReading gives value as if sensor was perfectly in line with
-                   * light ray. We then linearly decrease actual reading from 1 (dist
-                   * 0) to 0 (dist PI/2)
+                   * light ray. Each sensor then gets it scaled by its alignment with
+                   * the light.
                    */
-                  m_tReadings[unIdx].Value += ComputeReading(fReading) * ScaleReading(cAngularDistanceFromOptimalLightReceptionPoint);
+                  DistributeReading(m_sLanes, fLightX, fLightY,
+                                    ComputeReading(cRobotToLight.Length()));
                }
             }
             else {
@@ -195,14 +201,13 @@ namespace argos {
             }
          }
       }
-      /* Apply noise to the sensors */
-      if(m_bAddNoise) {
-         for(size_t i = 0; i < 24; ++i) {
+      for(UInt32 i = 0; i < NUM_LANES; ++i) {
+         m_tReadings[i].Value = m_sLanes.Value[i];
+         /* Apply noise to the sensor */
+         if(m_bAddNoise) {
             m_tReadings[i].Value += m_pcRNG->Uniform(m_cNoiseRange);
          }
-      }
-      /* Trunc the reading between 0 and 1 */
-      for(size_t i = 0; i < 24; ++i) {
+         /* Trunc the reading between 0 and 1 */
          SENSOR_RANGE.TruncValue(m_tReadings[i].Value);
       }
    }
@@ -211,6 +216,7 @@ namespace argos {
    /****************************************/
 
    void CNewEPuckLightRotZOnlySensor::Reset() {
+      m_cUpdatePeriod.Reset();
       for(UInt32 i = 0; i < GetReadings().size(); ++i) {
          m_tReadings[i].Value = 0.0f;
       }
@@ -232,9 +238,11 @@ namespace argos {
                    "perceived light. The reference intensity corresponds to the minimum distance at\n"
                    "which the light saturates a sensor. The reference intensity depends on the\n"
                    "individual light, and it is set with the \"intensity\" attribute of the light\n"
-                   "entity. In case multiple lights are present in the environment, each sensor\n"
-                   "reading is calculated as the sum of the individual readings due to each light.\n"
-                   "In other words, light wave interference is not taken into account. In\n"
+                   "entity. Each of the 24 sensors receives this reading scaled by the cosine of\n"
+                   "the angle between the sensor and the light, and nothing when the light is more\n"
+                   "than 90 degrees away. In case multiple lights are present in the environment,\n"
+                   "each sensor reading is calculated as the sum of the individual readings due to\n"
+                   "each light. In other words, light wave interference is not taken into account. In\n"
                    "controllers, you must include the ci_light_sensor.h header.\n\n"
                    "REQUIRED XML CONFIGURATION\n\n"
                    "  <controllers>\n"
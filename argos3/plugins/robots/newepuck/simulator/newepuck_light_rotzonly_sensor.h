@@ -16,15 +16,35 @@ namespace argos {
 }
 
 #include <argos3/plugins/robots/newepuck/control_interface/ci_newepuck_light_sensor.h>
+#include <argos3/plugins/simulator/sensors/robot_sensors/sensor_update_period.h>
+#include <argos3/plugins/robots/newepuck/simulator/newepuck_sensor_profiler.h>
 #include <argos3/core/utility/math/range.h>
 #include <argos3/core/utility/math/rng.h>
 #include <argos3/core/simulator/space/space.h>
 #include <argos3/core/simulator/sensor.h>
+#include <argos3/plugins/simulator/visualizations/batch_rendering/sensor_rays.h>
 
 namespace argos {
 
    class CNewEPuckLightRotZOnlySensor : public CSimulatedSensor,
-                                      public CCI_NewEPuckLightSensor {
+                                      public CCI_NewEPuckLightSensor,
+                                      public CSensorRays {
+
+   public:
+
+      /** Number of light readings exposed by the control interface */
+      static const UInt32 NUM_LANES = 24;
+
+      /**
+       * Per-sensor data laid out for the light distribution kernel.
+       * DirX/DirY hold the unit vector of each sensor in the robot frame,
+       * Value accumulates the contribution of every visible light.
+       */
+      struct SLanes {
+         Real DirX[NUM_LANES];
+         Real DirY[NUM_LANES];
+         Real Value[NUM_LANES];
+      };
 
    public:
 
@@ -56,6 +76,22 @@ namespace argos {
          m_bShowRays = b_show_rays;
       }
 
+      /**
+       * Adds the contribution of a light to all the sensors.
+       * Each sensor receives f_reading scaled by the cosine of the angle
+       * between the sensor and the light, clamped to zero past 90 degrees.
+       * The loop has a fixed trip count and no branches, so it is
+       * vectorized by the compiler.
+       * @param s_lanes the sensor directions and accumulators
+       * @param f_light_x x component of the unit vector to the light, robot frame
+       * @param f_light_y y component of the unit vector to the light, robot frame
+       * @param f_reading the reading of a sensor pointing straight at the light
+       */
+      static void DistributeReading(SLanes& s_lanes,
+                                    Real f_light_x,
+                                    Real f_light_y,
+                                    Real f_reading);
+
    protected:
 
       /** Reference to embodied entity associated to this sensor */
@@ -81,6 +117,15 @@ namespace argos {
 
       /** Reference to the space */
       CSpace& m_cSpace;
+
+      /** Sensor directions and accumulators for the distribution kernel */
+      SLanes m_sLanes;
+
+      /** Limits how often the readings are computed */
+      CSensorUpdatePeriod m_cUpdatePeriod;
+
+      /** Measures the updates, if profiling is on */
+      CNewEPuckSensorProfiler m_cProfiler;
    };
 
 }
@@ -0,0 +1,56 @@
+/**
+ * @file <argos3/plugins/robots/newepuck/simulator/newepuck_odometry_default_sensor.h>
+ *
+ * @author Jyotsna Bellary <jyotsnabellary@gmail.com>
+ */
+
+#ifndef NEWEPUCK_ODOMETRY_DEFAULT_SENSOR_H
+#define NEWEPUCK_ODOMETRY_DEFAULT_SENSOR_H
+
+namespace argos {
+   class CNewEPuckOdometryDefaultSensor;
+   class CEmbodiedEntity;
+   class CWheeledEntity;
+}
+
+#include <argos3/plugins/robots/newepuck/control_interface/ci_newepuck_odometry_sensor.h>
+#include <argos3/plugins/robots/newepuck/simulator/newepuck_sensor_profiler.h>
+#include <argos3/plugins/simulator/sensors/robot_sensors/odometry_batch.h>
+#include <argos3/core/simulator/sensor.h>
+
+namespace argos {
+
+   class CNewEPuckOdometryDefaultSensor : public CCI_NewEPuckOdometrySensor,
+                                          public CSimulatedSensor {
+
+   public:
+
+      CNewEPuckOdometryDefaultSensor();
+
+      virtual ~CNewEPuckOdometryDefaultSensor() {}
+
+      virtual void SetRobot(CComposableEntity& c_entity);
+
+      virtual void Init(TConfigurationNode& t_tree);
+
+      virtual void Update();
+
+      virtual void Reset();
+
+      virtual void Destroy();
+
+   private:
+
+      CEmbodiedEntity* m_pcEmbodiedEntity;
+      CWheeledEntity* m_pcWheeledEntity;
+
+      /** Slot in the batch, -1 before Init() */
+      SInt64 m_nSlot;
+
+      /** Measures the updates, if profiling is on */
+      CNewEPuckSensorProfiler m_cProfiler;
+   };
+
+}
+
+#endif
@@ -0,0 +1,70 @@
+/**
+ * @file <argos3/plugins/robots/newepuck/simulator/newepuck_pool.h>
+ *
+ * @brief This file provides a pool to spawn and despawn new e-pucks at runtime.
+ *
+ * Despawned robots are parked: taken out of the physics engines and
+ * disabled. Spawning reuses a parked robot before creating a new one. See
+ * CRobotPool for the details.
+ *
+ * Example, in a loop functions whose XML node has a <new_e-puck> child with
+ * the attributes and the <controller> of the robots:
+ *
+ *    m_pcPool = new CNewEPuckPool(GetSpace(),
+ *                                 GetNode(t_tree, "new_e-puck"),
+ *                                 "ep");
+ *    CNewEPuckEntity* pcRobot = m_pcPool->Spawn(CVector3(1.0, 0.0, 0.0));
+ *    ...
+ *    m_pcPool->Despawn(*pcRobot);
+ *
+ * @author Jyotsna Bellary <jyotsnabellary@gmail.com>
+ */
+
+#ifndef NEWEPUCK_POOL_H
+#define NEWEPUCK_POOL_H
+
+namespace argos {
+   class CNewEPuckPool;
+}
+
+#include <argos3/plugins/simulator/sensors/robot_sensors/robot_pool.h>
+#include <argos3/plugins/robots/newepuck/simulator/newepuck_entity.h>
+
+namespace argos {
+
+   class CNewEPuckPool : public CRobotPool {
+
+   public:
+
+      /**
+       * Creates an empty pool.
+       * @param c_space the space
+       * @param t_robot the <new_e-puck> node of the robots
+       * @param str_id_prefix the prefix of the robot ids
+       * @throws CARGoSException if the node is not a <new_e-puck> node
+       */
+      CNewEPuckPool(CSpace& c_space,
+                    TConfigurationNode& t_robot,
+                    const std::string& str_id_prefix) :
+         CRobotPool(c_space, t_robot, "new_e-puck", str_id_prefix) {}
+
+      /**
+       * Places a robot in the arena. See CRobotPool::SpawnEntity().
+       */
+      inline CNewEPuckEntity* Spawn(const CVector3& c_position,
+                                    const CQuaternion& c_orientation = CQuaternion()) {
+         return static_cast<CNewEPuckEntity*>(SpawnEntity(c_position, c_orientation));
+      }
+
+      /**
+       * Parks a robot. See CRobotPool::DespawnEntity().
+       */
+      inline void Despawn(CNewEPuckEntity& c_robot) {
+         DespawnEntity(c_robot);
+      }
+
+   };
+
+}
+
+#endif
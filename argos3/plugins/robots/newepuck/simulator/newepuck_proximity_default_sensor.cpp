@@ -16,41 +16,11 @@ namespace argos {
    /****************************************/
    /****************************************/
 
-   class CNewEPuckProximitySensorImpl : public CProximityDefaultSensor {
-
-   public:
-
-      virtual void SetRobot(CComposableEntity& c_entity) {
-         try {
-            m_pcEmbodiedEntity = &(c_entity.GetComponent<CEmbodiedEntity>("body"));
-            m_pcControllableEntity = &(c_entity.GetComponent<CControllableEntity>("controller"));
-            m_pcProximityEntity = &(c_entity.GetComponent<CProximitySensorEquippedEntity>("proximity_sensors[proximity]"));
-            m_pcProximityEntity->Enable();
-         }
-         catch(CARGoSException& ex) {
-            THROW_ARGOSEXCEPTION_NESTED("Can't set robot for the NewEPuck proximity default sensor", ex);
-         }
-      }
-
-      virtual Real CalculateReading(Real f_distance) {
-         if(f_distance < 0.04) {
-            return 1.0;
-         }
-         else if(f_distance > 0.12){
-            return 0.0;
-         }
-         else {
-            return 4.14*exp(-33.0*f_distance)-.085;
-         }
-      }
-
-   };
-
-   /****************************************/
-   /****************************************/
-
    CNewEPuckProximityDefaultSensor::CNewEPuckProximityDefaultSensor() :
-      m_pcProximityImpl(new CNewEPuckProximitySensorImpl()) {}
+      CSensorRays("proximity"),
+      m_pcProximityImpl(new CGatedProximitySensor("NewEPuck")),
+      m_pcControllableEntity(nullptr),
+      m_cProfiler("proximity") {}
 
    /****************************************/
    /****************************************/
@@ -63,8 +33,10 @@ namespace argos {
    /****************************************/
 
    void CNewEPuckProximityDefaultSensor::SetRobot(CComposableEntity& c_entity) {
+      m_cProfiler.SetRobot(c_entity.GetId());
       try {
          m_pcProximityImpl->SetRobot(c_entity);
+         m_pcControllableEntity = &(c_entity.GetComponent<CControllableEntity>("controller"));
       }
       catch(CARGoSException& ex) {
          THROW_ARGOSEXCEPTION_NESTED("Can't set robot for the NewEPuck proximity default sensor", ex);
@@ -76,12 +48,23 @@ namespace argos {
 
    void CNewEPuckProximityDefaultSensor::Init(TConfigurationNode& t_tree) {
       m_pcProximityImpl->Init(t_tree);
+      m_cUpdatePeriod.Init(t_tree);
+      /* Profile the updates? */
+      m_cProfiler.Init(t_tree);
    }
 
    /****************************************/
    /****************************************/
 
    void CNewEPuckProximityDefaultSensor::Update() {
+      /* Measure the whole update */
+      CNewEPuckSensorProfiler::CScope cProfile(m_cProfiler);
+      /* Remember which rays are from this sensor */
+      CSensorRays::CRecorder cRays(*this, *m_pcControllableEntity);
+      /* readings are not due yet--keep the last ones */
+      if(! m_cUpdatePeriod.IsDue()) {
+         return;
+      }
       m_pcProximityImpl->Update();
       for(size_t i = 0; i < m_pcProximityImpl->GetReadings().size(); ++i) {
          m_tReadings[i].Value = m_pcProximityImpl->GetReadings()[i];
@@ -92,6 +75,7 @@ namespace argos {
    /****************************************/
 
    void CNewEPuckProximityDefaultSensor::Reset() {
+      m_cUpdatePeriod.Reset();
       m_pcProximityImpl->Reset();
    }
 
@@ -105,7 +89,11 @@ namespace argos {
                    "The NewEPuck proximity sensor.",
                    "This sensor accesses the NewEPuck proximity sensor. For a complete description\n"
                    "of its usage, refer to the ci_newepuck_proximity_sensor.h interface. For the XML\n"
-                   "configuration, refer to the default proximity sensor.\n",
+                   "configuration, refer to the default proximity sensor.\n\n"
+                   "Before casting its rays, the sensor checks whether any other embodied entity\n"
+                   "is within reach of the IR ring. If nothing is, the rays are not cast and all\n"
+                   "the readings are set to zero (plus noise, if configured). The check is skipped\n"
+                   "when \"show_rays\" is set to true.\n",
                    "Usable"
 		  );
 
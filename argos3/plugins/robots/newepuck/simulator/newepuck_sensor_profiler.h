@@ -0,0 +1,45 @@
+/**
+ * @file <argos3/plugins/robots/newepuck/simulator/newepuck_sensor_profiler.h>
+ *
+ * @brief This file provides the time profiler of the NewEPuck sensors.
+ *
+ * Every NewEPuck sensor accepts an optional 'profile' attribute. When it
+ * is "true", or when the NEWEPUCK_SENSOR_PROFILE environment variable is
+ * set to anything but "0", the sensor measures each call to Update(). The
+ * report is written as newepuck_sensor_profile.csv and
+ * newepuck_sensor_profile.json at the end of the experiment. See
+ * CSensorProfiler for the details.
+ *
+ * @author Jyotsna Bellary <jyotsnabellary@gmail.com>
+ */
+
+#ifndef NEWEPUCK_SENSOR_PROFILER_H
+#define NEWEPUCK_SENSOR_PROFILER_H
+
+namespace argos {
+   class CNewEPuckSensorProfiler;
+}
+
+#include <argos3/plugins/simulator/sensors/robot_sensors/sensor_profiler.h>
+
+namespace argos {
+
+   class CNewEPuckSensorProfiler : public CSensorProfiler {
+
+   public:
+
+      /**
+       * @param str_sensor the kind of sensor, such as "lidar", as shown
+       * in the report
+       */
+      CNewEPuckSensorProfiler(const std::string& str_sensor) :
+         CSensorProfiler(str_sensor,
+                         "NewEPuck",
+                         "NEWEPUCK_SENSOR_PROFILE",
+                         "newepuck_sensor_profile") {}
+
+   };
+
+}
+
+#endif
@@ -6,11 +6,16 @@
 
 #include "qtopengl_newepuck.h"
 #include "newepuck_entity.h"
+#include <argos3/core/simulator/simulator.h>
+#include <argos3/core/simulator/space/space.h>
 #include <argos3/core/simulator/entity/embodied_entity.h>
 #include <argos3/core/utility/math/vector2.h>
 #include <argos3/core/utility/math/vector3.h>
 #include <argos3/plugins/simulator/entities/led_equipped_entity.h>
 #include <argos3/plugins/simulator/visualizations/qt-opengl/qtopengl_widget.h>
+#include <argos3/plugins/simulator/visualizations/batch_rendering/qtopengl_level_of_detail.h>
+#include <argos3/plugins/simulator/visualizations/batch_rendering/qtopengl_mesh_builder.h>
+#include <argos3/plugins/simulator/visualizations/batch_rendering/qtopengl_offscreen_render.h>
 
 namespace argos {
 
@@ -38,300 +43,346 @@ namespace argos {
    static const Real LED_HEIGHT                  = 0.01;                               // to be checked!
    static const Real LED_UPPER_RING_INNER_RADIUS = 0.8 * BODY_RADIUS;
 
-   /****************************************/
-   /****************************************/
+   static const GLuint LOW_POLY_VERTICES         = 12;
 
-   CQTOpenGLNewEPuck::CQTOpenGLNewEPuck() :
-      m_unVertices(40),
-      m_fLEDAngleSlice(360.0f / 8.0f) {
-      /* Reserve the needed display lists */
-      m_unLists = glGenLists(4);
-
-      /* Assign indices for better referencing (later) */
-      m_unWheelList   = m_unLists;
-      m_unChassisList = m_unLists + 1;
-      m_unBodyList    = m_unLists + 2;
-      m_unLEDList     = m_unLists + 3;
-
-      /* Create the wheel display list */
-      glNewList(m_unWheelList, GL_COMPILE);
-      RenderWheel();
-      glEndList();
-
-      /* Create the body display list */
-      glNewList(m_unBodyList, GL_COMPILE);
-      RenderBody();
-      glEndList();
-
-      /* Create the chassis display list */
-      glNewList(m_unChassisList, GL_COMPILE);
-      RenderChassis();
-      glEndList();
-
-      /* Create the LED display list */
-      glNewList(m_unLEDList, GL_COMPILE);
-      RenderLED();
-      glEndList();
-   }
+   static const UInt32 NUM_LEDS                  = 8;
 
    /****************************************/
    /****************************************/
 
-   CQTOpenGLNewEPuck::~CQTOpenGLNewEPuck() {
-      glDeleteLists(m_unLists, 4);
-   }
-
-   /****************************************/
-   /****************************************/
+   static const CQTOpenGLInstancedMesh::SMaterial GREEN_PLASTIC_MATERIAL = {
+      {   0.0f, 1.0f, 0.0f, 1.0f },
+      {   0.9f, 0.9f, 0.9f, 1.0f },
+      100.0f,
+      {   0.0f, 0.0f, 0.0f, 1.0f }
+   };
 
-   void CQTOpenGLNewEPuck::Draw(CNewEPuckEntity& c_entity) {
-      /* Place the chassis */
-      glCallList(m_unChassisList);
-      /* Place the body */
-      glCallList(m_unBodyList);
-      /* Place the wheels */
-      glPushMatrix();
-      glTranslated(0.0f, HALF_INTERWHEEL_DISTANCE, 0.0f);
-      glCallList(m_unWheelList);
-      glPopMatrix();
-      glPushMatrix();
-      glTranslated(0.0f, -HALF_INTERWHEEL_DISTANCE, 0.0f);
-      glCallList(m_unWheelList);
-      glPopMatrix();
-      /* Place the LEDs */
-      glPushMatrix();
-      CLEDEquippedEntity& cLEDEquippedEntity = c_entity.GetLEDEquippedEntity();
-      for(UInt32 i = 0; i < 8; i++) {
-         const CColor& cColor = cLEDEquippedEntity.GetLED(i).GetColor();
-         glRotated(-m_fLEDAngleSlice, 0.0f, 0.0f, 1.0f);
-         SetLEDMaterial(cColor.GetRed(),
-                        cColor.GetGreen(),
-                        cColor.GetBlue());
-         glCallList(m_unLEDList);
-      }
-      glPopMatrix();
-   }
+   static const CQTOpenGLInstancedMesh::SMaterial RED_PLASTIC_MATERIAL = {
+      {   1.0f, 0.0f, 0.0f, 1.0f },
+      {   0.9f, 0.9f, 0.9f, 1.0f },
+      100.0f,
+      {   0.0f, 0.0f, 0.0f, 1.0f }
+   };
 
-   /****************************************/
-   /****************************************/
+   /* Same as a yellow LED */
+   static const CQTOpenGLInstancedMesh::SMaterial DIRECTION_MATERIAL = {
+      {   1.0f, 1.0f, 0.0f, 1.0f },
+      {   0.0f, 0.0f, 0.0f, 1.0f },
+      0.0f,
+      {   1.0f, 1.0f, 0.0f, 1.0f }
+   };
 
-   void CQTOpenGLNewEPuck::SetGreenPlasticMaterial() {
-      const GLfloat pfColor[]     = {   0.0f, 1.0f, 0.0f, 1.0f };
-      const GLfloat pfSpecular[]  = {   0.9f, 0.9f, 0.9f, 1.0f };
-      const GLfloat pfShininess[] = { 100.0f                   };
-      const GLfloat pfEmission[]  = {   0.0f, 0.0f, 0.0f, 1.0f };
-      glMaterialfv(GL_FRONT_AND_BACK, GL_AMBIENT_AND_DIFFUSE, pfColor);
-      glMaterialfv(GL_FRONT_AND_BACK, GL_SPECULAR,            pfSpecular);
-      glMaterialfv(GL_FRONT_AND_BACK, GL_SHININESS,           pfShininess);
-      glMaterialfv(GL_FRONT_AND_BACK, GL_EMISSION,            pfEmission);
-   }
+   /* The color of the LED is the emission, set per instance */
+   static const CQTOpenGLInstancedMesh::SMaterial LED_MATERIAL = {
+      {   0.0f, 0.0f, 0.0f, 1.0f },
+      {   0.0f, 0.0f, 0.0f, 1.0f },
+      0.0f,
+      {   0.0f, 0.0f, 0.0f, 1.0f }
+   };
 
    /****************************************/
    /****************************************/
 
-   void CQTOpenGLNewEPuck::SetRedPlasticMaterial() {
-      const GLfloat pfColor[]     = {   1.0f, 0.0f, 0.0f, 1.0f };
-      const GLfloat pfSpecular[]  = {   0.9f, 0.9f, 0.9f, 1.0f };
-      const GLfloat pfShininess[] = { 100.0f                   };
-      const GLfloat pfEmission[]  = {   0.0f, 0.0f, 0.0f, 1.0f };
-      glMaterialfv(GL_FRONT_AND_BACK, GL_AMBIENT_AND_DIFFUSE, pfColor);
-      glMaterialfv(GL_FRONT_AND_BACK, GL_SPECULAR,            pfSpecular);
-      glMaterialfv(GL_FRONT_AND_BACK, GL_SHININESS,           pfShininess);
-      glMaterialfv(GL_FRONT_AND_BACK, GL_EMISSION,            pfEmission);
+   CQTOpenGLNewEPuck::CQTOpenGLNewEPuck() :
+      m_unVertices(40),
+      m_fLEDAngleSlice(360.0f / NUM_LEDS) {
+      /* Record each part once and keep it in a vertex buffer */
+      CQTOpenGLMeshBuilder cMesh;
+      RenderWheel(cMesh);
+      m_pcWheel = new CQTOpenGLInstancedMesh(cMesh, RED_PLASTIC_MATERIAL);
+      cMesh.Clear();
+      RenderChassis(cMesh);
+      m_pcChassis = new CQTOpenGLInstancedMesh(cMesh, GREEN_PLASTIC_MATERIAL);
+      cMesh.Clear();
+      RenderBody(cMesh);
+      m_pcBody = new CQTOpenGLInstancedMesh(cMesh, GREEN_PLASTIC_MATERIAL);
+      cMesh.Clear();
+      RenderDirection(cMesh);
+      m_pcDirection = new CQTOpenGLInstancedMesh(cMesh, DIRECTION_MATERIAL);
+
+      /* Mid-range and far parts, with fewer sides */
+      GLuint unVertices = m_unVertices;
+      m_unVertices = LOW_POLY_VERTICES;
+      cMesh.Clear();
+      RenderBody(cMesh);
+      m_pcLowPolyBody = new CQTOpenGLInstancedMesh(cMesh, GREEN_PLASTIC_MATERIAL);
+      cMesh.Clear();
+      RenderDisk(cMesh);
+      m_pcDisk = new CQTOpenGLInstancedMesh(cMesh, GREEN_PLASTIC_MATERIAL);
+      m_unVertices = unVertices;
+
+      /* Place the wheels */
+      CQTOpenGLInstancedMesh::MakeTranslation(m_pfLeftWheel,  0.0f,  HALF_INTERWHEEL_DISTANCE, 0.0f);
+      CQTOpenGLInstancedMesh::MakeTranslation(m_pfRightWheel, 0.0f, -HALF_INTERWHEEL_DISTANCE, 0.0f);
+
+      /* One LED mesh, turned into place on the ring by each instance */
+      cMesh.Clear();
+      RenderLED(cMesh);
+      m_pcLED = new CQTOpenGLInstancedMesh(cMesh, LED_MATERIAL);
+      for(UInt32 i = 0; i < NUM_LEDS; ++i) {
+         m_vecLEDRotations.push_back(
+            CQuaternion(ToRadians(CDegrees(-m_fLEDAngleSlice * (i + 1))), CVector3::Z));
+      }
    }
 
    /****************************************/
    /****************************************/
 
-   void CQTOpenGLNewEPuck::SetCircuitBoardMaterial() {
-      const GLfloat pfColor[]     = { 0.0f, 0.0f, 1.0f, 1.0f };
-      const GLfloat pfSpecular[]  = { 0.5f, 0.5f, 1.0f, 1.0f };
-      const GLfloat pfShininess[] = { 10.0f                  };
-      const GLfloat pfEmission[]  = { 0.0f, 0.0f, 0.0f, 1.0f };
-      glMaterialfv(GL_FRONT_AND_BACK, GL_AMBIENT_AND_DIFFUSE, pfColor);
-      glMaterialfv(GL_FRONT_AND_BACK, GL_SPECULAR,            pfSpecular);
-      glMaterialfv(GL_FRONT_AND_BACK, GL_SHININESS,           pfShininess);
-      glMaterialfv(GL_FRONT_AND_BACK, GL_EMISSION,            pfEmission);
+   CQTOpenGLNewEPuck::~CQTOpenGLNewEPuck() {
+      delete m_pcWheel;
+      delete m_pcChassis;
+      delete m_pcBody;
+      delete m_pcDirection;
+      delete m_pcLowPolyBody;
+      delete m_pcDisk;
+      delete m_pcLED;
    }
 
    /****************************************/
    /****************************************/
 
-   void CQTOpenGLNewEPuck::SetLEDMaterial(GLfloat f_red,
-                                       GLfloat f_green,
-                                       GLfloat f_blue) {
-      const GLfloat pfColor[]     = { f_red, f_green, f_blue, 1.0f };
-      const GLfloat pfSpecular[]  = {  0.0f,    0.0f,   0.0f, 1.0f };
-      const GLfloat pfShininess[] = {  0.0f                        };
-      const GLfloat pfEmission[]  = { f_red, f_green, f_blue, 1.0f };
-      glMaterialfv(GL_FRONT_AND_BACK, GL_AMBIENT_AND_DIFFUSE, pfColor);
-      glMaterialfv(GL_FRONT_AND_BACK, GL_SPECULAR,            pfSpecular);
-      glMaterialfv(GL_FRONT_AND_BACK, GL_SHININESS,           pfShininess);
-      glMaterialfv(GL_FRONT_AND_BACK, GL_EMISSION,            pfEmission);
+   void CQTOpenGLNewEPuck::Draw(CNewEPuckEntity& c_entity) {
+      CSpace::TMapPerType& tRobots = CSimulator::GetInstance().GetSpace().GetEntitiesByType("new_e-puck");
+      /* All the robots are drawn at once, when the first enabled one is */
+      CSpace::TMapPerType::iterator itFirst = tRobots.begin();
+      while(itFirst != tRobots.end() && !any_cast<CNewEPuckEntity*>(itFirst->second)->IsEnabled()) {
+         ++itFirst;
+      }
+      if(itFirst == tRobots.end() || any_cast<CNewEPuckEntity*>(itFirst->second) != &c_entity) {
+         return;
+      }
+      /* Sort the robots by distance from the camera */
+      CQTOpenGLLevelOfDetail& cLOD = CQTOpenGLLevelOfDetail::GetInstance();
+      cLOD.UpdateCamera();
+      for(UInt32 i = 0; i < CQTOpenGLLevelOfDetail::NUM_LEVELS; ++i) {
+         m_cInstances[i].Clear();
+      }
+      m_cLEDInstances.Clear();
+      m_cLEDColors.Clear();
+      m_cRays.Clear();
+      for(CSpace::TMapPerType::iterator it = tRobots.begin(); it != tRobots.end(); ++it) {
+         CNewEPuckEntity* pcRobot = any_cast<CNewEPuckEntity*>(it->second);
+         /* Disabled robots, such as the parked ones of a pool, are not drawn and have no rays */
+         if(!pcRobot->IsEnabled()) continue;
+         const SAnchor& sOrigin = pcRobot->GetEmbodiedEntity().GetOriginAnchor();
+         CQTOpenGLLevelOfDetail::ELevel eLevel = cLOD.GetLevel(sOrigin.Position);
+         m_cInstances[eLevel].Add(sOrigin.Position, sOrigin.Orientation);
+         /* Place the LEDs, if the robot has them and is not too far */
+         if(eLevel != CQTOpenGLLevelOfDetail::LEVEL_FAR && pcRobot->HasLEDEquippedEntity()) {
+            CLEDEquippedEntity& cLEDEquippedEntity = pcRobot->GetLEDEquippedEntity();
+            for(UInt32 j = 0; j < NUM_LEDS; ++j) {
+               m_cLEDInstances.Add(sOrigin.Position, sOrigin.Orientation * m_vecLEDRotations[j]);
+               m_cLEDColors.Add(cLEDEquippedEntity.GetLED(j).GetColor());
+            }
+         }
+         m_cRays.Add(pcRobot->GetControllableEntity());
+      }
+      for(UInt32 i = 0; i < CQTOpenGLLevelOfDetail::NUM_LEVELS; ++i) {
+         m_cInstances[i].Upload();
+      }
+      m_cLEDInstances.Upload();
+      m_cLEDColors.Upload();
+      /* Near robots: the full model */
+      CQTOpenGLInstances& cNear = m_cInstances[CQTOpenGLLevelOfDetail::LEVEL_NEAR];
+      /* Place the chassis */
+      m_pcChassis->Draw(cNear);
+      /* Place the body */
+      m_pcBody->Draw(cNear);
+      m_pcDirection->Draw(cNear);
+      /* Place the wheels */
+      m_pcWheel->Draw(cNear, m_pfLeftWheel);
+      m_pcWheel->Draw(cNear, m_pfRightWheel);
+      /* Mid-range robots: the body with fewer sides */
+      CQTOpenGLInstances& cMid = m_cInstances[CQTOpenGLLevelOfDetail::LEVEL_MID];
+      m_pcLowPolyBody->Draw(cMid);
+      m_pcDirection->Draw(cMid);
+      /* The LED rings of the near and mid-range robots */
+      m_pcLED->Draw(m_cLEDInstances, m_cLEDColors);
+      /* Far robots: a disk with the heading */
+      CQTOpenGLInstances& cFar = m_cInstances[CQTOpenGLLevelOfDetail::LEVEL_FAR];
+      m_pcDisk->Draw(cFar);
+      m_pcDirection->Draw(cFar);
+      /* The rays of all the robots at once */
+      m_cRays.Draw();
    }
 
    /****************************************/
    /****************************************/
 
-   void CQTOpenGLNewEPuck::RenderWheel() {
-      /* Set material */
-      SetRedPlasticMaterial();
+   void CQTOpenGLNewEPuck::RenderWheel(CQTOpenGLMeshBuilder& c_mesh) {
       /* Right side */
       CVector2 cVertex(WHEEL_RADIUS, 0.0f);
       CRadians cAngle(CRadians::TWO_PI / m_unVertices);
       CVector3 cNormal(-1.0f, -1.0f, 0.0f);
       cNormal.Normalize();
-      glBegin(GL_POLYGON);
+      c_mesh.Begin(CQTOpenGLMeshBuilder::POLYGON);
       for(GLuint i = 0; i <= m_unVertices; i++) {
-         glNormal3d(cNormal.GetX(), cNormal.GetY(), cNormal.GetZ());
-         glVertex3d(cVertex.GetX(), -HALF_WHEEL_WIDTH, WHEEL_RADIUS + cVertex.GetY());
+         c_mesh.Normal(cNormal.GetX(), cNormal.GetY(), cNormal.GetZ());
+         c_mesh.Vertex(cVertex.GetX(), -HALF_WHEEL_WIDTH, WHEEL_RADIUS + cVertex.GetY());
          cVertex.Rotate(cAngle);
          cNormal.RotateY(cAngle);
       }
-      glEnd();
+      c_mesh.End();
       /* Left side */
       cVertex.Set(WHEEL_RADIUS, 0.0f);
       cNormal.Set(-1.0f, 1.0f, 0.0f);
       cNormal.Normalize();
       cAngle = -cAngle;
-      glBegin(GL_POLYGON);
+      c_mesh.Begin(CQTOpenGLMeshBuilder::POLYGON);
       for(GLuint i = 0; i <= m_unVertices; i++) {
-         glNormal3d(cNormal.GetX(), cNormal.GetY(), cNormal.GetZ());
-         glVertex3d(cVertex.GetX(), HALF_WHEEL_WIDTH, WHEEL_RADIUS + cVertex.GetY());
+         c_mesh.Normal(cNormal.GetX(), cNormal.GetY(), cNormal.GetZ());
+         c_mesh.Vertex(cVertex.GetX(), HALF_WHEEL_WIDTH, WHEEL_RADIUS + cVertex.GetY());
          cVertex.Rotate(cAngle);
          cNormal.RotateY(cAngle);
       }
-      glEnd();
+      c_mesh.End();
       /* Tire */
       cNormal.Set(1.0f, 0.0f, 0.0f);
       cVertex.Set(WHEEL_RADIUS, 0.0f);
       cAngle = -cAngle;
-      glBegin(GL_QUAD_STRIP);
+      c_mesh.Begin(CQTOpenGLMeshBuilder::QUAD_STRIP);
       for(GLuint i = 0; i <= m_unVertices; i++) {
-         glNormal3d(cNormal.GetX(), cNormal.GetY(), cNormal.GetZ());
-         glVertex3d(cVertex.GetX(), -HALF_WHEEL_WIDTH, WHEEL_RADIUS + cVertex.GetY());
-         glVertex3d(cVertex.GetX(),  HALF_WHEEL_WIDTH, WHEEL_RADIUS + cVertex.GetY());
+         c_mesh.Normal(cNormal.GetX(), cNormal.GetY(), cNormal.GetZ());
+         c_mesh.Vertex(cVertex.GetX(), -HALF_WHEEL_WIDTH, WHEEL_RADIUS + cVertex.GetY());
+         c_mesh.Vertex(cVertex.GetX(),  HALF_WHEEL_WIDTH, WHEEL_RADIUS + cVertex.GetY());
          cVertex.Rotate(cAngle);
          cNormal.RotateY(cAngle);
       }
-      glEnd();
+      c_mesh.End();
    }
 
    /****************************************/
    /****************************************/
 
-   void CQTOpenGLNewEPuck::RenderChassis() {
-      /* Set material */
-      SetGreenPlasticMaterial();
+   void CQTOpenGLNewEPuck::RenderChassis(CQTOpenGLMeshBuilder& c_mesh) {
       /* This part covers the bottom face (parallel to XY) */
-      glBegin(GL_QUADS);
+      c_mesh.Begin(CQTOpenGLMeshBuilder::QUADS);
       /* Bottom face */
-      glNormal3d(0.0f, 0.0f, -1.0f);
-      glVertex3d( HALF_CHASSIS_LENGTH,  HALF_CHASSIS_WIDTH, CHASSIS_ELEVATION);
-      glVertex3d( HALF_CHASSIS_LENGTH, -HALF_CHASSIS_WIDTH, CHASSIS_ELEVATION);
-      glVertex3d(-HALF_CHASSIS_LENGTH, -HALF_CHASSIS_WIDTH, CHASSIS_ELEVATION);
-      glVertex3d(-HALF_CHASSIS_LENGTH,  HALF_CHASSIS_WIDTH, CHASSIS_ELEVATION);
-      glEnd();
+      c_mesh.Normal(0.0f, 0.0f, -1.0f);
+      c_mesh.Vertex( HALF_CHASSIS_LENGTH,  HALF_CHASSIS_WIDTH, CHASSIS_ELEVATION);
+      c_mesh.Vertex( HALF_CHASSIS_LENGTH, -HALF_CHASSIS_WIDTH, CHASSIS_ELEVATION);
+      c_mesh.Vertex(-HALF_CHASSIS_LENGTH, -HALF_CHASSIS_WIDTH, CHASSIS_ELEVATION);
+      c_mesh.Vertex(-HALF_CHASSIS_LENGTH,  HALF_CHASSIS_WIDTH, CHASSIS_ELEVATION);
+      c_mesh.End();
       /* This part covers the faces (South, East, North, West) */
-      glBegin(GL_QUAD_STRIP);
+      c_mesh.Begin(CQTOpenGLMeshBuilder::QUAD_STRIP);
       /* Starting side */
-      glNormal3d(-1.0f, 0.0f, 0.0f);
-      glVertex3d(-HALF_CHASSIS_LENGTH, -HALF_CHASSIS_WIDTH, CHASSIS_ELEVATION + WHEEL_DIAMETER);
-      glVertex3d(-HALF_CHASSIS_LENGTH, -HALF_CHASSIS_WIDTH, CHASSIS_ELEVATION);
+      c_mesh.Normal(-1.0f, 0.0f, 0.0f);
+      c_mesh.Vertex(-HALF_CHASSIS_LENGTH, -HALF_CHASSIS_WIDTH, CHASSIS_ELEVATION + WHEEL_DIAMETER);
+      c_mesh.Vertex(-HALF_CHASSIS_LENGTH, -HALF_CHASSIS_WIDTH, CHASSIS_ELEVATION);
       /* South face */
-      glVertex3d( HALF_CHASSIS_LENGTH, -HALF_CHASSIS_WIDTH, CHASSIS_ELEVATION + WHEEL_DIAMETER);
-      glVertex3d( HALF_CHASSIS_LENGTH, -HALF_CHASSIS_WIDTH, CHASSIS_ELEVATION);
+      c_mesh.Vertex( HALF_CHASSIS_LENGTH, -HALF_CHASSIS_WIDTH, CHASSIS_ELEVATION + WHEEL_DIAMETER);
+      c_mesh.Vertex( HALF_CHASSIS_LENGTH, -HALF_CHASSIS_WIDTH, CHASSIS_ELEVATION);
       /* East face */
-      glNormal3d(0.0f, -1.0f, 0.0f);
-      glVertex3d( HALF_CHASSIS_LENGTH,  HALF_CHASSIS_WIDTH, CHASSIS_ELEVATION + WHEEL_DIAMETER);
-      glVertex3d( HALF_CHASSIS_LENGTH,  HALF_CHASSIS_WIDTH, CHASSIS_ELEVATION);
+      c_mesh.Normal(0.0f, -1.0f, 0.0f);
+      c_mesh.Vertex( HALF_CHASSIS_LENGTH,  HALF_CHASSIS_WIDTH, CHASSIS_ELEVATION + WHEEL_DIAMETER);
+      c_mesh.Vertex( HALF_CHASSIS_LENGTH,  HALF_CHASSIS_WIDTH, CHASSIS_ELEVATION);
       /* North face */
-      glNormal3d(1.0f, 0.0f, 0.0f);
-      glVertex3d(-HALF_CHASSIS_LENGTH,  HALF_CHASSIS_WIDTH, CHASSIS_ELEVATION + WHEEL_DIAMETER);
-      glVertex3d(-HALF_CHASSIS_LENGTH,  HALF_CHASSIS_WIDTH, CHASSIS_ELEVATION);
+      c_mesh.Normal(1.0f, 0.0f, 0.0f);
+      c_mesh.Vertex(-HALF_CHASSIS_LENGTH,  HALF_CHASSIS_WIDTH, CHASSIS_ELEVATION + WHEEL_DIAMETER);
+      c_mesh.Vertex(-HALF_CHASSIS_LENGTH,  HALF_CHASSIS_WIDTH, CHASSIS_ELEVATION);
       /* West face */
-      glNormal3d(0.0f, 1.0f, 0.0f);
-      glVertex3d(-HALF_CHASSIS_LENGTH, -HALF_CHASSIS_WIDTH, CHASSIS_ELEVATION + WHEEL_DIAMETER);
-      glVertex3d(-HALF_CHASSIS_LENGTH, -HALF_CHASSIS_WIDTH, CHASSIS_ELEVATION);
-      glEnd();
+      c_mesh.Normal(0.0f, 1.0f, 0.0f);
+      c_mesh.Vertex(-HALF_CHASSIS_LENGTH, -HALF_CHASSIS_WIDTH, CHASSIS_ELEVATION + WHEEL_DIAMETER);
+      c_mesh.Vertex(-HALF_CHASSIS_LENGTH, -HALF_CHASSIS_WIDTH, CHASSIS_ELEVATION);
+      c_mesh.End();
    }
 
    /****************************************/
    /****************************************/
 
-   void CQTOpenGLNewEPuck::RenderBody() {
-      /* Set material */
-      SetGreenPlasticMaterial();
+   void CQTOpenGLNewEPuck::RenderBody(CQTOpenGLMeshBuilder& c_mesh) {
       CVector2 cVertex(BODY_RADIUS, 0.0f);
       CRadians cAngle(-CRadians::TWO_PI / m_unVertices);
       /* Bottom part */
-      glBegin(GL_POLYGON);
-      glNormal3d(0.0f, 0.0f, -1.0f);
+      c_mesh.Begin(CQTOpenGLMeshBuilder::POLYGON);
+      c_mesh.Normal(0.0f, 0.0f, -1.0f);
       for(GLuint i = 0; i <= m_unVertices; i++) {
-         glVertex3d(cVertex.GetX(), cVertex.GetY(), BODY_ELEVATION);
+         c_mesh.Vertex(cVertex.GetX(), cVertex.GetY(), BODY_ELEVATION);
          cVertex.Rotate(cAngle);
       }
-      glEnd();
+      c_mesh.End();
       /* Side surface */
       cAngle = -cAngle;
       CVector2 cNormal(1.0f, 0.0f);
       cVertex.Set(BODY_RADIUS, 0.0f);
-      glBegin(GL_QUAD_STRIP);
+      c_mesh.Begin(CQTOpenGLMeshBuilder::QUAD_STRIP);
       for(GLuint i = 0; i <= m_unVertices; i++) {
-         glNormal3d(cNormal.GetX(), cNormal.GetY(), 0.0f);
-         glVertex3d(cVertex.GetX(), cVertex.GetY(), BODY_ELEVATION + BODY_HEIGHT);
-         glVertex3d(cVertex.GetX(), cVertex.GetY(), BODY_ELEVATION);
+         c_mesh.Normal(cNormal.GetX(), cNormal.GetY(), 0.0f);
+         c_mesh.Vertex(cVertex.GetX(), cVertex.GetY(), BODY_ELEVATION + BODY_HEIGHT);
+         c_mesh.Vertex(cVertex.GetX(), cVertex.GetY(), BODY_ELEVATION);
          cVertex.Rotate(cAngle);
          cNormal.Rotate(cAngle);
       }
-      glEnd();
+      c_mesh.End();
       /* Top part */
-      glBegin(GL_POLYGON);
+      c_mesh.Begin(CQTOpenGLMeshBuilder::POLYGON);
       cVertex.Set(LED_UPPER_RING_INNER_RADIUS, 0.0f);
-      glNormal3d(0.0f, 0.0f, 1.0f);
+      c_mesh.Normal(0.0f, 0.0f, 1.0f);
       for(GLuint i = 0; i <= m_unVertices; i++) {
-         glVertex3d(cVertex.GetX(), cVertex.GetY(), BODY_ELEVATION + BODY_HEIGHT + LED_HEIGHT);
+         c_mesh.Vertex(cVertex.GetX(), cVertex.GetY(), BODY_ELEVATION + BODY_HEIGHT + LED_HEIGHT);
          cVertex.Rotate(cAngle);
       }
-      glEnd();
+      c_mesh.End();
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CQTOpenGLNewEPuck::RenderDirection(CQTOpenGLMeshBuilder& c_mesh) {
       /* Triangle to set the direction */
-      SetLEDMaterial(1.0f, 1.0f, 0.0f);
-      glBegin(GL_TRIANGLES);
-      glVertex3d( BODY_RADIUS * 0.7,               0.0f, BODY_ELEVATION + BODY_HEIGHT + LED_HEIGHT + 0.001f);
-      glVertex3d(-BODY_RADIUS * 0.7,  BODY_RADIUS * 0.3, BODY_ELEVATION + BODY_HEIGHT + LED_HEIGHT + 0.001f);
-      glVertex3d(-BODY_RADIUS * 0.7, -BODY_RADIUS * 0.3, BODY_ELEVATION + BODY_HEIGHT + LED_HEIGHT + 0.001f);
-      glEnd();
+      c_mesh.Normal(0.0f, 0.0f, 1.0f);
+      c_mesh.Begin(CQTOpenGLMeshBuilder::TRIANGLES);
+      c_mesh.Vertex( BODY_RADIUS * 0.7,               0.0f, BODY_ELEVATION + BODY_HEIGHT + LED_HEIGHT + 0.001f);
+      c_mesh.Vertex(-BODY_RADIUS * 0.7,  BODY_RADIUS * 0.3, BODY_ELEVATION + BODY_HEIGHT + LED_HEIGHT + 0.001f);
+      c_mesh.Vertex(-BODY_RADIUS * 0.7, -BODY_RADIUS * 0.3, BODY_ELEVATION + BODY_HEIGHT + LED_HEIGHT + 0.001f);
+      c_mesh.End();
    }
 
    /****************************************/
    /****************************************/
 
-   void CQTOpenGLNewEPuck::RenderLED() {
+   void CQTOpenGLNewEPuck::RenderDisk(CQTOpenGLMeshBuilder& c_mesh) {
+      CVector2 cVertex(BODY_RADIUS, 0.0f);
+      CRadians cAngle(CRadians::TWO_PI / m_unVertices);
+      c_mesh.Begin(CQTOpenGLMeshBuilder::POLYGON);
+      c_mesh.Normal(0.0f, 0.0f, 1.0f);
+      for(GLuint i = 0; i <= m_unVertices; i++) {
+         c_mesh.Vertex(cVertex.GetX(), cVertex.GetY(), BODY_ELEVATION + BODY_HEIGHT + LED_HEIGHT);
+         cVertex.Rotate(cAngle);
+      }
+      c_mesh.End();
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CQTOpenGLNewEPuck::RenderLED(CQTOpenGLMeshBuilder& c_mesh) {
       /* Side surface */
       CVector2 cVertex(BODY_RADIUS, 0.0f);
       CRadians cAngle(CRadians::TWO_PI / m_unVertices);
       CVector2 cNormal(1.0f, 0.0f);
-      glBegin(GL_QUAD_STRIP);
-      for(GLuint i = 0; i <= m_unVertices / 8; i++) {
-         glNormal3d(cNormal.GetX(), cNormal.GetY(), 0.0f);
-         glVertex3d(cVertex.GetX(), cVertex.GetY(), LED_ELEVATION + LED_HEIGHT);
-         glVertex3d(cVertex.GetX(), cVertex.GetY(), LED_ELEVATION);
+      c_mesh.Begin(CQTOpenGLMeshBuilder::QUAD_STRIP);
+      for(GLuint i = 0; i <= m_unVertices / NUM_LEDS; i++) {
+         c_mesh.Normal(cNormal.GetX(), cNormal.GetY(), 0.0f);
+         c_mesh.Vertex(cVertex.GetX(), cVertex.GetY(), LED_ELEVATION + LED_HEIGHT);
+         c_mesh.Vertex(cVertex.GetX(), cVertex.GetY(), LED_ELEVATION);
          cVertex.Rotate(cAngle);
          cNormal.Rotate(cAngle);
       }
-      glEnd();
+      c_mesh.End();
       /* Top surface  */
       cVertex.Set(BODY_RADIUS, 0.0f);
       CVector2 cVertex2(LED_UPPER_RING_INNER_RADIUS, 0.0f);
-      glBegin(GL_QUAD_STRIP);
-      glNormal3d(0.0f, 0.0f, 1.0f);      
-      for(GLuint i = 0; i <= m_unVertices / 8; i++) {         
-         glVertex3d(cVertex2.GetX(), cVertex2.GetY(), BODY_ELEVATION + BODY_HEIGHT + LED_HEIGHT);
-         glVertex3d(cVertex.GetX(), cVertex.GetY(), BODY_ELEVATION + BODY_HEIGHT + LED_HEIGHT);
+      c_mesh.Begin(CQTOpenGLMeshBuilder::QUAD_STRIP);
+      c_mesh.Normal(0.0f, 0.0f, 1.0f);
+      for(GLuint i = 0; i <= m_unVertices / NUM_LEDS; i++) {
+         c_mesh.Vertex(cVertex2.GetX(), cVertex2.GetY(), BODY_ELEVATION + BODY_HEIGHT + LED_HEIGHT);
+         c_mesh.Vertex(cVertex.GetX(), cVertex.GetY(), BODY_ELEVATION + BODY_HEIGHT + LED_HEIGHT);
          cVertex.Rotate(cAngle);
          cVertex2.Rotate(cAngle);
       }
-      glEnd();
+      c_mesh.End();
    }
 
    /****************************************/
@@ -342,8 +393,7 @@ namespace argos {
       void ApplyTo(CQTOpenGLWidget& c_visualization,
                    CNewEPuckEntity& c_entity) {
          static CQTOpenGLNewEPuck m_cModel;
-         c_visualization.DrawRays(c_entity.GetControllableEntity());
-         c_visualization.DrawEntity(c_entity.GetEmbodiedEntity());
+         /* The model places the robots and draws their rays itself */
          m_cModel.Draw(c_entity);
       }
    };
@@ -363,4 +413,15 @@ namespace argos {
    /****************************************/
    /****************************************/
 
+   /* The offscreen visualization has its own context, hence its own model */
+   static void DrawNewEPuckOffscreen(CEntity& c_entity) {
+      static CQTOpenGLNewEPuck cModel;
+      cModel.Draw(static_cast<CNewEPuckEntity&>(c_entity));
+   }
+
+   REGISTER_QTOPENGL_OFFSCREEN_DRAW_FUNCTION("new_e-puck", DrawNewEPuckOffscreen);
+
+   /****************************************/
+   /****************************************/
+
 }
@@ -10,13 +10,13 @@
 namespace argos {
    class CQTOpenGLNewEPuck;
    class CNewEPuckEntity;
+   class CQTOpenGLMeshBuilder;
 }
 
-#ifdef __APPLE__
-#include <gl.h>
-#else
-#include <GL/gl.h>
-#endif
+#include <argos3/plugins/simulator/visualizations/batch_rendering/qtopengl_instanced_mesh.h>
+#include <argos3/plugins/simulator/visualizations/batch_rendering/qtopengl_level_of_detail.h>
+#include <argos3/plugins/simulator/visualizations/batch_rendering/qtopengl_ray_renderer.h>
+#include <vector>
 
 namespace argos {
 
@@ -28,46 +28,67 @@ namespace argos {
 
       virtual ~CQTOpenGLNewEPuck();
 
+      /**
+       * Draws all the e-pucks in the space at once. The robots are drawn
+       * along with the first one in the space, the call does nothing for
+       * the others.
+       */
       virtual void Draw(CNewEPuckEntity& c_entity);
 
    protected:
 
-      /** Sets a green plastic material */
-      void SetGreenPlasticMaterial();
-      /** Sets a red plastic material */
-      void SetRedPlasticMaterial();
-      /** Sets a circuit board material */
-      void SetCircuitBoardMaterial();
-      /** Sets a colored LED material */
-      void SetLEDMaterial(GLfloat f_red,
-                          GLfloat f_green,
-                          GLfloat f_blue);
-
       /** Renders a wheel */
-      void RenderWheel();
+      void RenderWheel(CQTOpenGLMeshBuilder& c_mesh);
       /** Renders the chassis */
-      void RenderChassis();
+      void RenderChassis(CQTOpenGLMeshBuilder& c_mesh);
       /** Renders the body */
-      void RenderBody();
+      void RenderBody(CQTOpenGLMeshBuilder& c_mesh);
+      /** Renders the triangle that shows the direction */
+      void RenderDirection(CQTOpenGLMeshBuilder& c_mesh);
+      /** Renders the disk that stands for a far robot */
+      void RenderDisk(CQTOpenGLMeshBuilder& c_mesh);
       /** A single LED of the ring */
-      void RenderLED();
+      void RenderLED(CQTOpenGLMeshBuilder& c_mesh);
 
    private:
 
-      /** Start of the display list index */
-      GLuint m_unLists;
-
       /** E-puck wheel */
-      GLuint m_unWheelList;
+      CQTOpenGLInstancedMesh* m_pcWheel;
+
+      /** Chassis mesh */
+      CQTOpenGLInstancedMesh* m_pcChassis;
+
+      /** Body mesh */
+      CQTOpenGLInstancedMesh* m_pcBody;
+
+      /** Direction triangle mesh */
+      CQTOpenGLInstancedMesh* m_pcDirection;
+
+      /** Body of the mid-range robots */
+      CQTOpenGLInstancedMesh* m_pcLowPolyBody;
+
+      /** Disk of the far robots */
+      CQTOpenGLInstancedMesh* m_pcDisk;
+
+      /** A single LED, placed on the ring by its instance */
+      CQTOpenGLInstancedMesh* m_pcLED;
+
+      /** Placement of the wheels on the robot */
+      GLfloat m_pfLeftWheel[16];
+      GLfloat m_pfRightWheel[16];
+
+      /** Poses of the robots in the current frame, per level of detail */
+      CQTOpenGLInstances m_cInstances[CQTOpenGLLevelOfDetail::NUM_LEVELS];
 
-      /** Chassis display list */
-      GLuint m_unChassisList;
+      /** Rays of the sensors of all the robots */
+      CQTOpenGLRayRenderer m_cRays;
 
-      /** Body display list */
-      GLuint m_unBodyList;
+      /** The LEDs of the near and mid-range robots, and their colors */
+      CQTOpenGLInstances m_cLEDInstances;
+      CQTOpenGLInstanceColors m_cLEDColors;
 
-      /** LED display list */
-      GLuint m_unLEDList;
+      /** Rotation of each LED on the ring */
+      std::vector<CQuaternion> m_vecLEDRotations;
 
       /** Number of vertices to display the round parts
           (wheels, chassis, etc.) */
@@ -6,11 +6,15 @@
 
 #include "qtopengl_testbot.h"
 #include "testbot_entity.h"
+#include <argos3/core/simulator/simulator.h>
+#include <argos3/core/simulator/space/space.h>
 #include <argos3/core/simulator/entity/embodied_entity.h>
 #include <argos3/core/utility/math/vector2.h>
 #include <argos3/core/utility/math/vector3.h>
 #include <argos3/plugins/simulator/entities/led_equipped_entity.h>
 #include <argos3/plugins/simulator/visualizations/qt-opengl/qtopengl_widget.h>
+#include <argos3/plugins/simulator/visualizations/batch_rendering/qtopengl_mesh_builder.h>
+#include <argos3/plugins/simulator/visualizations/batch_rendering/qtopengl_offscreen_render.h>
 #include <argos3/plugins/robots/turtlebot4/simulator/turtlebot4_measures.h>
 
 namespace argos {
@@ -43,110 +47,101 @@ namespace argos {
    /****************************************/
    /****************************************/
 
+   /* The parts used to inherit the last material set, they are all
+      drawn as circuit board now */
+   static const CQTOpenGLInstancedMesh::SMaterial CIRCUIT_BOARD_MATERIAL = {
+      { 0.0f, 0.0f, 1.0f, 1.0f },
+      { 0.5f, 0.5f, 1.0f, 1.0f },
+      10.0f,
+      { 0.0f, 0.0f, 0.0f, 1.0f }
+   };
+
+   /****************************************/
+   /****************************************/
+
    CQTOpenGLTestBot::CQTOpenGLTestBot() :
       m_unVertices(40)
       // m_fLEDAngleSlice(360.0f / 8.0f) 
       {
-      /* Reserve the needed display lists */
-      m_unLists = glGenLists(4);
-
-      /* Assign indices for better referencing (later) */
-      m_unWheelList   = m_unLists;
-      // m_unChassisList = m_unLists + 1;
-      m_unBodyList    = m_unLists + 1;
-      // m_unLEDList     = m_unLists + 2;
-      m_unUpperBodyList = m_unLists + 2;
-      m_unColumnList    = m_unLists + 3;
-
-      /* Create the wheel display list */
-      glNewList(m_unWheelList, GL_COMPILE);
-      RenderWheel();
-      glEndList();
-
-      /* Create the body display list */
-      glNewList(m_unBodyList, GL_COMPILE);
-      RenderBody();
-      glEndList();
-
-      /* Create the upper body display list */
-      glNewList(m_unUpperBodyList, GL_COMPILE);
-      RenderUpperBody();
-      glEndList();
-
-      /* Create the column display list */
-      glNewList(m_unColumnList, GL_COMPILE);
-      RenderColumn();
-      glEndList();
-
-      /* Create the chassis display list */
-      // glNewList(m_unChassisList, GL_COMPILE);
-      // RenderChassis();
-      // glEndList();
-
-      /* Create the LED display list */
-      // glNewList(m_unLEDList, GL_COMPILE);
-      // RenderLED();
-      // glEndList();
+      /* Record each part once and keep it in a vertex buffer */
+      CQTOpenGLMeshBuilder cMesh;
+      RenderWheel(cMesh);
+      m_pcWheel = new CQTOpenGLInstancedMesh(cMesh, CIRCUIT_BOARD_MATERIAL);
+      cMesh.Clear();
+      RenderBody(cMesh);
+      m_pcBody = new CQTOpenGLInstancedMesh(cMesh, CIRCUIT_BOARD_MATERIAL);
+      cMesh.Clear();
+      RenderUpperBody(cMesh);
+      m_pcUpperBody = new CQTOpenGLInstancedMesh(cMesh, CIRCUIT_BOARD_MATERIAL);
+      cMesh.Clear();
+      RenderColumn(cMesh);
+      m_pcColumn = new CQTOpenGLInstancedMesh(cMesh, CIRCUIT_BOARD_MATERIAL);
+
+      /* Place the wheels */
+      CQTOpenGLInstancedMesh::MakeTranslation(m_pfLeftWheel,  0.0f,  HALF_INTERWHEEL_DISTANCE, 0.0f);
+      CQTOpenGLInstancedMesh::MakeTranslation(m_pfRightWheel, 0.0f, -HALF_INTERWHEEL_DISTANCE, 0.0f);
+
+      /* Columns (3 pillars) */
+      CRadians cStep = CRadians::TWO_PI / TURTLEBOT4_NUM_COLUMNS;
+      Real radius    = BODY_RADIUS * 0.9f; // slightly inside edge
+      for(UInt32 i = 0; i < TURTLEBOT4_NUM_COLUMNS; ++i) {
+         CRadians cAngle = cStep * i;
+         m_vecColumns.resize(m_vecColumns.size() + 16);
+         CQTOpenGLInstancedMesh::MakeTranslation(&m_vecColumns[16 * i],
+                                                 radius * Cos(cAngle),
+                                                 radius * Sin(cAngle),
+                                                 0.0f);
+      }
    }
 
    /****************************************/
    /****************************************/
 
    CQTOpenGLTestBot::~CQTOpenGLTestBot() {
-      glDeleteLists(m_unLists, 4);
+      delete m_pcWheel;
+      delete m_pcBody;
+      delete m_pcUpperBody;
+      delete m_pcColumn;
    }
 
    /****************************************/
    /****************************************/
 
    void CQTOpenGLTestBot::Draw(CTestBotEntity& c_entity) {
-      /* Place the chassis */
-      // glCallList(m_unChassisList);
+      CSpace::TMapPerType& tRobots = CSimulator::GetInstance().GetSpace().GetEntitiesByType("testbot");
+      /* All the robots are drawn at once, when the first enabled one is */
+      CSpace::TMapPerType::iterator itFirst = tRobots.begin();
+      while(itFirst != tRobots.end() && !any_cast<CTestBotEntity*>(itFirst->second)->IsEnabled()) {
+         ++itFirst;
+      }
+      if(itFirst == tRobots.end() || any_cast<CTestBotEntity*>(itFirst->second) != &c_entity) {
+         return;
+      }
+      /* Collect the poses of all the robots */
+      m_cInstances.Clear();
+      m_cRays.Clear();
+      for(CSpace::TMapPerType::iterator it = tRobots.begin(); it != tRobots.end(); ++it) {
+         CTestBotEntity* pcRobot = any_cast<CTestBotEntity*>(it->second);
+         /* Disabled robots, such as the parked ones of a pool, are not drawn and have no rays */
+         if(!pcRobot->IsEnabled()) continue;
+         const SAnchor& sOrigin = pcRobot->GetEmbodiedEntity().GetOriginAnchor();
+         m_cInstances.Add(sOrigin.Position, sOrigin.Orientation);
+         m_cRays.Add(pcRobot->GetControllableEntity());
+      }
+      m_cInstances.Upload();
       /* Place the body */
-      glCallList(m_unBodyList);
+      m_pcBody->Draw(m_cInstances);
       /* Place the wheels */
-      glPushMatrix();
-      glTranslated(0.0f, HALF_INTERWHEEL_DISTANCE, 0.0f);
-      glCallList(m_unWheelList);
-      glPopMatrix();
-      glPushMatrix();
-      glTranslated(0.0f, -HALF_INTERWHEEL_DISTANCE, 0.0f);
-      glCallList(m_unWheelList);
-      glPopMatrix();
-      /* Place the LEDs */
-      // glPushMatrix();
-
-      // from testbot_entity.h
-
-      // CLEDEquippedEntity& cLEDEquippedEntity = c_entity.GetLEDEquippedEntity();
-      // for(UInt32 i = 0; i < 8; i++) {
-      //    const CColor& cColor = cLEDEquippedEntity.GetLED(i).GetColor();
-      //    // glRotated(-m_fLEDAngleSlice, 0.0f, 0.0f, 1.0f);
-      //    // SetLEDMaterial(cColor.GetRed(),
-      //    //                cColor.GetGreen(),
-      //    //                cColor.GetBlue());
-      //    // glCallList(m_unLEDList);
-      // }
-   glCallList(m_unUpperBodyList);
-
-      /* Columns (3 pillars) */
-   CRadians cStep = CRadians::TWO_PI / TURTLEBOT4_NUM_COLUMNS;
-   Real angleStep = cStep.GetValue();
-
-   Real radius    = BODY_RADIUS * 0.9f; // slightly inside edge
-
-   for(UInt32 i = 0; i < TURTLEBOT4_NUM_COLUMNS; ++i) {
-    CRadians cAngle = cStep * i;
-
-    glPushMatrix();
-    glTranslated(radius * Cos(cAngle),
-                 radius * Sin(cAngle),
-                 0.0f);
-    glCallList(m_unColumnList);
-    glPopMatrix();
-}
-      // glPopMatrix();
+      m_pcWheel->Draw(m_cInstances, m_pfLeftWheel);
+      m_pcWheel->Draw(m_cInstances, m_pfRightWheel);
       /* Upper body plate */
+      m_pcUpperBody->Draw(m_cInstances);
+      /* Columns */
+      for(size_t i = 0; i < m_vecColumns.size(); i += 16) {
+         m_pcColumn->Draw(m_cInstances, &m_vecColumns[i]);
+      }
+      /* The rays of all the robots at once */
+      m_cRays.Draw();
    }
 
    /****************************************/
@@ -180,20 +175,6 @@ namespace argos {
    /****************************************/
    /****************************************/
 
-   void CQTOpenGLTestBot::SetCircuitBoardMaterial() {
-      const GLfloat pfColor[]     = { 0.0f, 0.0f, 1.0f, 1.0f };
-      const GLfloat pfSpecular[]  = { 0.5f, 0.5f, 1.0f, 1.0f };
-      const GLfloat pfShininess[] = { 10.0f                  };
-      const GLfloat pfEmission[]  = { 0.0f, 0.0f, 0.0f, 1.0f };
-      glMaterialfv(GL_FRONT_AND_BACK, GL_AMBIENT_AND_DIFFUSE, pfColor);
-      glMaterialfv(GL_FRONT_AND_BACK, GL_SPECULAR,            pfSpecular);
-      glMaterialfv(GL_FRONT_AND_BACK, GL_SHININESS,           pfShininess);
-      glMaterialfv(GL_FRONT_AND_BACK, GL_EMISSION,            pfEmission);
-   }
-
-   /****************************************/
-   /****************************************/
-
    // void CQTOpenGLTestBot::SetLEDMaterial(GLfloat f_red,
    //                                     GLfloat f_green,
    //                                     GLfloat f_blue) {
@@ -210,7 +191,7 @@ namespace argos {
    /****************************************/
    /****************************************/
 
-   void CQTOpenGLTestBot::RenderWheel() {
+   void CQTOpenGLTestBot::RenderWheel(CQTOpenGLMeshBuilder& c_mesh) {
       /* Set material */
       // SetRedPlasticMaterial();
       /* Right side */
@@ -218,102 +199,102 @@ namespace argos {
       CRadians cAngle(CRadians::TWO_PI / m_unVertices);
       CVector3 cNormal(-1.0f, -1.0f, 0.0f);
       cNormal.Normalize();
-      glBegin(GL_POLYGON);
+      c_mesh.Begin(CQTOpenGLMeshBuilder::POLYGON);
       for(GLuint i = 0; i <= m_unVertices; i++) {
-         glNormal3d(cNormal.GetX(), cNormal.GetY(), cNormal.GetZ());
-         glVertex3d(cVertex.GetX(), -HALF_WHEEL_WIDTH, WHEEL_RADIUS + cVertex.GetY());
+         c_mesh.Normal(cNormal.GetX(), cNormal.GetY(), cNormal.GetZ());
+         c_mesh.Vertex(cVertex.GetX(), -HALF_WHEEL_WIDTH, WHEEL_RADIUS + cVertex.GetY());
          cVertex.Rotate(cAngle);
          cNormal.RotateY(cAngle);
       }
-      glEnd();
+      c_mesh.End();
       /* Left side */
       cVertex.Set(WHEEL_RADIUS, 0.0f);
       cNormal.Set(-1.0f, 1.0f, 0.0f);
       cNormal.Normalize();
       cAngle = -cAngle;
-      glBegin(GL_POLYGON);
+      c_mesh.Begin(CQTOpenGLMeshBuilder::POLYGON);
       for(GLuint i = 0; i <= m_unVertices; i++) {
-         glNormal3d(cNormal.GetX(), cNormal.GetY(), cNormal.GetZ());
-         glVertex3d(cVertex.GetX(), HALF_WHEEL_WIDTH, WHEEL_RADIUS + cVertex.GetY());
+         c_mesh.Normal(cNormal.GetX(), cNormal.GetY(), cNormal.GetZ());
+         c_mesh.Vertex(cVertex.GetX(), HALF_WHEEL_WIDTH, WHEEL_RADIUS + cVertex.GetY());
          cVertex.Rotate(cAngle);
          cNormal.RotateY(cAngle);
       }
-      glEnd();
+      c_mesh.End();
       /* Tire */
       cNormal.Set(1.0f, 0.0f, 0.0f);
       cVertex.Set(WHEEL_RADIUS, 0.0f);
       cAngle = -cAngle;
-      glBegin(GL_QUAD_STRIP);
+      c_mesh.Begin(CQTOpenGLMeshBuilder::QUAD_STRIP);
       for(GLuint i = 0; i <= m_unVertices; i++) {
-         glNormal3d(cNormal.GetX(), cNormal.GetY(), cNormal.GetZ());
-         glVertex3d(cVertex.GetX(), -HALF_WHEEL_WIDTH, WHEEL_RADIUS + cVertex.GetY());
-         glVertex3d(cVertex.GetX(),  HALF_WHEEL_WIDTH, WHEEL_RADIUS + cVertex.GetY());
+         c_mesh.Normal(cNormal.GetX(), cNormal.GetY(), cNormal.GetZ());
+         c_mesh.Vertex(cVertex.GetX(), -HALF_WHEEL_WIDTH, WHEEL_RADIUS + cVertex.GetY());
+         c_mesh.Vertex(cVertex.GetX(),  HALF_WHEEL_WIDTH, WHEEL_RADIUS + cVertex.GetY());
          cVertex.Rotate(cAngle);
          cNormal.RotateY(cAngle);
       }
-      glEnd();
+      c_mesh.End();
    }
 
-   void CQTOpenGLTestBot::RenderUpperBody() {
+   void CQTOpenGLTestBot::RenderUpperBody(CQTOpenGLMeshBuilder& c_mesh) {
     Real z = BODY_ELEVATION + LOWER_BODY_HEIGHT + TURTLEBOT4_COLUMN_HEIGHT;
 
     CVector2 cVertex(UPPER_BODY_RADIUS, 0.0f);
     CRadians cAngle(CRadians::TWO_PI / m_unVertices);
 
-    glBegin(GL_POLYGON);
-    glNormal3d(0.0f, 0.0f, 1.0f);
+    c_mesh.Begin(CQTOpenGLMeshBuilder::POLYGON);
+    c_mesh.Normal(0.0f, 0.0f, 1.0f);
     for (GLuint i = 0; i <= m_unVertices; i++) {
-        glVertex3d(cVertex.GetX(), cVertex.GetY(), z);
+        c_mesh.Vertex(cVertex.GetX(), cVertex.GetY(), z);
         cVertex.Rotate(cAngle);
     }
-    glEnd();
+    c_mesh.End();
 }
 
 
 
 
-   void CQTOpenGLTestBot::RenderBody() {
+   void CQTOpenGLTestBot::RenderBody(CQTOpenGLMeshBuilder& c_mesh) {
    /* Bottom disk */
    CVector2 cVertex(BODY_RADIUS, 0.0f);
    CRadians cAngle(-CRadians::TWO_PI / m_unVertices);
 
-   glBegin(GL_POLYGON);
-   glNormal3d(0.0f, 0.0f, -1.0f);
+   c_mesh.Begin(CQTOpenGLMeshBuilder::POLYGON);
+   c_mesh.Normal(0.0f, 0.0f, -1.0f);
    for(GLuint i = 0; i <= m_unVertices; i++) {
-      glVertex3d(cVertex.GetX(), cVertex.GetY(), BODY_ELEVATION);
+      c_mesh.Vertex(cVertex.GetX(), cVertex.GetY(), BODY_ELEVATION);
       cVertex.Rotate(cAngle);
    }
-   glEnd();
+   c_mesh.End();
 
    /* Side cylinder */
    cAngle = -cAngle;
    CVector2 cNormal(1.0f, 0.0f);
    cVertex.Set(BODY_RADIUS, 0.0f);
 
-   glBegin(GL_QUAD_STRIP);
+   c_mesh.Begin(CQTOpenGLMeshBuilder::QUAD_STRIP);
    for(GLuint i = 0; i <= m_unVertices; i++) {
-      glNormal3d(cNormal.GetX(), cNormal.GetY(), 0.0f);
-      glVertex3d(cVertex.GetX(), cVertex.GetY(), BODY_ELEVATION + LOWER_BODY_HEIGHT);
-      glVertex3d(cVertex.GetX(), cVertex.GetY(), BODY_ELEVATION);
+      c_mesh.Normal(cNormal.GetX(), cNormal.GetY(), 0.0f);
+      c_mesh.Vertex(cVertex.GetX(), cVertex.GetY(), BODY_ELEVATION + LOWER_BODY_HEIGHT);
+      c_mesh.Vertex(cVertex.GetX(), cVertex.GetY(), BODY_ELEVATION);
       cVertex.Rotate(cAngle);
       cNormal.Rotate(cAngle);
    }
-   glEnd();
+   c_mesh.End();
 
    /* NEW: Top disk */
    cVertex.Set(BODY_RADIUS, 0.0f);
-   glBegin(GL_POLYGON);
-   glNormal3d(0.0f, 0.0f, 1.0f);
+   c_mesh.Begin(CQTOpenGLMeshBuilder::POLYGON);
+   c_mesh.Normal(0.0f, 0.0f, 1.0f);
    for(GLuint i = 0; i <= m_unVertices; i++) {
-      glVertex3d(cVertex.GetX(), cVertex.GetY(),
-                 BODY_ELEVATION + LOWER_BODY_HEIGHT);
+      c_mesh.Vertex(cVertex.GetX(), cVertex.GetY(),
+                    BODY_ELEVATION + LOWER_BODY_HEIGHT);
       cVertex.Rotate(cAngle);
    }
-   glEnd();
+   c_mesh.End();
 }
 
 
-void CQTOpenGLTestBot::RenderColumn() {
+void CQTOpenGLTestBot::RenderColumn(CQTOpenGLMeshBuilder& c_mesh) {
    Real baseZ = BODY_ELEVATION + LOWER_BODY_HEIGHT;
    Real topZ  = baseZ + TURTLEBOT4_COLUMN_HEIGHT;
 
@@ -322,15 +303,15 @@ void CQTOpenGLTestBot::RenderColumn() {
    CRadians cAngle(CRadians::TWO_PI / m_unVertices);
 
    /* Side tube */
-   glBegin(GL_QUAD_STRIP);
+   c_mesh.Begin(CQTOpenGLMeshBuilder::QUAD_STRIP);
    for(UInt32 i = 0; i <= m_unVertices; ++i) {
-      glNormal3d(cNormal.GetX(), cNormal.GetY(), 0.0f);
-      glVertex3d(cVertex.GetX(), cVertex.GetY(), baseZ);
-      glVertex3d(cVertex.GetX(), cVertex.GetY(), topZ);
+      c_mesh.Normal(cNormal.GetX(), cNormal.GetY(), 0.0f);
+      c_mesh.Vertex(cVertex.GetX(), cVertex.GetY(), baseZ);
+      c_mesh.Vertex(cVertex.GetX(), cVertex.GetY(), topZ);
       cVertex.Rotate(cAngle);
       cNormal.Rotate(cAngle);
    }
-   glEnd();
+   c_mesh.End();
 }
 
 
@@ -459,8 +440,7 @@ void CQTOpenGLTestBot::RenderColumn() {
       void ApplyTo(CQTOpenGLWidget& c_visualization,
                    CTestBotEntity& c_entity) {
          static CQTOpenGLTestBot m_cModel;
-         c_visualization.DrawRays(c_entity.GetControllableEntity());
-         c_visualization.DrawEntity(c_entity.GetEmbodiedEntity());
+         /* The model places the robots and draws their rays itself */
          m_cModel.Draw(c_entity);
       }
    };
@@ -480,4 +460,15 @@ void CQTOpenGLTestBot::RenderColumn() {
    /****************************************/
    /****************************************/
 
+   /* The offscreen visualization has its own context, hence its own model */
+   static void DrawTestBotOffscreen(CEntity& c_entity) {
+      static CQTOpenGLTestBot cModel;
+      cModel.Draw(static_cast<CTestBotEntity&>(c_entity));
+   }
+
+   REGISTER_QTOPENGL_OFFSCREEN_DRAW_FUNCTION("testbot", DrawTestBotOffscreen);
+
+   /****************************************/
+   /****************************************/
+
 }
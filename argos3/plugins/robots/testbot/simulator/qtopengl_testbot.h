@@ -10,13 +10,12 @@
 namespace argos {
    class CQTOpenGLTestBot;
    class CTestBotEntity;
+   class CQTOpenGLMeshBuilder;
 }
 
-#ifdef __APPLE__
-#include <gl.h>
-#else
-#include <GL/gl.h>
-#endif
+#include <argos3/plugins/simulator/visualizations/batch_rendering/qtopengl_instanced_mesh.h>
+#include <argos3/plugins/simulator/visualizations/batch_rendering/qtopengl_ray_renderer.h>
+#include <vector>
 
 namespace argos {
 
@@ -28,6 +27,11 @@ namespace argos {
 
       virtual ~CQTOpenGLTestBot();
 
+      /**
+       * Draws all the test bots in the space at once. The robots are drawn
+       * along with the first one in the space, the call does nothing for
+       * the others.
+       */
       virtual void Draw(CTestBotEntity& c_entity);
 
    protected:
@@ -36,47 +40,52 @@ namespace argos {
       // void SetGreenPlasticMaterial();
       /** Sets a red plastic material */
       // void SetRedPlasticMaterial();
-      /** Sets a circuit board material */
-      void SetCircuitBoardMaterial();
       /** Sets a colored LED material */
       // void SetLEDMaterial(GLfloat f_red,
       //                     GLfloat f_green,
       //                     GLfloat f_blue);
 
       /** Renders a wheel */
-      void RenderWheel();
+      void RenderWheel(CQTOpenGLMeshBuilder& c_mesh);
       /** Renders the chassis */
       // void RenderChassis();
       /** Renders the body */
-      void RenderBody();
+      void RenderBody(CQTOpenGLMeshBuilder& c_mesh);
       /** A single LED of the ring */
       // void RenderLED();
 
       /** Renders the upperbody */
-      void RenderUpperBody();
+      void RenderUpperBody(CQTOpenGLMeshBuilder& c_mesh);
 
       /** Renders the columns */
-      void RenderColumn();
+      void RenderColumn(CQTOpenGLMeshBuilder& c_mesh);
 
    private:
 
-      /** Start of the display list index */
-      GLuint m_unLists;
-
       /** Testbot wheel */
-      GLuint m_unWheelList;
+      CQTOpenGLInstancedMesh* m_pcWheel;
+
+      /** Body mesh */
+      CQTOpenGLInstancedMesh* m_pcBody;
+
+      /** Upper body mesh */
+      CQTOpenGLInstancedMesh* m_pcUpperBody;
+
+      /** Column mesh */
+      CQTOpenGLInstancedMesh* m_pcColumn;
 
-      /** Chassis display list */
-      // GLuint m_unChassisList;
+      /** Placement of the wheels on the robot */
+      GLfloat m_pfLeftWheel[16];
+      GLfloat m_pfRightWheel[16];
 
-      /** Body display list */
-      GLuint m_unBodyList;
+      /** Placement of the columns on the robot, 16 floats each */
+      std::vector<GLfloat> m_vecColumns;
 
-      /** Upper body list */
-      GLuint m_unUpperBodyList;
+      /** Poses of the robots in the current frame */
+      CQTOpenGLInstances m_cInstances;
 
-      /** Column list */
-      GLuint m_unColumnList;
+      /** Rays of the sensors of all the robots */
+      CQTOpenGLRayRenderer m_cRays;
 
       // /** LED display list */
       // GLuint m_unLEDList;
@@ -7,6 +7,7 @@
 #include "dynamics2d_turtlebot4_model.h"
 #include <argos3/plugins/simulator/physics_engines/dynamics2d/dynamics2d_gripping.h>
 #include <argos3/plugins/simulator/physics_engines/dynamics2d/dynamics2d_engine.h>
+#include <argos3/core/utility/logging/argos_log.h>
 #include "turtlebot4_measures.h"
 
 namespace argos {
@@ -16,6 +17,12 @@ namespace argos {
       TURTLEBOT4_RIGHT_WHEEL = 1
    };
 
+   /* Ticks a robot must stay still before its body is put to sleep */
+   static const UInt32 TURTLEBOT4_IDLE_TICKS_BEFORE_SLEEP = 10;
+   /* Below these speeds, a body is considered at rest */
+   static const Real TURTLEBOT4_REST_LINEAR_SPEED  = 1e-4;
+   static const Real TURTLEBOT4_REST_ANGULAR_SPEED = 1e-3;
+
    /****************************************/
    /****************************************/
 
@@ -29,7 +36,10 @@ namespace argos {
                       TURTLEBOT4_MAX_TORQUE,
                       TURTLEBOT4_WHEEL_DISTANCE,
                       c_entity.GetConfigurationNode()),
-      m_fCurrentWheelVelocity(m_cWheeledEntity.GetWheelVelocities()) {
+      m_fCurrentWheelVelocity(m_cWheeledEntity.GetWheelVelocities()),
+      m_unIdleTicks(0),
+      m_bSleepWhenIdle(c_entity.IsSleepWhenIdle()),
+      m_bSleeping(false) {
       /* Create the body with initial position and orientation */
       cpBody* ptBody =
          cpSpaceAddBody(GetDynamics2DEngine().GetPhysicsSpace(),
@@ -61,13 +71,19 @@ namespace argos {
    /****************************************/
 
    CDynamics2DTurtlebot4Model::~CDynamics2DTurtlebot4Model() {
-      m_cDiffSteering.Detach();
+      if(m_bSleeping) {
+         cpBodyActivate(GetBody());
+      }
+      else {
+         m_cDiffSteering.Detach();
+      }
    }
 
    /****************************************/
    /****************************************/
 
    void CDynamics2DTurtlebot4Model::Reset() {
+      Wake();
       CDynamics2DSingleBodyObjectModel::Reset();
       m_cDiffSteering.Reset();
    }
@@ -75,17 +91,83 @@ namespace argos {
    /****************************************/
    /****************************************/
 
+   void CDynamics2DTurtlebot4Model::MoveTo(const CVector3& c_position,
+                                           const CQuaternion& c_orientation) {
+      Wake();
+      CDynamics2DSingleBodyObjectModel::MoveTo(c_position, c_orientation);
+   }
+
+   /****************************************/
+   /****************************************/
+
    void CDynamics2DTurtlebot4Model::UpdateFromEntityStatus() {
       /* Do we want to move? */
-      if((m_fCurrentWheelVelocity[TURTLEBOT4_LEFT_WHEEL] != 0.0f) ||
-         (m_fCurrentWheelVelocity[TURTLEBOT4_RIGHT_WHEEL] != 0.0f)) {
+      bool bMove =
+         (m_fCurrentWheelVelocity[TURTLEBOT4_LEFT_WHEEL] != 0.0f) ||
+         (m_fCurrentWheelVelocity[TURTLEBOT4_RIGHT_WHEEL] != 0.0f);
+      /* A sleeping body wakes up on a command, or when Chipmunk woke it up for a contact */
+      if(m_bSleeping) {
+         if(!bMove && cpBodyIsSleeping(GetBody())) return;
+         Wake();
+      }
+      if(bMove) {
          m_cDiffSteering.SetWheelVelocity(m_fCurrentWheelVelocity[TURTLEBOT4_LEFT_WHEEL],
                                           m_fCurrentWheelVelocity[TURTLEBOT4_RIGHT_WHEEL]);
+         m_unIdleTicks = 0;
       }
       else {
-         /* No, we don't want to move - zero all speeds */
-         m_cDiffSteering.Reset();
+         /* No, we don't want to move - zero all speeds once */
+         if(m_unIdleTicks == 0) {
+            m_cDiffSteering.Reset();
+         }
+         ++m_unIdleTicks;
+         /* Go to sleep after a while, if nothing is pushing the robot */
+         if(m_bSleepWhenIdle &&
+            m_unIdleTicks >= TURTLEBOT4_IDLE_TICKS_BEFORE_SLEEP &&
+            cpvlength(cpBodyGetVel(GetBody())) < TURTLEBOT4_REST_LINEAR_SPEED &&
+            Abs(cpBodyGetAngVel(GetBody())) < TURTLEBOT4_REST_ANGULAR_SPEED) {
+            Sleep();
+         }
+      }
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CDynamics2DTurtlebot4Model::Sleep() {
+      /*
+       * Sleeping bodies are woken up by contacts only if sleeping is enabled
+       * in the space. The experiment enables it; the robot never does,
+       * because the threshold applies to every body in the space.
+       */
+      if(cpSpaceGetSleepTimeThreshold(GetDynamics2DEngine().GetPhysicsSpace()) == INFINITY) {
+         static bool bWarned = false;
+         if(!bWarned) {
+            LOGERR << "[WARNING] The turtlebot4 attribute 'sleep_when_idle' has no effect: "
+                   << "sleeping is not enabled in the dynamics2d space. "
+                   << "Set a sleep time threshold with cpSpaceSetSleepTimeThreshold()."
+                   << std::endl;
+            bWarned = true;
+         }
+         m_bSleepWhenIdle = false;
+         return;
       }
+      /* The steering control would keep the body awake */
+      m_cDiffSteering.Detach();
+      cpBodySleep(GetBody());
+      m_bSleeping = true;
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CDynamics2DTurtlebot4Model::Wake() {
+      m_unIdleTicks = 0;
+      if(!m_bSleeping) return;
+      cpBodyActivate(GetBody());
+      m_cDiffSteering.AttachTo(GetBody());
+      m_cDiffSteering.Reset();
+      m_bSleeping = false;
    }
 
    /****************************************/
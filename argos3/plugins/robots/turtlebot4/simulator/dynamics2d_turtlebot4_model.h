@@ -30,8 +30,24 @@ namespace argos {
 
       virtual void Reset();
 
+      virtual void MoveTo(const CVector3& c_position,
+                          const CQuaternion& c_orientation);
+
       virtual void UpdateFromEntityStatus();
       
+   private:
+
+      /*
+       * Puts the body to sleep. Sleeping bodies are skipped by the space
+       * step until they are woken up by a contact or by Wake().
+       */
+      void Sleep();
+
+      /*
+       * Wakes the body up and reattaches the steering control.
+       */
+      void Wake();
+
    private:
 
       CTurtlebot4Entity& m_cTurtlebot4Entity;
@@ -41,6 +57,15 @@ namespace argos {
 
       const Real* m_fCurrentWheelVelocity;
 
+      /* Number of consecutive ticks with both wheels stopped */
+      UInt32 m_unIdleTicks;
+
+      /* Whether the robot asked for its body to sleep when idle */
+      bool m_bSleepWhenIdle;
+
+      /* True when the body sleeps and the steering control is detached */
+      bool m_bSleeping;
+
    };
 
 }
@@ -11,6 +11,7 @@
 
 #include <argos3/plugins/simulator/entities/wheeled_entity.h>
 #include <argos3/plugins/robots/turtlebot4/simulator/turtlebot4_entity.h>
+#include <argos3/plugins/robots/turtlebot4/simulator/turtlebot4_measures.h>
 
 namespace argos {
 
@@ -23,16 +24,8 @@ namespace argos {
          links, however, setting it to 7 makes the turtlebot4 less stable for reasons. */
       CDynamics3DMultiBodyObjectModel(c_engine, c_turtlebot4, 3, false),
       m_cWheeledEntity(c_turtlebot4.GetWheeledEntity()) {
-      /* get the required collision shapes */
-      std::shared_ptr<btCollisionShape> ptrBodyShape =
-         CDynamics3DShapeManager::RequestCylinder(m_cBodyHalfExtents);
-      std::shared_ptr<btCollisionShape> ptrWheelShape =
-         CDynamics3DShapeManager::RequestCylinder(m_cWheelHalfExtents);
-      /* calculate the inertia of the collision objects */
-      btVector3 cBodyInertia;
-      btVector3 cWheelInertia;
-      ptrBodyShape->calculateLocalInertia(m_fBodyMass, cBodyInertia);
-      ptrWheelShape->calculateLocalInertia(m_fWheelMass, cWheelInertia);
+      /* the collision shapes and their inertia are the same for every robot */
+      const SSharedData& sShared = GetSharedData();
       /* calculate a btTransform that moves us from the global coordinate system to the
          local coordinate system */
       const SAnchor& sOriginAnchor = c_turtlebot4.GetEmbodiedEntity().GetOriginAnchor();
@@ -50,28 +43,28 @@ namespace argos {
       CAbstractBody::SData sBodyData(
          cStartTransform * m_cBodyOffset,
          m_cBodyGeometricOffset,
-         cBodyInertia,
+         sShared.BodyInertia,
          m_fBodyMass,
          GetEngine().GetDefaultFriction());
       CAbstractBody::SData sLeftWheelData(
          cStartTransform * m_cLeftWheelOffset,
          m_cWheelGeometricOffset,
-         cWheelInertia,
+         sShared.WheelInertia,
          m_fWheelMass,
          m_fWheelFriction);
       CAbstractBody::SData sRightWheelData(
          cStartTransform * m_cRightWheelOffset,
          m_cWheelGeometricOffset,
-         cWheelInertia,
+         sShared.WheelInertia,
          m_fWheelMass,
          m_fWheelFriction);
       /* create an anchor for the body (not strictly necessary but easier than
          overloading CDynamics3DMultiBodyObjectModel::UpdateOriginAnchor) */
       SAnchor* psBodyAnchor = &c_turtlebot4.GetEmbodiedEntity().AddAnchor("body", {0.0, 0.0, 0.00125});
       /* create the bodies */
-      m_ptrBody = std::make_shared<CBase>(*this, psBodyAnchor, ptrBodyShape, sBodyData);
-      m_ptrLeftWheel = std::make_shared<CLink>(*this, 0, nullptr, ptrWheelShape, sLeftWheelData);
-      m_ptrRightWheel = std::make_shared<CLink>(*this, 1, nullptr, ptrWheelShape, sRightWheelData);
+      m_ptrBody = std::make_shared<CBase>(*this, psBodyAnchor, sShared.BodyShape, sBodyData);
+      m_ptrLeftWheel = std::make_shared<CLink>(*this, 0, nullptr, sShared.WheelShape, sLeftWheelData);
+      m_ptrRightWheel = std::make_shared<CLink>(*this, 1, nullptr, sShared.WheelShape, sRightWheelData);
       /* copy the bodies to the base class */
       m_vecBodies = {m_ptrBody, m_ptrLeftWheel, m_ptrRightWheel};
       /* synchronize with the entity with the space */
@@ -81,9 +74,40 @@ namespace argos {
    /****************************************/
    /****************************************/
    
+   CDynamics3DTurtlebot4Model::SSharedData::SSharedData() :
+      BodyShape(CDynamics3DShapeManager::RequestCylinder(m_cBodyHalfExtents)),
+      WheelShape(CDynamics3DShapeManager::RequestCylinder(m_cWheelHalfExtents)) {
+      BodyShape->calculateLocalInertia(m_fBodyMass, BodyInertia);
+      WheelShape->calculateLocalInertia(m_fWheelMass, WheelInertia);
+   }
+
+   /****************************************/
+   /****************************************/
+
+   const CDynamics3DTurtlebot4Model::SSharedData& CDynamics3DTurtlebot4Model::GetSharedData() {
+      /* built by the first robot, kept until the end of the process */
+      static const SSharedData sSharedData;
+      return sSharedData;
+   }
+
+   /****************************************/
+   /****************************************/
+
    void CDynamics3DTurtlebot4Model::Reset() {
       /* reset the base class */
       CDynamics3DMultiBodyObjectModel::Reset();
+      /* after the first reset, the joints and motors already exist: only
+         bring them back to their initial state, without reallocating */
+      if(m_ptrLeftMotor) {
+         m_cMultiBody.setJointPos(m_ptrLeftWheel->GetIndex(), 0.0);
+         m_cMultiBody.setJointPos(m_ptrRightWheel->GetIndex(), 0.0);
+         m_cMultiBody.setJointVel(m_ptrLeftWheel->GetIndex(), 0.0);
+         m_cMultiBody.setJointVel(m_ptrRightWheel->GetIndex(), 0.0);
+         m_ptrLeftMotor->setVelocityTarget(0.0);
+         m_ptrRightMotor->setVelocityTarget(0.0);
+         UpdateEntityStatus();
+         return;
+      }
       /* set up wheels */
       m_cMultiBody.setupRevolute(m_ptrLeftWheel->GetIndex(),
                                  m_ptrLeftWheel->GetData().Mass,
@@ -178,7 +202,141 @@ namespace argos {
    /****************************************/
    /****************************************/
 
-   REGISTER_STANDARD_DYNAMICS3D_OPERATIONS_ON_ENTITY(CTurtlebot4Entity, CDynamics3DTurtlebot4Model);
+   CDynamics3DTurtlebot4ReducedModel::CDynamics3DTurtlebot4ReducedModel(CDynamics3DEngine& c_engine,
+                                                                        CTurtlebot4Entity& c_turtlebot4) :
+      CDynamics3DMultiBodyObjectModel(c_engine, c_turtlebot4, 0, false),
+      m_cWheeledEntity(c_turtlebot4.GetWheeledEntity()) {
+      /* the collision shape and its inertia are the same for every robot */
+      const SSharedData& sShared = GetSharedData();
+      /* calculate a btTransform that moves us from the global coordinate system to the
+         local coordinate system */
+      const SAnchor& sOriginAnchor = c_turtlebot4.GetEmbodiedEntity().GetOriginAnchor();
+      const CQuaternion& cOrientation = sOriginAnchor.Orientation;
+      const CVector3& cPosition = sOriginAnchor.Position;
+      const btTransform& cStartTransform = btTransform(
+         btQuaternion(cOrientation.GetX(),
+                      cOrientation.GetZ(),
+                     -cOrientation.GetY(),
+                      cOrientation.GetW()),
+         btVector3(cPosition.GetX(),
+                   cPosition.GetZ(),
+                  -cPosition.GetY()));
+      CAbstractBody::SData sBodyData(
+         cStartTransform,
+         sShared.BodyGeometricOffset,
+         sShared.BodyInertia,
+         TURTLEBOT4_TOTAL_MASS,
+         0.0);
+      SAnchor* psBodyAnchor = &c_turtlebot4.GetEmbodiedEntity().AddAnchor("body");
+      m_ptrBody = std::make_shared<CBase>(*this, psBodyAnchor, sShared.BodyShape, sBodyData);
+      m_vecBodies = {m_ptrBody};
+      /* synchronize with the entity with the space */
+      Reset();
+   }
+
+   /****************************************/
+   /****************************************/
+
+   CDynamics3DTurtlebot4ReducedModel::SSharedData::SSharedData() {
+      /* the cylinder goes from the floor to the top of the robot */
+      btScalar fHalfHeight = TURTLEBOT4_BASE_TOP * 0.5;
+      BodyShape = CDynamics3DShapeManager::RequestCylinder(
+         btVector3(TURTLEBOT4_BASE_RADIUS, fHalfHeight, TURTLEBOT4_BASE_RADIUS));
+      BodyShape->calculateLocalInertia(TURTLEBOT4_TOTAL_MASS, BodyInertia);
+      BodyGeometricOffset.setIdentity();
+      BodyGeometricOffset.setOrigin(btVector3(0.0, -fHalfHeight, 0.0));
+   }
+
+   /****************************************/
+   /****************************************/
+
+   const CDynamics3DTurtlebot4ReducedModel::SSharedData& CDynamics3DTurtlebot4ReducedModel::GetSharedData() {
+      /* built by the first robot, kept until the end of the process */
+      static const SSharedData sSharedData;
+      return sSharedData;
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CDynamics3DTurtlebot4ReducedModel::Reset() {
+      /* reset the base class */
+      CDynamics3DMultiBodyObjectModel::Reset();
+      /* Allocate memory and prepare the btMultiBody */
+      m_cMultiBody.finalizeMultiDof();
+      /* Synchronize with the entity in the space */
+      UpdateEntityStatus();
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CDynamics3DTurtlebot4ReducedModel::CalculateBoundingBox() {
+      btVector3 cModelAabbMin, cModelAabbMax;
+      m_ptrBody->GetShape().getAabb(m_ptrBody->GetTransform(), cModelAabbMin, cModelAabbMax);
+      /* Write back the bounding box swapping the coordinate systems and the Y component */
+      GetBoundingBox().MinCorner.Set(cModelAabbMin.getX(), -cModelAabbMax.getZ(), cModelAabbMin.getY());
+      GetBoundingBox().MaxCorner.Set(cModelAabbMax.getX(), -cModelAabbMin.getZ(), cModelAabbMax.getY());
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CDynamics3DTurtlebot4ReducedModel::UpdateFromEntityStatus() {
+      /* run the base class's implementation of this method */
+      CDynamics3DMultiBodyObjectModel::UpdateFromEntityStatus();
+      /* wheel speeds to unicycle velocities */
+      const Real* pfWheelVelocities = m_cWheeledEntity.GetWheelVelocities();
+      btScalar fLinear = 0.5 * (pfWheelVelocities[0] + pfWheelVelocities[1]);
+      btScalar fAngular = (pfWheelVelocities[1] - pfWheelVelocities[0]) / TURTLEBOT4_WHEEL_DISTANCE;
+      /* heading of the robot projected on the floor (the Bullet XZ plane) */
+      btVector3 cHeading =
+         quatRotate(m_cMultiBody.getWorldToBaseRot().inverse(), btVector3(1.0, 0.0, 0.0));
+      cHeading.setY(0.0);
+      btScalar fHeadingLength = cHeading.length();
+      if(fHeadingLength > SIMD_EPSILON) {
+         cHeading /= fHeadingLength;
+      }
+      /* drive along the heading and turn around the vertical axis, leaving the
+         vertical motion and the tilt to the solver */
+      const btVector3& cVelocity = m_cMultiBody.getBaseVel();
+      m_cMultiBody.setBaseVel(btVector3(cHeading.getX() * fLinear,
+                                        cVelocity.getY(),
+                                        cHeading.getZ() * fLinear));
+      const btVector3& cOmega = m_cMultiBody.getBaseOmega();
+      m_cMultiBody.setBaseOmega(btVector3(cOmega.getX(), fAngular, cOmega.getZ()));
+   }
+
+   /****************************************/
+   /****************************************/
+
+   /*
+    * The two models share the entity, so the add operation picks one
+    * according to the dynamics3d_model attribute of the robot.
+    */
+   class CDynamics3DOperationAddCTurtlebot4Entity : public CDynamics3DOperationAddEntity {
+   public:
+      CDynamics3DOperationAddCTurtlebot4Entity() {}
+      virtual ~CDynamics3DOperationAddCTurtlebot4Entity() {}
+      SOperationOutcome ApplyTo(CDynamics3DEngine& c_engine,
+                                CTurtlebot4Entity& c_entity) {
+         CDynamics3DModel* pcPhysModel;
+         if(c_entity.IsReducedDynamics3DModel()) {
+            pcPhysModel = new CDynamics3DTurtlebot4ReducedModel(c_engine, c_entity);
+         }
+         else {
+            pcPhysModel = new CDynamics3DTurtlebot4Model(c_engine, c_entity);
+         }
+         c_engine.AddPhysicsModel(c_entity.GetId(), *pcPhysModel);
+         c_entity.GetComponent<CEmbodiedEntity>("body").AddPhysicsModel(c_engine.GetId(), *pcPhysModel);
+         return SOperationOutcome(true);
+      }
+   };
+   REGISTER_DYNAMICS3D_OPERATION(CDynamics3DOperationAddEntity,
+                                 CDynamics3DOperationAddCTurtlebot4Entity,
+                                 CTurtlebot4Entity);
+
+   REGISTER_STANDARD_DYNAMICS3D_OPERATION_REMOVE_ENTITY(CTurtlebot4Entity);
 
    /****************************************/
    /****************************************/
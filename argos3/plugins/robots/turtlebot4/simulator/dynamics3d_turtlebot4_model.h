@@ -9,6 +9,7 @@
 
 namespace argos {
    class CDynamics3DTurtlebot4Model;
+   class CDynamics3DTurtlebot4ReducedModel;
    class CTurtlebot4Entity;
    class CWheeledEntity;
 }
@@ -40,6 +41,23 @@ namespace argos {
 
       virtual void RemoveFromWorld(btMultiBodyDynamicsWorld& c_world);
 
+   private:
+
+      /*
+       * Collision shapes and inertias, computed once and shared by all
+       * the instances of the model.
+       */
+      struct SSharedData {
+         std::shared_ptr<btCollisionShape> BodyShape;
+         std::shared_ptr<btCollisionShape> WheelShape;
+         btVector3 BodyInertia;
+         btVector3 WheelInertia;
+
+         SSharedData();
+      };
+
+      static const SSharedData& GetSharedData();
+
    private:
 
       /* joint constraints */
@@ -71,6 +89,56 @@ namespace argos {
       static const btScalar m_fWheelMotorMaxImpulse;
       static const btScalar m_fWheelFriction;
    };
+
+   /****************************************/
+   /****************************************/
+
+   /*
+    * A single cylinder with the footprint and mass of the turtlebot4.
+    * There are no wheel links or motors: at every step, the linear and
+    * yaw velocities of the base are set from the wheel speeds, which
+    * acts as a velocity-controlled differential drive constraint. The
+    * body slides without friction on the floor, so it keeps the set
+    * velocity between two steps. Selected with dynamics3d_model="reduced".
+    */
+   class CDynamics3DTurtlebot4ReducedModel : public CDynamics3DMultiBodyObjectModel {
+
+   public:
+
+      CDynamics3DTurtlebot4ReducedModel(CDynamics3DEngine& c_engine,
+                                        CTurtlebot4Entity& c_turtlebot4);
+
+      virtual ~CDynamics3DTurtlebot4ReducedModel() {}
+
+      virtual void Reset();
+
+      virtual void CalculateBoundingBox();
+
+      virtual void UpdateFromEntityStatus();
+
+   private:
+
+      /*
+       * Collision shape, inertia and geometric offset, computed once
+       * from the turtlebot4 measures and shared by all the instances.
+       */
+      struct SSharedData {
+         std::shared_ptr<btCollisionShape> BodyShape;
+         btVector3 BodyInertia;
+         btTransform BodyGeometricOffset;
+
+         SSharedData();
+      };
+
+      static const SSharedData& GetSharedData();
+
+   private:
+
+      /* links */
+      std::shared_ptr<CBase> m_ptrBody;
+      /* entities */
+      CWheeledEntity& m_cWheeledEntity;
+   };
 }
 
 #endif
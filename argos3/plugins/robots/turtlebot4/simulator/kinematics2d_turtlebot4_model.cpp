@@ -0,0 +1,32 @@
+/**
+ * @file <argos3/plugins/robots/turtlebot4/simulator/kinematics2d_turtlebot4_model.cpp>
+ *
+ * @author Jyotsna Bellary <jyotsnabellary@gmail.com>
+ */
+
+#include "kinematics2d_turtlebot4_model.h"
+#include "turtlebot4_measures.h"
+
+namespace argos {
+
+   /****************************************/
+   /****************************************/
+
+   CKinematics2DTurtlebot4Model::CKinematics2DTurtlebot4Model(CKinematics2DEngine& c_engine,
+                                                              CTurtlebot4Entity& c_entity) :
+      CKinematics2DModel(c_engine,
+                         c_entity.GetEmbodiedEntity(),
+                         c_entity.GetWheeledEntity(),
+                         TURTLEBOT4_BASE_RADIUS,
+                         TURTLEBOT4_BASE_TOP,
+                         TURTLEBOT4_WHEEL_DISTANCE) {}
+
+   /****************************************/
+   /****************************************/
+
+   REGISTER_STANDARD_KINEMATICS2D_OPERATIONS_ON_ENTITY(CTurtlebot4Entity, CKinematics2DTurtlebot4Model);
+
+   /****************************************/
+   /****************************************/
+
+}
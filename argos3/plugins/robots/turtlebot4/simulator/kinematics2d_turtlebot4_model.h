@@ -0,0 +1,32 @@
+/**
+ * @file <argos3/plugins/robots/turtlebot4/simulator/kinematics2d_turtlebot4_model.h>
+ *
+ * @author Jyotsna Bellary <jyotsnabellary@gmail.com>
+ */
+
+#ifndef KINEMATICS2D_TURTLEBOT4_MODEL_H
+#define KINEMATICS2D_TURTLEBOT4_MODEL_H
+
+namespace argos {
+   class CKinematics2DTurtlebot4Model;
+}
+
+#include <argos3/plugins/simulator/physics_engines/kinematics2d/kinematics2d_model.h>
+#include <argos3/plugins/robots/turtlebot4/simulator/turtlebot4_entity.h>
+
+namespace argos {
+
+   class CKinematics2DTurtlebot4Model : public CKinematics2DModel {
+
+   public:
+
+      CKinematics2DTurtlebot4Model(CKinematics2DEngine& c_engine,
+                                   CTurtlebot4Entity& c_entity);
+
+      virtual ~CKinematics2DTurtlebot4Model() {}
+
+   };
+
+}
+
+#endif
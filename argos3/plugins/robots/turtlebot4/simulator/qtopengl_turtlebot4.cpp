@@ -6,11 +6,18 @@
 
 #include "qtopengl_turtlebot4.h"
 #include "turtlebot4_entity.h"
+#include <argos3/core/simulator/simulator.h>
+#include <argos3/core/simulator/space/space.h>
 #include <argos3/core/simulator/entity/embodied_entity.h>
 #include <argos3/core/utility/math/vector2.h>
 #include <argos3/core/utility/math/vector3.h>
 #include <argos3/plugins/simulator/entities/led_equipped_entity.h>
 #include <argos3/plugins/simulator/visualizations/qt-opengl/qtopengl_widget.h>
+#include <argos3/plugins/simulator/visualizations/batch_rendering/qtopengl_level_of_detail.h>
+#include <argos3/plugins/simulator/visualizations/batch_rendering/qtopengl_mesh_builder.h>
+#include <argos3/plugins/simulator/visualizations/batch_rendering/qtopengl_offscreen_render.h>
+#include <argos3/plugins/simulator/visualizations/batch_rendering/qtopengl_obj_model.h>
+#include <argos3/core/utility/string_utilities.h>
 #include <argos3/plugins/robots/turtlebot4/simulator/turtlebot4_measures.h>
 
 namespace argos
@@ -45,78 +52,111 @@ namespace argos
    static const Real CAMERA_RADIUS               = BEACON_RADIUS;
    static const Real CAMERA_HEIGHT               = 0.104f;
 
+   /* Level of detail */
+   static const GLuint LOW_POLY_VERTICES         = 12;
+   static const Real   TOP_ELEVATION             = BODY_ELEVATION + LOWER_BODY_HEIGHT + TURTLEBOT4_COLUMN_HEIGHT;
+
    /****************************************/
    /****************************************/
 
-   CQTOpenGLTurtlebot4::CQTOpenGLTurtlebot4() : m_unVertices(40)
-   {
-      /* Reserve the needed display lists */
-      m_unLists = glGenLists(5);
-
-      /* Assign indices for better referencing (later) */
-      m_unWheelList = m_unLists;
-      m_unBodyList = m_unLists + 1;
-      m_unUpperBodyList = m_unLists + 2;
-      m_unColumnList = m_unLists + 3;
-      m_unCameraList                = m_unLists + 4;
-
-      /* Create the wheel display list */
-      glNewList(m_unWheelList, GL_COMPILE);
-      RenderWheel();
-      glEndList();
-
-      /* Create the body display list */
-      glNewList(m_unBodyList, GL_COMPILE);
-      RenderBody();
-      glEndList();
-
-      /* Create the upper body display list */
-      glNewList(m_unUpperBodyList, GL_COMPILE);
-      RenderUpperBody();
-      glEndList();
-
-      /* Create the column display list */
-      glNewList(m_unColumnList, GL_COMPILE);
-      RenderColumn();
-      glEndList();
-
-      /* Create the camera display list */
-      glNewList(m_unCameraList, GL_COMPILE);
-      RenderCamera();
-      glEndList();
-   }
+   /* Dark plastic (Lower body) */
+   static const CQTOpenGLInstancedMesh::SMaterial BASE_MATERIAL = {
+      { 0.15f, 0.15f, 0.15f, 1.0f }, // dark gray
+      { 0.05f, 0.05f, 0.05f, 1.0f },
+      5.0f,
+      { 0.0f, 0.0f, 0.0f, 1.0f }
+   };
 
-   /****************************************/
-   /****************************************/
+   /* Matte black (Upper deck) */
+   static const CQTOpenGLInstancedMesh::SMaterial DECK_MATERIAL = {
+      { 0.07f, 0.07f, 0.07f, 1.0f }, // matte black
+      { 0.02f, 0.02f, 0.02f, 1.0f },
+      2.0f,
+      { 0.0f, 0.0f, 0.0f, 1.0f }
+   };
 
-   CQTOpenGLTurtlebot4::~CQTOpenGLTurtlebot4()
-   {
-      glDeleteLists(m_unLists, 5);
-   }
+   /* Aluminum / metal (Columns) */
+   static const CQTOpenGLInstancedMesh::SMaterial COLUMN_MATERIAL = {
+      { 0.75f, 0.75f, 0.75f, 1.0f }, // light silver
+      { 0.90f, 0.90f, 0.90f, 1.0f }, // shiny
+      50.0f,
+      { 0.0f, 0.0f, 0.0f, 1.0f }
+   };
+
+   /* Rubber (Wheels) */
+   static const CQTOpenGLInstancedMesh::SMaterial WHEEL_MATERIAL = {
+      { 0.05f, 0.05f, 0.05f, 1.0f }, // dark rubber
+      { 0.00f, 0.00f, 0.00f, 1.0f },
+      1.0f,
+      { 0.0f, 0.0f, 0.0f, 1.0f }
+   };
+
+   /* Emissive yellow (Heading seen from far) */
+   static const CQTOpenGLInstancedMesh::SMaterial HEADING_MATERIAL = {
+      { 1.0f, 1.0f, 0.0f, 1.0f },
+      { 0.0f, 0.0f, 0.0f, 1.0f },
+      0.0f,
+      { 1.0f, 1.0f, 0.0f, 1.0f }
+   };
+
+   /* White plastic (Camera) */
+   static const CQTOpenGLInstancedMesh::SMaterial WHITE_PLASTIC_MATERIAL = {
+      { 1.0f, 1.0f, 1.0f, 1.0f },
+      { 0.9f, 0.9f, 0.9f, 1.0f },
+      100.0f,
+      { 0.0f, 0.0f, 0.0f, 1.0f }
+   };
 
    /****************************************/
    /****************************************/
 
-   void CQTOpenGLTurtlebot4::Draw(CTurtlebot4Entity &c_entity)
+   CQTOpenGLTurtlebot4::CQTOpenGLTurtlebot4() : m_unVertices(40)
    {
-      /* Place the body */
-      glCallList(m_unBodyList);
+      /* Record each part once and keep it in a vertex buffer */
+      CQTOpenGLMeshBuilder cMesh;
+      RenderWheel(cMesh);
+      m_pcWheel = new CQTOpenGLInstancedMesh(cMesh, WHEEL_MATERIAL);
+      cMesh.Clear();
+      RenderBody(cMesh);
+      m_pcBody = new CQTOpenGLInstancedMesh(cMesh, BASE_MATERIAL);
+      cMesh.Clear();
+      RenderUpperBody(cMesh);
+      m_pcUpperBody = new CQTOpenGLInstancedMesh(cMesh, DECK_MATERIAL);
+      cMesh.Clear();
+      RenderColumn(cMesh);
+      m_pcColumn = new CQTOpenGLInstancedMesh(cMesh, COLUMN_MATERIAL);
+      cMesh.Clear();
+      RenderCamera(cMesh);
+      m_pcCamera = new CQTOpenGLInstancedMesh(cMesh, WHITE_PLASTIC_MATERIAL);
+
+      /* Mid-range and far parts, with fewer sides */
+      GLuint unVertices = m_unVertices;
+      m_unVertices = LOW_POLY_VERTICES;
+      cMesh.Clear();
+      RenderBody(cMesh);
+      m_pcLowPolyBody = new CQTOpenGLInstancedMesh(cMesh, BASE_MATERIAL);
+      cMesh.Clear();
+      RenderUpperBody(cMesh);
+      m_pcLowPolyUpperBody = new CQTOpenGLInstancedMesh(cMesh, DECK_MATERIAL);
+
+      /* Far parts */
+      cMesh.Clear();
+      RenderDisk(cMesh);
+      m_pcDisk = new CQTOpenGLInstancedMesh(cMesh, BASE_MATERIAL);
+      m_unVertices = unVertices;
+      cMesh.Clear();
+      RenderHeading(cMesh);
+      m_pcHeading = new CQTOpenGLInstancedMesh(cMesh, HEADING_MATERIAL);
+
+      /* Optional mesh of the real robot */
+      LoadModel();
 
       /* Place the wheels */
-      glPushMatrix();
-      glTranslated(0.0f, HALF_INTERWHEEL_DISTANCE, 0.0f);
-      glCallList(m_unWheelList);
-      glPopMatrix();
-      glPushMatrix();
-      glTranslated(0.0f, -HALF_INTERWHEEL_DISTANCE, 0.0f);
-      glCallList(m_unWheelList);
-      glPopMatrix();
-
-      glCallList(m_unUpperBodyList);
+      CQTOpenGLInstancedMesh::MakeTranslation(m_pfLeftWheel, 0.0f, HALF_INTERWHEEL_DISTANCE, 0.0f);
+      CQTOpenGLInstancedMesh::MakeTranslation(m_pfRightWheel, 0.0f, -HALF_INTERWHEEL_DISTANCE, 0.0f);
 
       /* Columns (3 pillars) */
       CRadians cStep = CRadians::TWO_PI / TURTLEBOT4_NUM_COLUMNS;
-      Real angleStep = cStep.GetValue();
 
       Real radius = BODY_RADIUS * 0.9f;            // slightly inside edge
       CRadians cOffset = CRadians(ARGOS_PI / 3.0); // 60 degrees
@@ -124,177 +164,262 @@ namespace argos
       for (UInt32 i = 0; i < TURTLEBOT4_NUM_COLUMNS; ++i)
       {
          CRadians cAngle = cOffset + cStep * i;
-         // CRadians cAngle = cStep * i;
-
-         glPushMatrix();
-         glTranslated(radius * Cos(cAngle),
-                      radius * Sin(cAngle),
-                      0.0f);
-         glCallList(m_unColumnList);
-         glPopMatrix();
+         m_vecColumns.resize(m_vecColumns.size() + 16);
+         CQTOpenGLInstancedMesh::MakeTranslation(&m_vecColumns[16 * i],
+                                                 radius * Cos(cAngle),
+                                                 radius * Sin(cAngle),
+                                                 0.0f);
       }
-
-      /* Place the camera */
-      glCallList(m_unCameraList);
    }
 
-   /* Dark plastic (Lower body) */
-   void CQTOpenGLTurtlebot4::SetBaseMaterial()
+   /****************************************/
+   /****************************************/
+
+   CQTOpenGLTurtlebot4::~CQTOpenGLTurtlebot4()
    {
-      const GLfloat ambient_diffuse[] = {0.15f, 0.15f, 0.15f, 1.0f}; // dark gray
-      const GLfloat specular[] = {0.05f, 0.05f, 0.05f, 1.0f};
-      const GLfloat shininess[] = {5.0f};
-      glMaterialfv(GL_FRONT_AND_BACK, GL_AMBIENT_AND_DIFFUSE, ambient_diffuse);
-      glMaterialfv(GL_FRONT_AND_BACK, GL_SPECULAR, specular);
-      glMaterialfv(GL_FRONT_AND_BACK, GL_SHININESS, shininess);
+      delete m_pcWheel;
+      delete m_pcBody;
+      delete m_pcUpperBody;
+      delete m_pcColumn;
+      delete m_pcCamera;
+      delete m_pcLowPolyBody;
+      delete m_pcLowPolyUpperBody;
+      delete m_pcDisk;
+      delete m_pcHeading;
+      for(size_t i = 0; i < m_vecModel.size(); ++i) {
+         delete m_vecModel[i];
+      }
    }
 
-   /* Matte black (Upper deck) */
-   void CQTOpenGLTurtlebot4::SetDeckMaterial()
+   /****************************************/
+   /****************************************/
+
+   void CQTOpenGLTurtlebot4::Draw(CTurtlebot4Entity &c_entity)
    {
-      const GLfloat ambient_diffuse[] = {0.07f, 0.07f, 0.07f, 1.0f}; // matte black
-      const GLfloat specular[] = {0.02f, 0.02f, 0.02f, 1.0f};
-      const GLfloat shininess[] = {2.0f};
-      glMaterialfv(GL_FRONT_AND_BACK, GL_AMBIENT_AND_DIFFUSE, ambient_diffuse);
-      glMaterialfv(GL_FRONT_AND_BACK, GL_SPECULAR, specular);
-      glMaterialfv(GL_FRONT_AND_BACK, GL_SHININESS, shininess);
+      CSpace::TMapPerType& tRobots = CSimulator::GetInstance().GetSpace().GetEntitiesByType("turtlebot4");
+      /* All the robots are drawn at once, when the first enabled one is */
+      CSpace::TMapPerType::iterator itFirst = tRobots.begin();
+      while(itFirst != tRobots.end() && !any_cast<CTurtlebot4Entity*>(itFirst->second)->IsEnabled()) {
+         ++itFirst;
+      }
+      if(itFirst == tRobots.end() || any_cast<CTurtlebot4Entity*>(itFirst->second) != &c_entity) {
+         return;
+      }
+      /* Sort the robots by distance from the camera */
+      CQTOpenGLLevelOfDetail& cLOD = CQTOpenGLLevelOfDetail::GetInstance();
+      cLOD.UpdateCamera();
+      for(UInt32 i = 0; i < CQTOpenGLLevelOfDetail::NUM_LEVELS; ++i) {
+         m_cInstances[i].Clear();
+      }
+      m_cRays.Clear();
+      for(CSpace::TMapPerType::iterator it = tRobots.begin(); it != tRobots.end(); ++it) {
+         CTurtlebot4Entity* pcRobot = any_cast<CTurtlebot4Entity*>(it->second);
+         /* Disabled robots, such as the parked ones of a pool, are not drawn and have no rays */
+         if(!pcRobot->IsEnabled()) continue;
+         const SAnchor& sOrigin = pcRobot->GetEmbodiedEntity().GetOriginAnchor();
+         m_cInstances[cLOD.GetLevel(sOrigin.Position)].Add(sOrigin.Position, sOrigin.Orientation);
+         m_cRays.Add(pcRobot->GetControllableEntity());
+      }
+      for(UInt32 i = 0; i < CQTOpenGLLevelOfDetail::NUM_LEVELS; ++i) {
+         m_cInstances[i].Upload();
+      }
+
+      /* Near robots: the full model */
+      CQTOpenGLInstances& cNear = m_cInstances[CQTOpenGLLevelOfDetail::LEVEL_NEAR];
+
+      if(!m_vecModel.empty()) {
+         for(size_t i = 0; i < m_vecModel.size(); ++i) {
+            m_vecModel[i]->Draw(cNear);
+         }
+      }
+      else {
+         DrawParts(cNear);
+      }
+
+      /* Mid-range robots: the body and the deck, with fewer sides */
+      CQTOpenGLInstances& cMid = m_cInstances[CQTOpenGLLevelOfDetail::LEVEL_MID];
+      m_pcLowPolyBody->Draw(cMid);
+      m_pcLowPolyUpperBody->Draw(cMid);
+
+      /* Far robots: a disk with the heading */
+      CQTOpenGLInstances& cFar = m_cInstances[CQTOpenGLLevelOfDetail::LEVEL_FAR];
+      m_pcDisk->Draw(cFar);
+      m_pcHeading->Draw(cFar);
+
+      /* The rays of all the robots at once */
+      m_cRays.Draw();
    }
 
-   /* Aluminum / metal (Columns) */
-   void CQTOpenGLTurtlebot4::SetColumnMaterial()
+   void CQTOpenGLTurtlebot4::DrawParts(CQTOpenGLInstances& c_instances)
    {
-      const GLfloat ambient_diffuse[] = {0.75f, 0.75f, 0.75f, 1.0f}; // light silver
-      const GLfloat specular[] = {0.90f, 0.90f, 0.90f, 1.0f};        // shiny
-      const GLfloat shininess[] = {50.0f};
-      glMaterialfv(GL_FRONT_AND_BACK, GL_AMBIENT_AND_DIFFUSE, ambient_diffuse);
-      glMaterialfv(GL_FRONT_AND_BACK, GL_SPECULAR, specular);
-      glMaterialfv(GL_FRONT_AND_BACK, GL_SHININESS, shininess);
+      /* Place the body */
+      m_pcBody->Draw(c_instances);
+
+      /* Place the wheels */
+      m_pcWheel->Draw(c_instances, m_pfLeftWheel);
+      m_pcWheel->Draw(c_instances, m_pfRightWheel);
+
+      m_pcUpperBody->Draw(c_instances);
+
+      /* Columns */
+      for (size_t i = 0; i < m_vecColumns.size(); i += 16)
+      {
+         m_pcColumn->Draw(c_instances, &m_vecColumns[i]);
+      }
+
+      /* Place the camera */
+      m_pcCamera->Draw(c_instances);
    }
 
-   /* Rubber (Wheels) */
-   void CQTOpenGLTurtlebot4::SetWheelMaterial()
+   /****************************************/
+   /****************************************/
+
+   void CQTOpenGLTurtlebot4::LoadModel()
    {
-      const GLfloat ambient_diffuse[] = {0.05f, 0.05f, 0.05f, 1.0f}; // dark rubber
-      const GLfloat specular[] = {0.00f, 0.00f, 0.00f, 1.0f};
-      const GLfloat shininess[] = {1.0f};
-      glMaterialfv(GL_FRONT_AND_BACK, GL_AMBIENT_AND_DIFFUSE, ambient_diffuse);
-      glMaterialfv(GL_FRONT_AND_BACK, GL_SPECULAR, specular);
-      glMaterialfv(GL_FRONT_AND_BACK, GL_SHININESS, shininess);
+      TConfigurationNode& tRoot = CSimulator::GetInstance().GetConfigurationRoot();
+      if(! NodeExists(tRoot, "visualization")) {
+         return;
+      }
+      TConfigurationNode& tVisualization = GetNode(tRoot, "visualization");
+      if(! NodeExists(tVisualization, "qt-opengl") ||
+         ! NodeExists(GetNode(tVisualization, "qt-opengl"), "turtlebot4_model")) {
+         return;
+      }
+      try {
+         TConfigurationNode& tModel = GetNode(GetNode(tVisualization, "qt-opengl"), "turtlebot4_model");
+         std::string strFile;
+         Real fScale = 1.0;
+         bool bYUp = false;
+         GetNodeAttribute(tModel, "file", strFile);
+         ExpandEnvVariables(strFile);
+         GetNodeAttributeOrDefault(tModel, "scale", fScale, fScale);
+         GetNodeAttributeOrDefault(tModel, "y_up", bYUp, bYUp);
+         /* The parsed model is shared, each part is uploaded once */
+         const CQTOpenGLObjModel& cModel = CQTOpenGLObjModel::Load(strFile, fScale, bYUp);
+         for(size_t i = 0; i < cModel.GetSubMeshes().size(); ++i) {
+            const CQTOpenGLObjModel::SSubMesh& sSubMesh = cModel.GetSubMeshes()[i];
+            m_vecModel.push_back(new CQTOpenGLInstancedMesh(sSubMesh.Vertices,
+                                                            sSubMesh.Indices,
+                                                            sSubMesh.Material));
+         }
+      }
+      catch(CARGoSException& ex) {
+         THROW_ARGOSEXCEPTION_NESTED("Error loading the Turtlebot4 model of the Qt-OpenGL visualization", ex);
+      }
    }
 
-   void CQTOpenGLTurtlebot4::RenderWheel()
+   /****************************************/
+   /****************************************/
+
+   void CQTOpenGLTurtlebot4::RenderWheel(CQTOpenGLMeshBuilder& c_mesh)
    {
       /* Right side */
-      SetWheelMaterial();
       CVector2 cVertex(WHEEL_RADIUS, 0.0f);
       CRadians cAngle(CRadians::TWO_PI / m_unVertices);
       CVector3 cNormal(-1.0f, -1.0f, 0.0f);
       cNormal.Normalize();
-      glBegin(GL_POLYGON);
+      c_mesh.Begin(CQTOpenGLMeshBuilder::POLYGON);
       for (GLuint i = 0; i <= m_unVertices; i++)
       {
-         glNormal3d(cNormal.GetX(), cNormal.GetY(), cNormal.GetZ());
-         glVertex3d(cVertex.GetX(), -HALF_WHEEL_WIDTH, WHEEL_RADIUS + cVertex.GetY());
+         c_mesh.Normal(cNormal.GetX(), cNormal.GetY(), cNormal.GetZ());
+         c_mesh.Vertex(cVertex.GetX(), -HALF_WHEEL_WIDTH, WHEEL_RADIUS + cVertex.GetY());
          cVertex.Rotate(cAngle);
          cNormal.RotateY(cAngle);
       }
-      glEnd();
+      c_mesh.End();
       /* Left side */
       cVertex.Set(WHEEL_RADIUS, 0.0f);
       cNormal.Set(-1.0f, 1.0f, 0.0f);
       cNormal.Normalize();
       cAngle = -cAngle;
-      glBegin(GL_POLYGON);
+      c_mesh.Begin(CQTOpenGLMeshBuilder::POLYGON);
       for (GLuint i = 0; i <= m_unVertices; i++)
       {
-         glNormal3d(cNormal.GetX(), cNormal.GetY(), cNormal.GetZ());
-         glVertex3d(cVertex.GetX(), HALF_WHEEL_WIDTH, WHEEL_RADIUS + cVertex.GetY());
+         c_mesh.Normal(cNormal.GetX(), cNormal.GetY(), cNormal.GetZ());
+         c_mesh.Vertex(cVertex.GetX(), HALF_WHEEL_WIDTH, WHEEL_RADIUS + cVertex.GetY());
          cVertex.Rotate(cAngle);
          cNormal.RotateY(cAngle);
       }
-      glEnd();
+      c_mesh.End();
       /* Tire */
       cNormal.Set(1.0f, 0.0f, 0.0f);
       cVertex.Set(WHEEL_RADIUS, 0.0f);
       cAngle = -cAngle;
-      glBegin(GL_QUAD_STRIP);
+      c_mesh.Begin(CQTOpenGLMeshBuilder::QUAD_STRIP);
       for (GLuint i = 0; i <= m_unVertices; i++)
       {
-         glNormal3d(cNormal.GetX(), cNormal.GetY(), cNormal.GetZ());
-         glVertex3d(cVertex.GetX(), -HALF_WHEEL_WIDTH, WHEEL_RADIUS + cVertex.GetY());
-         glVertex3d(cVertex.GetX(), HALF_WHEEL_WIDTH, WHEEL_RADIUS + cVertex.GetY());
+         c_mesh.Normal(cNormal.GetX(), cNormal.GetY(), cNormal.GetZ());
+         c_mesh.Vertex(cVertex.GetX(), -HALF_WHEEL_WIDTH, WHEEL_RADIUS + cVertex.GetY());
+         c_mesh.Vertex(cVertex.GetX(), HALF_WHEEL_WIDTH, WHEEL_RADIUS + cVertex.GetY());
          cVertex.Rotate(cAngle);
          cNormal.RotateY(cAngle);
       }
-      glEnd();
+      c_mesh.End();
    }
 
-   void CQTOpenGLTurtlebot4::RenderUpperBody()
+   void CQTOpenGLTurtlebot4::RenderUpperBody(CQTOpenGLMeshBuilder& c_mesh)
    {
-      SetDeckMaterial();
       Real z = BODY_ELEVATION + LOWER_BODY_HEIGHT + TURTLEBOT4_COLUMN_HEIGHT;
 
       CVector2 cVertex(UPPER_BODY_RADIUS, 0.0f);
       CRadians cAngle(CRadians::TWO_PI / m_unVertices);
 
-      glBegin(GL_POLYGON);
-      glNormal3d(0.0f, 0.0f, 1.0f);
+      c_mesh.Begin(CQTOpenGLMeshBuilder::POLYGON);
+      c_mesh.Normal(0.0f, 0.0f, 1.0f);
       for (GLuint i = 0; i <= m_unVertices; i++)
       {
-         glVertex3d(cVertex.GetX(), cVertex.GetY(), z);
+         c_mesh.Vertex(cVertex.GetX(), cVertex.GetY(), z);
          cVertex.Rotate(cAngle);
       }
-      glEnd();
+      c_mesh.End();
    }
 
-   void CQTOpenGLTurtlebot4::RenderBody()
+   void CQTOpenGLTurtlebot4::RenderBody(CQTOpenGLMeshBuilder& c_mesh)
    {
-      SetBaseMaterial();
       /* Bottom disk */
       CVector2 cVertex(BODY_RADIUS, 0.0f);
       CRadians cAngle(-CRadians::TWO_PI / m_unVertices);
 
-      glBegin(GL_POLYGON);
-      glNormal3d(0.0f, 0.0f, -1.0f);
+      c_mesh.Begin(CQTOpenGLMeshBuilder::POLYGON);
+      c_mesh.Normal(0.0f, 0.0f, -1.0f);
       for (GLuint i = 0; i <= m_unVertices; i++)
       {
-         glVertex3d(cVertex.GetX(), cVertex.GetY(), BODY_ELEVATION);
+         c_mesh.Vertex(cVertex.GetX(), cVertex.GetY(), BODY_ELEVATION);
          cVertex.Rotate(cAngle);
       }
-      glEnd();
+      c_mesh.End();
 
       /* Side cylinder */
       cAngle = -cAngle;
       CVector2 cNormal(1.0f, 0.0f);
       cVertex.Set(BODY_RADIUS, 0.0f);
 
-      glBegin(GL_QUAD_STRIP);
+      c_mesh.Begin(CQTOpenGLMeshBuilder::QUAD_STRIP);
       for (GLuint i = 0; i <= m_unVertices; i++)
       {
-         glNormal3d(cNormal.GetX(), cNormal.GetY(), 0.0f);
-         glVertex3d(cVertex.GetX(), cVertex.GetY(), BODY_ELEVATION + LOWER_BODY_HEIGHT);
-         glVertex3d(cVertex.GetX(), cVertex.GetY(), BODY_ELEVATION);
+         c_mesh.Normal(cNormal.GetX(), cNormal.GetY(), 0.0f);
+         c_mesh.Vertex(cVertex.GetX(), cVertex.GetY(), BODY_ELEVATION + LOWER_BODY_HEIGHT);
+         c_mesh.Vertex(cVertex.GetX(), cVertex.GetY(), BODY_ELEVATION);
          cVertex.Rotate(cAngle);
          cNormal.Rotate(cAngle);
       }
-      glEnd();
+      c_mesh.End();
 
       /* NEW: Top disk */
       cVertex.Set(BODY_RADIUS, 0.0f);
-      glBegin(GL_POLYGON);
-      glNormal3d(0.0f, 0.0f, 1.0f);
+      c_mesh.Begin(CQTOpenGLMeshBuilder::POLYGON);
+      c_mesh.Normal(0.0f, 0.0f, 1.0f);
       for (GLuint i = 0; i <= m_unVertices; i++)
       {
-         glVertex3d(cVertex.GetX(), cVertex.GetY(),
-                    BODY_ELEVATION + LOWER_BODY_HEIGHT);
+         c_mesh.Vertex(cVertex.GetX(), cVertex.GetY(),
+                       BODY_ELEVATION + LOWER_BODY_HEIGHT);
          cVertex.Rotate(cAngle);
       }
-      glEnd();
+      c_mesh.End();
    }
 
-   void CQTOpenGLTurtlebot4::RenderColumn()
+   void CQTOpenGLTurtlebot4::RenderColumn(CQTOpenGLMeshBuilder& c_mesh)
    {
-      SetColumnMaterial();
       Real baseZ = BODY_ELEVATION + LOWER_BODY_HEIGHT;
       Real topZ = baseZ + TURTLEBOT4_COLUMN_HEIGHT;
 
@@ -303,66 +428,77 @@ namespace argos
       CRadians cAngle(CRadians::TWO_PI / m_unVertices);
 
       /* Side tube */
-      glBegin(GL_QUAD_STRIP);
+      c_mesh.Begin(CQTOpenGLMeshBuilder::QUAD_STRIP);
       for (UInt32 i = 0; i <= m_unVertices; ++i)
       {
-         glNormal3d(cNormal.GetX(), cNormal.GetY(), 0.0f);
-         glVertex3d(cVertex.GetX(), cVertex.GetY(), baseZ);
-         glVertex3d(cVertex.GetX(), cVertex.GetY(), topZ);
+         c_mesh.Normal(cNormal.GetX(), cNormal.GetY(), 0.0f);
+         c_mesh.Vertex(cVertex.GetX(), cVertex.GetY(), baseZ);
+         c_mesh.Vertex(cVertex.GetX(), cVertex.GetY(), topZ);
          cVertex.Rotate(cAngle);
          cNormal.Rotate(cAngle);
       }
-      glEnd();
-   }
-
-   void CQTOpenGLTurtlebot4::SetWhitePlasticMaterial() {
-      const GLfloat pfColor[]     = {   1.0f, 1.0f, 1.0f, 1.0f };
-      const GLfloat pfSpecular[]  = {   0.9f, 0.9f, 0.9f, 1.0f };
-      const GLfloat pfShininess[] = { 100.0f                   };
-      const GLfloat pfEmission[]  = {   0.0f, 0.0f, 0.0f, 1.0f };
-      glMaterialfv(GL_FRONT_AND_BACK, GL_AMBIENT_AND_DIFFUSE, pfColor);
-      glMaterialfv(GL_FRONT_AND_BACK, GL_SPECULAR,            pfSpecular);
-      glMaterialfv(GL_FRONT_AND_BACK, GL_SHININESS,           pfShininess);
-      glMaterialfv(GL_FRONT_AND_BACK, GL_EMISSION,            pfEmission);
+      c_mesh.End();
    }
 
-   void CQTOpenGLTurtlebot4::RenderCamera() {
-      /* Set material */
-      SetWhitePlasticMaterial();
+   void CQTOpenGLTurtlebot4::RenderCamera(CQTOpenGLMeshBuilder& c_mesh) {
       CVector2 cVertex(CAMERA_RADIUS, 0.0f);
       CRadians cAngle(-CRadians::TWO_PI / m_unVertices);
       /* Bottom part */
-      glBegin(GL_POLYGON);
-      glNormal3d(0.0f, 0.0f, -1.0f);
+      c_mesh.Begin(CQTOpenGLMeshBuilder::POLYGON);
+      c_mesh.Normal(0.0f, 0.0f, -1.0f);
       for(GLuint i = 0; i <= m_unVertices; i++) {
-         glVertex3d(cVertex.GetX(), cVertex.GetY(), CAMERA_ELEVATION);
+         c_mesh.Vertex(cVertex.GetX(), cVertex.GetY(), CAMERA_ELEVATION);
          cVertex.Rotate(cAngle);
       }
-      glEnd();
+      c_mesh.End();
       /* Side surface */
       cAngle = -cAngle;
       CVector2 cNormal(1.0f, 0.0f);
       cVertex.Set(CAMERA_RADIUS, 0.0f);
-      glBegin(GL_QUAD_STRIP);
+      c_mesh.Begin(CQTOpenGLMeshBuilder::QUAD_STRIP);
       for(GLuint i = 0; i <= m_unVertices; i++) {
-         glNormal3d(cNormal.GetX(), cNormal.GetY(), 0.0f);
-         glVertex3d(cVertex.GetX(), cVertex.GetY(), CAMERA_ELEVATION + CAMERA_HEIGHT);
-         glVertex3d(cVertex.GetX(), cVertex.GetY(), CAMERA_ELEVATION);
+         c_mesh.Normal(cNormal.GetX(), cNormal.GetY(), 0.0f);
+         c_mesh.Vertex(cVertex.GetX(), cVertex.GetY(), CAMERA_ELEVATION + CAMERA_HEIGHT);
+         c_mesh.Vertex(cVertex.GetX(), cVertex.GetY(), CAMERA_ELEVATION);
          cVertex.Rotate(cAngle);
          cNormal.Rotate(cAngle);
       }
-      glEnd();
+      c_mesh.End();
       /* Top part */
-      glBegin(GL_POLYGON);
-      glNormal3d(0.0f, 0.0f, 1.0f);
+      c_mesh.Begin(CQTOpenGLMeshBuilder::POLYGON);
+      c_mesh.Normal(0.0f, 0.0f, 1.0f);
       cVertex.Set(CAMERA_RADIUS, 0.0f);
       for(GLuint i = 0; i <= m_unVertices; i++) {
-         glVertex3d(cVertex.GetX(), cVertex.GetY(), CAMERA_ELEVATION + CAMERA_HEIGHT);
+         c_mesh.Vertex(cVertex.GetX(), cVertex.GetY(), CAMERA_ELEVATION + CAMERA_HEIGHT);
          cVertex.Rotate(cAngle);
       }
-      glEnd();
+      c_mesh.End();
    }
    
+   void CQTOpenGLTurtlebot4::RenderDisk(CQTOpenGLMeshBuilder& c_mesh)
+   {
+      CVector2 cVertex(BODY_RADIUS, 0.0f);
+      CRadians cAngle(CRadians::TWO_PI / m_unVertices);
+      c_mesh.Begin(CQTOpenGLMeshBuilder::POLYGON);
+      c_mesh.Normal(0.0f, 0.0f, 1.0f);
+      for (GLuint i = 0; i <= m_unVertices; i++)
+      {
+         c_mesh.Vertex(cVertex.GetX(), cVertex.GetY(), TOP_ELEVATION);
+         cVertex.Rotate(cAngle);
+      }
+      c_mesh.End();
+   }
+
+   void CQTOpenGLTurtlebot4::RenderHeading(CQTOpenGLMeshBuilder& c_mesh)
+   {
+      c_mesh.Normal(0.0f, 0.0f, 1.0f);
+      c_mesh.Begin(CQTOpenGLMeshBuilder::TRIANGLES);
+      c_mesh.Vertex( BODY_RADIUS * 0.7,               0.0f, TOP_ELEVATION + 0.001f);
+      c_mesh.Vertex(-BODY_RADIUS * 0.7,  BODY_RADIUS * 0.3, TOP_ELEVATION + 0.001f);
+      c_mesh.Vertex(-BODY_RADIUS * 0.7, -BODY_RADIUS * 0.3, TOP_ELEVATION + 0.001f);
+      c_mesh.End();
+   }
+
    class CQTOpenGLOperationDrawTurtlebot4Normal : public CQTOpenGLOperationDrawNormal
    {
    public:
@@ -370,8 +506,7 @@ namespace argos
                    CTurtlebot4Entity &c_entity)
       {
          static CQTOpenGLTurtlebot4 m_cModel;
-         c_visualization.DrawRays(c_entity.GetControllableEntity());
-         c_visualization.DrawEntity(c_entity.GetEmbodiedEntity());
+         /* The model places the robots and draws their rays itself */
          m_cModel.Draw(c_entity);
       }
    };
@@ -389,4 +524,16 @@ namespace argos
    REGISTER_QTOPENGL_ENTITY_OPERATION(CQTOpenGLOperationDrawNormal, CQTOpenGLOperationDrawTurtlebot4Normal, CTurtlebot4Entity);
 
    REGISTER_QTOPENGL_ENTITY_OPERATION(CQTOpenGLOperationDrawSelected, CQTOpenGLOperationDrawTurtlebot4Selected, CTurtlebot4Entity);
+
+   /****************************************/
+   /****************************************/
+
+   /* The offscreen visualization has its own context, hence its own model */
+   static void DrawTurtlebot4Offscreen(CEntity& c_entity)
+   {
+      static CQTOpenGLTurtlebot4 cModel;
+      cModel.Draw(static_cast<CTurtlebot4Entity&>(c_entity));
+   }
+
+   REGISTER_QTOPENGL_OFFSCREEN_DRAW_FUNCTION("turtlebot4", DrawTurtlebot4Offscreen);
 }
\ No newline at end of file
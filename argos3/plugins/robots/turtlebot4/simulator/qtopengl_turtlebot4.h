@@ -10,13 +10,13 @@
 namespace argos {
    class CQTOpenGLTurtlebot4;
    class CTurtlebot4Entity;
+   class CQTOpenGLMeshBuilder;
 }
 
-#ifdef __APPLE__
-#include <gl.h>
-#else
-#include <GL/gl.h>
-#endif
+#include <argos3/plugins/simulator/visualizations/batch_rendering/qtopengl_instanced_mesh.h>
+#include <argos3/plugins/simulator/visualizations/batch_rendering/qtopengl_level_of_detail.h>
+#include <argos3/plugins/simulator/visualizations/batch_rendering/qtopengl_ray_renderer.h>
+#include <vector>
 
 namespace argos {
 
@@ -28,60 +28,88 @@ namespace argos {
 
       virtual ~CQTOpenGLTurtlebot4();
 
+      /**
+       * Draws all the Turtlebot4s in the space at once. The robots are
+       * drawn along with the first one in the space, the call does
+       * nothing for the others.
+       */
       virtual void Draw(CTurtlebot4Entity& c_entity);
 
    protected:
 
+      /** Draws the procedural model */
+      void DrawParts(CQTOpenGLInstances& c_instances);
+
+      /**
+       * Loads the mesh of the real robot, if the <qt-opengl> node has a
+       * <turtlebot4_model file="..." [scale="..."] [y_up="..."] /> node.
+       */
+      void LoadModel();
+
       /** Renders a wheel */
-      void RenderWheel();
+      void RenderWheel(CQTOpenGLMeshBuilder& c_mesh);
 
       /** Renders the body */
-      void RenderBody();
+      void RenderBody(CQTOpenGLMeshBuilder& c_mesh);
 
       /** Renders the upperbody */
-      void RenderUpperBody();
+      void RenderUpperBody(CQTOpenGLMeshBuilder& c_mesh);
 
       /** Renders the columns */
-      void RenderColumn();
+      void RenderColumn(CQTOpenGLMeshBuilder& c_mesh);
 
-      /** Set Base Material */ 
-      void SetBaseMaterial();
+      /** Renders the camera */
+      void RenderCamera(CQTOpenGLMeshBuilder& c_mesh);
 
-      /** Set deck Material */ 
-      void SetDeckMaterial();
+      /** Renders the disk that stands for a far robot */
+      void RenderDisk(CQTOpenGLMeshBuilder& c_mesh);
 
-      /** Set Column Material */ 
-      void SetColumnMaterial();
+      /** Renders the heading of a far robot */
+      void RenderHeading(CQTOpenGLMeshBuilder& c_mesh);
 
-      /** Set Wheel Material */
-      void SetWheelMaterial(); 
+   private:
 
-      /** Renders the camera */
-      void RenderCamera();
+      /** Turtlebot4 wheel */
+      CQTOpenGLInstancedMesh* m_pcWheel;
 
-      void SetWhitePlasticMaterial();
-   private:
+      /** Body mesh */
+      CQTOpenGLInstancedMesh* m_pcBody;
 
-      /** Start of the display list index */
-      GLuint m_unLists;
+      /** Upper body mesh */
+      CQTOpenGLInstancedMesh* m_pcUpperBody;
 
-      /** Turtlebot4 wheel */
-      GLuint m_unWheelList;
+      /** Column mesh */
+      CQTOpenGLInstancedMesh* m_pcColumn;
+
+      /** Camera mesh */
+      CQTOpenGLInstancedMesh* m_pcCamera;
+
+      /** Body and upper body of the mid-range robots */
+      CQTOpenGLInstancedMesh* m_pcLowPolyBody;
+      CQTOpenGLInstancedMesh* m_pcLowPolyUpperBody;
+
+      /** Disk and heading of the far robots */
+      CQTOpenGLInstancedMesh* m_pcDisk;
+      CQTOpenGLInstancedMesh* m_pcHeading;
 
-      /** Body display list */
-      GLuint m_unBodyList;
+      /** Mesh of the real robot, one part per material; empty if not used */
+      std::vector<CQTOpenGLInstancedMesh*> m_vecModel;
 
-      /** Upper body list */
-      GLuint m_unUpperBodyList;
+      /** Placement of the wheels on the robot */
+      GLfloat m_pfLeftWheel[16];
+      GLfloat m_pfRightWheel[16];
 
-      /** Column list */
-      GLuint m_unColumnList;
+      /** Placement of the columns on the robot, 16 floats each */
+      std::vector<GLfloat> m_vecColumns;
+
+      /** Poses of the robots in the current frame, per level of detail */
+      CQTOpenGLInstances m_cInstances[CQTOpenGLLevelOfDetail::NUM_LEVELS];
+
+      /** Rays of the sensors of all the robots */
+      CQTOpenGLRayRenderer m_cRays;
 
       /** Number of vertices to display the round parts */
       GLuint m_unVertices;
-
-      /** Foot-bot camera module */
-      GLuint m_unCameraList;
    };
 
 }
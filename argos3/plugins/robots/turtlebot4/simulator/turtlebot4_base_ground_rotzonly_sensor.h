@@ -17,6 +17,8 @@ namespace argos {
 }
 
 #include <argos3/plugins/robots/turtlebot4/control_interface/ci_turtlebot4_base_ground_sensor.h>
+#include <argos3/plugins/simulator/sensors/robot_sensors/sensor_update_period.h>
+#include <argos3/plugins/robots/turtlebot4/simulator/turtlebot4_sensor_profiler.h>
 #include <argos3/core/utility/math/range.h>
 #include <argos3/core/utility/math/rng.h>
 #include <argos3/core/simulator/space/space.h>
@@ -63,6 +65,12 @@ namespace argos {
 
       /** Reference to the space */
       CSpace& m_cSpace;
+
+      /** Limits how often the readings are computed */
+      CSensorUpdatePeriod m_cUpdatePeriod;
+
+      /** Measures the updates, if profiling is on */
+      CTurtlebot4SensorProfiler m_cProfiler;
    };
 
 }
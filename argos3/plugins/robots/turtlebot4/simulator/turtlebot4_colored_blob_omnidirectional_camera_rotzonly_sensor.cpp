@@ -120,12 +120,14 @@ namespace argos {
    /****************************************/
 
    CTurtlebot4ColoredBlobOmnidirectionalCameraRotZOnlySensor::CTurtlebot4ColoredBlobOmnidirectionalCameraRotZOnlySensor() :
+      CSensorRays("camera"),
       m_pcOmnicamEntity(nullptr),
       m_pcControllableEntity(nullptr),
       m_pcEmbodiedEntity(nullptr),
       m_pcLEDIndex(nullptr),
       m_pcEmbodiedIndex(nullptr),
-      m_bShowRays(false) {
+      m_bShowRays(false),
+      m_cProfiler("camera") {
    }
 
    /****************************************/
@@ -138,6 +140,7 @@ namespace argos {
    /****************************************/
 
    void CTurtlebot4ColoredBlobOmnidirectionalCameraRotZOnlySensor::SetRobot(CComposableEntity& c_entity) {
+      m_cProfiler.SetRobot(c_entity.GetId());
       /* Get omndirectional camera equipped entity */
       m_pcOmnicamEntity = &(c_entity.GetComponent<COmnidirectionalCameraEquippedEntity>("omnidirectional_camera"));
       /* Get controllable entity */
@@ -151,6 +154,10 @@ namespace argos {
 
    void CTurtlebot4ColoredBlobOmnidirectionalCameraRotZOnlySensor::Init(TConfigurationNode& t_tree) {
       try {
+         /* Parse the update period */
+         m_cUpdatePeriod.Init(t_tree);
+         /* Profile the updates? */
+         m_cProfiler.Init(t_tree);
          /* Parent class init */
          CCI_Turtlebot4ColoredBlobOmnidirectionalCameraSensor::Init(t_tree);
          /* Show rays? */
@@ -182,10 +189,18 @@ namespace argos {
    /****************************************/
 
    void CTurtlebot4ColoredBlobOmnidirectionalCameraRotZOnlySensor::Update() {
+      /* Measure the whole update */
+      CTurtlebot4SensorProfiler::CScope cProfile(m_cProfiler);
+      /* Remember which rays are from this sensor */
+      CSensorRays::CRecorder cRays(*this, *m_pcControllableEntity);
       /* sensor is disabled--nothing to do */
       if (IsDisabled()) {
         return;
       }
+      /* readings are not due yet--keep the last ones */
+      if(! m_cUpdatePeriod.IsDue()) {
+         return;
+      }
 
       /* Increase data counter */
       ++m_sReadings.Counter;
@@ -208,6 +223,7 @@ namespace argos {
    /****************************************/
 
    void CTurtlebot4ColoredBlobOmnidirectionalCameraRotZOnlySensor::Reset() {
+      m_cUpdatePeriod.Reset();
       m_sReadings.Counter = 0;
       m_sReadings.BlobList.clear();
    }
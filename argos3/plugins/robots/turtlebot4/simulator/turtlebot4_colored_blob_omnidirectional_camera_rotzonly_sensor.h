@@ -13,11 +13,15 @@ namespace argos {
 #include <argos3/core/simulator/space/space.h>
 #include <argos3/core/simulator/sensor.h>
 #include <argos3/plugins/robots/turtlebot4/control_interface/ci_turtlebot4_colored_blob_omnidirectional_camera_sensor.h>
+#include <argos3/plugins/simulator/sensors/robot_sensors/sensor_update_period.h>
+#include <argos3/plugins/robots/turtlebot4/simulator/turtlebot4_sensor_profiler.h>
+#include <argos3/plugins/simulator/visualizations/batch_rendering/sensor_rays.h>
 
 namespace argos {
 
   class CTurtlebot4ColoredBlobOmnidirectionalCameraRotZOnlySensor : public CCI_Turtlebot4ColoredBlobOmnidirectionalCameraSensor,
-                                                          public CSimulatedSensor {
+                                                          public CSimulatedSensor,
+                                                          public CSensorRays {
 
    public:
 
@@ -64,6 +68,12 @@ namespace argos {
       CTurtlebot4OmnidirectionalCameraLEDCheckOperation* m_pcOperation;
       bool                                     m_bShowRays;
 
+
+      /** Limits how often the readings are computed */
+      CSensorUpdatePeriod m_cUpdatePeriod;
+
+      /** Measures the updates, if profiling is on */
+      CTurtlebot4SensorProfiler m_cProfiler;
    };
 }
 
@@ -17,9 +17,116 @@
 #include <argos3/plugins/simulator/entities/omnidirectional_camera_equipped_entity.h>
 #include <argos3/plugins/simulator/entities/proximity_sensor_equipped_entity.h>
 #include <argos3/plugins/simulator/entities/battery_equipped_entity.h>
+#include <argos3/core/simulator/simulator.h>
+#include <initializer_list>
+#include <map>
+#include <set>
 
 namespace argos {
 
+   /****************************************/
+   /****************************************/
+
+   /*
+    * Tells which optional components a robot needs, looking at the <sensors>
+    * and <actuators> sections of its controller. When the devices can't be
+    * known in advance, everything is needed: this happens when the controller
+    * is not found and with Lua controllers, which may ask for any device at
+    * runtime.
+    */
+   class CTurtlebot4ComponentDemand {
+
+   public:
+
+      /**
+       * Returns the demand for the controller with the given id. The
+       * controller configuration is inspected only once per experiment, and
+       * the result is shared by all the robots with that controller.
+       */
+      static const CTurtlebot4ComponentDemand& Get(const std::string& str_controller_id) {
+         std::map<std::string, CTurtlebot4ComponentDemand>& mapDemands = GetCache();
+         auto it = mapDemands.find(str_controller_id);
+         if(it == mapDemands.end()) {
+            it = mapDemands.emplace(str_controller_id,
+                                    CTurtlebot4ComponentDemand(str_controller_id)).first;
+         }
+         return it->second;
+      }
+
+      /**
+       * Forgets the demands, so the next robot inspects the controller
+       * configuration again. The next experiment may reuse the controller
+       * ids with other devices.
+       */
+      static void Clear() {
+         GetCache().clear();
+      }
+
+      CTurtlebot4ComponentDemand(const std::string& str_controller_id) :
+         m_bAll(true) {
+         TConfigurationNode& tRoot = CSimulator::GetInstance().GetConfigurationRoot();
+         if(! NodeExists(tRoot, "controllers")) {
+            return;
+         }
+         TConfigurationNodeIterator itController;
+         for(itController = itController.begin(&GetNode(tRoot, "controllers"));
+             itController != itController.end();
+             ++itController) {
+            std::string strId;
+            GetNodeAttributeOrDefault(*itController, "id", strId, strId);
+            if(strId == str_controller_id) {
+               if(itController->Value() != "lua_controller") {
+                  m_bAll = false;
+                  AddDevices(*itController, "sensors");
+                  AddDevices(*itController, "actuators");
+               }
+               return;
+            }
+         }
+      }
+
+      /**
+       * Returns true if any of the given devices is used by the controller.
+       */
+      bool Needs(std::initializer_list<const char*> lst_devices) const {
+         if(m_bAll) {
+            return true;
+         }
+         for(const char* pchDevice : lst_devices) {
+            if(m_setDevices.count(pchDevice) > 0) {
+               return true;
+            }
+         }
+         return false;
+      }
+
+   private:
+
+      static std::map<std::string, CTurtlebot4ComponentDemand>& GetCache() {
+         static std::map<std::string, CTurtlebot4ComponentDemand> mapDemands;
+         return mapDemands;
+      }
+
+      void AddDevices(TConfigurationNode& t_controller,
+                      const std::string& str_section) {
+         if(NodeExists(t_controller, str_section)) {
+            TConfigurationNodeIterator itDevice;
+            for(itDevice = itDevice.begin(&GetNode(t_controller, str_section));
+                itDevice != itDevice.end();
+                ++itDevice) {
+               m_setDevices.insert(itDevice->Value());
+            }
+         }
+      }
+
+   private:
+
+      bool m_bAll;
+      std::set<std::string> m_setDevices;
+   };
+
+   /****************************************/
+   /****************************************/
 
    CTurtlebot4Entity::CTurtlebot4Entity() :
       CComposableEntity(nullptr),
@@ -27,9 +134,13 @@ namespace argos {
       m_pcEmbodiedEntity(nullptr),
       m_pcGroundSensorEquippedEntity(nullptr),
       m_pcLEDEquippedEntity(nullptr),
+      m_pcLightSensorEquippedEntity(nullptr),
       m_pcProximitySensorEquippedEntity(nullptr),
+      m_pcLIDARSensorEquippedEntity(nullptr),
       m_pcWheeledEntity(nullptr),
-      m_pcOmnidirectionalCameraEquippedEntity(nullptr)
+      m_pcOmnidirectionalCameraEquippedEntity(nullptr),
+      m_bReducedDynamics3DModel(false),
+      m_bSleepWhenIdle(false)
       // m_pcPerspectiveCameraEquippedEntity(NULL)
       {
    }
@@ -55,9 +166,13 @@ namespace argos {
       m_pcEmbodiedEntity(nullptr),
       m_pcGroundSensorEquippedEntity(nullptr),
       m_pcLEDEquippedEntity(nullptr),
+      m_pcLightSensorEquippedEntity(nullptr),
       m_pcProximitySensorEquippedEntity(nullptr),
+      m_pcLIDARSensorEquippedEntity(nullptr),
       m_pcWheeledEntity(nullptr),
-      m_pcOmnidirectionalCameraEquippedEntity(nullptr)
+      m_pcOmnidirectionalCameraEquippedEntity(nullptr),
+      m_bReducedDynamics3DModel(false),
+      m_bSleepWhenIdle(false)
       // m_pcPerspectiveCameraEquippedEntity(nullptr)
        {
       try {
@@ -67,100 +182,8 @@ namespace argos {
          /* Embodied entity */
          m_pcEmbodiedEntity = new CEmbodiedEntity(this, "body_0", c_position, c_orientation);
          AddComponent(*m_pcEmbodiedEntity);
-         /* Wheeled entity and wheel positions (left, right) */
-         m_pcWheeledEntity = new CWheeledEntity(this, "wheels_0", 2);
-         AddComponent(*m_pcWheeledEntity);
-         m_pcWheeledEntity->SetWheel(0, CVector3(0.0f,  TURTLEBOT4_HALF_WHEEL_DISTANCE, 0.0f), TURTLEBOT4_WHEEL_RADIUS);
-         m_pcWheeledEntity->SetWheel(1, CVector3(0.0f, -TURTLEBOT4_HALF_WHEEL_DISTANCE, 0.0f), TURTLEBOT4_WHEEL_RADIUS);
-
-         // /* LED equipped entity */
-         m_pcLEDEquippedEntity = new CLEDEquippedEntity(this, "leds_0");
-         AddComponent(*m_pcLEDEquippedEntity);
-         m_pcLEDEquippedEntity->AddLEDRing(
-            CVector3(0.0f, 0.0f, TURTLEBOT4_LED_RING_ELEVATION),
-            TURTLEBOT4_LED_RING_RADIUS,
-            TURTLEBOT4_LED_RING_START_ANGLE,
-            8,
-            m_pcEmbodiedEntity->GetOriginAnchor());
-
-         /* LIDAR sensor equipped entity */
-         m_pcLIDARSensorEquippedEntity =
-            new CProximitySensorEquippedEntity(this,
-                                               "lidar");
-         AddComponent(*m_pcLIDARSensorEquippedEntity);
-
-         /* Proximity sensor equipped entity */
-         m_pcProximitySensorEquippedEntity =
-            new CProximitySensorEquippedEntity(this,
-                                               "proximity");
-         AddComponent(*m_pcProximitySensorEquippedEntity);
-
-         CRadians sensor_angle[7] = {
-    -CRadians::PI / 2.75f,             // -65,3°
-    -CRadians::PI / 4.736f,             // -38°
-    -CRadians::PI / 9.0f,                   // -20° 
-    -CRadians::PI / 60.0f,              // -3°
-    CRadians::PI / 12.630f,              // +60°
-    CRadians::PI / 5.294f,              // +60°
-    CRadians::PI / 2.7565f             // +90° (rightmost)            // slight extra left bias if needed
-         };
-
-         CRadians cAngle;
-         CVector3 cOff, cDir, c_center = CVector3(0.0f, 0.0f, TURTLEBOT4_IR_SENSOR_RING_ELEVATION);
-         for(UInt32 i = 0; i < 7; ++i)
-         {
-            cAngle = sensor_angle[i];
-            cAngle.SignedNormalize();
-            cOff.Set(TURTLEBOT4_IR_SENSOR_RING_RADIUS, 0.0f, 0.0f);
-            cOff.RotateZ(cAngle);
-            cOff += c_center;
-            cDir.Set(TURTLEBOT4_IR_SENSOR_RING_RANGE, 0.0f, 0.0f);
-            cDir.RotateZ(cAngle);
-            m_pcProximitySensorEquippedEntity->AddSensor(cOff, cDir, TURTLEBOT4_IR_SENSOR_RING_RANGE, m_pcEmbodiedEntity->GetOriginAnchor());
-         }
-
-         /* Omnidirectional camera equipped entity */
-         m_pcOmnidirectionalCameraEquippedEntity =
-            new COmnidirectionalCameraEquippedEntity(this,
-                                                     "omnidirectional_camera_0",
-                                                     c_omnicam_aperture,
-                                                     CVector3(0.0f,
-                                                              0.0f,
-                                                              OMNIDIRECTIONAL_CAMERA_ELEVATION));
-         AddComponent(*m_pcOmnidirectionalCameraEquippedEntity);
-         
-         /* Perspective camera equipped entity */
-         // CQuaternion cPerspCamOrient(CRadians::PI_OVER_TWO, CVector3::Y);
-         // SAnchor& cPerspCamAnchor = m_pcEmbodiedEntity->AddAnchor("perspective_camera",
-         //                                                          CVector3(0.0, 0.0, 0.0),
-                                                                  // cPerspCamOrient);
-         // m_pcPerspectiveCameraEquippedEntity =
-         //    new CPerspectiveCameraEquippedEntity(this,
-         //                                         "perspective_camera_0",
-         //                                         c_perspcam_aperture,
-         //                                         f_perspcam_focal_length,
-         //                                         f_perspcam_range,
-         //                                         640, 480,
-         //                                         cPerspCamAnchor);
-         // AddComponent(*m_pcPerspectiveCameraEquippedEntity);
-
-         /* Ground sensor equipped entity */
-         m_pcGroundSensorEquippedEntity =
-            new CGroundSensorEquippedEntity(this, "ground_0");
-         AddComponent(*m_pcGroundSensorEquippedEntity);
-         m_pcGroundSensorEquippedEntity->AddSensor(CVector2(0.1425, 0.0268),
-            CGroundSensorEquippedEntity::TYPE_GRAYSCALE,
-            m_pcEmbodiedEntity->GetOriginAnchor());
-         m_pcGroundSensorEquippedEntity->AddSensor(CVector2(0.1425, -0.0268),
-            CGroundSensorEquippedEntity::TYPE_GRAYSCALE,
-            m_pcEmbodiedEntity->GetOriginAnchor());
-         m_pcGroundSensorEquippedEntity->AddSensor(CVector2(0.0879, 0.109),
-            CGroundSensorEquippedEntity::TYPE_GRAYSCALE,
-            m_pcEmbodiedEntity->GetOriginAnchor());
-         m_pcGroundSensorEquippedEntity->AddSensor(CVector2(0.0879, -0.109),
-            CGroundSensorEquippedEntity::TYPE_GRAYSCALE,
-            m_pcEmbodiedEntity->GetOriginAnchor());
-
+         /* Wheels, sensors and LEDs */
+         CreateComponents(str_controller_id, c_omnicam_aperture);
          /* Controllable entity
             It must be the last one, for actuators/sensors to link to composing entities correctly */
          m_pcControllableEntity = new CControllableEntity(this, "controller_0");
@@ -191,97 +214,156 @@ namespace argos {
          m_pcEmbodiedEntity = new CEmbodiedEntity(this);
          AddComponent(*m_pcEmbodiedEntity);
          m_pcEmbodiedEntity->Init(GetNode(t_tree, "body"));
-         
-         /* Wheeled entity and wheel positions (left, right) */
-         m_pcWheeledEntity = new CWheeledEntity(this, "wheels_0", 2);
-         AddComponent(*m_pcWheeledEntity);
-         m_pcWheeledEntity->SetWheel(0, CVector3(0.0f,  TURTLEBOT4_HALF_WHEEL_DISTANCE, 0.0f), TURTLEBOT4_WHEEL_RADIUS);
-         m_pcWheeledEntity->SetWheel(1, CVector3(0.0f, -TURTLEBOT4_HALF_WHEEL_DISTANCE, 0.0f), TURTLEBOT4_WHEEL_RADIUS);
-         /* LED equipped entity, with LEDs [0-11] and beacon [12] */
+         /* Wheels, sensors and LEDs */
+         std::string strControllerId;
+         GetNodeAttribute(GetNode(t_tree, "controller"), "config", strControllerId);
+         CDegrees cAperture(70.0f);
+         GetNodeAttributeOrDefault(t_tree, "omnidirectional_camera_aperture", cAperture, cAperture);
+         CreateComponents(strControllerId, ToRadians(cAperture));
+         /* Which body the dynamics3d engine builds for the robot */
+         m_bReducedDynamics3DModel = ParseDynamics3DModel(t_tree);
+         /* Whether the dynamics2d engine puts the idle body to sleep */
+         GetNodeAttributeOrDefault(t_tree, "sleep_when_idle", m_bSleepWhenIdle, m_bSleepWhenIdle);
+         /* Controllable entity
+            It must be the last one, for actuators/sensors to link to composing entities correctly */
+         m_pcControllableEntity = new CControllableEntity(this);
+         AddComponent(*m_pcControllableEntity);
+         m_pcControllableEntity->Init(GetNode(t_tree, "controller"));
+         /* Update components */
+         UpdateComponents();
+      }
+      catch(CARGoSException& ex) {
+         THROW_ARGOSEXCEPTION_NESTED("Failed to initialize entity \"" << GetId() << "\".", ex);
+      }
+   }
+
+   /****************************************/
+   /****************************************/
+
+   bool CTurtlebot4Entity::ParseDynamics3DModel(TConfigurationNode& t_tree) {
+      std::string strDynamics3DModel = "full";
+      GetNodeAttributeOrDefault(t_tree, "dynamics3d_model", strDynamics3DModel, strDynamics3DModel);
+      if(strDynamics3DModel == "reduced") {
+         return true;
+      }
+      else if(strDynamics3DModel != "full") {
+         THROW_ARGOSEXCEPTION("Unknown dynamics3d model \"" << strDynamics3DModel <<
+                              "\", use \"full\" or \"reduced\".");
+      }
+      return false;
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CTurtlebot4Entity::CreateComponents(const std::string& str_controller_id,
+                                            const CRadians& c_omnicam_aperture) {
+      /* Find out which components the controller needs */
+      const CTurtlebot4ComponentDemand& cDemand = CTurtlebot4ComponentDemand::Get(str_controller_id);
+      SAnchor& sOriginAnchor = m_pcEmbodiedEntity->GetOriginAnchor();
+      /* Wheeled entity and wheel positions (left, right) */
+      m_pcWheeledEntity = new CWheeledEntity(this, "wheels_0", 2);
+      AddComponent(*m_pcWheeledEntity);
+      m_pcWheeledEntity->SetWheel(0, CVector3(0.0f,  TURTLEBOT4_HALF_WHEEL_DISTANCE, 0.0f), TURTLEBOT4_WHEEL_RADIUS);
+      m_pcWheeledEntity->SetWheel(1, CVector3(0.0f, -TURTLEBOT4_HALF_WHEEL_DISTANCE, 0.0f), TURTLEBOT4_WHEEL_RADIUS);
+
+      /* LED equipped entity */
+      if(cDemand.Needs({ "leds" })) {
          m_pcLEDEquippedEntity = new CLEDEquippedEntity(this, "leds_0");
          AddComponent(*m_pcLEDEquippedEntity);
-         m_pcLEDEquippedEntity->AddLEDRing(
-            CVector3(0.0f, 0.0f, TURTLEBOT4_LED_RING_ELEVATION),
-            TURTLEBOT4_LED_RING_RADIUS,
-            TURTLEBOT4_LED_RING_START_ANGLE,
-            8,
-            m_pcEmbodiedEntity->GetOriginAnchor());
-         
-         /* LIDAR sensor equipped entity */
+         for(UInt32 i = 0; i < TURTLEBOT4_LED_RING_NUM_LEDS; ++i) {
+            m_pcLEDEquippedEntity->AddLED(
+               CVector3(TURTLEBOT4_LED_RING_RADIUS * TURTLEBOT4_LED_RING_LAYOUT[i][0],
+                        TURTLEBOT4_LED_RING_RADIUS * TURTLEBOT4_LED_RING_LAYOUT[i][1],
+                        TURTLEBOT4_LED_RING_ELEVATION),
+               sOriginAnchor);
+         }
+      }
+
+      /* LIDAR sensor equipped entity */
+      if(cDemand.Needs({ "turtlebot4_lidar" })) {
          m_pcLIDARSensorEquippedEntity =
             new CProximitySensorEquippedEntity(this,
                                                "lidar");
          AddComponent(*m_pcLIDARSensorEquippedEntity);
-         
-         /* Proximity sensor equipped entity */
+      }
+
+      /* Proximity sensor equipped entity */
+      if(cDemand.Needs({ "turtlebot4_proximity", "proximity" })) {
          m_pcProximitySensorEquippedEntity =
             new CProximitySensorEquippedEntity(this,
                                                "proximity");
          AddComponent(*m_pcProximitySensorEquippedEntity);
-
-
-	      CRadians sensor_angle[7] = {
-    -CRadians::PI / 2.75f,             // -65,3°
-    -CRadians::PI / 4.736f,             // -38°
-    -CRadians::PI / 9.0f,                   // -20° 
-    -CRadians::PI / 60.0f,              // -3°
-    CRadians::PI / 12.630f,              // +60°
-    CRadians::PI / 5.294f,              // +60°
-    CRadians::PI / 2.7565f             // +90° (rightmost)            // slight extra left bias if needed
-         };
-         CRadians cAngle;
-         CVector3 cOff, cDir, c_center = CVector3(0.0f, 0.0f, TURTLEBOT4_IR_SENSOR_RING_ELEVATION);
-         for(UInt32 i = 0; i < 7; ++i)
-         {
-            cAngle = sensor_angle[i];
-            cAngle.SignedNormalize();
-            cOff.Set(TURTLEBOT4_IR_SENSOR_RING_RADIUS, 0.0f, 0.0f);
-            cOff.RotateZ(cAngle);
-            cOff += c_center;
-            cDir.Set(TURTLEBOT4_IR_SENSOR_RING_RANGE, 0.0f, 0.0f);
-            cDir.RotateZ(cAngle);
-            m_pcProximitySensorEquippedEntity->AddSensor(cOff, cDir, TURTLEBOT4_IR_SENSOR_RING_RANGE, m_pcEmbodiedEntity->GetOriginAnchor());
+         for(UInt32 i = 0; i < TURTLEBOT4_IR_SENSOR_RING_NUM_SENSORS; ++i) {
+            Real fCos = TURTLEBOT4_IR_SENSOR_RING_LAYOUT[i][1];
+            Real fSin = TURTLEBOT4_IR_SENSOR_RING_LAYOUT[i][2];
+            m_pcProximitySensorEquippedEntity->AddSensor(
+               CVector3(TURTLEBOT4_IR_SENSOR_RING_RADIUS * fCos,
+                        TURTLEBOT4_IR_SENSOR_RING_RADIUS * fSin,
+                        TURTLEBOT4_IR_SENSOR_RING_ELEVATION),
+               CVector3(TURTLEBOT4_IR_SENSOR_RING_RANGE * fCos,
+                        TURTLEBOT4_IR_SENSOR_RING_RANGE * fSin,
+                        0.0f),
+               TURTLEBOT4_IR_SENSOR_RING_RANGE,
+               sOriginAnchor);
          }
+      }
 
-         /* Omnidirectional camera equipped entity */
-         CDegrees cAperture(70.0f);
-         GetNodeAttributeOrDefault(t_tree, "omnidirectional_camera_aperture", cAperture, cAperture);
+      /* Light sensor equipped entity */
+      if(cDemand.Needs({ "turtlebot4_light", "light" })) {
+         m_pcLightSensorEquippedEntity =
+            new CLightSensorEquippedEntity(this,
+                                           "light_0");
+         AddComponent(*m_pcLightSensorEquippedEntity);
+         m_pcLightSensorEquippedEntity->AddSensorRing(
+            CVector3(0.0f, 0.0f, TURTLEBOT4_LIGHT_SENSOR_RING_ELEVATION),
+            TURTLEBOT4_LIGHT_SENSOR_RING_RADIUS,
+            TURTLEBOT4_LIGHT_SENSOR_RING_START_ANGLE,
+            TURTLEBOT4_LIGHT_SENSOR_RING_RANGE,
+            TURTLEBOT4_LIGHT_SENSOR_RING_NUM_SENSORS,
+            sOriginAnchor);
+      }
+
+      /* Omnidirectional camera equipped entity */
+      if(cDemand.Needs({ "turtlebot4_colored_blob_omnidirectional_camera",
+                         "colored_blob_omnidirectional_camera" })) {
          m_pcOmnidirectionalCameraEquippedEntity =
             new COmnidirectionalCameraEquippedEntity(this,
                                                      "omnidirectional_camera_0",
-                                                     ToRadians(cAperture),
+                                                     c_omnicam_aperture,
                                                      CVector3(0.0f,
                                                               0.0f,
                                                               OMNIDIRECTIONAL_CAMERA_ELEVATION));
          AddComponent(*m_pcOmnidirectionalCameraEquippedEntity);
+      }
 
-         /* Ground sensor equipped entity */
+      /* Perspective camera equipped entity */
+      // CQuaternion cPerspCamOrient(CRadians::PI_OVER_TWO, CVector3::Y);
+      // SAnchor& cPerspCamAnchor = m_pcEmbodiedEntity->AddAnchor("perspective_camera",
+      //                                                          CVector3(0.0, 0.0, 0.0),
+      //                                                          cPerspCamOrient);
+      // m_pcPerspectiveCameraEquippedEntity =
+      //    new CPerspectiveCameraEquippedEntity(this,
+      //                                         "perspective_camera_0",
+      //                                         c_perspcam_aperture,
+      //                                         f_perspcam_focal_length,
+      //                                         f_perspcam_range,
+      //                                         640, 480,
+      //                                         cPerspCamAnchor);
+      // AddComponent(*m_pcPerspectiveCameraEquippedEntity);
+
+      /* Ground sensor equipped entity */
+      if(cDemand.Needs({ "turtlebot4_ground", "ground" })) {
          m_pcGroundSensorEquippedEntity =
             new CGroundSensorEquippedEntity(this, "ground_0");
          AddComponent(*m_pcGroundSensorEquippedEntity);
-         m_pcGroundSensorEquippedEntity->AddSensor(CVector2(0.1425, 0.0268),
-            CGroundSensorEquippedEntity::TYPE_GRAYSCALE,
-            m_pcEmbodiedEntity->GetOriginAnchor());
-         m_pcGroundSensorEquippedEntity->AddSensor(CVector2(0.1425, -0.0268),
-            CGroundSensorEquippedEntity::TYPE_GRAYSCALE,
-            m_pcEmbodiedEntity->GetOriginAnchor());
-         m_pcGroundSensorEquippedEntity->AddSensor(CVector2(0.0879, 0.109),
-            CGroundSensorEquippedEntity::TYPE_GRAYSCALE,
-            m_pcEmbodiedEntity->GetOriginAnchor());
-         m_pcGroundSensorEquippedEntity->AddSensor(CVector2(0.0879, -0.109),
-            CGroundSensorEquippedEntity::TYPE_GRAYSCALE,
-            m_pcEmbodiedEntity->GetOriginAnchor());
-         
-         /* Controllable entity
-            It must be the last one, for actuators/sensors to link to composing entities correctly */
-         m_pcControllableEntity = new CControllableEntity(this);
-         AddComponent(*m_pcControllableEntity);
-         m_pcControllableEntity->Init(GetNode(t_tree, "controller"));
-         /* Update components */
-         UpdateComponents();
-      }
-      catch(CARGoSException& ex) {
-         THROW_ARGOSEXCEPTION_NESTED("Failed to initialize entity \"" << GetId() << "\".", ex);
+         for(UInt32 i = 0; i < TURTLEBOT4_GROUND_SENSOR_NUM_SENSORS; ++i) {
+            m_pcGroundSensorEquippedEntity->AddSensor(
+               CVector2(TURTLEBOT4_GROUND_SENSOR_LAYOUT[i][0],
+                        TURTLEBOT4_GROUND_SENSOR_LAYOUT[i][1]),
+               CGroundSensorEquippedEntity::TYPE_GRAYSCALE,
+               sOriginAnchor);
+         }
       }
    }
 
@@ -300,16 +382,27 @@ namespace argos {
 
    void CTurtlebot4Entity::Destroy() {
       CComposableEntity::Destroy();
+      /* The demands belong to the configuration of this experiment */
+      CTurtlebot4ComponentDemand::Clear();
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CTurtlebot4Entity::ThrowMissingComponent(const std::string& str_device) const {
+      THROW_ARGOSEXCEPTION("The Turtlebot4 \"" << GetId() << "\" has no component for the " << str_device <<
+                           " (its controller does not declare the device).");
    }
 
    /****************************************/
    /****************************************/
 
-#define UPDATE(COMPONENT) if(COMPONENT->IsEnabled()) COMPONENT->Update();
+#define UPDATE(COMPONENT) if(COMPONENT != nullptr && COMPONENT->IsEnabled()) COMPONENT->Update();
 
    void CTurtlebot4Entity::UpdateComponents() {
       UPDATE(m_pcLEDEquippedEntity);
       UPDATE(m_pcGroundSensorEquippedEntity);
+      UPDATE(m_pcLightSensorEquippedEntity);
       // UPDATE(m_pcPerspectiveCameraEquippedEntity)
    }
 
@@ -351,7 +444,10 @@ namespace argos {
                    "is oriented along the X axis.\n"
                    "The 'controller/config' attribute is used to assign a controller to the\n"
                    "turtlebot4. The value of the attribute must be set to the id of a previously\n"
-                   "defined controller. Controllers are defined in the <controllers> XML subtree.\n\n"
+                   "defined controller. Controllers are defined in the <controllers> XML subtree.\n"
+                   "Only the components needed by the sensors and actuators listed in the\n"
+                   "controller configuration are created. With Lua controllers, which can ask for\n"
+                   "any device at runtime, all the components are created.\n\n"
                    "OPTIONAL XML CONFIGURATION\n\n"
                    "You can set the emission range of the range-and-bearing system. By default, a\n"
                    "message sent by an turtlebot4 can be received up to 80cm. By using the 'rab_range'\n"
@@ -412,6 +508,38 @@ namespace argos {
                    "    </turtlebot4>\n"
                    "    ...\n"
                    "  </arena>\n\n"
+                   "With the dynamics3d engine, the robot is by default made of a body and two\n"
+                   "wheels driven by joint motors. Setting 'dynamics3d_model' to 'reduced' replaces\n"
+                   "them with a single cylinder whose velocity is set from the wheel speeds at\n"
+                   "each step. This is about three times cheaper for the solver and is meant for\n"
+                   "large swarms on flat ground:\n\n"
+                   "  <arena ...>\n"
+                   "    ...\n"
+                   "    <turtlebot4 id=\"eb0\" dynamics3d_model=\"reduced\">\n"
+                   "      <body position=\"0.4,2.3,0\" orientation=\"45,0,0\" />\n"
+                   "      <controller config=\"mycntrl\" />\n"
+                   "    </turtlebot4>\n"
+                   "    ...\n"
+                   "  </arena>\n\n"
+                   "With the dynamics2d engine, setting 'sleep_when_idle' to 'true' puts the body\n"
+                   "to sleep when the wheels have been stopped for 10 steps and the robot is at\n"
+                   "rest. A sleeping body is skipped by the engine until a wheel command or a\n"
+                   "contact wakes it up. The default is 'false'. Sleeping must also be enabled in\n"
+                   "the physics space, which the robot does not do by itself because it affects\n"
+                   "every body in the engine. Enable it once, e.g., in the Init() of the loop\n"
+                   "functions:\n\n"
+                   "    CDynamics2DEngine& cEngine =\n"
+                   "       dynamic_cast<CDynamics2DEngine&>(GetSimulator().GetPhysicsEngine(\"dyn2d\"));\n"
+                   "    cpSpaceSetSleepTimeThreshold(cEngine.GetPhysicsSpace(), 1.0);\n\n"
+                   "Without it, the option has no effect and a warning is printed.\n\n"
+                   "  <arena ...>\n"
+                   "    ...\n"
+                   "    <turtlebot4 id=\"eb0\" sleep_when_idle=\"true\">\n"
+                   "      <body position=\"0.4,2.3,0\" orientation=\"45,0,0\" />\n"
+                   "      <controller config=\"mycntrl\" />\n"
+                   "    </turtlebot4>\n"
+                   "    ...\n"
+                   "  </arena>\n\n"
                    "Finally, you can change the parameters of the camera. You can set its aperture,\n"
                    "focal length, and range with the attributes 'camera_aperture',\n"
                    "'camera_focal_length', and 'camera_range', respectively. The default values are:\n"
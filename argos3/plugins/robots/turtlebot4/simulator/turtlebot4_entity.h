@@ -13,7 +13,7 @@ namespace argos {
    class CTurtlebot4Entity;
    class CGroundSensorEquippedEntity;
    class CLEDEquippedEntity;
-   // class CLightSensorEquippedEntity;
+   class CLightSensorEquippedEntity;
    // class CPerspectiveCameraEquippedEntity;
    class COmnidirectionalCameraEquippedEntity;
    class CProximitySensorEquippedEntity;
@@ -56,6 +56,13 @@ namespace argos {
       virtual void Destroy();
 
       virtual void UpdateComponents();
+
+      /*
+       * The body, wheels and controller are always present. The other
+       * components are created only if the controller uses a device that
+       * needs them: check with the Has*() methods, as their getters throw
+       * a CARGoSException naming the missing device.
+       */
       
       inline CControllableEntity& GetControllableEntity() {
          return *m_pcControllableEntity;
@@ -65,27 +72,69 @@ namespace argos {
          return *m_pcEmbodiedEntity;
       }
 
+      inline bool HasGroundSensorEquippedEntity() const {
+         return m_pcGroundSensorEquippedEntity != nullptr;
+      }
+
       inline CGroundSensorEquippedEntity& GetGroundSensorEquippedEntity() {
+         if(m_pcGroundSensorEquippedEntity == nullptr) {
+            ThrowMissingComponent("ground sensors");
+         }
          return *m_pcGroundSensorEquippedEntity;
       }
 
+      inline bool HasLEDEquippedEntity() const {
+         return m_pcLEDEquippedEntity != nullptr;
+      }
+
       inline CLEDEquippedEntity& GetLEDEquippedEntity() {
+         if(m_pcLEDEquippedEntity == nullptr) {
+            ThrowMissingComponent("LEDs");
+         }
          return *m_pcLEDEquippedEntity;
       }
 
-      // inline CLightSensorEquippedEntity& GetLightSensorEquippedEntity() {
-      //    return *m_pcLightSensorEquippedEntity;
-      // }
+      inline bool HasLightSensorEquippedEntity() const {
+         return m_pcLightSensorEquippedEntity != nullptr;
+      }
+
+      inline CLightSensorEquippedEntity& GetLightSensorEquippedEntity() {
+         if(m_pcLightSensorEquippedEntity == nullptr) {
+            ThrowMissingComponent("light sensors");
+         }
+         return *m_pcLightSensorEquippedEntity;
+      }
+
+      inline bool HasOmnidirectionalCameraEquippedEntity() const {
+         return m_pcOmnidirectionalCameraEquippedEntity != nullptr;
+      }
 
       inline COmnidirectionalCameraEquippedEntity& GetOmnidirectionalCameraEquippedEntity() {
+         if(m_pcOmnidirectionalCameraEquippedEntity == nullptr) {
+            ThrowMissingComponent("omnidirectional camera");
+         }
          return *m_pcOmnidirectionalCameraEquippedEntity;
       }
 
+      inline bool HasLidarSensorEquippedEntity() const {
+         return m_pcLIDARSensorEquippedEntity != nullptr;
+      }
+
       inline CProximitySensorEquippedEntity& GetLidarSensorEquippedEntity() {
+         if(m_pcLIDARSensorEquippedEntity == nullptr) {
+            ThrowMissingComponent("LIDAR");
+         }
          return *m_pcLIDARSensorEquippedEntity;
       }
 
+      inline bool HasProximitySensorEquippedEntity() const {
+         return m_pcProximitySensorEquippedEntity != nullptr;
+      }
+
       inline CProximitySensorEquippedEntity& GetProximitySensorEquippedEntity() {
+         if(m_pcProximitySensorEquippedEntity == nullptr) {
+            ThrowMissingComponent("proximity sensors");
+         }
          return *m_pcProximitySensorEquippedEntity;
       }
 
@@ -105,21 +154,66 @@ namespace argos {
          return "turtlebot4";
       }
 
+      /*
+       * Whether the dynamics3d engine models the robot as a single
+       * velocity-driven cylinder instead of a body with two wheels.
+       * Set it before adding the robot to the space.
+       */
+      inline bool IsReducedDynamics3DModel() const {
+         return m_bReducedDynamics3DModel;
+      }
+
+      inline void SetReducedDynamics3DModel(bool b_reduced) {
+         m_bReducedDynamics3DModel = b_reduced;
+      }
+
+      /*
+       * Parses the optional 'dynamics3d_model' attribute, "full" or
+       * "reduced", of a <turtlebot4> node. Returns true for "reduced".
+       */
+      static bool ParseDynamics3DModel(TConfigurationNode& t_tree);
+
+      /*
+       * Whether the dynamics2d engine puts the body to sleep when the robot
+       * stays still. Set it before adding the robot to the space.
+       */
+      inline bool IsSleepWhenIdle() const {
+         return m_bSleepWhenIdle;
+      }
+
+      inline void SetSleepWhenIdle(bool b_sleep_when_idle) {
+         m_bSleepWhenIdle = b_sleep_when_idle;
+      }
+
       // inline CQuadRotorEntity& GetQuadRotorEntity() {
       //    return *m_pcQuadRotorEntity;
       // }
 
    private:
 
+      /*
+       * Creates the wheels, sensors and LEDs. Both the XML and the
+       * programmatic creation use it, so the two produce the same robot.
+       * The embodied entity must exist already.
+       */
+      void CreateComponents(const std::string& str_controller_id,
+                            const CRadians& c_omnicam_aperture);
+
       void SetLEDPosition();
 
+      /*
+       * Throws a CARGoSException telling that the robot has no component
+       * for the given device.
+       */
+      void ThrowMissingComponent(const std::string& str_device) const;
+
    private:
 
       CControllableEntity*                   m_pcControllableEntity;
       CEmbodiedEntity*                       m_pcEmbodiedEntity;
       CGroundSensorEquippedEntity*           m_pcGroundSensorEquippedEntity;
       CLEDEquippedEntity*                    m_pcLEDEquippedEntity;
-      // CLightSensorEquippedEntity*            m_pcLightSensorEquippedEntity;
+      CLightSensorEquippedEntity*            m_pcLightSensorEquippedEntity;
       CProximitySensorEquippedEntity*        m_pcProximitySensorEquippedEntity;
       CProximitySensorEquippedEntity*        m_pcLIDARSensorEquippedEntity;
       // CRABEquippedEntity*                    m_pcRABEquippedEntity;
@@ -128,6 +222,8 @@ namespace argos {
       // CQuadRotorEntity*                      m_pcQuadRotorEntity;
       // CPerspectiveCameraEquippedEntity*      m_pcPerspectiveCameraEquippedEntity;
       COmnidirectionalCameraEquippedEntity*  m_pcOmnidirectionalCameraEquippedEntity;
+      bool                                   m_bReducedDynamics3DModel;
+      bool                                   m_bSleepWhenIdle;
    };
 
 }
@@ -8,6 +8,7 @@
 #include <argos3/core/simulator/entity/composable_entity.h>
 #include <argos3/core/simulator/simulator.h>
 #include <argos3/plugins/simulator/entities/proximity_sensor_equipped_entity.h>
+#include <argos3/plugins/simulator/sensors/robot_sensors/lidar_geometry.h>
 
 #include "turtlebot4_lidar_default_sensor.h"
 #include "turtlebot4_measures.h"
@@ -44,6 +45,7 @@ namespace argos {
    /****************************************/
 
    CTurtlebot4LIDARDefaultSensor::CTurtlebot4LIDARDefaultSensor() :
+      CSensorRays("lidar"),
       m_pnReadings(NULL),
       m_unNumReadings(1800),
       m_unPowerLaserState(TURTLEBOT4_POWERON_LASERON),
@@ -51,7 +53,9 @@ namespace argos {
       m_bShowRays(false),
       m_pcRNG(NULL),
       m_bAddNoise(false),
-      m_cSpace(CSimulator::GetInstance().GetSpace()) {}
+      m_cSpace(CSimulator::GetInstance().GetSpace()),
+      m_psGeometry(NULL),
+      m_cProfiler("lidar") {}
 
    /****************************************/
    /****************************************/
@@ -63,6 +67,7 @@ namespace argos {
    /****************************************/
 
    void CTurtlebot4LIDARDefaultSensor::SetRobot(CComposableEntity& c_entity) {
+      m_cProfiler.SetRobot(c_entity.GetId());
       try {
          m_pcEmbodiedEntity = &(c_entity.GetComponent<CEmbodiedEntity>("body"));
          m_pcControllableEntity = &(c_entity.GetComponent<CControllableEntity>("controller"));
@@ -80,16 +85,19 @@ namespace argos {
    void CTurtlebot4LIDARDefaultSensor::Init(TConfigurationNode& t_tree) {
       try {
          CCI_Turtlebot4LIDARSensor::Init(t_tree);
+         /* Parse the update period */
+         m_cUpdatePeriod.Init(t_tree);
+         /* Profile the updates? */
+         m_cProfiler.Init(t_tree);
          /* How many readings? */
          GetNodeAttributeOrDefault(t_tree, "num_readings", m_unNumReadings, m_unNumReadings);
-         m_pcProximityEntity->AddSensorFan(
-            CVector3(0.0, 0.0, TURTLEBOT4_LIDAR_ELEVATION),
-            TURTLEBOT4_LIDAR_SENSORS_FAN_RADIUS + TURTLEBOT4_LIDAR_SENSORS_RING_RANGE.GetMin(),
-            -TURTLEBOT4_LIDAR_ANGLE_SPAN * 0.5,
-            TURTLEBOT4_LIDAR_ANGLE_SPAN * 0.5,
-            TURTLEBOT4_LIDAR_SENSORS_FAN_RADIUS + TURTLEBOT4_LIDAR_SENSORS_RING_RANGE.GetMax(),
-            m_unNumReadings,
-            m_pcEmbodiedEntity->GetOriginAnchor());
+         /* The ray geometry is shared, only the anchor is per robot */
+         m_psGeometry = &CLIDARGeometryCache::Get("turtlebot4",
+                                                  TURTLEBOT4_LIDAR_ELEVATION,
+                                                  TURTLEBOT4_LIDAR_SENSORS_FAN_RADIUS,
+                                                  TURTLEBOT4_LIDAR_SENSORS_RING_RANGE,
+                                                  TURTLEBOT4_LIDAR_ANGLE_SPAN,
+                                                  m_unNumReadings);
          m_pnReadings = new long[m_unNumReadings];
          /* Show rays? */
          GetNodeAttributeOrDefault(t_tree, "show_rays", m_bShowRays, m_bShowRays);
@@ -114,24 +122,33 @@ namespace argos {
    /****************************************/
 
    void CTurtlebot4LIDARDefaultSensor::Update() {
+      /* Measure the whole update */
+      CTurtlebot4SensorProfiler::CScope cProfile(m_cProfiler);
+      /* Remember which rays are from this sensor */
+      CSensorRays::CRecorder cRays(*this, *m_pcControllableEntity);
       /* Nothing to do if sensor is deactivated */
       if(m_unPowerLaserState != TURTLEBOT4_POWERON_LASERON)
          return;
+      /* readings are not due yet--keep the last ones */
+      if(! m_cUpdatePeriod.IsDue()) {
+         return;
+      }
       /* Ray used for scanning the environment for obstacles */
       CRay3 cScanningRay;
       CVector3 cRayStart, cRayEnd;
       /* Buffers to contain data about the intersection */
       SEmbodiedEntityIntersectionItem sIntersection;
+      /* All the rays are attached to the robot origin */
+      const SAnchor& sAnchor = m_pcEmbodiedEntity->GetOriginAnchor();
       /* Go through the sensors */
       for(UInt32 i = 0; i < m_unNumReadings; ++i) {
          /* Compute ray for sensor i */
-         cRayStart = m_pcProximityEntity->GetSensor(i).Offset;
-         cRayStart.Rotate(m_pcProximityEntity->GetSensor(i).Anchor.Orientation);
-         cRayStart += m_pcProximityEntity->GetSensor(i).Anchor.Position;
-         cRayEnd = m_pcProximityEntity->GetSensor(i).Offset;
-         cRayEnd += m_pcProximityEntity->GetSensor(i).Direction;
-         cRayEnd.Rotate(m_pcProximityEntity->GetSensor(i).Anchor.Orientation);
-         cRayEnd += m_pcProximityEntity->GetSensor(i).Anchor.Position;
+         cRayStart = m_psGeometry->RayStarts[i];
+         cRayStart.Rotate(sAnchor.Orientation);
+         cRayStart += sAnchor.Position;
+         cRayEnd = m_psGeometry->RayEnds[i];
+         cRayEnd.Rotate(sAnchor.Orientation);
+         cRayEnd += sAnchor.Position;
          cScanningRay.Set(cRayStart,cRayEnd);
          /* Compute reading */
          /* Get the closest intersection */
@@ -165,6 +182,7 @@ namespace argos {
    /****************************************/
 
    void CTurtlebot4LIDARDefaultSensor::Reset() {
+      m_cUpdatePeriod.Reset();
       memset(m_pnReadings, 0, m_unNumReadings * sizeof(long int));
    }
 
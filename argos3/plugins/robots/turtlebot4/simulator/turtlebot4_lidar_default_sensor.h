@@ -12,15 +12,20 @@
 
 namespace argos {
    class CTurtlebot4LIDARDefaultSensor;
+   struct SLIDARGeometry;
 }
 
 #include <argos3/plugins/robots/turtlebot4/control_interface/ci_turtlebot4_lidar_sensor.h>
+#include <argos3/plugins/simulator/sensors/robot_sensors/sensor_update_period.h>
+#include <argos3/plugins/robots/turtlebot4/simulator/turtlebot4_sensor_profiler.h>
 #include <argos3/plugins/robots/generic/simulator/proximity_default_sensor.h>
+#include <argos3/plugins/simulator/visualizations/batch_rendering/sensor_rays.h>
 
 namespace argos {
 
    class CTurtlebot4LIDARDefaultSensor : public CCI_Turtlebot4LIDARSensor,
-                                        public CSimulatedSensor {
+                                        public CSimulatedSensor,
+                                        public CSensorRays {
 
    public:
 
@@ -84,6 +89,15 @@ namespace argos {
 
       /** Reference to the space */
       CSpace& m_cSpace;
+
+      /** Limits how often the readings are computed */
+      CSensorUpdatePeriod m_cUpdatePeriod;
+
+      /** Ray geometry, shared by all the LIDARs with the same number of readings */
+      const SLIDARGeometry* m_psGeometry;
+
+      /** Measures the updates, if profiling is on */
+      CTurtlebot4SensorProfiler m_cProfiler;
    };
 
 }
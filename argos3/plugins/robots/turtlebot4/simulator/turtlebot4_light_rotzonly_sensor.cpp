@@ -0,0 +1,307 @@
+/**
+ * @file <argos3/plugins/robots/turtlebot4/simulator/turtlebot4_light_rotzonly_sensor.cpp>
+ *
+ * @author Jyotsna Bellary <jyotsnabellary@gmail.com>
+ */
+
+#include <argos3/core/simulator/simulator.h>
+#include <argos3/core/simulator/entity/embodied_entity.h>
+#include <argos3/core/simulator/entity/composable_entity.h>
+#include <argos3/plugins/simulator/entities/light_entity.h>
+#include <argos3/plugins/simulator/entities/light_sensor_equipped_entity.h>
+
+#include "turtlebot4_light_rotzonly_sensor.h"
+
+#include <cmath>
+
+namespace argos {
+
+   /****************************************/
+   /****************************************/
+
+   static CRange<Real> SENSOR_RANGE(0.0f, 1.0f);
+
+   /****************************************/
+   /****************************************/
+
+   static Real ComputeReading(Real f_distance) {
+      if(f_distance > 2.5f) {
+         return 0.0f;
+      }
+      else {
+         return ::exp(-f_distance * 2.0f);
+      }
+   }
+
+   /****************************************/
+   /****************************************/
+
+   /*
+    * Adds the contribution of one light to all the sensors at once.
+    * For each sensor, the angular distance between the light and the sensor is
+    * wrapped into [-PI,PI] arithmetically, and the reading decreases linearly
+    * from f_reading (distance 0) to 0 (distance PI/2). The loop has no
+    * branches and no cross-iteration dependencies, so the compiler can
+    * vectorize it.
+    */
+   static void AccumulateLight(const Real* pf_sensor_angles,
+                               Real* pf_accumulator,
+                               size_t un_num_sensors,
+                               Real f_light_angle,
+                               Real f_reading) {
+      const Real fTwoPi     = CRadians::TWO_PI.GetValue();
+      const Real fInvTwoPi  = 1.0 / fTwoPi;
+      const Real fTwoOverPi = 2.0 / CRadians::PI.GetValue();
+      for(size_t i = 0; i < un_num_sensors; ++i) {
+         Real fDiff = f_light_angle - pf_sensor_angles[i];
+         fDiff -= fTwoPi * std::floor(fDiff * fInvTwoPi + 0.5);
+         Real fWeight = 1.0 - std::fabs(fDiff) * fTwoOverPi;
+         pf_accumulator[i] += f_reading * (fWeight > 0.0 ? fWeight : 0.0);
+      }
+   }
+
+   /****************************************/
+   /****************************************/
+
+   CTurtlebot4LightRotZOnlySensor::CTurtlebot4LightRotZOnlySensor() :
+      CSensorRays("light"),
+      m_pcEmbodiedEntity(nullptr),
+      m_pcLightEntity(nullptr),
+      m_pcControllableEntity(nullptr),
+      m_bShowRays(false),
+      m_pcRNG(nullptr),
+      m_bAddNoise(false),
+      m_cSpace(CSimulator::GetInstance().GetSpace()),
+      m_cProfiler("light") {}
+
+   /****************************************/
+   /****************************************/
+
+   void CTurtlebot4LightRotZOnlySensor::SetRobot(CComposableEntity& c_entity) {
+      m_cProfiler.SetRobot(c_entity.GetId());
+      try {
+         m_pcEmbodiedEntity = &(c_entity.GetComponent<CEmbodiedEntity>("body"));
+         m_pcControllableEntity = &(c_entity.GetComponent<CControllableEntity>("controller"));
+         m_pcLightEntity = &(c_entity.GetComponent<CLightSensorEquippedEntity>("light_sensors"));
+         m_pcLightEntity->Enable();
+
+         /* sensor is enabled by default */
+         Enable();
+      }
+      catch(CARGoSException& ex) {
+         THROW_ARGOSEXCEPTION_NESTED("Can't set robot for the turtlebot4 light rot_z_only sensor", ex);
+      }
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CTurtlebot4LightRotZOnlySensor::Init(TConfigurationNode& t_tree) {
+      try {
+         /* Parse the update period */
+         m_cUpdatePeriod.Init(t_tree);
+         /* Profile the updates? */
+         m_cProfiler.Init(t_tree);
+         /* Show rays? */
+         GetNodeAttributeOrDefault(t_tree, "show_rays", m_bShowRays, m_bShowRays);
+         /* Parse noise level */
+         Real fNoiseLevel = 0.0f;
+         GetNodeAttributeOrDefault(t_tree, "noise_level", fNoiseLevel, fNoiseLevel);
+         if(fNoiseLevel < 0.0f) {
+            THROW_ARGOSEXCEPTION("Can't specify a negative value for the noise level of the light sensor");
+         }
+         else if(fNoiseLevel > 0.0f) {
+            m_bAddNoise = true;
+            m_cNoiseRange.Set(-fNoiseLevel, fNoiseLevel);
+            m_pcRNG = CRandom::CreateRNG("argos");
+         }
+         /* The control interface and the entity must agree on the sensor layout */
+         if(m_pcLightEntity->GetNumSensors() != m_tReadings.size()) {
+            THROW_ARGOSEXCEPTION("The turtlebot4 light sensor expects " << m_tReadings.size() <<
+                                 " sensors, but the entity has " << m_pcLightEntity->GetNumSensors());
+         }
+         m_vecSensorAngles.resize(m_tReadings.size());
+         m_vecAccumulator.resize(m_tReadings.size());
+         for(size_t i = 0; i < m_tReadings.size(); ++i) {
+            m_vecSensorAngles[i] = m_tReadings[i].Angle.GetValue();
+         }
+      }
+      catch(CARGoSException& ex) {
+         THROW_ARGOSEXCEPTION_NESTED("Initialization error in turtlebot4 rot_z_only light sensor", ex);
+      }
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CTurtlebot4LightRotZOnlySensor::Update() {
+      /* Measure the whole update */
+      CTurtlebot4SensorProfiler::CScope cProfile(m_cProfiler);
+      /* Remember which rays are from this sensor */
+      CSensorRays::CRecorder cRays(*this, *m_pcControllableEntity);
+      /* sensor is disabled--nothing to do */
+      if (IsDisabled()) {
+        return;
+      }
+      /* readings are not due yet--keep the last ones */
+      if(! m_cUpdatePeriod.IsDue()) {
+         return;
+      }
+      /* Erase readings */
+      std::fill(m_vecAccumulator.begin(), m_vecAccumulator.end(), 0.0f);
+      /* Get turtlebot4 orientation */
+      CRadians cTmp1, cTmp2, cOrientationZ;
+      m_pcEmbodiedEntity->GetOriginAnchor().Orientation.ToEulerAngles(cOrientationZ, cTmp1, cTmp2);
+      /* Ray used for scanning the environment for obstacles */
+      CRay3 cOcclusionCheckRay;
+      cOcclusionCheckRay.SetStart(m_pcEmbodiedEntity->GetOriginAnchor().Position);
+      CVector3 cRobotToLight;
+      /* Buffers to contain data about the intersection */
+      SEmbodiedEntityIntersectionItem sIntersection;
+      /* List of light entities */
+      CSpace::TMapPerType& mapLights = m_cSpace.GetEntitiesByType("light");
+      /*
+       * 1. go through the list of light entities in the scene
+       * 2. check if a light is occluded
+       * 3. if it isn't, add its contribution to all the sensors at once
+       *    NOTE: the readings are additive
+       * 4. go through the sensors and clamp their values
+       */
+      for(auto it = mapLights.begin();
+          it != mapLights.end();
+          ++it) {
+         /* Get a reference to the light */
+         CLightEntity& cLight = *(any_cast<CLightEntity*>(it->second));
+         /* Consider the light only if it has non zero intensity */
+         if(cLight.GetIntensity() > 0.0f) {
+            /* Set the ray end */
+            cOcclusionCheckRay.SetEnd(cLight.GetPosition());
+            /* Check occlusion between the turtlebot4 and the light */
+            if(! GetClosestEmbodiedEntityIntersectedByRay(sIntersection,
+                                                          cOcclusionCheckRay,
+                                                          *m_pcEmbodiedEntity)) {
+               /* The light is not occluded */
+               if(m_bShowRays) {
+                  m_pcControllableEntity->AddCheckedRay(false, cOcclusionCheckRay);
+               }
+               /* Get the distance between the light and the turtlebot4 */
+               cOcclusionCheckRay.ToVector(cRobotToLight);
+               /*
+                * Linearly scale the distance with the light intensity
+                * The greater the intensity, the smaller the distance
+                */
+               cRobotToLight /= cLight.GetIntensity();
+               /* Distribute the reading across the sensors, wrt the turtlebot4 rotation */
+               AccumulateLight(m_vecSensorAngles.data(),
+                               m_vecAccumulator.data(),
+                               m_vecAccumulator.size(),
+                               (cRobotToLight.GetZAngle() - cOrientationZ).GetValue(),
+                               ComputeReading(cRobotToLight.Length()));
+            }
+            else {
+               /* The ray is occluded */
+               if(m_bShowRays) {
+                  m_pcControllableEntity->AddCheckedRay(true, cOcclusionCheckRay);
+                  m_pcControllableEntity->AddIntersectionPoint(cOcclusionCheckRay, sIntersection.TOnRay);
+               }
+            }
+         }
+      }
+      for(size_t i = 0; i < m_tReadings.size(); ++i) {
+         m_tReadings[i].Value = m_vecAccumulator[i];
+         /* Apply noise to the sensor */
+         if(m_bAddNoise) {
+            m_tReadings[i].Value += m_pcRNG->Uniform(m_cNoiseRange);
+         }
+         /* Trunc the reading between 0 and 1 */
+         SENSOR_RANGE.TruncValue(m_tReadings[i].Value);
+      }
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CTurtlebot4LightRotZOnlySensor::Reset() {
+      m_cUpdatePeriod.Reset();
+      for(UInt32 i = 0; i < GetReadings().size(); ++i) {
+         m_tReadings[i].Value = 0.0f;
+      }
+   }
+
+   /****************************************/
+   /****************************************/
+
+   REGISTER_SENSOR(CTurtlebot4LightRotZOnlySensor,
+                   "turtlebot4_light", "rot_z_only",
+                   "Jyotsna Bellary [jyotsnabellary@gmail.com]",
+                   "1.0",
+                   "The turtlebot4 light sensor (optimized for 2D).",
+                   "This sensor accesses a ring of 8 light sensors around the turtlebot4 lower\n"
+                   "body. The real robot has no such sensor; it is provided so that phototaxis\n"
+                   "controllers do not need the omnidirectional camera to find a light. The\n"
+                   "sensors all return a value between 0 and 1, where 0 means nothing within\n"
+                   "range and 1 means the perceived light saturates the sensor. Each visible\n"
+                   "light contributes exp(-2x), where x is the distance to the light divided by\n"
+                   "its intensity, and the contribution decreases linearly to 0 as the angle\n"
+                   "between the sensor and the light grows to 90 degrees. This angular falloff\n"
+                   "differs from the one of the newepuck_light sensor, which is the cosine of\n"
+                   "the angle. In case multiple lights are present in the environment, each\n"
+                   "sensor reading is calculated as the sum of the individual readings due to\n"
+                   "each light. In controllers, you must include the ci_turtlebot4_light_sensor.h\n"
+                   "header.\n\n"
+                   "REQUIRED XML CONFIGURATION\n\n"
+                   "  <controllers>\n"
+                   "    ...\n"
+                   "    <my_controller ...>\n"
+                   "      ...\n"
+                   "      <sensors>\n"
+                   "        ...\n"
+                   "        <turtlebot4_light implementation=\"rot_z_only\" />\n"
+                   "        ...\n"
+                   "      </sensors>\n"
+                   "      ...\n"
+                   "    </my_controller>\n"
+                   "    ...\n"
+                   "  </controllers>\n\n"
+                   "OPTIONAL XML CONFIGURATION\n\n"
+                   "It is possible to draw the rays shot by the light sensor in the OpenGL\n"
+                   "visualization. In OpenGL, the rays are drawn in cyan when they are not\n"
+                   "obstructed and in purple when they are. In case a ray is obstructed, a black\n"
+                   "dot is drawn where the intersection occurred. To turn this functionality on,\n"
+                   "add the attribute \"show_rays\" as in this example:\n\n"
+                   "  <controllers>\n"
+                   "    ...\n"
+                   "    <my_controller ...>\n"
+                   "      ...\n"
+                   "      <sensors>\n"
+                   "        ...\n"
+                   "        <turtlebot4_light implementation=\"rot_z_only\"\n"
+                   "                          show_rays=\"true\" />\n"
+                   "        ...\n"
+                   "      </sensors>\n"
+                   "      ...\n"
+                   "    </my_controller>\n"
+                   "    ...\n"
+                   "  </controllers>\n\n"
+                   "It is possible to add uniform noise to the sensors, thus matching the\n"
+                   "characteristics of a real robot better. This can be done with the attribute\n"
+                   "\"noise_level\", whose allowed range is in [-1,1] and is added to the calculated\n"
+                   "reading. The final sensor reading is always normalized in the [0-1] range.\n\n"
+                   "  <controllers>\n"
+                   "    ...\n"
+                   "    <my_controller ...>\n"
+                   "      ...\n"
+                   "      <sensors>\n"
+                   "        ...\n"
+                   "        <turtlebot4_light implementation=\"rot_z_only\"\n"
+                   "                          noise_level=\"0.1\" />\n"
+                   "        ...\n"
+                   "      </sensors>\n"
+                   "      ...\n"
+                   "    </my_controller>\n"
+                   "    ...\n"
+                   "  </controllers>\n\n",
+                   "Usable"
+      );
+
+}
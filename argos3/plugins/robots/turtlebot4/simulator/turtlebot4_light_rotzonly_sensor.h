@@ -0,0 +1,105 @@
+/**
+ * @file <argos3/plugins/robots/turtlebot4/simulator/turtlebot4_light_rotzonly_sensor.h>
+ *
+ * @author Jyotsna Bellary <jyotsnabellary@gmail.com>
+ */
+
+#ifndef TURTLEBOT4_LIGHT_ROTZONLY_SENSOR_H
+#define TURTLEBOT4_LIGHT_ROTZONLY_SENSOR_H
+
+#include <string>
+#include <map>
+#include <vector>
+
+namespace argos {
+   class CTurtlebot4LightRotZOnlySensor;
+   class CLightSensorEquippedEntity;
+}
+
+#include <argos3/plugins/robots/turtlebot4/control_interface/ci_turtlebot4_light_sensor.h>
+#include <argos3/plugins/simulator/sensors/robot_sensors/sensor_update_period.h>
+#include <argos3/plugins/robots/turtlebot4/simulator/turtlebot4_sensor_profiler.h>
+#include <argos3/core/utility/math/range.h>
+#include <argos3/core/utility/math/rng.h>
+#include <argos3/core/simulator/space/space.h>
+#include <argos3/core/simulator/sensor.h>
+#include <argos3/plugins/simulator/visualizations/batch_rendering/sensor_rays.h>
+
+namespace argos {
+
+   class CTurtlebot4LightRotZOnlySensor : public CSimulatedSensor,
+                                         public CCI_Turtlebot4LightSensor,
+                                         public CSensorRays {
+
+   public:
+
+      CTurtlebot4LightRotZOnlySensor();
+
+      virtual ~CTurtlebot4LightRotZOnlySensor() {}
+
+      virtual void SetRobot(CComposableEntity& c_entity);
+
+      virtual void Init(TConfigurationNode& t_tree);
+
+      virtual void Update();
+
+      virtual void Reset();
+
+      /**
+       * Returns true if the rays must be shown in the GUI.
+       * @return true if the rays must be shown in the GUI.
+       */
+      inline bool IsShowRays() {
+         return m_bShowRays;
+      }
+
+      /**
+       * Sets whether or not the rays must be shown in the GUI.
+       * @param b_show_rays true if the rays must be shown, false otherwise
+       */
+      inline void SetShowRays(bool b_show_rays) {
+         m_bShowRays = b_show_rays;
+      }
+
+   protected:
+
+      /** Reference to embodied entity associated to this sensor */
+      CEmbodiedEntity* m_pcEmbodiedEntity;
+
+      /** Reference to light sensor equipped entity associated to this sensor */
+      CLightSensorEquippedEntity* m_pcLightEntity;
+
+      /** Reference to controllable entity associated to this sensor */
+      CControllableEntity* m_pcControllableEntity;
+
+      /** Flag to show rays in the simulator */
+      bool m_bShowRays;
+
+      /** Random number generator */
+      CRandom::CRNG* m_pcRNG;
+
+      /** Whether to add noise or not */
+      bool m_bAddNoise;
+
+      /** Noise range */
+      CRange<Real> m_cNoiseRange;
+
+      /** Reference to the space */
+      CSpace& m_cSpace;
+
+      /** Sensor angles wrt the robot, in radians, laid out for the accumulation kernel */
+      std::vector<Real> m_vecSensorAngles;
+
+      /** Per-sensor accumulator of the contributions of all the visible lights */
+      std::vector<Real> m_vecAccumulator;
+
+      /** Limits how often the readings are computed */
+      CSensorUpdatePeriod m_cUpdatePeriod;
+
+      /** Measures the updates, if profiling is on */
+      CTurtlebot4SensorProfiler m_cProfiler;
+   };
+
+}
+
+#endif
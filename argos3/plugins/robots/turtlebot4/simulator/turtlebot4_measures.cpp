@@ -13,6 +13,7 @@
 
 UInt8 TURTLEBOT4_POWERON_LASERON   = 3;
 const Real TURTLEBOT4_MASS = 0.4f;
+const Real TURTLEBOT4_TOTAL_MASS = 3.9f; // robot with battery and sensors, used by the 3D models
 const Real TURTLEBOT4_BASE_RADIUS    = 0.169; //important used for collision
 const Real TURTLEBOT4_BASE_ELEVATION = 0.045;
 const Real TURTLEBOT4_BASE_HEIGHT    = 0.351;
@@ -60,6 +61,13 @@ const CRadians TURTLEBOT4_IR_SENSOR_RING_START_ANGLE = CRadians((2 * ARGOS_PI /
 const Real TURTLEBOT4_IR_SENSOR_RING_RANGE           = 0.1f;
 const Real OMNIDIRECTIONAL_CAMERA_ELEVATION = 0.288699733f;
 
+// The real robot has no light sensors, this ring is simulation-only
+const Real TURTLEBOT4_LIGHT_SENSOR_RING_ELEVATION       = TURTLEBOT4_IR_SENSOR_RING_ELEVATION;
+const Real TURTLEBOT4_LIGHT_SENSOR_RING_RADIUS          = TURTLEBOT4_BASE_RADIUS;
+const CRadians TURTLEBOT4_LIGHT_SENSOR_RING_START_ANGLE = CRadians(ARGOS_PI / 8.0f);
+const Real TURTLEBOT4_LIGHT_SENSOR_RING_RANGE           = 2.5f;
+const UInt32 TURTLEBOT4_LIGHT_SENSOR_RING_NUM_SENSORS   = 8;
+
 // Readings from here:
 // https://emanual.robotis.com/docs/en/platform/turtlebot4/appendix_lds_01/
 
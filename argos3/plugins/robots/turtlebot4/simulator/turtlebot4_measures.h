@@ -15,6 +15,7 @@ using namespace argos;
 
 extern UInt8 TURTLEBOT4_POWERON_LASERON;
 extern const Real TURTLEBOT4_MASS;
+extern const Real TURTLEBOT4_TOTAL_MASS;
 extern const Real TURTLEBOT4_BASE_RADIUS;
 extern const Real TURTLEBOT4_BASE_ELEVATION;
 extern const Real TURTLEBOT4_BASE_HEIGHT;
@@ -35,6 +36,12 @@ extern const Real TURTLEBOT4_IR_SENSOR_RING_ELEVATION;
 extern const Real TURTLEBOT4_IR_SENSOR_RING_RADIUS;
 extern const Real TURTLEBOT4_IR_SENSOR_RING_RANGE;
 
+extern const Real TURTLEBOT4_LIGHT_SENSOR_RING_ELEVATION;
+extern const Real TURTLEBOT4_LIGHT_SENSOR_RING_RADIUS;
+extern const CRadians TURTLEBOT4_LIGHT_SENSOR_RING_START_ANGLE;
+extern const Real TURTLEBOT4_LIGHT_SENSOR_RING_RANGE;
+extern const UInt32 TURTLEBOT4_LIGHT_SENSOR_RING_NUM_SENSORS;
+
 extern const CRadians TURTLEBOT4_LED_RING_START_ANGLE;
 extern const Real TURTLEBOT4_LED_RING_RADIUS;
 extern const Real TURTLEBOT4_LED_RING_ELEVATION;
@@ -53,6 +60,46 @@ extern const Real TURTLEBOT4_LIDAR_SENSORS_FAN_RADIUS;
 extern const CRadians TURTLEBOT4_LIDAR_ANGLE_SPAN;
 extern const CRange<Real> TURTLEBOT4_LIDAR_SENSORS_RING_RANGE;
 
+/*
+ * Layouts of the IR ring, LED ring and ground sensors. They are constant
+ * tables, so building a robot only scales them and never calls a
+ * trigonometric function.
+ */
+
+/* IR sensors: angle from the front (rad), cosine and sine of the angle */
+constexpr UInt32 TURTLEBOT4_IR_SENSOR_RING_NUM_SENSORS = 7;
+constexpr Real TURTLEBOT4_IR_SENSOR_RING_LAYOUT[TURTLEBOT4_IR_SENSOR_RING_NUM_SENSORS][3] = {
+   { -1.142397329, 0.415415013, -0.909631995 }, // -PI / 2.75,   -65.5°
+   { -0.663343043, 0.787938145, -0.615754399 }, // -PI / 4.736,  -38.0°
+   { -0.349065850, 0.939692621, -0.342020143 }, // -PI / 9,      -20.0°
+   { -0.052359878, 0.998629535, -0.052335956 }, // -PI / 60,      -3.0°
+   {  0.248740511, 0.969223256,  0.246183429 }, //  PI / 12.63,  +14.3°
+   {  0.593425133, 0.829030198,  0.559203836 }, //  PI / 5.294,  +34.0°
+   {  1.139703484, 0.417863910,  0.908509633 }  //  PI / 2.7565, +65.3°
+};
+
+/* LEDs: cosine and sine of the angle, starting at PI / 16 every PI / 4 */
+constexpr UInt32 TURTLEBOT4_LED_RING_NUM_LEDS = 8;
+constexpr Real TURTLEBOT4_LED_RING_LAYOUT[TURTLEBOT4_LED_RING_NUM_LEDS][2] = {
+   {  0.980785280,  0.195090322 },
+   {  0.555570233,  0.831469612 },
+   { -0.195090322,  0.980785280 },
+   { -0.831469612,  0.555570233 },
+   { -0.980785280, -0.195090322 },
+   { -0.555570233, -0.831469612 },
+   {  0.195090322, -0.980785280 },
+   {  0.831469612, -0.555570233 }
+};
+
+/* Ground sensors: position on the bottom of the robot (m) */
+constexpr UInt32 TURTLEBOT4_GROUND_SENSOR_NUM_SENSORS = 4;
+constexpr Real TURTLEBOT4_GROUND_SENSOR_LAYOUT[TURTLEBOT4_GROUND_SENSOR_NUM_SENSORS][2] = {
+   { 0.1425,  0.0268 },
+   { 0.1425, -0.0268 },
+   { 0.0879,  0.109  },
+   { 0.0879, -0.109  }
+};
+
 extern const Real TURTLEBOT4_MAX_FORCE;
 extern const Real TURTLEBOT4_MAX_TORQUE;
 extern const Real OMNIDIRECTIONAL_CAMERA_ELEVATION;
@@ -0,0 +1,125 @@
+/**
+ * @file <argos3/plugins/robots/turtlebot4/simulator/turtlebot4_odometry_default_sensor.cpp>
+ *
+ * @author Jyotsna Bellary <jyotsnabellary@gmail.com>
+ */
+
+#include "turtlebot4_odometry_default_sensor.h"
+
+#include <argos3/core/simulator/entity/composable_entity.h>
+#include <argos3/core/simulator/entity/embodied_entity.h>
+#include <argos3/plugins/simulator/entities/wheeled_entity.h>
+
+namespace argos {
+
+   /****************************************/
+   /****************************************/
+
+   CTurtlebot4OdometryDefaultSensor::CTurtlebot4OdometryDefaultSensor() :
+      m_pcEmbodiedEntity(nullptr),
+      m_pcWheeledEntity(nullptr),
+      m_nSlot(-1),
+      m_cProfiler("odometry") {}
+
+   /****************************************/
+   /****************************************/
+
+   void CTurtlebot4OdometryDefaultSensor::SetRobot(CComposableEntity& c_entity) {
+      m_cProfiler.SetRobot(c_entity.GetId());
+      m_pcEmbodiedEntity = &(c_entity.GetComponent<CEmbodiedEntity>("body"));
+      m_pcWheeledEntity = &(c_entity.GetComponent<CWheeledEntity>("wheels"));
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CTurtlebot4OdometryDefaultSensor::Init(TConfigurationNode& t_tree) {
+      try {
+         CCI_Turtlebot4OdometrySensor::Init(t_tree);
+         /* Profile the updates? */
+         m_cProfiler.Init(t_tree);
+         /* Join the batch, with the slip and noise model */
+         COdometryBatch::GetInstance().Add(m_nSlot, *m_pcEmbodiedEntity, *m_pcWheeledEntity, t_tree);
+         /* sensor is enabled by default */
+         Enable();
+      }
+      catch(CARGoSException& ex) {
+         THROW_ARGOSEXCEPTION_NESTED("Initialization error in turtlebot4 odometry sensor", ex);
+      }
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CTurtlebot4OdometryDefaultSensor::Update() {
+      /* Measure the whole update */
+      CTurtlebot4SensorProfiler::CScope cProfile(m_cProfiler);
+      /* sensor is disabled--nothing to do */
+      if(IsDisabled()) {
+         return;
+      }
+      COdometryBatch& cBatch = COdometryBatch::GetInstance();
+      cBatch.Update();
+      cBatch.GetReading(m_nSlot, m_sReading);
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CTurtlebot4OdometryDefaultSensor::Reset() {
+      COdometryBatch::GetInstance().Reset(m_nSlot);
+      m_sReading = SReading();
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CTurtlebot4OdometryDefaultSensor::Destroy() {
+      if(m_nSlot >= 0) {
+         COdometryBatch::GetInstance().Remove(m_nSlot);
+      }
+   }
+
+   /****************************************/
+   /****************************************/
+
+   REGISTER_SENSOR(CTurtlebot4OdometryDefaultSensor,
+                   "turtlebot4_odometry", "default",
+                   "Jyotsna Bellary [jyotsnabellary@gmail.com]",
+                   "1.0",
+                   "The turtlebot4 wheel odometry sensor.",
+                   "This sensor integrates the motion of the robot into a pose estimate. For a\n"
+                   "complete description of its usage, refer to the ci_turtlebot4_odometry_sensor.h\n"
+                   "interface.\n\n"
+                   "REQUIRED XML CONFIGURATION\n\n"
+                   "  <controllers>\n"
+                   "    ...\n"
+                   "    <my_controller ...>\n"
+                   "      ...\n"
+                   "      <sensors>\n"
+                   "        ...\n"
+                   "        <turtlebot4_odometry implementation=\"default\" />\n"
+                   "        ...\n"
+                   "      </sensors>\n"
+                   "      ...\n"
+                   "    </my_controller>\n"
+                   "    ...\n"
+                   "  </controllers>\n\n"
+                   "OPTIONAL XML CONFIGURATION\n\n"
+                   "By default the readings follow the actual motion of the robot. The 'slip'\n"
+                   "attribute, between 0 and 1, sets how much of the wheel motion that does not\n"
+                   "move the robot (e.g., when it pushes against a wall) the sensor counts. With\n"
+                   "slip=\"1\", the sensor behaves like pure wheel encoders.\n"
+                   "The 'linear_noise' and 'angular_noise' attributes set the standard deviation\n"
+                   "of the relative error on the distance travelled and on the rotation at each\n"
+                   "step, e.g., 0.05 for 5%:\n\n"
+                   "        <turtlebot4_odometry implementation=\"default\"\n"
+                   "                             slip=\"0.5\"\n"
+                   "                             linear_noise=\"0.05\"\n"
+                   "                             angular_noise=\"0.05\" />\n\n"
+                   "The sensors of all the robots are updated together, in a single pass per\n"
+                   "step.\n",
+                   "Usable"
+		  );
+
+}
@@ -0,0 +1,56 @@
+/**
+ * @file <argos3/plugins/robots/turtlebot4/simulator/turtlebot4_odometry_default_sensor.h>
+ *
+ * @author Jyotsna Bellary <jyotsnabellary@gmail.com>
+ */
+
+#ifndef TURTLEBOT4_ODOMETRY_DEFAULT_SENSOR_H
+#define TURTLEBOT4_ODOMETRY_DEFAULT_SENSOR_H
+
+namespace argos {
+   class CTurtlebot4OdometryDefaultSensor;
+   class CEmbodiedEntity;
+   class CWheeledEntity;
+}
+
+#include <argos3/plugins/robots/turtlebot4/control_interface/ci_turtlebot4_odometry_sensor.h>
+#include <argos3/plugins/robots/turtlebot4/simulator/turtlebot4_sensor_profiler.h>
+#include <argos3/plugins/simulator/sensors/robot_sensors/odometry_batch.h>
+#include <argos3/core/simulator/sensor.h>
+
+namespace argos {
+
+   class CTurtlebot4OdometryDefaultSensor : public CCI_Turtlebot4OdometrySensor,
+                                            public CSimulatedSensor {
+
+   public:
+
+      CTurtlebot4OdometryDefaultSensor();
+
+      virtual ~CTurtlebot4OdometryDefaultSensor() {}
+
+      virtual void SetRobot(CComposableEntity& c_entity);
+
+      virtual void Init(TConfigurationNode& t_tree);
+
+      virtual void Update();
+
+      virtual void Reset();
+
+      virtual void Destroy();
+
+   private:
+
+      CEmbodiedEntity* m_pcEmbodiedEntity;
+      CWheeledEntity* m_pcWheeledEntity;
+
+      /** Slot in the batch, -1 before Init() */
+      SInt64 m_nSlot;
+
+      /** Measures the updates, if profiling is on */
+      CTurtlebot4SensorProfiler m_cProfiler;
+   };
+
+}
+
+#endif
@@ -0,0 +1,70 @@
+/**
+ * @file <argos3/plugins/robots/turtlebot4/simulator/turtlebot4_pool.h>
+ *
+ * @brief This file provides a pool to spawn and despawn Turtlebot4s at runtime.
+ *
+ * Despawned robots are parked: taken out of the physics engines and
+ * disabled. Spawning reuses a parked robot before creating a new one. See
+ * CRobotPool for the details.
+ *
+ * Example, in a loop functions whose XML node has a <turtlebot4> child with
+ * the attributes and the <controller> of the robots:
+ *
+ *    m_pcPool = new CTurtlebot4Pool(GetSpace(),
+ *                                   GetNode(t_tree, "turtlebot4"),
+ *                                   "tb");
+ *    CTurtlebot4Entity* pcRobot = m_pcPool->Spawn(CVector3(1.0, 0.0, 0.0));
+ *    ...
+ *    m_pcPool->Despawn(*pcRobot);
+ *
+ * @author Jyotsna Bellary <jyotsnabellary@gmail.com>
+ */
+
+#ifndef TURTLEBOT4_POOL_H
+#define TURTLEBOT4_POOL_H
+
+namespace argos {
+   class CTurtlebot4Pool;
+}
+
+#include <argos3/plugins/simulator/sensors/robot_sensors/robot_pool.h>
+#include <argos3/plugins/robots/turtlebot4/simulator/turtlebot4_entity.h>
+
+namespace argos {
+
+   class CTurtlebot4Pool : public CRobotPool {
+
+   public:
+
+      /**
+       * Creates an empty pool.
+       * @param c_space the space
+       * @param t_robot the <turtlebot4> node of the robots
+       * @param str_id_prefix the prefix of the robot ids
+       * @throws CARGoSException if the node is not a <turtlebot4> node
+       */
+      CTurtlebot4Pool(CSpace& c_space,
+                      TConfigurationNode& t_robot,
+                      const std::string& str_id_prefix) :
+         CRobotPool(c_space, t_robot, "turtlebot4", str_id_prefix) {}
+
+      /**
+       * Places a robot in the arena. See CRobotPool::SpawnEntity().
+       */
+      inline CTurtlebot4Entity* Spawn(const CVector3& c_position,
+                                      const CQuaternion& c_orientation = CQuaternion()) {
+         return static_cast<CTurtlebot4Entity*>(SpawnEntity(c_position, c_orientation));
+      }
+
+      /**
+       * Parks a robot. See CRobotPool::DespawnEntity().
+       */
+      inline void Despawn(CTurtlebot4Entity& c_robot) {
+         DespawnEntity(c_robot);
+      }
+
+   };
+
+}
+
+#endif
@@ -15,12 +15,16 @@ namespace argos {
 }
 
 #include <argos3/plugins/robots/turtlebot4/control_interface/ci_turtlebot4_proximity_sensor.h>
-#include <argos3/plugins/robots/generic/simulator/proximity_default_sensor.h>
+#include <argos3/plugins/simulator/sensors/robot_sensors/sensor_update_period.h>
+#include <argos3/plugins/robots/turtlebot4/simulator/turtlebot4_sensor_profiler.h>
+#include <argos3/plugins/simulator/sensors/robot_sensors/gated_proximity_sensor.h>
+#include <argos3/plugins/simulator/visualizations/batch_rendering/sensor_rays.h>
 
 namespace argos {
 
    class CTurtlebot4ProximityDefaultSensor : public CCI_Turtlebot4ProximitySensor,
-                                            public CSimulatedSensor {
+                                            public CSimulatedSensor,
+                                            public CSensorRays {
 
    public:
 
@@ -40,6 +44,14 @@ namespace argos {
 
       CProximityDefaultSensor* m_pcProximityImpl;
 
+      /** Where the implementation adds its rays */
+      CControllableEntity* m_pcControllableEntity;
+
+      /** Limits how often the readings are computed */
+      CSensorUpdatePeriod m_cUpdatePeriod;
+
+      /** Measures the updates, if profiling is on */
+      CTurtlebot4SensorProfiler m_cProfiler;
    };
 
 }
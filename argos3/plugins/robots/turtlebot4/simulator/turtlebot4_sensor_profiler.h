@@ -0,0 +1,44 @@
+/**
+ * @file <argos3/plugins/robots/turtlebot4/simulator/turtlebot4_sensor_profiler.h>
+ *
+ * @brief This file provides the time profiler of the Turtlebot4 sensors.
+ *
+ * Every Turtlebot4 sensor accepts an optional 'profile' attribute. When it is
+ * "true", or when the TURTLEBOT4_SENSOR_PROFILE environment variable is set to
+ * anything but "0", the sensor measures each call to Update(). The report
+ * is written as turtlebot4_sensor_profile.csv and turtlebot4_sensor_profile.json at
+ * the end of the experiment. See CSensorProfiler for the details.
+ *
+ * @author Jyotsna Bellary <jyotsnabellary@gmail.com>
+ */
+
+#ifndef TURTLEBOT4_SENSOR_PROFILER_H
+#define TURTLEBOT4_SENSOR_PROFILER_H
+
+namespace argos {
+   class CTurtlebot4SensorProfiler;
+}
+
+#include <argos3/plugins/simulator/sensors/robot_sensors/sensor_profiler.h>
+
+namespace argos {
+
+   class CTurtlebot4SensorProfiler : public CSensorProfiler {
+
+   public:
+
+      /**
+       * @param str_sensor the kind of sensor, such as "lidar", as shown
+       * in the report
+       */
+      CTurtlebot4SensorProfiler(const std::string& str_sensor) :
+         CSensorProfiler(str_sensor,
+                         "Turtlebot4",
+                         "TURTLEBOT4_SENSOR_PROFILE",
+                         "turtlebot4_sensor_profile") {}
+
+   };
+
+}
+
+#endif
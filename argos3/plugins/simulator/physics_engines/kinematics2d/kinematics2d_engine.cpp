@@ -0,0 +1,484 @@
+/**
+ * @file <argos3/plugins/simulator/physics_engines/kinematics2d/kinematics2d_engine.cpp>
+ *
+ * @author Jyotsna Bellary <jyotsnabellary@gmail.com>
+ */
+
+#include "kinematics2d_engine.h"
+#include "kinematics2d_model.h"
+#include <argos3/core/simulator/simulator.h>
+#include <argos3/core/simulator/space/space.h>
+#include <argos3/core/utility/math/general.h>
+#include <algorithm>
+#include <cmath>
+
+namespace argos {
+
+   /****************************************/
+   /****************************************/
+
+   /* Upper bound on the number of grid cells, to bound memory in huge arenas */
+   static const SInt32 MAX_GRID_CELLS = 1 << 22;
+
+   /****************************************/
+   /****************************************/
+
+   template<class T>
+   static void RemoveSwappingLast(std::vector<T>& vec_data, size_t un_index) {
+      vec_data[un_index] = vec_data.back();
+      vec_data.pop_back();
+   }
+
+   /****************************************/
+   /****************************************/
+
+   CKinematics2DEngine::CKinematics2DEngine() :
+      m_fGridMinX(0.0f),
+      m_fGridMinY(0.0f),
+      m_fGridMaxX(0.0f),
+      m_fGridMaxY(0.0f),
+      m_fCellSize(0.0f),
+      m_nCellsX(0),
+      m_nCellsY(0),
+      m_bGridDirty(true) {}
+
+   /****************************************/
+   /****************************************/
+
+   void CKinematics2DEngine::Init(TConfigurationNode& t_tree) {
+      try {
+         /* Init parent */
+         CPhysicsEngine::Init(t_tree);
+      }
+      catch(CARGoSException& ex) {
+         THROW_ARGOSEXCEPTION_NESTED("Error initializing the kinematics 2D engine \"" << GetId() << "\"", ex);
+      }
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CKinematics2DEngine::Reset() {
+      for(size_t i = 0; i < m_vecModels.size(); ++i) {
+         m_vecModels[i]->Reset();
+      }
+      m_bGridDirty = true;
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CKinematics2DEngine::Destroy() {
+      for(std::map<std::string, CKinematics2DModel*>::iterator it = m_tPhysicsModels.begin();
+          it != m_tPhysicsModels.end(); ++it) {
+         delete it->second;
+      }
+      m_tPhysicsModels.clear();
+      m_vecModels.clear();
+      m_sBodies = SBodies();
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CKinematics2DEngine::Update() {
+      if(m_vecModels.empty()) return;
+      /* Fetch the wheel velocities set by the actuators */
+      for(size_t i = 0; i < m_vecModels.size(); ++i) {
+         m_sBodies.LeftVelocity[i]  = m_sBodies.WheelVelocities[i][0];
+         m_sBodies.RightVelocity[i] = m_sBodies.WheelVelocities[i][1];
+      }
+      /* Move the robots and separate them */
+      for(size_t i = 0; i < GetIterations(); ++i) {
+         Integrate(GetPhysicsClockTick());
+         BuildGrid();
+         ResolveOverlaps();
+      }
+      /* The grid is used by the ray queries of the sensors */
+      BuildGrid();
+      /* Update the entities */
+      for(size_t i = 0; i < m_vecModels.size(); ++i) {
+         m_vecModels[i]->UpdateEntityStatus();
+      }
+   }
+
+   /****************************************/
+   /****************************************/
+
+   size_t CKinematics2DEngine::GetNumPhysicsModels() {
+      return m_vecModels.size();
+   }
+
+   /****************************************/
+   /****************************************/
+
+   bool CKinematics2DEngine::AddEntity(CEntity& c_entity) {
+      SOperationOutcome cOutcome =
+         CallEntityOperation<CKinematics2DOperationAddEntity, CKinematics2DEngine, SOperationOutcome>
+         (*this, c_entity);
+      return cOutcome.Value;
+   }
+
+   /****************************************/
+   /****************************************/
+
+   bool CKinematics2DEngine::RemoveEntity(CEntity& c_entity) {
+      SOperationOutcome cOutcome =
+         CallEntityOperation<CKinematics2DOperationRemoveEntity, CKinematics2DEngine, SOperationOutcome>
+         (*this, c_entity);
+      return cOutcome.Value;
+   }
+
+   /****************************************/
+   /****************************************/
+
+   bool CKinematics2DEngine::IsPointContained(const CVector3& c_point) {
+      return true;
+   }
+
+   /****************************************/
+   /****************************************/
+
+   bool CKinematics2DEngine::IsEntityTransferNeeded() const {
+      return false;
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CKinematics2DEngine::TransferEntities() {
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CKinematics2DEngine::CheckIntersectionWithRay(TEmbodiedEntityIntersectionData& t_data,
+                                                      const CRay3& c_ray) const {
+      const CVector3& cStart = c_ray.GetStart();
+      const CVector3& cEnd = c_ray.GetEnd();
+      Real fDX = cEnd.GetX() - cStart.GetX();
+      Real fDY = cEnd.GetY() - cStart.GetY();
+      Real fDZ = cEnd.GetZ() - cStart.GetZ();
+      Real fA = fDX * fDX + fDY * fDY;
+      /* Vertical rays never hit the side of a robot */
+      if(fA == 0.0f) return;
+      /* Ray-disc test, the ray must enter the disc from outside */
+      auto TestBody = [&](size_t i) {
+         Real fCX = cStart.GetX() - m_sBodies.PosX[i];
+         Real fCY = cStart.GetY() - m_sBodies.PosY[i];
+         Real fB = fCX * fDX + fCY * fDY;
+         Real fC = fCX * fCX + fCY * fCY - m_sBodies.Radius[i] * m_sBodies.Radius[i];
+         Real fDisc = fB * fB - fA * fC;
+         if(fDisc < 0.0f) return;
+         Real fT = (-fB - std::sqrt(fDisc)) / fA;
+         if(fT < 0.0f || fT > 1.0f) return;
+         Real fZ = cStart.GetZ() + fT * fDZ - m_sBodies.PosZ[i];
+         if(fZ < 0.0f || fZ > m_sBodies.Height[i]) return;
+         t_data.push_back(
+            SEmbodiedEntityIntersectionItem(&m_vecModels[i]->GetEmbodiedEntity(), fT));
+      };
+      if(m_bGridDirty) {
+         /* The grid is stale, test all the robots */
+         for(size_t i = 0; i < m_vecModels.size(); ++i) {
+            TestBody(i);
+         }
+         return;
+      }
+      /* Test the robots in the cells around the segment */
+      SInt32 nMinX = static_cast<SInt32>(std::floor((Min(cStart.GetX(), cEnd.GetX()) - m_fGridMinX) / m_fCellSize)) - 1;
+      SInt32 nMaxX = static_cast<SInt32>(std::floor((Max(cStart.GetX(), cEnd.GetX()) - m_fGridMinX) / m_fCellSize)) + 1;
+      SInt32 nMinY = static_cast<SInt32>(std::floor((Min(cStart.GetY(), cEnd.GetY()) - m_fGridMinY) / m_fCellSize)) - 1;
+      SInt32 nMaxY = static_cast<SInt32>(std::floor((Max(cStart.GetY(), cEnd.GetY()) - m_fGridMinY) / m_fCellSize)) + 1;
+      nMinX = Max<SInt32>(nMinX, 0); nMaxX = Min<SInt32>(nMaxX, m_nCellsX - 1);
+      nMinY = Max<SInt32>(nMinY, 0); nMaxY = Min<SInt32>(nMaxY, m_nCellsY - 1);
+      for(SInt32 nY = nMinY; nY <= nMaxY; ++nY) {
+         for(SInt32 nX = nMinX; nX <= nMaxX; ++nX) {
+            size_t unCell = nY * m_nCellsX + nX;
+            for(UInt32 k = m_vecCellStart[unCell]; k < m_vecCellStart[unCell + 1]; ++k) {
+               TestBody(m_vecCellItems[k]);
+            }
+         }
+      }
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CKinematics2DEngine::AddPhysicsModel(const std::string& str_id,
+                                             CKinematics2DModel& c_model) {
+      c_model.m_unIndex = m_vecModels.size();
+      m_vecModels.push_back(&c_model);
+      m_tPhysicsModels[str_id] = &c_model;
+      m_sBodies.PosX.push_back(0.0f);
+      m_sBodies.PosY.push_back(0.0f);
+      m_sBodies.PosZ.push_back(0.0f);
+      m_sBodies.Cos.push_back(1.0f);
+      m_sBodies.Sin.push_back(0.0f);
+      m_sBodies.Radius.push_back(c_model.GetRadius());
+      m_sBodies.Height.push_back(c_model.GetHeight());
+      m_sBodies.InterwheelDistance.push_back(c_model.GetInterwheelDistance());
+      m_sBodies.LeftVelocity.push_back(0.0f);
+      m_sBodies.RightVelocity.push_back(0.0f);
+      m_sBodies.WheelVelocities.push_back(c_model.GetWheelVelocities());
+      SetPose(c_model.m_unIndex,
+              c_model.GetEmbodiedEntity().GetOriginAnchor().Position,
+              c_model.GetEmbodiedEntity().GetOriginAnchor().Orientation);
+      /* A cell must be as large as the largest robot */
+      if(2.0f * c_model.GetRadius() > m_fCellSize) {
+         m_fCellSize = 2.0f * c_model.GetRadius();
+         m_nCellsX = 0;
+      }
+      c_model.UpdateEntityStatus();
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CKinematics2DEngine::RemovePhysicsModel(const std::string& str_id) {
+      std::map<std::string, CKinematics2DModel*>::iterator it = m_tPhysicsModels.find(str_id);
+      if(it == m_tPhysicsModels.end()) {
+         THROW_ARGOSEXCEPTION("Kinematics2D model id \"" << str_id << "\" not found in kinematics 2D engine \"" << GetId() << "\"");
+      }
+      /* Move the last robot in the place of the removed one */
+      size_t unIndex = it->second->m_unIndex;
+      RemoveSwappingLast(m_vecModels, unIndex);
+      RemoveSwappingLast(m_sBodies.PosX, unIndex);
+      RemoveSwappingLast(m_sBodies.PosY, unIndex);
+      RemoveSwappingLast(m_sBodies.PosZ, unIndex);
+      RemoveSwappingLast(m_sBodies.Cos, unIndex);
+      RemoveSwappingLast(m_sBodies.Sin, unIndex);
+      RemoveSwappingLast(m_sBodies.Radius, unIndex);
+      RemoveSwappingLast(m_sBodies.Height, unIndex);
+      RemoveSwappingLast(m_sBodies.InterwheelDistance, unIndex);
+      RemoveSwappingLast(m_sBodies.LeftVelocity, unIndex);
+      RemoveSwappingLast(m_sBodies.RightVelocity, unIndex);
+      RemoveSwappingLast(m_sBodies.WheelVelocities, unIndex);
+      if(unIndex < m_vecModels.size()) {
+         m_vecModels[unIndex]->m_unIndex = unIndex;
+      }
+      delete it->second;
+      m_tPhysicsModels.erase(it);
+      m_bGridDirty = true;
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CKinematics2DEngine::SetPose(size_t un_index,
+                                     const CVector3& c_position,
+                                     const CQuaternion& c_orientation) {
+      CRadians cZAngle, cYAngle, cXAngle;
+      c_orientation.ToEulerAngles(cZAngle, cYAngle, cXAngle);
+      m_sBodies.PosX[un_index] = c_position.GetX();
+      m_sBodies.PosY[un_index] = c_position.GetY();
+      m_sBodies.PosZ[un_index] = c_position.GetZ();
+      m_sBodies.Cos[un_index] = Cos(cZAngle);
+      m_sBodies.Sin[un_index] = Sin(cZAngle);
+      m_bGridDirty = true;
+   }
+
+   /****************************************/
+   /****************************************/
+
+   bool CKinematics2DEngine::IsOverlapping(size_t un_index) const {
+      for(size_t i = 0; i < m_vecModels.size(); ++i) {
+         if(i == un_index) continue;
+         Real fDX = m_sBodies.PosX[i] - m_sBodies.PosX[un_index];
+         Real fDY = m_sBodies.PosY[i] - m_sBodies.PosY[un_index];
+         Real fRadii = m_sBodies.Radius[i] + m_sBodies.Radius[un_index];
+         if(fDX * fDX + fDY * fDY < fRadii * fRadii) return true;
+      }
+      return false;
+   }
+
+   /****************************************/
+   /****************************************/
+
+   /*
+    * Unicycle model. The heading is rotated with a truncated Taylor series
+    * of sine and cosine, and renormalized, so the loop has no calls nor
+    * branches and vectorizes. The rotation per step is small, which keeps
+    * the error far below the robot resolution. The arrays must not overlap.
+    */
+   static void IntegrateUnicycle(size_t un_bodies,
+                                 Real* __restrict pf_pos_x,
+                                 Real* __restrict pf_pos_y,
+                                 Real* __restrict pf_cos,
+                                 Real* __restrict pf_sin,
+                                 const Real* __restrict pf_left,
+                                 const Real* __restrict pf_right,
+                                 const Real* __restrict pf_interwheel,
+                                 Real f_dt) {
+      for(size_t i = 0; i < un_bodies; ++i) {
+         Real fLinear = 0.5f * (pf_left[i] + pf_right[i]) * f_dt;
+         Real fAngle = (pf_right[i] - pf_left[i]) / pf_interwheel[i] * f_dt;
+         Real fAngle2 = fAngle * fAngle;
+         Real fRotCos = 1.0f - fAngle2 * (0.5f - fAngle2 * (1.0f / 24.0f));
+         Real fRotSin = fAngle * (1.0f - fAngle2 * (1.0f / 6.0f));
+         Real fNewCos = pf_cos[i] * fRotCos - pf_sin[i] * fRotSin;
+         Real fNewSin = pf_sin[i] * fRotCos + pf_cos[i] * fRotSin;
+         /* One Newton step of 1/sqrt around 1, the norm is always close to 1 */
+         Real fNorm = 0.5f * (3.0f - (fNewCos * fNewCos + fNewSin * fNewSin));
+         fNewCos *= fNorm;
+         fNewSin *= fNorm;
+         /* Move along the chord of the arc */
+         pf_pos_x[i] += 0.5f * fLinear * (pf_cos[i] + fNewCos);
+         pf_pos_y[i] += 0.5f * fLinear * (pf_sin[i] + fNewSin);
+         pf_cos[i] = fNewCos;
+         pf_sin[i] = fNewSin;
+      }
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CKinematics2DEngine::Integrate(Real f_dt) {
+      IntegrateUnicycle(m_vecModels.size(),
+                        m_sBodies.PosX.data(),
+                        m_sBodies.PosY.data(),
+                        m_sBodies.Cos.data(),
+                        m_sBodies.Sin.data(),
+                        m_sBodies.LeftVelocity.data(),
+                        m_sBodies.RightVelocity.data(),
+                        m_sBodies.InterwheelDistance.data(),
+                        f_dt);
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CKinematics2DEngine::ResolveOverlaps() {
+      size_t unBodies = m_vecModels.size();
+      std::vector<Real>& vecPosX = m_sBodies.PosX;
+      std::vector<Real>& vecPosY = m_sBodies.PosY;
+      const std::vector<Real>& vecRadius = m_sBodies.Radius;
+      /* Push apart each overlapping pair, half each */
+      for(size_t i = 0; i < unBodies; ++i) {
+         SInt32 nCX = m_vecBodyCell[i] % m_nCellsX;
+         SInt32 nCY = m_vecBodyCell[i] / m_nCellsX;
+         for(SInt32 nY = Max<SInt32>(nCY - 1, 0); nY <= Min<SInt32>(nCY + 1, m_nCellsY - 1); ++nY) {
+            for(SInt32 nX = Max<SInt32>(nCX - 1, 0); nX <= Min<SInt32>(nCX + 1, m_nCellsX - 1); ++nX) {
+               size_t unCell = nY * m_nCellsX + nX;
+               for(UInt32 k = m_vecCellStart[unCell]; k < m_vecCellStart[unCell + 1]; ++k) {
+                  size_t j = m_vecCellItems[k];
+                  if(j <= i) continue;
+                  Real fDX = vecPosX[j] - vecPosX[i];
+                  Real fDY = vecPosY[j] - vecPosY[i];
+                  Real fRadii = vecRadius[i] + vecRadius[j];
+                  Real fDist2 = fDX * fDX + fDY * fDY;
+                  if(fDist2 >= fRadii * fRadii) continue;
+                  Real fDist = std::sqrt(fDist2);
+                  Real fNX = 1.0f, fNY = 0.0f;
+                  if(fDist > 1e-9) {
+                     fNX = fDX / fDist;
+                     fNY = fDY / fDist;
+                  }
+                  Real fPush = 0.5f * (fRadii - fDist);
+                  vecPosX[i] -= fNX * fPush;
+                  vecPosY[i] -= fNY * fPush;
+                  vecPosX[j] += fNX * fPush;
+                  vecPosY[j] += fNY * fPush;
+               }
+            }
+         }
+      }
+      /* Keep the robots in the arena */
+      for(size_t i = 0; i < unBodies; ++i) {
+         vecPosX[i] = Min(Max(vecPosX[i], m_fGridMinX + vecRadius[i]), m_fGridMaxX - vecRadius[i]);
+         vecPosY[i] = Min(Max(vecPosY[i], m_fGridMinY + vecRadius[i]), m_fGridMaxY - vecRadius[i]);
+      }
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CKinematics2DEngine::BuildGrid() {
+      if(m_nCellsX == 0) {
+         /* The grid covers the arena */
+         const CRange<CVector3>& cLimits = CSimulator::GetInstance().GetSpace().GetArenaLimits();
+         m_fGridMinX = cLimits.GetMin().GetX();
+         m_fGridMinY = cLimits.GetMin().GetY();
+         m_fGridMaxX = cLimits.GetMax().GetX();
+         m_fGridMaxY = cLimits.GetMax().GetY();
+         do {
+            m_nCellsX = Max<SInt32>(1, static_cast<SInt32>(std::ceil((m_fGridMaxX - m_fGridMinX) / m_fCellSize)));
+            m_nCellsY = Max<SInt32>(1, static_cast<SInt32>(std::ceil((m_fGridMaxY - m_fGridMinY) / m_fCellSize)));
+            if(static_cast<SInt64>(m_nCellsX) * m_nCellsY > MAX_GRID_CELLS) {
+               m_fCellSize *= 2.0f;
+            }
+            else {
+               break;
+            }
+         } while(true);
+         m_vecCellStart.resize(m_nCellsX * m_nCellsY + 1);
+      }
+      /* Counting sort of the robots by cell */
+      size_t unBodies = m_vecModels.size();
+      m_vecBodyCell.resize(unBodies);
+      m_vecCellItems.resize(unBodies);
+      std::fill(m_vecCellStart.begin(), m_vecCellStart.end(), 0);
+      for(size_t i = 0; i < unBodies; ++i) {
+         m_vecBodyCell[i] = GetCell(m_sBodies.PosX[i], m_sBodies.PosY[i]);
+         ++m_vecCellStart[m_vecBodyCell[i] + 1];
+      }
+      for(size_t c = 1; c < m_vecCellStart.size(); ++c) {
+         m_vecCellStart[c] += m_vecCellStart[c - 1];
+      }
+      for(size_t i = 0; i < unBodies; ++i) {
+         m_vecCellItems[m_vecCellStart[m_vecBodyCell[i]]++] = i;
+      }
+      /* The loop above moved each start to the next cell, move it back */
+      for(size_t c = m_vecCellStart.size() - 1; c > 0; --c) {
+         m_vecCellStart[c] = m_vecCellStart[c - 1];
+      }
+      m_vecCellStart[0] = 0;
+      m_bGridDirty = false;
+   }
+
+   /****************************************/
+   /****************************************/
+
+   size_t CKinematics2DEngine::GetCell(Real f_x, Real f_y) const {
+      SInt32 nX = static_cast<SInt32>(std::floor((f_x - m_fGridMinX) / m_fCellSize));
+      SInt32 nY = static_cast<SInt32>(std::floor((f_y - m_fGridMinY) / m_fCellSize));
+      nX = Min<SInt32>(Max<SInt32>(nX, 0), m_nCellsX - 1);
+      nY = Min<SInt32>(Max<SInt32>(nY, 0), m_nCellsY - 1);
+      return nY * m_nCellsX + nX;
+   }
+
+   /****************************************/
+   /****************************************/
+
+   REGISTER_PHYSICS_ENGINE(CKinematics2DEngine,
+                           "kinematics2d",
+                           "Jyotsna Bellary [jyotsnabellary@gmail.com]",
+                           "1.0",
+                           "A kinematics-only 2D engine for large swarms of wheeled robots.",
+                           "This physics engine moves differential-drive robots with unicycle\n"
+                           "kinematics. Each robot is a disc: when two robots overlap, they are\n"
+                           "pushed apart, and robots are kept inside the arena. There are no forces,\n"
+                           "no friction and no gripping. The engine is meant for studies with\n"
+                           "thousands of robots, where the dynamics2d engine is too slow.\n\n"
+                           "Only robots can be added to this engine. Other objects, such as walls,\n"
+                           "boxes and cylinders, must go in another engine, and the robots in this\n"
+                           "engine do not collide with them.\n\n"
+                           "REQUIRED XML CONFIGURATION\n\n"
+                           "  <physics_engines>\n"
+                           "    ...\n"
+                           "    <kinematics2d id=\"kin2d\" />\n"
+                           "    ...\n"
+                           "  </physics_engines>\n\n"
+                           "The 'id' attribute is necessary and must be unique among the physics engines.\n\n"
+                           "OPTIONAL XML CONFIGURATION\n\n"
+                           "The engine can perform several steps per simulation tick, each followed by\n"
+                           "the separation of the overlapping robots. The number of steps is set with\n"
+                           "the 'iterations' attribute:\n\n"
+                           "  <physics_engines>\n"
+                           "    ...\n"
+                           "    <kinematics2d id=\"kin2d\" iterations=\"20\" />\n"
+                           "    ...\n"
+                           "  </physics_engines>\n\n",
+                           "Under development"
+      );
+
+}
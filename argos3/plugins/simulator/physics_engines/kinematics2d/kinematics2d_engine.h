@@ -0,0 +1,224 @@
+/**
+ * @file <argos3/plugins/simulator/physics_engines/kinematics2d/kinematics2d_engine.h>
+ *
+ * @brief This file provides a kinematics-only 2D engine for large swarms.
+ *
+ * The engine moves differential-drive robots with unicycle kinematics and
+ * keeps them from overlapping, treating each robot as a disc. There are no
+ * forces, masses or friction. The state of all the robots is kept in
+ * parallel arrays (one array per quantity), so that the integration is a
+ * plain loop the compiler can vectorize, and the overlaps are found with a
+ * uniform grid rebuilt at every step.
+ *
+ * Only robots go in this engine. Walls, boxes and cylinders must be put
+ * in another engine, and robots do not collide with them; robots are only
+ * kept inside the arena.
+ *
+ * @author Jyotsna Bellary <jyotsnabellary@gmail.com>
+ */
+
+#ifndef KINEMATICS2D_ENGINE_H
+#define KINEMATICS2D_ENGINE_H
+
+namespace argos {
+   class CKinematics2DEngine;
+   class CKinematics2DModel;
+}
+
+#include <argos3/core/simulator/physics_engine/physics_engine.h>
+#include <argos3/core/simulator/entity/embodied_entity.h>
+#include <map>
+#include <vector>
+
+namespace argos {
+
+   /****************************************/
+   /****************************************/
+
+   class CKinematics2DEngine : public CPhysicsEngine {
+
+   public:
+
+      /**
+       * The state of the robots, one entry per robot in each array.
+       */
+      struct SBodies {
+         std::vector<Real> PosX;
+         std::vector<Real> PosY;
+         std::vector<Real> PosZ;
+         /* Heading as a unit vector */
+         std::vector<Real> Cos;
+         std::vector<Real> Sin;
+         std::vector<Real> Radius;
+         std::vector<Real> Height;
+         std::vector<Real> InterwheelDistance;
+         std::vector<Real> LeftVelocity;
+         std::vector<Real> RightVelocity;
+         std::vector<const Real*> WheelVelocities;
+      };
+
+   public:
+
+      CKinematics2DEngine();
+
+      virtual ~CKinematics2DEngine() {}
+
+      virtual void Init(TConfigurationNode& t_tree);
+
+      virtual void Reset();
+
+      virtual void Destroy();
+
+      virtual void Update();
+
+      virtual size_t GetNumPhysicsModels();
+
+      virtual bool AddEntity(CEntity& c_entity);
+
+      virtual bool RemoveEntity(CEntity& c_entity);
+
+      virtual bool IsPointContained(const CVector3& c_point);
+
+      virtual bool IsEntityTransferNeeded() const;
+
+      virtual void TransferEntities();
+
+      virtual void CheckIntersectionWithRay(TEmbodiedEntityIntersectionData& t_data,
+                                            const CRay3& c_ray) const;
+
+      void AddPhysicsModel(const std::string& str_id,
+                           CKinematics2DModel& c_model);
+
+      void RemovePhysicsModel(const std::string& str_id);
+
+      /**
+       * Sets the pose of a robot.
+       * @param un_index the index of the robot
+       * @param c_position the new position
+       * @param c_orientation the new orientation; only the rotation around Z is kept
+       */
+      void SetPose(size_t un_index,
+                   const CVector3& c_position,
+                   const CQuaternion& c_orientation);
+
+      /**
+       * Returns true if a robot overlaps another one.
+       * @param un_index the index of the robot
+       */
+      bool IsOverlapping(size_t un_index) const;
+
+      inline const SBodies& GetBodies() const {
+         return m_sBodies;
+      }
+
+   private:
+
+      void Integrate(Real f_dt);
+
+      void ResolveOverlaps();
+
+      void BuildGrid();
+
+      inline size_t GetCell(Real f_x, Real f_y) const;
+
+   private:
+
+      /** The robot models, indexed by id */
+      std::map<std::string, CKinematics2DModel*> m_tPhysicsModels;
+
+      /** The robot models, in the same order as the bodies */
+      std::vector<CKinematics2DModel*> m_vecModels;
+
+      /** The state of the robots */
+      SBodies m_sBodies;
+
+      /** Lower corner of the grid */
+      Real m_fGridMinX, m_fGridMinY;
+
+      /** Upper corner of the grid */
+      Real m_fGridMaxX, m_fGridMaxY;
+
+      /** Side of a grid cell, the diameter of the largest robot */
+      Real m_fCellSize;
+
+      /** Number of cells along each axis */
+      SInt32 m_nCellsX, m_nCellsY;
+
+      /** Index of the first robot of each cell in m_vecCellItems */
+      std::vector<UInt32> m_vecCellStart;
+
+      /** Robots sorted by cell */
+      std::vector<UInt32> m_vecCellItems;
+
+      /** Cell of each robot */
+      std::vector<UInt32> m_vecBodyCell;
+
+      /** True when the grid does not match the robot positions */
+      bool m_bGridDirty;
+   };
+
+   /****************************************/
+   /****************************************/
+
+   class CKinematics2DOperationAddEntity : public CEntityOperation<CKinematics2DOperationAddEntity, CKinematics2DEngine, SOperationOutcome> {
+   public:
+      virtual ~CKinematics2DOperationAddEntity() {}
+   };
+
+   class CKinematics2DOperationRemoveEntity : public CEntityOperation<CKinematics2DOperationRemoveEntity, CKinematics2DEngine, SOperationOutcome> {
+   public:
+      virtual ~CKinematics2DOperationRemoveEntity() {}
+   };
+
+#define REGISTER_KINEMATICS2D_OPERATION(ACTION, OPERATION, ENTITY)       \
+   REGISTER_ENTITY_OPERATION(ACTION, CKinematics2DEngine, OPERATION, SOperationOutcome, ENTITY);
+
+#define REGISTER_STANDARD_KINEMATICS2D_OPERATION_ADD_ENTITY(SPACE_ENTITY, KIN2D_MODEL) \
+   class CKinematics2DOperationAdd ## SPACE_ENTITY : public CKinematics2DOperationAddEntity { \
+   public:                                                              \
+   CKinematics2DOperationAdd ## SPACE_ENTITY() {}                       \
+   virtual ~CKinematics2DOperationAdd ## SPACE_ENTITY() {}              \
+   SOperationOutcome ApplyTo(CKinematics2DEngine& c_engine,             \
+                             SPACE_ENTITY& c_entity) {                  \
+      KIN2D_MODEL* pcPhysModel = new KIN2D_MODEL(c_engine,              \
+                                                 c_entity);             \
+      c_engine.AddPhysicsModel(c_entity.GetId(),                        \
+                               *pcPhysModel);                           \
+      c_entity.                                                         \
+         GetComponent<CEmbodiedEntity>("body").                         \
+         AddPhysicsModel(c_engine.GetId(), *pcPhysModel);               \
+      return SOperationOutcome(true);                                   \
+   }                                                                    \
+   };                                                                   \
+   REGISTER_KINEMATICS2D_OPERATION(CKinematics2DOperationAddEntity,     \
+                                   CKinematics2DOperationAdd ## SPACE_ENTITY, \
+                                   SPACE_ENTITY);
+
+#define REGISTER_STANDARD_KINEMATICS2D_OPERATION_REMOVE_ENTITY(SPACE_ENTITY) \
+   class CKinematics2DOperationRemove ## SPACE_ENTITY : public CKinematics2DOperationRemoveEntity { \
+   public:                                                              \
+   CKinematics2DOperationRemove ## SPACE_ENTITY() {}                    \
+   virtual ~CKinematics2DOperationRemove ## SPACE_ENTITY() {}           \
+   SOperationOutcome ApplyTo(CKinematics2DEngine& c_engine,             \
+                             SPACE_ENTITY& c_entity) {                  \
+      c_engine.RemovePhysicsModel(c_entity.GetId());                    \
+      c_entity.                                                         \
+         GetComponent<CEmbodiedEntity>("body").                         \
+         RemovePhysicsModel(c_engine.GetId());                          \
+      return SOperationOutcome(true);                                   \
+   }                                                                    \
+   };                                                                   \
+   REGISTER_KINEMATICS2D_OPERATION(CKinematics2DOperationRemoveEntity,  \
+                                   CKinematics2DOperationRemove ## SPACE_ENTITY, \
+                                   SPACE_ENTITY);
+
+#define REGISTER_STANDARD_KINEMATICS2D_OPERATIONS_ON_ENTITY(SPACE_ENTITY, KIN2D_ENTITY) \
+   REGISTER_STANDARD_KINEMATICS2D_OPERATION_ADD_ENTITY(SPACE_ENTITY, KIN2D_ENTITY) \
+   REGISTER_STANDARD_KINEMATICS2D_OPERATION_REMOVE_ENTITY(SPACE_ENTITY)
+
+   /****************************************/
+   /****************************************/
+
+}
+
+#endif
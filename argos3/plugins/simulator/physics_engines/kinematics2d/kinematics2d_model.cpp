@@ -0,0 +1,100 @@
+/**
+ * @file <argos3/plugins/simulator/physics_engines/kinematics2d/kinematics2d_model.cpp>
+ *
+ * @author Jyotsna Bellary <jyotsnabellary@gmail.com>
+ */
+
+#include "kinematics2d_model.h"
+#include <argos3/plugins/simulator/entities/wheeled_entity.h>
+
+namespace argos {
+
+   /****************************************/
+   /****************************************/
+
+   CKinematics2DModel::CKinematics2DModel(CKinematics2DEngine& c_engine,
+                                          CEmbodiedEntity& c_body,
+                                          CWheeledEntity& c_wheels,
+                                          Real f_radius,
+                                          Real f_height,
+                                          Real f_interwheel_distance) :
+      CPhysicsModel(c_engine, c_body),
+      m_cKinematics2DEngine(c_engine),
+      m_fRadius(f_radius),
+      m_fHeight(f_height),
+      m_fInterwheelDistance(f_interwheel_distance),
+      m_pfWheelVelocities(c_wheels.GetWheelVelocities()),
+      m_unIndex(0) {
+      RegisterAnchorMethod<CKinematics2DModel>(GetEmbodiedEntity().GetOriginAnchor(),
+                                               &CKinematics2DModel::UpdateOriginAnchor);
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CKinematics2DModel::Reset() {
+      m_cKinematics2DEngine.SetPose(m_unIndex,
+                                    GetEmbodiedEntity().GetOriginAnchor().Position,
+                                    GetEmbodiedEntity().GetOriginAnchor().Orientation);
+      UpdateEntityStatus();
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CKinematics2DModel::MoveTo(const CVector3& c_position,
+                                   const CQuaternion& c_orientation) {
+      m_cKinematics2DEngine.SetPose(m_unIndex, c_position, c_orientation);
+      UpdateEntityStatus();
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CKinematics2DModel::CalculateBoundingBox() {
+      const CKinematics2DEngine::SBodies& sBodies = m_cKinematics2DEngine.GetBodies();
+      GetBoundingBox().MinCorner.Set(sBodies.PosX[m_unIndex] - m_fRadius,
+                                     sBodies.PosY[m_unIndex] - m_fRadius,
+                                     sBodies.PosZ[m_unIndex]);
+      GetBoundingBox().MaxCorner.Set(sBodies.PosX[m_unIndex] + m_fRadius,
+                                     sBodies.PosY[m_unIndex] + m_fRadius,
+                                     sBodies.PosZ[m_unIndex] + m_fHeight);
+   }
+
+   /****************************************/
+   /****************************************/
+
+   bool CKinematics2DModel::IsPointContained(const CVector3& c_point) const {
+      const CKinematics2DEngine::SBodies& sBodies = m_cKinematics2DEngine.GetBodies();
+      Real fDX = c_point.GetX() - sBodies.PosX[m_unIndex];
+      Real fDY = c_point.GetY() - sBodies.PosY[m_unIndex];
+      Real fDZ = c_point.GetZ() - sBodies.PosZ[m_unIndex];
+      return
+         (fDX * fDX + fDY * fDY <= m_fRadius * m_fRadius) &&
+         (fDZ >= 0.0f) && (fDZ <= m_fHeight);
+   }
+
+   /****************************************/
+   /****************************************/
+
+   bool CKinematics2DModel::IsCollidingWithSomething() const {
+      return m_cKinematics2DEngine.IsOverlapping(m_unIndex);
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CKinematics2DModel::UpdateOriginAnchor(SAnchor& s_anchor) {
+      const CKinematics2DEngine::SBodies& sBodies = m_cKinematics2DEngine.GetBodies();
+      s_anchor.Position.Set(sBodies.PosX[m_unIndex],
+                            sBodies.PosY[m_unIndex],
+                            sBodies.PosZ[m_unIndex]);
+      s_anchor.Orientation.FromAngleAxis(
+         ATan2(sBodies.Sin[m_unIndex], sBodies.Cos[m_unIndex]),
+         CVector3::Z);
+   }
+
+   /****************************************/
+   /****************************************/
+
+}
@@ -0,0 +1,102 @@
+/**
+ * @file <argos3/plugins/simulator/physics_engines/kinematics2d/kinematics2d_model.h>
+ *
+ * @brief This file provides the model of a differential-drive disc robot
+ * for the kinematics2d engine.
+ *
+ * The model holds no state of its own: the pose of the robot lives in the
+ * arrays of the engine, and the model only tells the engine the size of
+ * the robot and where its wheel velocities are.
+ *
+ * @author Jyotsna Bellary <jyotsnabellary@gmail.com>
+ */
+
+#ifndef KINEMATICS2D_MODEL_H
+#define KINEMATICS2D_MODEL_H
+
+namespace argos {
+   class CKinematics2DEngine;
+   class CKinematics2DModel;
+   class CWheeledEntity;
+}
+
+#include <argos3/core/simulator/physics_engine/physics_model.h>
+#include <argos3/plugins/simulator/physics_engines/kinematics2d/kinematics2d_engine.h>
+
+namespace argos {
+
+   class CKinematics2DModel : public CPhysicsModel {
+
+   public:
+
+      /**
+       * Class constructor.
+       * @param c_engine the engine
+       * @param c_body the body of the robot
+       * @param c_wheels the wheels of the robot, left and right
+       * @param f_radius the radius of the robot
+       * @param f_height the height of the robot
+       * @param f_interwheel_distance the distance between the wheels
+       */
+      CKinematics2DModel(CKinematics2DEngine& c_engine,
+                         CEmbodiedEntity& c_body,
+                         CWheeledEntity& c_wheels,
+                         Real f_radius,
+                         Real f_height,
+                         Real f_interwheel_distance);
+
+      virtual ~CKinematics2DModel() {}
+
+      virtual void Reset();
+
+      virtual void MoveTo(const CVector3& c_position,
+                          const CQuaternion& c_orientation);
+
+      virtual void CalculateBoundingBox();
+
+      virtual void UpdateFromEntityStatus() {}
+
+      virtual bool IsPointContained(const CVector3& c_point) const;
+
+      virtual bool IsCollidingWithSomething() const;
+
+      void UpdateOriginAnchor(SAnchor& s_anchor);
+
+      inline Real GetRadius() const {
+         return m_fRadius;
+      }
+
+      inline Real GetHeight() const {
+         return m_fHeight;
+      }
+
+      inline Real GetInterwheelDistance() const {
+         return m_fInterwheelDistance;
+      }
+
+      inline const Real* GetWheelVelocities() const {
+         return m_pfWheelVelocities;
+      }
+
+      /**
+       * Returns the index of the robot in the arrays of the engine.
+       */
+      inline size_t GetIndex() const {
+         return m_unIndex;
+      }
+
+   private:
+
+      friend class CKinematics2DEngine;
+
+      CKinematics2DEngine& m_cKinematics2DEngine;
+      Real m_fRadius;
+      Real m_fHeight;
+      Real m_fInterwheelDistance;
+      const Real* m_pfWheelVelocities;
+      size_t m_unIndex;
+   };
+
+}
+
+#endif
@@ -0,0 +1,230 @@
+/**
+ * @file <argos3/plugins/simulator/sensors/robot_sensors/gated_proximity_sensor.cpp>
+ *
+ * @author Jyotsna Bellary <jyotsnabellary@gmail.com>
+ */
+
+#include "gated_proximity_sensor.h"
+
+#include <argos3/core/simulator/entity/embodied_entity.h>
+#include <argos3/core/simulator/entity/composable_entity.h>
+#include <argos3/core/simulator/simulator.h>
+#include <argos3/core/simulator/space/space.h>
+#include <argos3/plugins/simulator/entities/proximity_sensor_equipped_entity.h>
+
+#include <limits>
+
+namespace argos {
+
+   /****************************************/
+   /****************************************/
+
+   static CRange<Real> UNIT(0.0f, 1.0f);
+
+   /** Side of a grid cell, in meters; well above the reach of the IR rings */
+   static const Real CELL_SIZE = 0.5;
+
+   static const UInt32 INVALID_CLOCK = std::numeric_limits<UInt32>::max();
+
+   /****************************************/
+   /****************************************/
+
+   CProximityNeighbourIndex& CProximityNeighbourIndex::GetInstance() {
+      static CProximityNeighbourIndex cInstance;
+      return cInstance;
+   }
+
+   /****************************************/
+   /****************************************/
+
+   CProximityNeighbourIndex::CProximityNeighbourIndex() :
+      m_pcSpace(nullptr),
+      m_nSizeI(0),
+      m_nSizeJ(0),
+      m_unBuiltAt(INVALID_CLOCK) {}
+
+   /****************************************/
+   /****************************************/
+
+   bool CProximityNeighbourIndex::IsAnyEntityInBoxRange(const CVector3& c_center,
+                                                        const CVector3& c_half_size,
+                                                        const CEmbodiedEntity& c_ignored) {
+      Update();
+      CVector3 cMin(c_center - c_half_size);
+      CVector3 cMax(c_center + c_half_size);
+      SInt32 nMinI, nMinJ, nMaxI, nMaxJ;
+      PositionToCell(nMinI, nMinJ, cMin);
+      PositionToCell(nMaxI, nMaxJ, cMax);
+      for(SInt32 j = nMinJ; j <= nMaxJ; ++j) {
+         for(SInt32 i = nMinI; i <= nMaxI; ++i) {
+            const std::vector<SEntry>& vecCell = m_vecCells[j * m_nSizeI + i];
+            for(size_t k = 0; k < vecCell.size(); ++k) {
+               const SEntry& sEntry = vecCell[k];
+               if(sEntry.Entity != &c_ignored &&
+                  sEntry.MinCorner.GetX() <= cMax.GetX() && sEntry.MaxCorner.GetX() >= cMin.GetX() &&
+                  sEntry.MinCorner.GetY() <= cMax.GetY() && sEntry.MaxCorner.GetY() >= cMin.GetY() &&
+                  sEntry.MinCorner.GetZ() <= cMax.GetZ() && sEntry.MaxCorner.GetZ() >= cMin.GetZ()) {
+                  return true;
+               }
+            }
+         }
+      }
+      return false;
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CProximityNeighbourIndex::Invalidate() {
+      m_unBuiltAt.store(INVALID_CLOCK, std::memory_order_release);
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CProximityNeighbourIndex::Update() {
+      CSpace& cSpace = CSimulator::GetInstance().GetSpace();
+      UInt32 unClock = cSpace.GetSimulationClock();
+      if(m_unBuiltAt.load(std::memory_order_acquire) == unClock) return;
+      std::lock_guard<std::mutex> cLock(m_cMutex);
+      if(m_unBuiltAt.load(std::memory_order_relaxed) == unClock) return;
+      /* A new experiment may have a different arena */
+      if(m_pcSpace != &cSpace || m_cArenaSize != cSpace.GetArenaSize()) {
+         Resize(cSpace);
+      }
+      /* Clearing keeps the capacity of the cells, so this is allocation-free once warm */
+      for(size_t i = 0; i < m_vecCells.size(); ++i) {
+         m_vecCells[i].clear();
+      }
+      CSpace::TMapPerType& mapBodies = cSpace.GetEntitiesByType("body");
+      SInt32 nMinI, nMinJ, nMaxI, nMaxJ;
+      for(auto it = mapBodies.begin(); it != mapBodies.end(); ++it) {
+         CEmbodiedEntity& cBody = *any_cast<CEmbodiedEntity*>(it->second);
+         /* A disabled robot, e.g. parked by a pool, is not in the arena */
+         if(! cBody.GetRootEntity().IsEnabled()) continue;
+         const SBoundingBox& sBox = cBody.GetBoundingBox();
+         SEntry sEntry = { sBox.MinCorner, sBox.MaxCorner, &cBody };
+         PositionToCell(nMinI, nMinJ, sBox.MinCorner);
+         PositionToCell(nMaxI, nMaxJ, sBox.MaxCorner);
+         for(SInt32 j = nMinJ; j <= nMaxJ; ++j) {
+            for(SInt32 i = nMinI; i <= nMaxI; ++i) {
+               m_vecCells[j * m_nSizeI + i].push_back(sEntry);
+            }
+         }
+      }
+      m_unBuiltAt.store(unClock, std::memory_order_release);
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CProximityNeighbourIndex::Resize(CSpace& c_space) {
+      /* The grid spans the arena on the XY plane */
+      m_pcSpace = &c_space;
+      m_cArenaSize = c_space.GetArenaSize();
+      m_cAreaMin = c_space.GetArenaCenter() - m_cArenaSize * 0.5f;
+      m_nSizeI = Max<SInt32>(1, Ceil(m_cArenaSize.GetX() / CELL_SIZE));
+      m_nSizeJ = Max<SInt32>(1, Ceil(m_cArenaSize.GetY() / CELL_SIZE));
+      m_vecCells.assign(m_nSizeI * m_nSizeJ, std::vector<SEntry>());
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CProximityNeighbourIndex::PositionToCell(SInt32& n_i,
+                                                 SInt32& n_j,
+                                                 const CVector3& c_position) const {
+      n_i = Floor((c_position.GetX() - m_cAreaMin.GetX()) / CELL_SIZE);
+      n_j = Floor((c_position.GetY() - m_cAreaMin.GetY()) / CELL_SIZE);
+      n_i = Min(Max(n_i, 0), m_nSizeI - 1);
+      n_j = Min(Max(n_j, 0), m_nSizeJ - 1);
+   }
+
+   /****************************************/
+   /****************************************/
+
+   CGatedProximitySensor::CGatedProximitySensor(const std::string& str_robot) :
+      m_strRobot(str_robot),
+      m_fReach(0.0f) {}
+
+   /****************************************/
+   /****************************************/
+
+   void CGatedProximitySensor::SetRobot(CComposableEntity& c_entity) {
+      try {
+         m_pcEmbodiedEntity = &(c_entity.GetComponent<CEmbodiedEntity>("body"));
+         m_pcControllableEntity = &(c_entity.GetComponent<CControllableEntity>("controller"));
+         m_pcProximityEntity = &(c_entity.GetComponent<CProximitySensorEquippedEntity>("proximity_sensors[proximity]"));
+         m_pcProximityEntity->Enable();
+      }
+      catch(CARGoSException& ex) {
+         THROW_ARGOSEXCEPTION_NESTED("Can't set robot for the " << m_strRobot << " proximity default sensor", ex);
+      }
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CGatedProximitySensor::Init(TConfigurationNode& t_tree) {
+      CProximityDefaultSensor::Init(t_tree);
+      /* The farthest point any ray can reach, relative to the anchor */
+      m_fReach = 0.0f;
+      for(size_t i = 0; i < m_pcProximityEntity->GetNumSensors(); ++i) {
+         const CProximitySensorEquippedEntity::SSensor& sSensor = m_pcProximityEntity->GetSensor(i);
+         m_fReach = Max(m_fReach, sSensor.Offset.Length());
+         m_fReach = Max(m_fReach, (sSensor.Offset + sSensor.Direction).Length());
+      }
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CGatedProximitySensor::Update() {
+      /*
+       * Skip the ray casting when no other embodied entity is within reach
+       * of the IR ring. When the rays must be shown, always cast them.
+       */
+      if(!m_bShowRays &&
+         !CProximityNeighbourIndex::GetInstance().IsAnyEntityInBoxRange(
+            m_pcEmbodiedEntity->GetOriginAnchor().Position,
+            CVector3(m_fReach, m_fReach, m_fReach),
+            *m_pcEmbodiedEntity)) {
+         for(size_t i = 0; i < m_tReadings.size(); ++i) {
+            m_tReadings[i] = 0.0f;
+            if(m_bAddNoise) {
+               m_tReadings[i] += m_pcRNG->Uniform(m_cNoiseRange);
+               UNIT.TruncValue(m_tReadings[i]);
+            }
+         }
+         return;
+      }
+      CProximityDefaultSensor::Update();
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CGatedProximitySensor::Reset() {
+      CProximityDefaultSensor::Reset();
+      CProximityNeighbourIndex::GetInstance().Invalidate();
+   }
+
+   /****************************************/
+   /****************************************/
+
+   Real CGatedProximitySensor::CalculateReading(Real f_distance) {
+      if(f_distance < 0.04) {
+         return 1.0;
+      }
+      else if(f_distance > 0.12){
+         return 0.0;
+      }
+      else {
+         return 4.14*exp(-33.0*f_distance)-.085;
+      }
+   }
+
+   /****************************************/
+   /****************************************/
+
+}
@@ -0,0 +1,122 @@
+/**
+ * @file <argos3/plugins/simulator/sensors/robot_sensors/gated_proximity_sensor.h>
+ *
+ * @brief This file provides the IR proximity model shared by the Turtlebot4
+ * and the e-puck.
+ *
+ * CGatedProximitySensor is a CProximityDefaultSensor that first asks
+ * CProximityNeighbourIndex whether any other embodied entity is within
+ * reach of the IR ring. If nothing is, the rays are not cast and all the
+ * readings are zero (plus noise, if configured). The index is a uniform XY
+ * grid over the bounding boxes of the enabled bodies in the space, rebuilt at most
+ * once per step by whichever sensor queries it first, and shared by the
+ * sensors of all the robot types.
+ *
+ * @author Jyotsna Bellary <jyotsnabellary@gmail.com>
+ */
+
+#ifndef GATED_PROXIMITY_SENSOR_H
+#define GATED_PROXIMITY_SENSOR_H
+
+namespace argos {
+   class CProximityNeighbourIndex;
+   class CGatedProximitySensor;
+   class CEmbodiedEntity;
+   class CSpace;
+}
+
+#include <argos3/plugins/robots/generic/simulator/proximity_default_sensor.h>
+#include <argos3/core/utility/math/vector3.h>
+#include <atomic>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace argos {
+
+   class CProximityNeighbourIndex {
+
+   public:
+
+      static CProximityNeighbourIndex& GetInstance();
+
+      /**
+       * Returns true if the bounding box of any embodied entity but
+       * c_ignored overlaps the given box.
+       */
+      bool IsAnyEntityInBoxRange(const CVector3& c_center,
+                                 const CVector3& c_half_size,
+                                 const CEmbodiedEntity& c_ignored);
+
+      /** Forces a rebuild at the next query, e.g., after a reset of the experiment */
+      void Invalidate();
+
+   private:
+
+      struct SEntry {
+         CVector3 MinCorner;
+         CVector3 MaxCorner;
+         const CEmbodiedEntity* Entity;
+      };
+
+      CProximityNeighbourIndex();
+
+      void Update();
+
+      /** Sizes the grid after the arena of the current space */
+      void Resize(CSpace& c_space);
+
+      void PositionToCell(SInt32& n_i, SInt32& n_j, const CVector3& c_position) const;
+
+   private:
+
+      /** The space and arena the grid was sized for */
+      CSpace* m_pcSpace;
+      CVector3 m_cArenaSize;
+      CVector3 m_cAreaMin;
+      SInt32 m_nSizeI;
+      SInt32 m_nSizeJ;
+      std::vector<std::vector<SEntry> > m_vecCells;
+      std::atomic<UInt32> m_unBuiltAt;
+      std::mutex m_cMutex;
+   };
+
+   /****************************************/
+   /****************************************/
+
+   class CGatedProximitySensor : public CProximityDefaultSensor {
+
+   public:
+
+      /**
+       * @param str_robot the robot type, as shown in the error messages
+       */
+      CGatedProximitySensor(const std::string& str_robot);
+
+      virtual ~CGatedProximitySensor() {}
+
+      virtual void SetRobot(CComposableEntity& c_entity);
+
+      virtual void Init(TConfigurationNode& t_tree);
+
+      virtual void Update();
+
+      virtual void Reset();
+
+      /**
+       * The e-puck IR response, shared by both robots.
+       */
+      virtual Real CalculateReading(Real f_distance);
+
+   private:
+
+      /** Robot type, for the error messages */
+      std::string m_strRobot;
+
+      /** Farthest distance from the anchor covered by the IR rays */
+      Real m_fReach;
+   };
+
+}
+
+#endif
@@ -0,0 +1,78 @@
+/**
+ * @file <argos3/plugins/simulator/sensors/robot_sensors/lidar_geometry.cpp>
+ *
+ * @author Jyotsna Bellary <jyotsnabellary@gmail.com>
+ */
+
+#include "lidar_geometry.h"
+
+#include <map>
+#include <memory>
+#include <mutex>
+
+namespace argos {
+
+   /****************************************/
+   /****************************************/
+
+   static void BuildLIDARGeometry(SLIDARGeometry& s_geometry,
+                                  Real f_elevation,
+                                  Real f_fan_radius,
+                                  const CRange<Real>& c_range,
+                                  const CRadians& c_angle_span,
+                                  UInt32 un_num_readings) {
+      CVector3 cCenter(0.0, 0.0, f_elevation);
+      Real fRadius = f_fan_radius + c_range.GetMin();
+      Real fRange = f_fan_radius + c_range.GetMax();
+      CRadians cStartAngle = -c_angle_span * 0.5;
+      CRadians cSpacing = (un_num_readings > 1) ?
+         c_angle_span / (un_num_readings - 1) :
+         CRadians::ZERO;
+      s_geometry.RayStarts.resize(un_num_readings);
+      s_geometry.RayEnds.resize(un_num_readings);
+      CRadians cAngle;
+      CVector3 cOff, cDir;
+      for(UInt32 i = 0; i < un_num_readings; ++i) {
+         cAngle = cStartAngle + i * cSpacing;
+         cAngle.SignedNormalize();
+         cOff.Set(fRadius, 0.0f, 0.0f);
+         cOff.RotateZ(cAngle);
+         cOff += cCenter;
+         cDir.Set(fRange, 0.0f, 0.0f);
+         cDir.RotateZ(cAngle);
+         s_geometry.RayStarts[i] = cOff;
+         s_geometry.RayEnds[i] = cOff + cDir;
+      }
+   }
+
+   /****************************************/
+   /****************************************/
+
+   const SLIDARGeometry& CLIDARGeometryCache::Get(const std::string& str_model,
+                                                  Real f_elevation,
+                                                  Real f_fan_radius,
+                                                  const CRange<Real>& c_range,
+                                                  const CRadians& c_angle_span,
+                                                  UInt32 un_num_readings) {
+      static std::map<std::pair<std::string, UInt32>,
+                      std::unique_ptr<SLIDARGeometry> > mapGeometries;
+      static std::mutex cMutex;
+      std::lock_guard<std::mutex> cLock(cMutex);
+      std::unique_ptr<SLIDARGeometry>& psGeometry =
+         mapGeometries[std::make_pair(str_model, un_num_readings)];
+      if(! psGeometry) {
+         psGeometry.reset(new SLIDARGeometry);
+         BuildLIDARGeometry(*psGeometry,
+                            f_elevation,
+                            f_fan_radius,
+                            c_range,
+                            c_angle_span,
+                            un_num_readings);
+      }
+      return *psGeometry;
+   }
+
+   /****************************************/
+   /****************************************/
+
+}
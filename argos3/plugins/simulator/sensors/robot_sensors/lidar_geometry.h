@@ -0,0 +1,70 @@
+/**
+ * @file <argos3/plugins/simulator/sensors/robot_sensors/lidar_geometry.h>
+ *
+ * @brief This file provides the LIDAR ray geometry shared by the Turtlebot4
+ * and the e-puck.
+ *
+ * The rays of a LIDAR fan, in the frame of the robot origin anchor, are the
+ * same for all the robots of a model. CLIDARGeometryCache builds them once
+ * per model and number of readings, and every sensor only transforms them
+ * with the anchor of its robot.
+ *
+ * @author Jyotsna Bellary <jyotsnabellary@gmail.com>
+ */
+
+#ifndef LIDAR_GEOMETRY_H
+#define LIDAR_GEOMETRY_H
+
+namespace argos {
+   struct SLIDARGeometry;
+   class CLIDARGeometryCache;
+}
+
+#include <argos3/core/utility/datatypes/datatypes.h>
+#include <argos3/core/utility/math/angles.h>
+#include <argos3/core/utility/math/range.h>
+#include <argos3/core/utility/math/vector3.h>
+#include <string>
+#include <vector>
+
+namespace argos {
+
+   /**
+    * The ray geometry of a LIDAR, in the frame of the robot origin anchor.
+    */
+   struct SLIDARGeometry {
+      std::vector<CVector3> RayStarts;
+      std::vector<CVector3> RayEnds;
+   };
+
+   /****************************************/
+   /****************************************/
+
+   class CLIDARGeometryCache {
+
+   public:
+
+      /**
+       * Returns the geometry of a LIDAR fan, creating it on first use. The
+       * returned reference stays valid for the whole run. The rays are laid
+       * out as in CProximitySensorEquippedEntity::AddSensorFan().
+       * @param str_model the robot model, such as "turtlebot4"; the fan
+       * parameters must be the same for all the calls with the same model
+       * @param f_elevation the elevation of the fan center
+       * @param f_fan_radius the distance of the rays from the fan center
+       * @param c_range the range of the readings, from the fan radius
+       * @param c_angle_span the angle covered by the rays
+       * @param un_num_readings the number of rays
+       */
+      static const SLIDARGeometry& Get(const std::string& str_model,
+                                       Real f_elevation,
+                                       Real f_fan_radius,
+                                       const CRange<Real>& c_range,
+                                       const CRadians& c_angle_span,
+                                       UInt32 un_num_readings);
+
+   };
+
+}
+
+#endif
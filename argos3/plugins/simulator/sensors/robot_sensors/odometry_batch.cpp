@@ -0,0 +1,245 @@
+/**
+ * @file <argos3/plugins/simulator/sensors/robot_sensors/odometry_batch.cpp>
+ *
+ * @author Jyotsna Bellary <jyotsnabellary@gmail.com>
+ */
+
+#include "odometry_batch.h"
+
+#include <argos3/core/simulator/simulator.h>
+#include <argos3/core/simulator/space/space.h>
+#include <argos3/core/simulator/entity/embodied_entity.h>
+#include <argos3/core/simulator/physics_engine/physics_engine.h>
+#include <argos3/plugins/simulator/entities/wheeled_entity.h>
+
+#include <cmath>
+
+namespace argos {
+
+   /****************************************/
+   /****************************************/
+
+   static const Real TWO_PI = 2.0 * ARGOS_PI;
+
+   /*
+    * Yaw of a quaternion, without going through the full Euler
+    * decomposition.
+    */
+   static Real Yaw(const CQuaternion& c_orientation) {
+      return std::atan2(2.0 * (c_orientation.GetW() * c_orientation.GetZ() +
+                               c_orientation.GetX() * c_orientation.GetY()),
+                        1.0 - 2.0 * (c_orientation.GetY() * c_orientation.GetY() +
+                                     c_orientation.GetZ() * c_orientation.GetZ()));
+   }
+
+   /****************************************/
+   /****************************************/
+
+   COdometryBatch& COdometryBatch::GetInstance() {
+      static COdometryBatch cInstance;
+      return cInstance;
+   }
+
+   /****************************************/
+   /****************************************/
+
+   COdometryBatch::COdometryBatch() :
+      m_pcRNG(nullptr),
+      m_nLastClock(-1) {}
+
+   /****************************************/
+   /****************************************/
+
+   void COdometryBatch::Add(SInt64& n_slot,
+                            CEmbodiedEntity& c_body,
+                            CWheeledEntity& c_wheels,
+                            TConfigurationNode& t_tree) {
+      /* Parse the slip and noise model */
+      Real fSlip = 0.0f;
+      GetNodeAttributeOrDefault(t_tree, "slip", fSlip, fSlip);
+      if(fSlip < 0.0f || fSlip > 1.0f) {
+         THROW_ARGOSEXCEPTION("The slip of the odometry sensor must be between 0 and 1");
+      }
+      Real fLinearNoise = 0.0f;
+      GetNodeAttributeOrDefault(t_tree, "linear_noise", fLinearNoise, fLinearNoise);
+      Real fAngularNoise = 0.0f;
+      GetNodeAttributeOrDefault(t_tree, "angular_noise", fAngularNoise, fAngularNoise);
+      if(fLinearNoise < 0.0f || fAngularNoise < 0.0f) {
+         THROW_ARGOSEXCEPTION("Can't specify a negative value for the noise of the odometry sensor");
+      }
+      std::lock_guard<std::mutex> cLock(m_cMutex);
+      if(m_pcRNG == nullptr && (fLinearNoise > 0.0f || fAngularNoise > 0.0f)) {
+         m_pcRNG = CRandom::CreateRNG("argos");
+      }
+      m_vecSlots.push_back(&n_slot);
+      m_vecBodies.push_back(&c_body);
+      m_vecWheels.push_back(&c_wheels);
+      m_vecInterwheelDistance.push_back(
+         (c_wheels.GetWheelPosition(0) - c_wheels.GetWheelPosition(1)).Length());
+      m_vecSlip.push_back(fSlip);
+      m_vecLinearNoise.push_back(fLinearNoise);
+      m_vecAngularNoise.push_back(fAngularNoise);
+      m_vecPosX.push_back(0.0f);
+      m_vecPosY.push_back(0.0f);
+      m_vecYaw.push_back(0.0f);
+      m_vecBodyStep.push_back(0.0f);
+      m_vecBodyTurn.push_back(0.0f);
+      m_vecWheelStep.push_back(0.0f);
+      m_vecWheelTurn.push_back(0.0f);
+      m_vecEstX.push_back(0.0f);
+      m_vecEstY.push_back(0.0f);
+      m_vecEstYaw.push_back(0.0f);
+      m_vecLinearVelocity.push_back(0.0f);
+      m_vecAngularVelocity.push_back(0.0f);
+      size_t unSlot = m_vecSlots.size() - 1;
+      const SAnchor& sOrigin = c_body.GetOriginAnchor();
+      m_vecPosX[unSlot] = sOrigin.Position.GetX();
+      m_vecPosY[unSlot] = sOrigin.Position.GetY();
+      m_vecYaw[unSlot] = Yaw(sOrigin.Orientation);
+      n_slot = unSlot;
+   }
+
+   /****************************************/
+   /****************************************/
+
+   template<typename T>
+   static void SwapRemove(std::vector<T>& vec_data, size_t un_slot) {
+      vec_data[un_slot] = vec_data.back();
+      vec_data.pop_back();
+   }
+
+   void COdometryBatch::Remove(SInt64& n_slot) {
+      std::lock_guard<std::mutex> cLock(m_cMutex);
+      size_t unSlot = n_slot;
+      n_slot = -1;
+      SwapRemove(m_vecSlots, unSlot);
+      SwapRemove(m_vecBodies, unSlot);
+      SwapRemove(m_vecWheels, unSlot);
+      SwapRemove(m_vecInterwheelDistance, unSlot);
+      SwapRemove(m_vecSlip, unSlot);
+      SwapRemove(m_vecLinearNoise, unSlot);
+      SwapRemove(m_vecAngularNoise, unSlot);
+      SwapRemove(m_vecPosX, unSlot);
+      SwapRemove(m_vecPosY, unSlot);
+      SwapRemove(m_vecYaw, unSlot);
+      SwapRemove(m_vecBodyStep, unSlot);
+      SwapRemove(m_vecBodyTurn, unSlot);
+      SwapRemove(m_vecWheelStep, unSlot);
+      SwapRemove(m_vecWheelTurn, unSlot);
+      SwapRemove(m_vecEstX, unSlot);
+      SwapRemove(m_vecEstY, unSlot);
+      SwapRemove(m_vecEstYaw, unSlot);
+      SwapRemove(m_vecLinearVelocity, unSlot);
+      SwapRemove(m_vecAngularVelocity, unSlot);
+      /* the sensor that was last now lives in the freed slot */
+      if(unSlot < m_vecSlots.size()) {
+         *m_vecSlots[unSlot] = unSlot;
+      }
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void COdometryBatch::Reset(size_t un_slot) {
+      std::lock_guard<std::mutex> cLock(m_cMutex);
+      const SAnchor& sOrigin = m_vecBodies[un_slot]->GetOriginAnchor();
+      m_vecPosX[un_slot] = sOrigin.Position.GetX();
+      m_vecPosY[un_slot] = sOrigin.Position.GetY();
+      m_vecYaw[un_slot] = Yaw(sOrigin.Orientation);
+      m_vecEstX[un_slot] = 0.0f;
+      m_vecEstY[un_slot] = 0.0f;
+      m_vecEstYaw[un_slot] = 0.0f;
+      m_vecLinearVelocity[un_slot] = 0.0f;
+      m_vecAngularVelocity[un_slot] = 0.0f;
+      m_nLastClock.store(-1);
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void COdometryBatch::Update() {
+      SInt64 nClock = CSimulator::GetInstance().GetSpace().GetSimulationClock();
+      /* another sensor has done it already at this tick */
+      if(m_nLastClock.load(std::memory_order_acquire) == nClock) {
+         return;
+      }
+      std::lock_guard<std::mutex> cLock(m_cMutex);
+      SInt64 nLastClock = m_nLastClock.load(std::memory_order_relaxed);
+      if(nLastClock == nClock) {
+         return;
+      }
+      /* if no sensor was updated for a while, integrate over the whole gap */
+      Real fDt = CPhysicsEngine::GetSimulationClockTick();
+      if(nLastClock >= 0 && nLastClock < nClock) {
+         fDt *= (nClock - nLastClock);
+      }
+      Integrate(fDt);
+      m_nLastClock.store(nClock, std::memory_order_release);
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void COdometryBatch::Integrate(Real f_dt) {
+      size_t unSize = m_vecSlots.size();
+      /* gather the actual motion of the bodies and the motion of the wheels */
+      for(size_t i = 0; i < unSize; ++i) {
+         /* a disabled robot, e.g. parked by a pool, keeps its estimate */
+         if(! m_vecBodies[i]->GetRootEntity().IsEnabled()) {
+            m_vecBodyStep[i] = 0.0f;
+            m_vecBodyTurn[i] = 0.0f;
+            m_vecWheelStep[i] = 0.0f;
+            m_vecWheelTurn[i] = 0.0f;
+            continue;
+         }
+         const SAnchor& sOrigin = m_vecBodies[i]->GetOriginAnchor();
+         Real fPosX = sOrigin.Position.GetX();
+         Real fPosY = sOrigin.Position.GetY();
+         Real fYaw = Yaw(sOrigin.Orientation);
+         Real fCos = std::cos(m_vecYaw[i]);
+         Real fSin = std::sin(m_vecYaw[i]);
+         m_vecBodyStep[i] = (fPosX - m_vecPosX[i]) * fCos + (fPosY - m_vecPosY[i]) * fSin;
+         m_vecBodyTurn[i] = std::remainder(fYaw - m_vecYaw[i], TWO_PI);
+         m_vecPosX[i] = fPosX;
+         m_vecPosY[i] = fPosY;
+         m_vecYaw[i] = fYaw;
+         const Real* pfWheelVelocities = m_vecWheels[i]->GetWheelVelocities();
+         m_vecWheelStep[i] = 0.5f * (pfWheelVelocities[0] + pfWheelVelocities[1]) * f_dt;
+         m_vecWheelTurn[i] = (pfWheelVelocities[1] - pfWheelVelocities[0]) / m_vecInterwheelDistance[i] * f_dt;
+      }
+      /* slip: how much of the wheel motion that did not move the body the sensor sees */
+      Real* pfStep = m_vecBodyStep.data();
+      Real* pfTurn = m_vecBodyTurn.data();
+      const Real* pfWheelStep = m_vecWheelStep.data();
+      const Real* pfWheelTurn = m_vecWheelTurn.data();
+      const Real* pfSlip = m_vecSlip.data();
+      for(size_t i = 0; i < unSize; ++i) {
+         pfStep[i] += pfSlip[i] * (pfWheelStep[i] - pfStep[i]);
+         pfTurn[i] += pfSlip[i] * (pfWheelTurn[i] - pfTurn[i]);
+      }
+      /* noise, proportional to the motion */
+      if(m_pcRNG != nullptr) {
+         for(size_t i = 0; i < unSize; ++i) {
+            if(m_vecLinearNoise[i] > 0.0f) {
+               pfStep[i] *= 1.0f + m_pcRNG->Gaussian(m_vecLinearNoise[i]);
+            }
+            if(m_vecAngularNoise[i] > 0.0f) {
+               pfTurn[i] *= 1.0f + m_pcRNG->Gaussian(m_vecAngularNoise[i]);
+            }
+         }
+      }
+      /* integrate the estimate at the midpoint heading */
+      for(size_t i = 0; i < unSize; ++i) {
+         Real fHeading = m_vecEstYaw[i] + 0.5f * pfTurn[i];
+         m_vecEstX[i] += pfStep[i] * std::cos(fHeading);
+         m_vecEstY[i] += pfStep[i] * std::sin(fHeading);
+         m_vecEstYaw[i] = std::remainder(m_vecEstYaw[i] + pfTurn[i], TWO_PI);
+         m_vecLinearVelocity[i] = pfStep[i] / f_dt;
+         m_vecAngularVelocity[i] = pfTurn[i] / f_dt;
+      }
+   }
+
+   /****************************************/
+   /****************************************/
+
+}
@@ -0,0 +1,122 @@
+/**
+ * @file <argos3/plugins/simulator/sensors/robot_sensors/odometry_batch.h>
+ *
+ * @brief This file provides the wheel odometry model shared by the Turtlebot4
+ * and the e-puck.
+ *
+ * The state of all the odometry sensors is stored as one array per
+ * quantity. The first sensor updated at a tick integrates every robot in a
+ * single pass; the others only copy their slot. The sensors of both robot
+ * types share the same batch. Disabled robots are not integrated, and a
+ * robot that is moved by hand must have its slot reset.
+ *
+ * @author Jyotsna Bellary <jyotsnabellary@gmail.com>
+ */
+
+#ifndef ODOMETRY_BATCH_H
+#define ODOMETRY_BATCH_H
+
+namespace argos {
+   class COdometryBatch;
+   class CEmbodiedEntity;
+   class CWheeledEntity;
+}
+
+#include <argos3/core/utility/configuration/argos_configuration.h>
+#include <argos3/core/utility/math/rng.h>
+#include <atomic>
+#include <mutex>
+#include <vector>
+
+namespace argos {
+
+   class COdometryBatch {
+
+   public:
+
+      static COdometryBatch& GetInstance();
+
+      /**
+       * Adds a sensor, with the slip and noise model in its XML node.
+       * @param n_slot where the slot of the sensor is stored. It is updated
+       * when the sensor moves to another slot, and set to -1 on removal.
+       * @param c_body the body of the robot
+       * @param c_wheels the wheels of the robot
+       * @param t_tree the XML node of the sensor
+       * @throws CARGoSException if the model is not valid
+       */
+      void Add(SInt64& n_slot,
+               CEmbodiedEntity& c_body,
+               CWheeledEntity& c_wheels,
+               TConfigurationNode& t_tree);
+
+      /**
+       * Removes the sensor in the given slot. The last sensor takes its slot.
+       */
+      void Remove(SInt64& n_slot);
+
+      /**
+       * Restarts the estimate of the given slot from the current pose.
+       */
+      void Reset(size_t un_slot);
+
+      /**
+       * Integrates all the sensors, once per tick.
+       */
+      void Update();
+
+      /**
+       * Copies the estimate of the given slot into a reading with the
+       * fields Position, Orientation, LinearVelocity and AngularVelocity.
+       */
+      template<typename READING>
+      void GetReading(size_t un_slot,
+                      READING& s_reading) const {
+         s_reading.Position.Set(m_vecEstX[un_slot], m_vecEstY[un_slot]);
+         s_reading.Orientation.SetValue(m_vecEstYaw[un_slot]);
+         s_reading.LinearVelocity = m_vecLinearVelocity[un_slot];
+         s_reading.AngularVelocity = m_vecAngularVelocity[un_slot];
+      }
+
+   private:
+
+      COdometryBatch();
+
+      void Integrate(Real f_dt);
+
+   private:
+
+      /* inputs */
+      std::vector<SInt64*> m_vecSlots;
+      std::vector<CEmbodiedEntity*> m_vecBodies;
+      std::vector<CWheeledEntity*> m_vecWheels;
+      std::vector<Real> m_vecInterwheelDistance;
+      std::vector<Real> m_vecSlip;
+      std::vector<Real> m_vecLinearNoise;
+      std::vector<Real> m_vecAngularNoise;
+      /* actual pose at the last update */
+      std::vector<Real> m_vecPosX;
+      std::vector<Real> m_vecPosY;
+      std::vector<Real> m_vecYaw;
+      /* motion in the last step, in the robot frame */
+      std::vector<Real> m_vecBodyStep;
+      std::vector<Real> m_vecBodyTurn;
+      std::vector<Real> m_vecWheelStep;
+      std::vector<Real> m_vecWheelTurn;
+      /* estimate */
+      std::vector<Real> m_vecEstX;
+      std::vector<Real> m_vecEstY;
+      std::vector<Real> m_vecEstYaw;
+      std::vector<Real> m_vecLinearVelocity;
+      std::vector<Real> m_vecAngularVelocity;
+
+      CRandom::CRNG* m_pcRNG;
+
+      /* the tick of the last update, -1 if none */
+      std::atomic<SInt64> m_nLastClock;
+      std::mutex m_cMutex;
+   };
+
+}
+
+#endif
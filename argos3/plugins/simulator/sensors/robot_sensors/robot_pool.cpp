@@ -0,0 +1,164 @@
+/**
+ * @file <argos3/plugins/simulator/sensors/robot_sensors/robot_pool.cpp>
+ *
+ * @author Jyotsna Bellary <jyotsnabellary@gmail.com>
+ */
+
+#include "robot_pool.h"
+
+#include <argos3/core/simulator/entity/composable_entity.h>
+#include <argos3/core/simulator/entity/controllable_entity.h>
+#include <argos3/core/simulator/entity/embodied_entity.h>
+#include <argos3/core/simulator/physics_engine/physics_engine.h>
+#include <argos3/core/simulator/physics_engine/physics_model.h>
+#include <argos3/core/simulator/space/space.h>
+#include <argos3/core/utility/plugins/factory.h>
+#include <argos3/plugins/simulator/entities/wheeled_entity.h>
+
+namespace argos {
+
+   /****************************************/
+   /****************************************/
+
+   CRobotPool::CRobotPool(CSpace& c_space,
+                          TConfigurationNode& t_robot,
+                          const std::string& str_robot_type,
+                          const std::string& str_id_prefix) :
+      m_cSpace(c_space),
+      m_tRobot(t_robot),
+      m_strRobotType(str_robot_type),
+      m_strIdPrefix(str_id_prefix) {
+      if(m_tRobot.Value() != m_strRobotType) {
+         THROW_ARGOSEXCEPTION("The pool \"" << m_strIdPrefix << "\" needs a <" << m_strRobotType <<
+                              "> node, not <" << m_tRobot.Value() << ">.");
+      }
+      /* The pose of each robot goes in the <body> node */
+      if(! NodeExists(m_tRobot, "body")) {
+         TConfigurationNode tBody("body");
+         AddChildNode(m_tRobot, tBody);
+      }
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CRobotPool::Reserve(size_t un_size) {
+      m_vecRobots.reserve(un_size);
+      m_vecParked.reserve(un_size);
+      m_vecIsParked.reserve(un_size);
+      /* The robots leave the engines right away, so they can all start in the same place */
+      CVector3 cPosition(m_cSpace.GetArenaCenter().GetX(),
+                         m_cSpace.GetArenaCenter().GetY(),
+                         0.0f);
+      while(m_vecRobots.size() < un_size) {
+         Park(CreateRobot(cPosition, CQuaternion()));
+      }
+   }
+
+   /****************************************/
+   /****************************************/
+
+   CComposableEntity* CRobotPool::SpawnEntity(const CVector3& c_position,
+                                              const CQuaternion& c_orientation) {
+      if(m_vecParked.empty()) {
+         size_t unIndex = CreateRobot(c_position, c_orientation);
+         CComposableEntity* pcRobot = m_vecRobots[unIndex];
+         if(pcRobot->GetComponent<CEmbodiedEntity>("body").IsCollidingWithSomething()) {
+            /* The pose is taken, keep the robot for later */
+            Park(unIndex);
+            return NULL;
+         }
+         return pcRobot;
+      }
+      size_t unIndex = m_vecParked.back();
+      m_vecParked.pop_back();
+      m_vecIsParked[unIndex] = false;
+      CComposableEntity* pcRobot = m_vecRobots[unIndex];
+      CEmbodiedEntity& cBody = pcRobot->GetComponent<CEmbodiedEntity>("body");
+      /* The engines build the new physics model at the pose of the origin anchor */
+      cBody.GetOriginAnchor().Position = c_position;
+      cBody.GetOriginAnchor().Orientation = c_orientation;
+      m_cSpace.AddEntityToPhysicsEngine(cBody);
+      if(cBody.IsCollidingWithSomething()) {
+         /* The pose is taken, park the robot again */
+         Park(unIndex);
+         return NULL;
+      }
+      pcRobot->SetEnabled(true);
+      /* Restart the sensors from the new pose, so the odometry doesn't see the move */
+      pcRobot->GetComponent<CControllableEntity>("controller").Reset();
+      return pcRobot;
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CRobotPool::DespawnEntity(CComposableEntity& c_robot) {
+      std::map<CComposableEntity*, size_t>::const_iterator it = m_mapIndices.find(&c_robot);
+      if(it == m_mapIndices.end()) {
+         THROW_ARGOSEXCEPTION("Robot \"" << c_robot.GetId() << "\" does not belong to the pool \"" << m_strIdPrefix << "\".");
+      }
+      if(! m_vecIsParked[it->second]) {
+         Park(it->second);
+      }
+   }
+
+   /****************************************/
+   /****************************************/
+
+   size_t CRobotPool::CreateRobot(const CVector3& c_position,
+                                  const CQuaternion& c_orientation) {
+      size_t unIndex = m_vecRobots.size();
+      /* Set the id and the pose, as <distribute> does */
+      SetNodeAttribute(m_tRobot, "id", m_strIdPrefix + ToString(unIndex));
+      TConfigurationNode& tBody = GetNode(m_tRobot, "body");
+      SetNodeAttribute(tBody, "position", c_position);
+      SetNodeAttribute(tBody, "orientation", c_orientation);
+      CEntity* pcEntity = CFactory<CEntity>::New(m_strRobotType);
+      CComposableEntity* pcRobot = dynamic_cast<CComposableEntity*>(pcEntity);
+      if(pcRobot == NULL) {
+         delete pcEntity;
+         THROW_ARGOSEXCEPTION("The pool \"" << m_strIdPrefix << "\" can't pool entities of type \"" << m_strRobotType << "\".");
+      }
+      try {
+         pcRobot->Init(m_tRobot);
+      }
+      catch(CARGoSException& ex) {
+         delete pcRobot;
+         THROW_ARGOSEXCEPTION_NESTED("Failed to create robot " << unIndex << " of the pool \"" << m_strIdPrefix << "\".", ex);
+      }
+      CallEntityOperation<CSpaceOperationAddEntity, CSpace, void>(m_cSpace, *pcRobot);
+      m_vecRobots.push_back(pcRobot);
+      m_vecIsParked.push_back(false);
+      m_mapIndices[pcRobot] = unIndex;
+      return unIndex;
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CRobotPool::Park(size_t un_index) {
+      CComposableEntity& cRobot = *m_vecRobots[un_index];
+      /* Stop the wheels */
+      if(cRobot.HasComponent("wheels")) {
+         CWheeledEntity& cWheels = cRobot.GetComponent<CWheeledEntity>("wheels");
+         std::vector<Real> vecZeroVelocities(cWheels.GetNumWheels(), 0.0f);
+         cWheels.SetVelocities(vecZeroVelocities.data());
+      }
+      /* Take the body out of the engines: nothing collides with it, no ray hits it */
+      CEmbodiedEntity& cBody = cRobot.GetComponent<CEmbodiedEntity>("body");
+      for(size_t i = cBody.GetPhysicsModelsNum(); i > 0; --i) {
+         cBody.GetPhysicsModel(i - 1).GetEngine().RemoveEntity(cRobot);
+      }
+      /* The space skips the controller, sensors and actuators of disabled robots */
+      cRobot.SetEnabled(false);
+      /* Forget the controller state */
+      cRobot.GetComponent<CControllableEntity>("controller").Reset();
+      m_vecParked.push_back(un_index);
+      m_vecIsParked[un_index] = true;
+   }
+
+   /****************************************/
+   /****************************************/
+
+}
@@ -0,0 +1,145 @@
+/**
+ * @file <argos3/plugins/simulator/sensors/robot_sensors/robot_pool.h>
+ *
+ * @brief This file provides the spawn and despawn pool shared by the
+ * Turtlebot4 and the e-puck.
+ *
+ * Removing a robot from the space destroys its physics model, sensors and
+ * index entries, and adding it back rebuilds all of them. When loop
+ * functions make robots enter and leave the arena during an experiment,
+ * a pool avoids that churn: despawned robots are parked, and spawning
+ * reuses a parked robot before creating a new one.
+ *
+ * A parked robot is taken out of the physics engines, so nothing collides
+ * with it and no ray hits it, and it is disabled, so its controller,
+ * sensors and actuators are not stepped and the drawing, the odometry and
+ * the proximity index skip it. Only its physics model is rebuilt when it
+ * is spawned again.
+ *
+ * The robots are created from an XML node with the same attributes and
+ * children as in the <arena> section. The pool sets the id and the <body>
+ * of the node for each robot, as <distribute> does, so the node must
+ * outlive the pool.
+ *
+ * The robots derive a thin pool that only sets the robot type and the
+ * entity class, such as CTurtlebot4Pool.
+ *
+ * @author Jyotsna Bellary <jyotsnabellary@gmail.com>
+ */
+
+#ifndef ROBOT_POOL_H
+#define ROBOT_POOL_H
+
+namespace argos {
+   class CRobotPool;
+   class CComposableEntity;
+   class CSpace;
+}
+
+#include <argos3/core/utility/configuration/argos_configuration.h>
+#include <argos3/core/utility/math/quaternion.h>
+#include <argos3/core/utility/math/vector3.h>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace argos {
+
+   class CRobotPool {
+
+   public:
+
+      /**
+       * Creates an empty pool.
+       * @param c_space the space
+       * @param t_robot the XML node of the robots, such as <turtlebot4>
+       * @param str_robot_type the XML tag of the robot type, such as "turtlebot4"
+       * @param str_id_prefix the prefix of the robot ids
+       * @throws CARGoSException if the node is not of the given robot type
+       */
+      CRobotPool(CSpace& c_space,
+                 TConfigurationNode& t_robot,
+                 const std::string& str_robot_type,
+                 const std::string& str_id_prefix);
+
+      virtual ~CRobotPool() {}
+
+      /**
+       * Creates parked robots until the pool holds the given number of robots.
+       * @param un_size the number of robots
+       * @throws CARGoSException if a robot can't be created
+       */
+      void Reserve(size_t un_size);
+
+      /**
+       * Returns the number of robots in the arena.
+       */
+      inline size_t GetNumActive() const {
+         return m_vecRobots.size() - m_vecParked.size();
+      }
+
+      /**
+       * Returns the number of parked robots.
+       */
+      inline size_t GetNumParked() const {
+         return m_vecParked.size();
+      }
+
+   protected:
+
+      /**
+       * Places a robot in the arena. A parked robot is reused if available,
+       * otherwise a new robot is created.
+       * @param c_position the position of the robot
+       * @param c_orientation the orientation of the robot
+       * @return the robot, or <tt>NULL</tt> if the pose is not free
+       * @throws CARGoSException if a new robot is needed and can't be created
+       */
+      CComposableEntity* SpawnEntity(const CVector3& c_position,
+                                     const CQuaternion& c_orientation);
+
+      /**
+       * Removes a robot from the arena and parks it. The controller is reset.
+       * Despawning a robot that is already parked does nothing.
+       * @param c_robot a robot spawned by this pool
+       * @throws CARGoSException if the robot does not belong to the pool
+       */
+      void DespawnEntity(CComposableEntity& c_robot);
+
+   private:
+
+      size_t CreateRobot(const CVector3& c_position,
+                         const CQuaternion& c_orientation);
+
+      void Park(size_t un_index);
+
+   private:
+
+      /** Reference to the space */
+      CSpace& m_cSpace;
+
+      /** XML node of the robots */
+      TConfigurationNode m_tRobot;
+
+      /** XML tag of the robot type */
+      std::string m_strRobotType;
+
+      /** Prefix of the robot ids */
+      std::string m_strIdPrefix;
+
+      /** All the robots of the pool */
+      std::vector<CComposableEntity*> m_vecRobots;
+
+      /** Index of each robot in m_vecRobots */
+      std::map<CComposableEntity*, size_t> m_mapIndices;
+
+      /** Indices of the parked robots */
+      std::vector<size_t> m_vecParked;
+
+      /** Whether each robot is parked */
+      std::vector<bool> m_vecIsParked;
+   };
+
+}
+
+#endif
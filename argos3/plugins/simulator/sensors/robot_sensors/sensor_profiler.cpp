@@ -0,0 +1,319 @@
+/**
+ * @file <argos3/plugins/simulator/sensors/robot_sensors/sensor_profiler.cpp>
+ *
+ * @author Jyotsna Bellary <jyotsnabellary@gmail.com>
+ */
+
+#include "sensor_profiler.h"
+#include <argos3/core/utility/logging/argos_log.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <map>
+#include <memory>
+#include <mutex>
+
+namespace argos {
+
+   /****************************************/
+   /****************************************/
+
+   /*
+    * The measures of the destroyed sensors of a robot type, per sensor type
+    * and per robot. The report is written when the last profiled sensor of
+    * the robot type goes.
+    */
+   struct SSensorProfileReport {
+      typedef CSensorProfiler::SHistogram SHistogram;
+      /* Robot type, for the messages */
+      std::string RobotType;
+      /* Name of the files, without extension */
+      std::string FileName;
+      std::mutex Mutex;
+      std::map<std::string, SHistogram> PerType;
+      std::map<std::pair<std::string, std::string>, SHistogram> PerRobot;
+      /* Profiled sensors still alive */
+      UInt32 Live;
+      /* To convert the clock ticks into time */
+      UInt64 StartTicks;
+      std::chrono::steady_clock::time_point StartTime;
+
+      SSensorProfileReport(const std::string& str_robot_type,
+                           const std::string& str_file_name) :
+         RobotType(str_robot_type),
+         FileName(str_file_name),
+         Live(0),
+         StartTicks(0) {}
+
+      /* Returns the report written to the given files, created on first use */
+      static SSensorProfileReport& GetInstance(const std::string& str_robot_type,
+                                               const std::string& str_file_name) {
+         static std::mutex cMutex;
+         static std::map<std::string, std::unique_ptr<SSensorProfileReport> > mapReports;
+         std::lock_guard<std::mutex> cLock(cMutex);
+         std::unique_ptr<SSensorProfileReport>& pcReport = mapReports[str_file_name];
+         if(!pcReport) {
+            pcReport.reset(new SSensorProfileReport(str_robot_type, str_file_name));
+         }
+         return *pcReport;
+      }
+
+      void Write();
+   };
+
+   /****************************************/
+   /****************************************/
+
+   static std::string EscapeJSON(const std::string& str_value) {
+      std::string strEscaped;
+      for(size_t i = 0; i < str_value.size(); ++i) {
+         if(str_value[i] == '"' || str_value[i] == '\\') {
+            strEscaped += '\\';
+         }
+         strEscaped += str_value[i];
+      }
+      return strEscaped;
+   }
+
+   /****************************************/
+   /****************************************/
+
+   /* One line of the report, times in microseconds */
+   struct SReportLine {
+      UInt64 Calls;
+      Real Total;
+      Real Mean;
+      Real P50;
+      Real P99;
+      Real Max;
+
+      SReportLine(const CSensorProfiler::SHistogram& s_histogram,
+                  Real f_ticks_per_us) :
+         Calls(s_histogram.Calls),
+         Total(s_histogram.Total / f_ticks_per_us),
+         Mean(Calls > 0 ? Total / Calls : 0.0),
+         P50(s_histogram.GetQuantile(0.5) / f_ticks_per_us),
+         P99(s_histogram.GetQuantile(0.99) / f_ticks_per_us),
+         Max(s_histogram.Max / f_ticks_per_us) {}
+   };
+
+   static void WriteCSVLine(std::ostream& c_csv,
+                            const std::string& str_sensor,
+                            const std::string& str_robot,
+                            const SReportLine& s_line) {
+      c_csv << str_sensor << ','
+            << str_robot << ','
+            << s_line.Calls << ','
+            << s_line.Total << ','
+            << s_line.Mean << ','
+            << s_line.P50 << ','
+            << s_line.P99 << ','
+            << s_line.Max << '\n';
+   }
+
+   static void WriteJSONLine(std::ostream& c_json,
+                             const std::string& str_sensor,
+                             const std::string* pstr_robot,
+                             const SReportLine& s_line) {
+      c_json << "    { \"sensor\": \"" << EscapeJSON(str_sensor) << "\", ";
+      if(pstr_robot != NULL) {
+         c_json << "\"robot\": \"" << EscapeJSON(*pstr_robot) << "\", ";
+      }
+      c_json << "\"calls\": " << s_line.Calls << ", "
+             << "\"total_us\": " << s_line.Total << ", "
+             << "\"mean_us\": " << s_line.Mean << ", "
+             << "\"p50_us\": " << s_line.P50 << ", "
+             << "\"p99_us\": " << s_line.P99 << ", "
+             << "\"max_us\": " << s_line.Max << " }";
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void SSensorProfileReport::Write() {
+      /* Clock ticks per microsecond, measured over the whole run */
+      Real fTicksPerUs = 1000.0;
+      UInt64 unTicks = CSensorProfiler::ReadClock() - StartTicks;
+      Real fMicroseconds = std::chrono::duration<Real, std::micro>(
+         std::chrono::steady_clock::now() - StartTime).count();
+      if(fMicroseconds > 0.0) {
+         fTicksPerUs = unTicks / fMicroseconds;
+      }
+      std::string strCSV = FileName + ".csv";
+      std::ofstream cCSV(strCSV.c_str(), std::ios::out | std::ios::trunc);
+      std::string strJSON = FileName + ".json";
+      std::ofstream cJSON(strJSON.c_str(), std::ios::out | std::ios::trunc);
+      if(cCSV.fail() || cJSON.fail()) {
+         LOGERR << "[WARNING] Can't write the " << RobotType << " sensor profile to \""
+                << strCSV << "\" and \"" << strJSON << "\"" << std::endl;
+         return;
+      }
+      cCSV << std::fixed << std::setprecision(3);
+      cJSON << std::fixed << std::setprecision(3);
+      /* The robot column is empty in the totals per type */
+      cCSV << "sensor,robot,calls,total_us,mean_us,p50_us,p99_us,max_us\n";
+      cJSON << "{\n  \"ticks_per_us\": " << fTicksPerUs << ",\n  \"sensors\": [\n";
+      for(std::map<std::string, SHistogram>::iterator it = PerType.begin();
+          it != PerType.end();
+          ++it) {
+         SReportLine sLine(it->second, fTicksPerUs);
+         WriteCSVLine(cCSV, it->first, "", sLine);
+         if(it != PerType.begin()) {
+            cJSON << ",\n";
+         }
+         WriteJSONLine(cJSON, it->first, NULL, sLine);
+      }
+      cJSON << "\n  ],\n  \"robots\": [\n";
+      for(std::map<std::pair<std::string, std::string>, SHistogram>::iterator it = PerRobot.begin();
+          it != PerRobot.end();
+          ++it) {
+         SReportLine sLine(it->second, fTicksPerUs);
+         WriteCSVLine(cCSV, it->first.first, it->first.second, sLine);
+         if(it != PerRobot.begin()) {
+            cJSON << ",\n";
+         }
+         WriteJSONLine(cJSON, it->first.first, &it->first.second, sLine);
+      }
+      cJSON << "\n  ]\n}\n";
+      LOG << "[INFO] " << RobotType << " sensor profile written to \""
+          << strCSV << "\" and \"" << strJSON << "\"" << std::endl;
+   }
+
+   /****************************************/
+   /****************************************/
+
+   CSensorProfiler::SHistogram::SHistogram() :
+      Calls(0),
+      Total(0),
+      Max(0) {}
+
+   /****************************************/
+   /****************************************/
+
+   void CSensorProfiler::SHistogram::Reserve() {
+      if(Counts.empty()) {
+         Counts.assign(NUM_BUCKETS, 0);
+      }
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CSensorProfiler::SHistogram::Add(UInt64 un_ticks) {
+      /* The small values have a bucket each, the others SUB_BITS bits of precision */
+      UInt32 unBucket;
+      if(un_ticks < SUB_BUCKETS) {
+         unBucket = un_ticks;
+      }
+      else {
+         UInt32 unShift = 63 - __builtin_clzll(un_ticks) - SUB_BITS;
+         unBucket = (unShift + 1) * SUB_BUCKETS + (un_ticks >> unShift) - SUB_BUCKETS;
+      }
+      ++Counts[unBucket];
+      ++Calls;
+      Total += un_ticks;
+      if(un_ticks > Max) {
+         Max = un_ticks;
+      }
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CSensorProfiler::SHistogram::Merge(const SHistogram& s_other) {
+      if(! s_other.Counts.empty()) {
+         Reserve();
+         for(UInt32 i = 0; i < NUM_BUCKETS; ++i) {
+            Counts[i] += s_other.Counts[i];
+         }
+      }
+      Calls += s_other.Calls;
+      Total += s_other.Total;
+      if(s_other.Max > Max) {
+         Max = s_other.Max;
+      }
+   }
+
+   /****************************************/
+   /****************************************/
+
+   UInt64 CSensorProfiler::SHistogram::GetQuantile(Real f_quantile) const {
+      if(Calls == 0 || Counts.empty()) {
+         return 0;
+      }
+      UInt64 unRank = std::max<UInt64>(1, static_cast<UInt64>(f_quantile * Calls + 0.5));
+      UInt64 unSeen = 0;
+      for(UInt32 i = 0; i < NUM_BUCKETS; ++i) {
+         unSeen += Counts[i];
+         if(unSeen >= unRank) {
+            if(i < SUB_BUCKETS) {
+               return i;
+            }
+            /* The middle of the bucket */
+            UInt32 unShift = i / SUB_BUCKETS - 1;
+            UInt64 unLow = static_cast<UInt64>(SUB_BUCKETS + i % SUB_BUCKETS) << unShift;
+            return std::min<UInt64>(unLow + ((1ull << unShift) >> 1), Max);
+         }
+      }
+      return Max;
+   }
+
+   /****************************************/
+   /****************************************/
+
+   CSensorProfiler::CSensorProfiler(const std::string& str_sensor,
+                                    const std::string& str_robot_type,
+                                    const std::string& str_env_variable,
+                                    const std::string& str_report) :
+      m_strSensor(str_sensor),
+      m_strEnvVariable(str_env_variable),
+      m_sReport(SSensorProfileReport::GetInstance(str_robot_type, str_report)),
+      m_bEnabled(false) {}
+
+   /****************************************/
+   /****************************************/
+
+   CSensorProfiler::~CSensorProfiler() {
+      if(! m_bEnabled) {
+         return;
+      }
+      std::lock_guard<std::mutex> cLock(m_sReport.Mutex);
+      m_sReport.PerType[m_strSensor].Merge(m_sHistogram);
+      m_sReport.PerRobot[std::make_pair(m_strSensor, m_strRobot)].Merge(m_sHistogram);
+      if(--m_sReport.Live == 0) {
+         try {
+            m_sReport.Write();
+         }
+         catch(std::exception& ex) {
+            LOGERR << "[WARNING] Can't write the " << m_sReport.RobotType << " sensor profile: " << ex.what() << std::endl;
+         }
+      }
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CSensorProfiler::Init(TConfigurationNode& t_tree) {
+      if(m_bEnabled) {
+         return;
+      }
+      const char* pchEnv = ::getenv(m_strEnvVariable.c_str());
+      m_bEnabled = (pchEnv != NULL && std::string(pchEnv) != "0");
+      GetNodeAttributeOrDefault(t_tree, "profile", m_bEnabled, m_bEnabled);
+      if(m_bEnabled) {
+         m_sHistogram.Reserve();
+         std::lock_guard<std::mutex> cLock(m_sReport.Mutex);
+         if(m_sReport.Live++ == 0 && m_sReport.StartTicks == 0) {
+            m_sReport.StartTicks = ReadClock();
+            m_sReport.StartTime = std::chrono::steady_clock::now();
+         }
+      }
+   }
+
+   /****************************************/
+   /****************************************/
+
+}
@@ -0,0 +1,172 @@
+/**
+ * @file <argos3/plugins/simulator/sensors/robot_sensors/sensor_profiler.h>
+ *
+ * @brief This file provides the time profiler of the robot sensors.
+ *
+ * Every sensor with a profiler accepts an optional 'profile' attribute.
+ * When it is "true", or when the environment variable of the robot type
+ * (e.g., TURTLEBOT4_SENSOR_PROFILE) is set to anything but "0", the sensor
+ * measures each call to Update() with the time stamp counter of the CPU.
+ * The measures are kept by the sensor itself, so the threads never share
+ * anything while the experiment runs.
+ *
+ * Each robot type has its own report. When the last profiled sensor of a
+ * type is destroyed, at the end of the experiment, the measures are written
+ * as <report>.csv and <report>.json in the working directory (e.g.,
+ * turtlebot4_sensor_profile.csv), with total, mean, p50, p99 and max time
+ * per sensor type and per robot. The percentiles are accurate to about 3%.
+ *
+ * The robots derive a thin profiler that only sets the names, such as
+ * CTurtlebot4SensorProfiler.
+ *
+ * @author Jyotsna Bellary <jyotsnabellary@gmail.com>
+ */
+
+#ifndef SENSOR_PROFILER_H
+#define SENSOR_PROFILER_H
+
+namespace argos {
+   class CSensorProfiler;
+   struct SSensorProfileReport;
+}
+
+#include <argos3/core/utility/configuration/argos_configuration.h>
+#include <argos3/core/utility/datatypes/datatypes.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#else
+#include <chrono>
+#endif
+
+#include <string>
+#include <vector>
+
+namespace argos {
+
+   class CSensorProfiler {
+
+   public:
+
+      /**
+       * Measures the scope it lives in, including early returns. It does
+       * nothing if the profiler is disabled.
+       */
+      class CScope {
+      public:
+         CScope(CSensorProfiler& c_profiler) :
+            m_pcProfiler(c_profiler.m_bEnabled ? &c_profiler : NULL),
+            m_unStart(m_pcProfiler != NULL ? ReadClock() : 0) {}
+         ~CScope() {
+            if(m_pcProfiler != NULL) {
+               m_pcProfiler->Record(ReadClock() - m_unStart);
+            }
+         }
+      private:
+         CSensorProfiler* m_pcProfiler;
+         UInt64 m_unStart;
+      };
+
+      /**
+       * Counts of the measures, on a logarithmic scale. Each power of two
+       * is split in SUB_BUCKETS buckets. The buckets are allocated by
+       * Reserve(), so a disabled profiler costs no memory.
+       */
+      struct SHistogram {
+         static const UInt32 SUB_BITS = 4;
+         static const UInt32 SUB_BUCKETS = 1 << SUB_BITS;
+         static const UInt32 NUM_BUCKETS = (64 - SUB_BITS + 1) * SUB_BUCKETS;
+
+         std::vector<UInt32> Counts;
+         UInt64 Calls;
+         UInt64 Total;
+         UInt64 Max;
+
+         SHistogram();
+
+         /** Allocates the buckets, if not done yet */
+         void Reserve();
+
+         /** Adds a measure; the buckets must have been reserved */
+         void Add(UInt64 un_ticks);
+
+         void Merge(const SHistogram& s_other);
+
+         /** Returns the measure at the given quantile, in [0,1] */
+         UInt64 GetQuantile(Real f_quantile) const;
+      };
+
+   public:
+
+      /**
+       * @param str_sensor the kind of sensor, such as "lidar", as shown
+       * in the report
+       * @param str_robot_type the robot type, such as "Turtlebot4", as
+       * shown in the messages
+       * @param str_env_variable the environment variable that profiles
+       * all the sensors of the robot type
+       * @param str_report the name of the report files, without extension
+       */
+      CSensorProfiler(const std::string& str_sensor,
+                      const std::string& str_robot_type,
+                      const std::string& str_env_variable,
+                      const std::string& str_report);
+
+      /**
+       * Hands the measures over to the report, and writes the report if
+       * this was the last profiled sensor of the robot type.
+       */
+      ~CSensorProfiler();
+
+      /**
+       * Sets the robot shown in the report.
+       */
+      inline void SetRobot(const std::string& str_robot) {
+         m_strRobot = str_robot;
+      }
+
+      /**
+       * Parses the optional 'profile' attribute of the sensor node.
+       * @param t_tree the XML node of the sensor
+       */
+      void Init(TConfigurationNode& t_tree);
+
+      inline bool IsEnabled() const {
+         return m_bEnabled;
+      }
+
+      /**
+       * Returns a time stamp in clock ticks.
+       */
+      static inline UInt64 ReadClock() {
+#if defined(__x86_64__) || defined(__i386__)
+         return __rdtsc();
+#else
+         return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+      }
+
+   private:
+
+      CSensorProfiler(const CSensorProfiler&);
+      CSensorProfiler& operator=(const CSensorProfiler&);
+
+      inline void Record(UInt64 un_ticks) {
+         m_sHistogram.Add(un_ticks);
+      }
+
+   private:
+
+      std::string m_strSensor;
+      std::string m_strRobot;
+      std::string m_strEnvVariable;
+      /** The report of the robot type */
+      SSensorProfileReport& m_sReport;
+      bool m_bEnabled;
+      SHistogram m_sHistogram;
+   };
+
+}
+
+#endif
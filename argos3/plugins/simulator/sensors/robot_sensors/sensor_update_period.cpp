@@ -0,0 +1,81 @@
+/**
+ * @file <argos3/plugins/simulator/sensors/robot_sensors/sensor_update_period.cpp>
+ *
+ * @author Jyotsna Bellary <jyotsnabellary@gmail.com>
+ */
+
+#include "sensor_update_period.h"
+#include <argos3/core/simulator/simulator.h>
+#include <argos3/core/simulator/space/space.h>
+#include <argos3/core/simulator/physics_engine/physics_engine.h>
+#include <argos3/core/utility/string_utilities.h>
+
+namespace argos {
+
+   /****************************************/
+   /****************************************/
+
+   CSensorUpdatePeriod::CSensorUpdatePeriod() :
+      m_cSpace(CSimulator::GetInstance().GetSpace()),
+      m_unPeriod(1),
+      m_unLastUpdate(0),
+      m_bUpdated(false) {}
+
+   /****************************************/
+   /****************************************/
+
+   void CSensorUpdatePeriod::Init(TConfigurationNode& t_tree) {
+      std::string strPeriod;
+      GetNodeAttributeOrDefault(t_tree, "update_period", strPeriod, strPeriod);
+      if(strPeriod.empty()) {
+         m_unPeriod = 1;
+      }
+      else if(strPeriod.back() == 's') {
+         /* Period in seconds, rounded to the closest number of ticks */
+         Real fSeconds = FromString<Real>(strPeriod.substr(0, strPeriod.size() - 1));
+         if(fSeconds <= 0.0f) {
+            THROW_ARGOSEXCEPTION("The update period must be positive, \"" << strPeriod << "\" given");
+         }
+         Real fTicks = fSeconds / CPhysicsEngine::GetSimulationClockTick();
+         m_unPeriod = Max<UInt32>(1, static_cast<UInt32>(fTicks + 0.5f));
+      }
+      else {
+         /* Period in ticks */
+         m_unPeriod = FromString<UInt32>(strPeriod);
+         if(m_unPeriod == 0) {
+            THROW_ARGOSEXCEPTION("The update period must be positive, \"" << strPeriod << "\" given");
+         }
+      }
+      Reset();
+   }
+
+   /****************************************/
+   /****************************************/
+
+   bool CSensorUpdatePeriod::IsDue() {
+      if(m_unPeriod == 1) {
+         return true;
+      }
+      UInt32 unClock = m_cSpace.GetSimulationClock();
+      if(m_bUpdated &&
+         unClock >= m_unLastUpdate &&
+         unClock - m_unLastUpdate < m_unPeriod) {
+         return false;
+      }
+      m_unLastUpdate = unClock;
+      m_bUpdated = true;
+      return true;
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CSensorUpdatePeriod::Reset() {
+      m_unLastUpdate = 0;
+      m_bUpdated = false;
+   }
+
+   /****************************************/
+   /****************************************/
+
+}
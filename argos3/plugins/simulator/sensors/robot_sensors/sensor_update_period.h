@@ -0,0 +1,75 @@
+/**
+ * @file <argos3/plugins/simulator/sensors/robot_sensors/sensor_update_period.h>
+ *
+ * @brief This file provides the update rate limiter shared by the robot sensors.
+ *
+ * Every Turtlebot4 and e-puck sensor accepts an optional 'update_period'
+ * attribute. The value is a number of simulation ticks (e.g., "10"), or a
+ * time in seconds when followed by 's' (e.g., "0.2s"). The sensor computes
+ * new readings only when the period has elapsed, and keeps its last
+ * readings in between.
+ *
+ * @author Jyotsna Bellary <jyotsnabellary@gmail.com>
+ */
+
+#ifndef SENSOR_UPDATE_PERIOD_H
+#define SENSOR_UPDATE_PERIOD_H
+
+namespace argos {
+   class CSensorUpdatePeriod;
+   class CSpace;
+}
+
+#include <argos3/core/utility/configuration/argos_configuration.h>
+#include <argos3/core/utility/datatypes/datatypes.h>
+
+namespace argos {
+
+   class CSensorUpdatePeriod {
+
+   public:
+
+      CSensorUpdatePeriod();
+
+      /**
+       * Parses the optional 'update_period' attribute of the sensor node.
+       * @param t_tree the XML node of the sensor
+       */
+      void Init(TConfigurationNode& t_tree);
+
+      /**
+       * Returns true if the sensor must compute new readings at this tick.
+       * When it returns true, the current tick is recorded as the last update.
+       */
+      bool IsDue();
+
+      /**
+       * Forgets the last update, so the next call to IsDue() returns true.
+       */
+      void Reset();
+
+      /**
+       * Returns the update period in simulation ticks.
+       */
+      inline UInt32 GetPeriod() const {
+         return m_unPeriod;
+      }
+
+   private:
+
+      /** Reference to the space */
+      CSpace& m_cSpace;
+
+      /** Update period in ticks */
+      UInt32 m_unPeriod;
+
+      /** Clock of the last update */
+      UInt32 m_unLastUpdate;
+
+      /** Whether an update has happened since the last reset */
+      bool m_bUpdated;
+   };
+
+}
+
+#endif
@@ -0,0 +1,261 @@
+/**
+ * @file <argos3/plugins/simulator/visualizations/batch_rendering/qtopengl_frame_writer.cpp>
+ *
+ * @author Jyotsna Bellary <jyotsnabellary@gmail.com>
+ */
+
+#include "qtopengl_frame_writer.h"
+
+#include <argos3/core/utility/configuration/argos_exception.h>
+#include <argos3/core/utility/logging/argos_log.h>
+
+#include <QDir>
+#include <QImage>
+#include <QOpenGLContext>
+#include <QOpenGLExtraFunctions>
+
+#include <cstring>
+#include <iomanip>
+#include <sstream>
+
+namespace argos {
+
+   /****************************************/
+   /****************************************/
+
+   static const UInt32 BYTES_PER_PIXEL = 4;
+
+   /****************************************/
+   /****************************************/
+
+   static QOpenGLExtraFunctions& GetFunctions() {
+      return *QOpenGLContext::currentContext()->extraFunctions();
+   }
+
+   /****************************************/
+   /****************************************/
+
+   CQTOpenGLFrameWriter::CQTOpenGLFrameWriter(const std::string& str_directory,
+                                              const std::string& str_prefix,
+                                              const std::string& str_format,
+                                              SInt32 n_quality,
+                                              UInt32 un_width,
+                                              UInt32 un_height,
+                                              UInt32 un_queue_size) :
+      m_strDirectory(str_directory),
+      m_strPrefix(str_prefix),
+      m_strFormat(str_format),
+      m_nQuality(n_quality),
+      m_unWidth(un_width),
+      m_unHeight(un_height),
+      m_unQueueSize(un_queue_size),
+      m_unNextBuffer(0),
+      m_bStop(false),
+      m_unDropped(0),
+      m_unFailed(0) {
+      if(! QDir().mkpath(QString::fromStdString(m_strDirectory))) {
+         THROW_ARGOSEXCEPTION("Can't create the frame directory \"" << m_strDirectory << "\"");
+      }
+      for(UInt32 i = 0; i < NUM_PIXEL_BUFFERS; ++i) {
+         m_pnPending[i] = -1;
+      }
+      /* Pixel buffers need glMapBufferRange() to be read back */
+      QOpenGLContext* pcContext = QOpenGLContext::currentContext();
+      if(pcContext->format().version() >= qMakePair(3, 0) ||
+         pcContext->hasExtension("GL_ARB_map_buffer_range")) {
+         QOpenGLExtraFunctions& cGL = GetFunctions();
+         m_vecPixelBuffers.resize(NUM_PIXEL_BUFFERS);
+         cGL.glGenBuffers(NUM_PIXEL_BUFFERS, m_vecPixelBuffers.data());
+         for(UInt32 i = 0; i < NUM_PIXEL_BUFFERS; ++i) {
+            cGL.glBindBuffer(GL_PIXEL_PACK_BUFFER, m_vecPixelBuffers[i]);
+            cGL.glBufferData(GL_PIXEL_PACK_BUFFER,
+                             m_unWidth * m_unHeight * BYTES_PER_PIXEL,
+                             nullptr,
+                             GL_STREAM_READ);
+         }
+         cGL.glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+      }
+      else {
+         LOG << "[INFO] Pixel buffer objects not available, frames are read back synchronously" << std::endl;
+      }
+      m_cThread = std::thread(&CQTOpenGLFrameWriter::Write, this);
+   }
+
+   /****************************************/
+   /****************************************/
+
+   CQTOpenGLFrameWriter::~CQTOpenGLFrameWriter() {
+      if(m_cThread.joinable()) {
+         {
+            std::lock_guard<std::mutex> cLock(m_cMutex);
+            m_bStop = true;
+         }
+         m_cCondition.notify_one();
+         m_cThread.join();
+      }
+      if(! m_vecPixelBuffers.empty() && QOpenGLContext::currentContext() != nullptr) {
+         GetFunctions().glDeleteBuffers(NUM_PIXEL_BUFFERS, m_vecPixelBuffers.data());
+      }
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CQTOpenGLFrameWriter::Capture(UInt32 un_frame) {
+      glPixelStorei(GL_PACK_ALIGNMENT, 4);
+      if(m_vecPixelBuffers.empty()) {
+         std::vector<UInt8> vecPixels;
+         TakeBuffer(vecPixels);
+         glReadPixels(0, 0, m_unWidth, m_unHeight, GL_RGBA, GL_UNSIGNED_BYTE, vecPixels.data());
+         Enqueue(un_frame, vecPixels);
+         return;
+      }
+      /* The buffer still holds the oldest frame in flight */
+      if(m_pnPending[m_unNextBuffer] >= 0) {
+         Fetch(m_unNextBuffer);
+      }
+      QOpenGLExtraFunctions& cGL = GetFunctions();
+      cGL.glBindBuffer(GL_PIXEL_PACK_BUFFER, m_vecPixelBuffers[m_unNextBuffer]);
+      /* With a pack buffer bound, the call only schedules the copy */
+      glReadPixels(0, 0, m_unWidth, m_unHeight, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+      cGL.glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+      m_pnPending[m_unNextBuffer] = un_frame;
+      m_unNextBuffer = (m_unNextBuffer + 1) % NUM_PIXEL_BUFFERS;
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CQTOpenGLFrameWriter::Flush() {
+      /* Oldest frames first */
+      for(UInt32 i = 0; i < NUM_PIXEL_BUFFERS && ! m_vecPixelBuffers.empty(); ++i) {
+         UInt32 unBuffer = (m_unNextBuffer + i) % NUM_PIXEL_BUFFERS;
+         if(m_pnPending[unBuffer] >= 0) {
+            Fetch(unBuffer);
+         }
+      }
+      {
+         std::lock_guard<std::mutex> cLock(m_cMutex);
+         m_bStop = true;
+      }
+      m_cCondition.notify_one();
+      if(m_cThread.joinable()) {
+         m_cThread.join();
+      }
+      if(m_unDropped > 0) {
+         LOGERR << "[WARNING] "
+                << m_unDropped
+                << " frames were dropped because writing them to \""
+                << m_strDirectory
+                << "\" was too slow; consider a larger queue or a faster format"
+                << std::endl;
+      }
+      if(m_unFailed > 0) {
+         LOGERR << "[WARNING] "
+                << m_unFailed
+                << " frames could not be written to \""
+                << m_strDirectory
+                << "\""
+                << std::endl;
+      }
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CQTOpenGLFrameWriter::Fetch(UInt32 un_buffer) {
+      QOpenGLExtraFunctions& cGL = GetFunctions();
+      UInt32 unSize = m_unWidth * m_unHeight * BYTES_PER_PIXEL;
+      std::vector<UInt8> vecPixels;
+      TakeBuffer(vecPixels);
+      cGL.glBindBuffer(GL_PIXEL_PACK_BUFFER, m_vecPixelBuffers[un_buffer]);
+      void* pData = cGL.glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, unSize, GL_MAP_READ_BIT);
+      if(pData != nullptr) {
+         ::memcpy(vecPixels.data(), pData, unSize);
+         cGL.glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+         Enqueue(m_pnPending[un_buffer], vecPixels);
+      }
+      else {
+         std::lock_guard<std::mutex> cLock(m_cMutex);
+         ++m_unFailed;
+      }
+      cGL.glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+      m_pnPending[un_buffer] = -1;
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CQTOpenGLFrameWriter::Enqueue(UInt32 un_frame,
+                                      std::vector<UInt8>& vec_pixels) {
+      std::lock_guard<std::mutex> cLock(m_cMutex);
+      if(m_deqFrames.size() >= m_unQueueSize) {
+         ++m_unDropped;
+         m_vecFreeBuffers.push_back(std::vector<UInt8>());
+         m_vecFreeBuffers.back().swap(vec_pixels);
+         return;
+      }
+      m_deqFrames.push_back(SFrame());
+      m_deqFrames.back().Number = un_frame;
+      m_deqFrames.back().Pixels.swap(vec_pixels);
+      m_cCondition.notify_one();
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CQTOpenGLFrameWriter::TakeBuffer(std::vector<UInt8>& vec_pixels) {
+      {
+         std::lock_guard<std::mutex> cLock(m_cMutex);
+         if(! m_vecFreeBuffers.empty()) {
+            vec_pixels.swap(m_vecFreeBuffers.back());
+            m_vecFreeBuffers.pop_back();
+         }
+      }
+      vec_pixels.resize(m_unWidth * m_unHeight * BYTES_PER_PIXEL);
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CQTOpenGLFrameWriter::Write() {
+      std::unique_lock<std::mutex> cLock(m_cMutex);
+      while(true) {
+         m_cCondition.wait(cLock, [this] { return m_bStop || ! m_deqFrames.empty(); });
+         if(m_deqFrames.empty()) {
+            /* Stopped, and nothing left to write */
+            return;
+         }
+         SFrame sFrame;
+         sFrame.Number = m_deqFrames.front().Number;
+         sFrame.Pixels.swap(m_deqFrames.front().Pixels);
+         m_deqFrames.pop_front();
+         /* Encode without holding the lock */
+         cLock.unlock();
+         std::ostringstream cPath;
+         cPath << m_strDirectory << "/"
+               << m_strPrefix
+               << std::setw(6) << std::setfill('0') << sFrame.Number
+               << "." << m_strFormat;
+         /* OpenGL rows go bottom to top */
+         QImage cImage(sFrame.Pixels.data(),
+                       m_unWidth,
+                       m_unHeight,
+                       m_unWidth * BYTES_PER_PIXEL,
+                       QImage::Format_RGBA8888);
+         bool bSaved = cImage.mirrored().save(QString::fromStdString(cPath.str()),
+                                              m_strFormat.c_str(),
+                                              m_nQuality);
+         cLock.lock();
+         if(! bSaved) {
+            ++m_unFailed;
+         }
+         m_vecFreeBuffers.push_back(std::vector<UInt8>());
+         m_vecFreeBuffers.back().swap(sFrame.Pixels);
+      }
+   }
+
+   /****************************************/
+   /****************************************/
+
+}
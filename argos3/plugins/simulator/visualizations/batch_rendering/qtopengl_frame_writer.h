@@ -0,0 +1,150 @@
+/**
+ * @file <argos3/plugins/simulator/visualizations/batch_rendering/qtopengl_frame_writer.h>
+ *
+ * @brief This file provides the asynchronous readback and encoding of
+ * rendered frames.
+ *
+ * Capture() starts copying the bound framebuffer into a pixel buffer
+ * object and returns at once. The pixels are fetched when the buffer comes
+ * round again, NUM_PIXEL_BUFFERS captures later, when the transfer is long
+ * over, and handed to a thread that compresses them into image files. If
+ * the thread falls behind by more than the queue size, frames are dropped
+ * rather than stalling the simulation.
+ *
+ * Without pixel buffer objects (OpenGL < 3.0 without
+ * GL_ARB_map_buffer_range), the readback is synchronous, but the
+ * encoding still happens in the thread.
+ *
+ * @author Jyotsna Bellary <jyotsnabellary@gmail.com>
+ */
+
+#ifndef QTOPENGL_FRAME_WRITER_H
+#define QTOPENGL_FRAME_WRITER_H
+
+namespace argos {
+   class CQTOpenGLFrameWriter;
+}
+
+#include <argos3/core/utility/datatypes/datatypes.h>
+
+#ifdef __APPLE__
+#include <gl.h>
+#else
+#include <GL/gl.h>
+#endif
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace argos {
+
+   class CQTOpenGLFrameWriter {
+
+   public:
+
+      /** Frames in flight between the GPU and the writer */
+      static const UInt32 NUM_PIXEL_BUFFERS = 3;
+
+   public:
+
+      /**
+       * Creates the writer and starts its thread. The OpenGL context
+       * must be current.
+       * @param str_directory where the frames are written; it is created
+       * if needed
+       * @param str_prefix the beginning of the file names, followed by
+       * the frame number
+       * @param str_format the image format, such as "png" or "jpg"
+       * @param n_quality the compression quality in [0,100], or -1 for the
+       * default of the format
+       * @param un_width the frame width in pixels
+       * @param un_height the frame height in pixels
+       * @param un_queue_size the maximum number of frames waiting to be
+       * written
+       * @throws CARGoSException if the directory cannot be created
+       */
+      CQTOpenGLFrameWriter(const std::string& str_directory,
+                           const std::string& str_prefix,
+                           const std::string& str_format,
+                           SInt32 n_quality,
+                           UInt32 un_width,
+                           UInt32 un_height,
+                           UInt32 un_queue_size);
+
+      /**
+       * Stops the thread. Call Flush() before to keep the last frames.
+       */
+      ~CQTOpenGLFrameWriter();
+
+      /**
+       * Starts reading back the framebuffer bound for reading.
+       * @param un_frame the number in the file name
+       */
+      void Capture(UInt32 un_frame);
+
+      /**
+       * Writes the frames still in flight, stops the thread and logs what
+       * has been lost. Call it once, at the end of the experiment, with the
+       * OpenGL context current.
+       */
+      void Flush();
+
+   private:
+
+      CQTOpenGLFrameWriter(const CQTOpenGLFrameWriter&);
+      CQTOpenGLFrameWriter& operator=(const CQTOpenGLFrameWriter&);
+
+      /** Maps a pixel buffer and queues its content */
+      void Fetch(UInt32 un_buffer);
+
+      /** Queues a frame, or drops it if the queue is full */
+      void Enqueue(UInt32 un_frame, std::vector<UInt8>& vec_pixels);
+
+      /** Returns a buffer for a frame, reusing the ones already written */
+      void TakeBuffer(std::vector<UInt8>& vec_pixels);
+
+      /** The body of the thread */
+      void Write();
+
+   private:
+
+      struct SFrame {
+         UInt32 Number;
+         std::vector<UInt8> Pixels;
+      };
+
+   private:
+
+      std::string m_strDirectory;
+      std::string m_strPrefix;
+      std::string m_strFormat;
+      SInt32 m_nQuality;
+      UInt32 m_unWidth;
+      UInt32 m_unHeight;
+      UInt32 m_unQueueSize;
+
+      /* Ring of pixel buffers, empty if not supported */
+      std::vector<GLuint> m_vecPixelBuffers;
+      /* Frame in each pixel buffer, or -1 if it's free */
+      SInt64 m_pnPending[NUM_PIXEL_BUFFERS];
+      UInt32 m_unNextBuffer;
+
+      /* Shared with the thread */
+      std::mutex m_cMutex;
+      std::condition_variable m_cCondition;
+      std::deque<SFrame> m_deqFrames;
+      std::vector<std::vector<UInt8> > m_vecFreeBuffers;
+      bool m_bStop;
+      UInt32 m_unDropped;
+      UInt32 m_unFailed;
+
+      std::thread m_cThread;
+   };
+
+}
+
+#endif
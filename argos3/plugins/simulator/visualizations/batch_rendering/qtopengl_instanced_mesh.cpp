@@ -0,0 +1,494 @@
+/**
+ * @file <argos3/plugins/simulator/visualizations/batch_rendering/qtopengl_instanced_mesh.cpp>
+ *
+ * @author Jyotsna Bellary <jyotsnabellary@gmail.com>
+ */
+
+#include "qtopengl_instanced_mesh.h"
+#include "qtopengl_mesh_builder.h"
+
+#include <argos3/core/utility/logging/argos_log.h>
+
+#include <QOpenGLContext>
+#include <QOpenGLExtraFunctions>
+#include <QOpenGLShaderProgram>
+
+#include <algorithm>
+
+namespace argos {
+
+   /****************************************/
+   /****************************************/
+
+   /* Attribute locations shared by the shader and the buffers */
+   static const GLuint ATTRIB_POSITION  = 0;
+   static const GLuint ATTRIB_NORMAL    = 1;
+   static const GLuint ATTRIB_TRANSFORM = 2; // takes 4 locations, one per column
+   static const GLuint ATTRIB_COLOR     = 6;
+
+   /*
+    * Same lighting as the fixed pipeline of the Qt-OpenGL widget, reading
+    * the lights and the material from the GL state. With u_colored, the
+    * emission comes from the instance color instead.
+    */
+   static const char* VERTEX_SHADER =
+      "#version 120\n"
+      "attribute vec3 a_position;\n"
+      "attribute vec3 a_normal;\n"
+      "attribute vec4 a_transform0;\n"
+      "attribute vec4 a_transform1;\n"
+      "attribute vec4 a_transform2;\n"
+      "attribute vec4 a_transform3;\n"
+      "attribute vec4 a_color;\n"
+      "uniform mat4 u_part;\n"
+      "varying vec3 v_normal;\n"
+      "varying vec3 v_eye;\n"
+      "varying vec4 v_color;\n"
+      "void main() {\n"
+      "   mat4 mModelView = gl_ModelViewMatrix *\n"
+      "                     mat4(a_transform0, a_transform1, a_transform2, a_transform3) *\n"
+      "                     u_part;\n"
+      "   vec4 vEye = mModelView * vec4(a_position, 1.0);\n"
+      "   v_eye = vEye.xyz;\n"
+      "   v_normal = mat3(mModelView) * a_normal;\n"
+      "   v_color = a_color;\n"
+      "   gl_Position = gl_ProjectionMatrix * vEye;\n"
+      "}\n";
+
+   static const char* FRAGMENT_SHADER =
+      "#version 120\n"
+      "varying vec3 v_normal;\n"
+      "varying vec3 v_eye;\n"
+      "varying vec4 v_color;\n"
+      "uniform bool u_colored;\n"
+      "void main() {\n"
+      "   vec3 vNormal = normalize(v_normal);\n"
+      "   if(! gl_FrontFacing) vNormal = -vNormal;\n"
+      "   vec3 vView = normalize(-v_eye);\n"
+      "   vec4 vColor = (u_colored ? v_color : gl_FrontMaterial.emission) +\n"
+      "                 gl_LightModel.ambient * gl_FrontMaterial.ambient;\n"
+      "   for(int i = 0; i < 2; ++i) {\n"
+      "      vec3 vLight = gl_LightSource[i].position.w == 0.0 ?\n"
+      "         normalize(gl_LightSource[i].position.xyz) :\n"
+      "         normalize(gl_LightSource[i].position.xyz - v_eye);\n"
+      "      float fDiffuse = max(dot(vNormal, vLight), 0.0);\n"
+      "      vColor += gl_FrontMaterial.ambient * gl_LightSource[i].ambient +\n"
+      "                gl_FrontMaterial.diffuse * gl_LightSource[i].diffuse * fDiffuse;\n"
+      "      if(fDiffuse > 0.0) {\n"
+      "         float fSpecular = max(dot(vNormal, normalize(vLight + vView)), 0.0);\n"
+      "         vColor += gl_FrontMaterial.specular * gl_LightSource[i].specular *\n"
+      "                   pow(fSpecular, gl_FrontMaterial.shininess);\n"
+      "      }\n"
+      "   }\n"
+      "   gl_FragColor = vec4(vColor.rgb, gl_FrontMaterial.diffuse.a);\n"
+      "}\n";
+
+   static const GLfloat IDENTITY[16] = {
+      1.0f, 0.0f, 0.0f, 0.0f,
+      0.0f, 1.0f, 0.0f, 0.0f,
+      0.0f, 0.0f, 1.0f, 0.0f,
+      0.0f, 0.0f, 0.0f, 1.0f
+   };
+
+   /****************************************/
+   /****************************************/
+
+   static QOpenGLExtraFunctions& GetFunctions() {
+      return *QOpenGLContext::currentContext()->extraFunctions();
+   }
+
+   /****************************************/
+   /****************************************/
+
+   /*
+    * The shader is compiled the first time a mesh is drawn. If this fails,
+    * or the context cannot draw instances, nullptr is returned for the
+    * rest of the process and the meshes use the fallback path.
+    */
+   static QOpenGLShaderProgram* GetProgram() {
+      static bool bInitialized = false;
+      static QOpenGLShaderProgram* pcProgram = nullptr;
+      if(!bInitialized) {
+         bInitialized = true;
+         if(!CQTOpenGLInstancedMesh::IsInstancingSupported()) {
+            LOG << "[INFO] Instanced rendering not available, robots are drawn one by one" << std::endl;
+            return nullptr;
+         }
+         pcProgram = new QOpenGLShaderProgram;
+         pcProgram->addShaderFromSourceCode(QOpenGLShader::Vertex, VERTEX_SHADER);
+         pcProgram->addShaderFromSourceCode(QOpenGLShader::Fragment, FRAGMENT_SHADER);
+         pcProgram->bindAttributeLocation("a_position",   ATTRIB_POSITION);
+         pcProgram->bindAttributeLocation("a_normal",     ATTRIB_NORMAL);
+         pcProgram->bindAttributeLocation("a_transform0", ATTRIB_TRANSFORM);
+         pcProgram->bindAttributeLocation("a_transform1", ATTRIB_TRANSFORM + 1);
+         pcProgram->bindAttributeLocation("a_transform2", ATTRIB_TRANSFORM + 2);
+         pcProgram->bindAttributeLocation("a_transform3", ATTRIB_TRANSFORM + 3);
+         pcProgram->bindAttributeLocation("a_color",      ATTRIB_COLOR);
+         if(!pcProgram->link()) {
+            LOGERR << "[WARNING] Can't link the instanced robot shader: "
+                   << pcProgram->log().toStdString()
+                   << std::endl;
+            delete pcProgram;
+            pcProgram = nullptr;
+         }
+      }
+      return pcProgram;
+   }
+
+   /****************************************/
+   /****************************************/
+
+   CQTOpenGLInstances::CQTOpenGLInstances() :
+      m_unBuffer(0) {}
+
+   /****************************************/
+   /****************************************/
+
+   CQTOpenGLInstances::~CQTOpenGLInstances() {
+      if(m_unBuffer != 0 && QOpenGLContext::currentContext() != nullptr) {
+         GetFunctions().glDeleteBuffers(1, &m_unBuffer);
+      }
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CQTOpenGLInstances::Clear() {
+      m_vecTransforms.clear();
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CQTOpenGLInstances::Add(const CVector3& c_position,
+                                const CQuaternion& c_orientation) {
+      GLfloat fW = c_orientation.GetW();
+      GLfloat fX = c_orientation.GetX();
+      GLfloat fY = c_orientation.GetY();
+      GLfloat fZ = c_orientation.GetZ();
+      /* rotation matrix of the quaternion, column by column */
+      const GLfloat pfTransform[16] = {
+         1.0f - 2.0f * (fY * fY + fZ * fZ), 2.0f * (fX * fY + fW * fZ), 2.0f * (fX * fZ - fW * fY), 0.0f,
+         2.0f * (fX * fY - fW * fZ), 1.0f - 2.0f * (fX * fX + fZ * fZ), 2.0f * (fY * fZ + fW * fX), 0.0f,
+         2.0f * (fX * fZ + fW * fY), 2.0f * (fY * fZ - fW * fX), 1.0f - 2.0f * (fX * fX + fY * fY), 0.0f,
+         static_cast<GLfloat>(c_position.GetX()),
+         static_cast<GLfloat>(c_position.GetY()),
+         static_cast<GLfloat>(c_position.GetZ()),
+         1.0f
+      };
+      m_vecTransforms.insert(m_vecTransforms.end(), pfTransform, pfTransform + 16);
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CQTOpenGLInstances::Upload() {
+      /* the fallback path reads the transforms from memory */
+      if(GetProgram() == nullptr) {
+         return;
+      }
+      QOpenGLExtraFunctions& cGL = GetFunctions();
+      if(m_unBuffer == 0) {
+         cGL.glGenBuffers(1, &m_unBuffer);
+      }
+      cGL.glBindBuffer(GL_ARRAY_BUFFER, m_unBuffer);
+      /* a new store every frame, so the driver need not wait for the last draw */
+      cGL.glBufferData(GL_ARRAY_BUFFER,
+                       m_vecTransforms.size() * sizeof(GLfloat),
+                       m_vecTransforms.empty() ? nullptr : m_vecTransforms.data(),
+                       GL_STREAM_DRAW);
+      cGL.glBindBuffer(GL_ARRAY_BUFFER, 0);
+   }
+
+   /****************************************/
+   /****************************************/
+
+   CQTOpenGLInstanceColors::CQTOpenGLInstanceColors() :
+      m_unBuffer(0) {}
+
+   /****************************************/
+   /****************************************/
+
+   CQTOpenGLInstanceColors::~CQTOpenGLInstanceColors() {
+      if(m_unBuffer != 0 && QOpenGLContext::currentContext() != nullptr) {
+         GetFunctions().glDeleteBuffers(1, &m_unBuffer);
+      }
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CQTOpenGLInstanceColors::Clear() {
+      m_vecColors.clear();
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CQTOpenGLInstanceColors::Add(const CColor& c_color) {
+      m_vecColors.push_back(c_color.GetRed());
+      m_vecColors.push_back(c_color.GetGreen());
+      m_vecColors.push_back(c_color.GetBlue());
+      m_vecColors.push_back(255);
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CQTOpenGLInstanceColors::Upload() {
+      /* the fallback path reads the colors from memory */
+      if(GetProgram() == nullptr) {
+         return;
+      }
+      /* the LEDs rarely change, most frames end here */
+      if(m_unBuffer != 0 && m_vecColors == m_vecUploaded) {
+         return;
+      }
+      QOpenGLExtraFunctions& cGL = GetFunctions();
+      if(m_unBuffer == 0) {
+         cGL.glGenBuffers(1, &m_unBuffer);
+      }
+      cGL.glBindBuffer(GL_ARRAY_BUFFER, m_unBuffer);
+      if(m_vecColors.size() == m_vecUploaded.size()) {
+         cGL.glBufferSubData(GL_ARRAY_BUFFER, 0, m_vecColors.size(), m_vecColors.data());
+      }
+      else {
+         cGL.glBufferData(GL_ARRAY_BUFFER,
+                          m_vecColors.size(),
+                          m_vecColors.empty() ? nullptr : m_vecColors.data(),
+                          GL_DYNAMIC_DRAW);
+      }
+      cGL.glBindBuffer(GL_ARRAY_BUFFER, 0);
+      m_vecUploaded = m_vecColors;
+   }
+
+   /****************************************/
+   /****************************************/
+
+   CQTOpenGLInstancedMesh::CQTOpenGLInstancedMesh(const CQTOpenGLMeshBuilder& c_mesh,
+                                                  const SMaterial& s_material) :
+      m_unBuffer(0),
+      m_unIndexBuffer(0),
+      m_nNumVertices(c_mesh.GetNumVertices()),
+      m_nNumIndices(0),
+      m_sMaterial(s_material) {
+      Upload(c_mesh.GetVertices(), std::vector<GLuint>());
+   }
+
+   /****************************************/
+   /****************************************/
+
+   CQTOpenGLInstancedMesh::CQTOpenGLInstancedMesh(const std::vector<GLfloat>& vec_vertices,
+                                                  const std::vector<GLuint>& vec_indices,
+                                                  const SMaterial& s_material) :
+      m_unBuffer(0),
+      m_unIndexBuffer(0),
+      m_nNumVertices(vec_vertices.size() / CQTOpenGLMeshBuilder::FLOATS_PER_VERTEX),
+      m_nNumIndices(vec_indices.size()),
+      m_sMaterial(s_material) {
+      Upload(vec_vertices, vec_indices);
+   }
+
+   /****************************************/
+   /****************************************/
+
+   CQTOpenGLInstancedMesh::~CQTOpenGLInstancedMesh() {
+      if(QOpenGLContext::currentContext() != nullptr) {
+         GetFunctions().glDeleteBuffers(1, &m_unBuffer);
+         if(m_unIndexBuffer != 0) {
+            GetFunctions().glDeleteBuffers(1, &m_unIndexBuffer);
+         }
+      }
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CQTOpenGLInstancedMesh::Draw(const CQTOpenGLInstances& c_instances,
+                                     const GLfloat* pf_part) {
+      DrawInstances(c_instances, nullptr, pf_part);
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CQTOpenGLInstancedMesh::Draw(const CQTOpenGLInstances& c_instances,
+                                     const CQTOpenGLInstanceColors& c_colors,
+                                     const GLfloat* pf_part) {
+      DrawInstances(c_instances, &c_colors, pf_part);
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CQTOpenGLInstancedMesh::DrawInstances(const CQTOpenGLInstances& c_instances,
+                                              const CQTOpenGLInstanceColors* pc_colors,
+                                              const GLfloat* pf_part) {
+      if(c_instances.GetSize() == 0 || m_nNumVertices == 0) {
+         return;
+      }
+      /* the colors must cover every instance */
+      if(pc_colors != nullptr && pc_colors->GetSize() < c_instances.GetSize()) {
+         return;
+      }
+      if(pf_part == nullptr) {
+         pf_part = IDENTITY;
+      }
+      SetMaterial();
+      QOpenGLExtraFunctions& cGL = GetFunctions();
+      const GLsizei nStride = CQTOpenGLMeshBuilder::FLOATS_PER_VERTEX * sizeof(GLfloat);
+      cGL.glBindBuffer(GL_ARRAY_BUFFER, m_unBuffer);
+      if(m_unIndexBuffer != 0) {
+         cGL.glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_unIndexBuffer);
+      }
+      QOpenGLShaderProgram* pcProgram = GetProgram();
+      if(pcProgram != nullptr) {
+         pcProgram->bind();
+         cGL.glUniformMatrix4fv(pcProgram->uniformLocation("u_part"), 1, GL_FALSE, pf_part);
+         cGL.glUniform1i(pcProgram->uniformLocation("u_colored"), pc_colors != nullptr);
+         /* per-vertex attributes */
+         cGL.glEnableVertexAttribArray(ATTRIB_POSITION);
+         cGL.glVertexAttribPointer(ATTRIB_POSITION, 3, GL_FLOAT, GL_FALSE, nStride,
+                                   reinterpret_cast<const void*>(0));
+         cGL.glEnableVertexAttribArray(ATTRIB_NORMAL);
+         cGL.glVertexAttribPointer(ATTRIB_NORMAL, 3, GL_FLOAT, GL_FALSE, nStride,
+                                   reinterpret_cast<const void*>(3 * sizeof(GLfloat)));
+         /* per-instance attributes: the four columns of the transform */
+         cGL.glBindBuffer(GL_ARRAY_BUFFER, c_instances.GetBuffer());
+         for(GLuint i = 0; i < 4; ++i) {
+            cGL.glEnableVertexAttribArray(ATTRIB_TRANSFORM + i);
+            cGL.glVertexAttribPointer(ATTRIB_TRANSFORM + i, 4, GL_FLOAT, GL_FALSE, 16 * sizeof(GLfloat),
+                                      reinterpret_cast<const void*>(4 * i * sizeof(GLfloat)));
+            cGL.glVertexAttribDivisor(ATTRIB_TRANSFORM + i, 1);
+         }
+         if(pc_colors != nullptr) {
+            cGL.glBindBuffer(GL_ARRAY_BUFFER, pc_colors->GetBuffer());
+            cGL.glEnableVertexAttribArray(ATTRIB_COLOR);
+            cGL.glVertexAttribPointer(ATTRIB_COLOR, 4, GL_UNSIGNED_BYTE, GL_TRUE, 4 * sizeof(GLubyte),
+                                      reinterpret_cast<const void*>(0));
+            cGL.glVertexAttribDivisor(ATTRIB_COLOR, 1);
+         }
+         if(m_unIndexBuffer != 0) {
+            cGL.glDrawElementsInstanced(GL_TRIANGLES, m_nNumIndices, GL_UNSIGNED_INT, nullptr, c_instances.GetSize());
+         }
+         else {
+            cGL.glDrawArraysInstanced(GL_TRIANGLES, 0, m_nNumVertices, c_instances.GetSize());
+         }
+         /* leave the state as the widget expects it */
+         if(pc_colors != nullptr) {
+            cGL.glVertexAttribDivisor(ATTRIB_COLOR, 0);
+            cGL.glDisableVertexAttribArray(ATTRIB_COLOR);
+         }
+         for(GLuint i = 0; i < 4; ++i) {
+            cGL.glVertexAttribDivisor(ATTRIB_TRANSFORM + i, 0);
+            cGL.glDisableVertexAttribArray(ATTRIB_TRANSFORM + i);
+         }
+         cGL.glDisableVertexAttribArray(ATTRIB_NORMAL);
+         cGL.glDisableVertexAttribArray(ATTRIB_POSITION);
+         pcProgram->release();
+      }
+      else {
+         glEnableClientState(GL_VERTEX_ARRAY);
+         glEnableClientState(GL_NORMAL_ARRAY);
+         glVertexPointer(3, GL_FLOAT, nStride, reinterpret_cast<const void*>(0));
+         glNormalPointer(GL_FLOAT, nStride, reinterpret_cast<const void*>(3 * sizeof(GLfloat)));
+         /* the emission follows glColor, no material switch per instance */
+         if(pc_colors != nullptr) {
+            glColorMaterial(GL_FRONT_AND_BACK, GL_EMISSION);
+            glEnable(GL_COLOR_MATERIAL);
+         }
+         for(size_t i = 0; i < c_instances.GetSize(); ++i) {
+            if(pc_colors != nullptr) {
+               glColor4ubv(pc_colors->GetColor(i));
+            }
+            glPushMatrix();
+            glMultMatrixf(c_instances.GetTransform(i));
+            glMultMatrixf(pf_part);
+            if(m_unIndexBuffer != 0) {
+               glDrawElements(GL_TRIANGLES, m_nNumIndices, GL_UNSIGNED_INT, nullptr);
+            }
+            else {
+               glDrawArrays(GL_TRIANGLES, 0, m_nNumVertices);
+            }
+            glPopMatrix();
+         }
+         if(pc_colors != nullptr) {
+            glDisable(GL_COLOR_MATERIAL);
+            glColorMaterial(GL_FRONT_AND_BACK, GL_AMBIENT_AND_DIFFUSE);
+            glMaterialfv(GL_FRONT_AND_BACK, GL_EMISSION, m_sMaterial.Emission);
+         }
+         glDisableClientState(GL_NORMAL_ARRAY);
+         glDisableClientState(GL_VERTEX_ARRAY);
+      }
+      cGL.glBindBuffer(GL_ARRAY_BUFFER, 0);
+      if(m_unIndexBuffer != 0) {
+         cGL.glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+      }
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CQTOpenGLInstancedMesh::MakeTranslation(GLfloat* pf_matrix,
+                                                Real f_x,
+                                                Real f_y,
+                                                Real f_z) {
+      std::copy(IDENTITY, IDENTITY + 16, pf_matrix);
+      pf_matrix[12] = f_x;
+      pf_matrix[13] = f_y;
+      pf_matrix[14] = f_z;
+   }
+
+   /****************************************/
+   /****************************************/
+
+   bool CQTOpenGLInstancedMesh::IsInstancingSupported() {
+      QOpenGLContext* pcContext = QOpenGLContext::currentContext();
+      if(pcContext == nullptr) {
+         return false;
+      }
+      QPair<int,int> cVersion = pcContext->format().version();
+      return
+         cVersion >= qMakePair(3, 3) ||
+         (pcContext->hasExtension("GL_ARB_instanced_arrays") &&
+          pcContext->hasExtension("GL_ARB_draw_instanced"));
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CQTOpenGLInstancedMesh::Upload(const std::vector<GLfloat>& vec_vertices,
+                                       const std::vector<GLuint>& vec_indices) {
+      QOpenGLExtraFunctions& cGL = GetFunctions();
+      cGL.glGenBuffers(1, &m_unBuffer);
+      cGL.glBindBuffer(GL_ARRAY_BUFFER, m_unBuffer);
+      cGL.glBufferData(GL_ARRAY_BUFFER,
+                       vec_vertices.size() * sizeof(GLfloat),
+                       vec_vertices.data(),
+                       GL_STATIC_DRAW);
+      cGL.glBindBuffer(GL_ARRAY_BUFFER, 0);
+      if(!vec_indices.empty()) {
+         cGL.glGenBuffers(1, &m_unIndexBuffer);
+         cGL.glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_unIndexBuffer);
+         cGL.glBufferData(GL_ELEMENT_ARRAY_BUFFER,
+                          vec_indices.size() * sizeof(GLuint),
+                          vec_indices.data(),
+                          GL_STATIC_DRAW);
+         cGL.glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+      }
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CQTOpenGLInstancedMesh::SetMaterial() const {
+      glMaterialfv(GL_FRONT_AND_BACK, GL_AMBIENT_AND_DIFFUSE, m_sMaterial.AmbientDiffuse);
+      glMaterialfv(GL_FRONT_AND_BACK, GL_SPECULAR,            m_sMaterial.Specular);
+      glMaterialfv(GL_FRONT_AND_BACK, GL_SHININESS,           &m_sMaterial.Shininess);
+      glMaterialfv(GL_FRONT_AND_BACK, GL_EMISSION,            m_sMaterial.Emission);
+   }
+
+   /****************************************/
+   /****************************************/
+
+}
@@ -0,0 +1,247 @@
+/**
+ * @file <argos3/plugins/simulator/visualizations/batch_rendering/qtopengl_instanced_mesh.h>
+ *
+ * @brief This file provides instanced drawing of the robot parts.
+ *
+ * A CQTOpenGLInstances holds the transforms of all the robots of a type for
+ * the current frame, and uploads them into a buffer once. A
+ * CQTOpenGLInstancedMesh is one part of a robot (body, wheel, ...) stored
+ * in a static vertex buffer, and draws the part for every robot with a
+ * single instanced call. When the context has no instancing (OpenGL < 3.3
+ * without GL_ARB_instanced_arrays), the mesh falls back to one glDrawArrays()
+ * per robot from the same buffer.
+ *
+ * A CQTOpenGLInstanceColors adds a color per instance, used as the
+ * emission of the part. This is how the LEDs are drawn: the colors are
+ * sent to the GPU only in the frames in which some LED changed.
+ *
+ * The meshes must be drawn with the view matrix on the modelview stack,
+ * that is, before any entity transform is applied.
+ *
+ * @author Jyotsna Bellary <jyotsnabellary@gmail.com>
+ */
+
+#ifndef QTOPENGL_INSTANCED_MESH_H
+#define QTOPENGL_INSTANCED_MESH_H
+
+namespace argos {
+   class CQTOpenGLInstances;
+   class CQTOpenGLInstanceColors;
+   class CQTOpenGLInstancedMesh;
+   class CQTOpenGLMeshBuilder;
+}
+
+#include <argos3/core/utility/math/vector3.h>
+#include <argos3/core/utility/math/quaternion.h>
+#include <argos3/core/utility/datatypes/color.h>
+
+#ifdef __APPLE__
+#include <gl.h>
+#else
+#include <GL/gl.h>
+#endif
+
+#include <vector>
+
+namespace argos {
+
+   class CQTOpenGLInstances {
+
+   public:
+
+      CQTOpenGLInstances();
+
+      ~CQTOpenGLInstances();
+
+      /**
+       * Forgets the instances of the last frame.
+       */
+      void Clear();
+
+      /**
+       * Adds an instance placed at the given pose.
+       */
+      void Add(const CVector3& c_position,
+               const CQuaternion& c_orientation);
+
+      /**
+       * Sends the transforms to the GPU. Call it once per frame, after
+       * the last Add() and before drawing.
+       */
+      void Upload();
+
+      inline size_t GetSize() const {
+         return m_vecTransforms.size() / 16;
+      }
+
+      /**
+       * Returns the column-major 4x4 transform of an instance.
+       */
+      inline const GLfloat* GetTransform(size_t un_index) const {
+         return &m_vecTransforms[un_index * 16];
+      }
+
+      inline GLuint GetBuffer() const {
+         return m_unBuffer;
+      }
+
+   private:
+
+      CQTOpenGLInstances(const CQTOpenGLInstances&);
+      CQTOpenGLInstances& operator=(const CQTOpenGLInstances&);
+
+   private:
+
+      std::vector<GLfloat> m_vecTransforms;
+      GLuint m_unBuffer;
+   };
+
+   /****************************************/
+   /****************************************/
+
+   class CQTOpenGLInstanceColors {
+
+   public:
+
+      CQTOpenGLInstanceColors();
+
+      ~CQTOpenGLInstanceColors();
+
+      /**
+       * Forgets the colors of the last frame.
+       */
+      void Clear();
+
+      /**
+       * Adds the color of the next instance.
+       */
+      void Add(const CColor& c_color);
+
+      /**
+       * Sends the colors to the GPU, unless they are the same as in the
+       * last upload. Call it once per frame, after the last Add() and
+       * before drawing.
+       */
+      void Upload();
+
+      inline size_t GetSize() const {
+         return m_vecColors.size() / 4;
+      }
+
+      /**
+       * Returns the RGBA color of an instance.
+       */
+      inline const GLubyte* GetColor(size_t un_index) const {
+         return &m_vecColors[un_index * 4];
+      }
+
+      inline GLuint GetBuffer() const {
+         return m_unBuffer;
+      }
+
+   private:
+
+      CQTOpenGLInstanceColors(const CQTOpenGLInstanceColors&);
+      CQTOpenGLInstanceColors& operator=(const CQTOpenGLInstanceColors&);
+
+   private:
+
+      std::vector<GLubyte> m_vecColors;
+      /* What the buffer holds */
+      std::vector<GLubyte> m_vecUploaded;
+      GLuint m_unBuffer;
+   };
+
+   /****************************************/
+   /****************************************/
+
+   class CQTOpenGLInstancedMesh {
+
+   public:
+
+      /** The same parameters as glMaterialfv() */
+      struct SMaterial {
+         GLfloat AmbientDiffuse[4];
+         GLfloat Specular[4];
+         GLfloat Shininess;
+         GLfloat Emission[4];
+      };
+
+   public:
+
+      CQTOpenGLInstancedMesh(const CQTOpenGLMeshBuilder& c_mesh,
+                             const SMaterial& s_material);
+
+      /**
+       * Creates an indexed mesh.
+       * @param vec_vertices the vertices, laid out as in CQTOpenGLMeshBuilder
+       * @param vec_indices three indices per triangle
+       * @param s_material the material
+       */
+      CQTOpenGLInstancedMesh(const std::vector<GLfloat>& vec_vertices,
+                             const std::vector<GLuint>& vec_indices,
+                             const SMaterial& s_material);
+
+      ~CQTOpenGLInstancedMesh();
+
+      /**
+       * Draws the mesh once per instance.
+       * @param c_instances the robots
+       * @param pf_part the placement of the part on the robot, as a
+       * column-major 4x4 matrix, or nullptr for none
+       */
+      void Draw(const CQTOpenGLInstances& c_instances,
+                const GLfloat* pf_part = nullptr);
+
+      /**
+       * Draws the mesh once per instance, with the color of the instance
+       * as emission instead of the one of the material.
+       * @param c_instances the instances
+       * @param c_colors one color per instance
+       * @param pf_part the placement of the part, or nullptr for none
+       */
+      void Draw(const CQTOpenGLInstances& c_instances,
+                const CQTOpenGLInstanceColors& c_colors,
+                const GLfloat* pf_part = nullptr);
+
+      /**
+       * Fills a column-major 4x4 matrix with a translation.
+       */
+      static void MakeTranslation(GLfloat* pf_matrix,
+                                  Real f_x,
+                                  Real f_y,
+                                  Real f_z);
+
+      /**
+       * Returns true if the current context can draw instances in
+       * a single call.
+       */
+      static bool IsInstancingSupported();
+
+   private:
+
+      CQTOpenGLInstancedMesh(const CQTOpenGLInstancedMesh&);
+      CQTOpenGLInstancedMesh& operator=(const CQTOpenGLInstancedMesh&);
+
+      void Upload(const std::vector<GLfloat>& vec_vertices,
+                  const std::vector<GLuint>& vec_indices);
+
+      void DrawInstances(const CQTOpenGLInstances& c_instances,
+                         const CQTOpenGLInstanceColors* pc_colors,
+                         const GLfloat* pf_part);
+
+      void SetMaterial() const;
+
+   private:
+
+      GLuint m_unBuffer;
+      /* 0 for a non-indexed mesh */
+      GLuint m_unIndexBuffer;
+      GLsizei m_nNumVertices;
+      GLsizei m_nNumIndices;
+      SMaterial m_sMaterial;
+   };
+
+}
+
+#endif
@@ -0,0 +1,99 @@
+/**
+ * @file <argos3/plugins/simulator/visualizations/batch_rendering/qtopengl_level_of_detail.cpp>
+ *
+ * @author Jyotsna Bellary <jyotsnabellary@gmail.com>
+ */
+
+#include "qtopengl_level_of_detail.h"
+#include "qtopengl_visualization_settings.h"
+
+#include <argos3/core/utility/configuration/argos_configuration.h>
+
+#ifdef __APPLE__
+#include <gl.h>
+#else
+#include <GL/gl.h>
+#endif
+
+namespace argos {
+
+   /****************************************/
+   /****************************************/
+
+   static const Real DEFAULT_NEAR = 4.0;
+   static const Real DEFAULT_FAR  = 10.0;
+
+   /****************************************/
+   /****************************************/
+
+   CQTOpenGLLevelOfDetail& CQTOpenGLLevelOfDetail::GetInstance() {
+      static CQTOpenGLLevelOfDetail cInstance;
+      return cInstance;
+   }
+
+   /****************************************/
+   /****************************************/
+
+   CQTOpenGLLevelOfDetail::CQTOpenGLLevelOfDetail() :
+      m_bEnabled(false),
+      m_fNearSquare(0.0),
+      m_fFarSquare(0.0) {
+      try {
+         TConfigurationNode* ptLOD = GetVisualizationSettings("lod");
+         if(ptLOD == NULL) {
+            return;
+         }
+         TConfigurationNode& tLOD = *ptLOD;
+         Real fNear = DEFAULT_NEAR;
+         Real fFar = DEFAULT_FAR;
+         GetNodeAttributeOrDefault(tLOD, "near", fNear, fNear);
+         GetNodeAttributeOrDefault(tLOD, "far", fFar, fFar);
+         if(fNear < 0.0 || fFar < fNear) {
+            THROW_ARGOSEXCEPTION("The lod thresholds must satisfy 0 <= near <= far, got near=" << fNear << " and far=" << fFar);
+         }
+         m_fNearSquare = fNear * fNear;
+         m_fFarSquare = fFar * fFar;
+         m_bEnabled = true;
+      }
+      catch(CARGoSException& ex) {
+         THROW_ARGOSEXCEPTION_NESTED("Error parsing the <lod> node of the visualization", ex);
+      }
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CQTOpenGLLevelOfDetail::UpdateCamera() {
+      if(!m_bEnabled) {
+         return;
+      }
+      /* The view is a rigid transform: the camera is at -R^T * t */
+      GLfloat pfView[16];
+      glGetFloatv(GL_MODELVIEW_MATRIX, pfView);
+      m_cCamera.Set(
+         -(pfView[0] * pfView[12] + pfView[1] * pfView[13] + pfView[2]  * pfView[14]),
+         -(pfView[4] * pfView[12] + pfView[5] * pfView[13] + pfView[6]  * pfView[14]),
+         -(pfView[8] * pfView[12] + pfView[9] * pfView[13] + pfView[10] * pfView[14]));
+   }
+
+   /****************************************/
+   /****************************************/
+
+   CQTOpenGLLevelOfDetail::ELevel CQTOpenGLLevelOfDetail::GetLevel(const CVector3& c_position) const {
+      if(!m_bEnabled) {
+         return LEVEL_NEAR;
+      }
+      Real fDistanceSquare = SquareDistance(c_position, m_cCamera);
+      if(fDistanceSquare < m_fNearSquare) {
+         return LEVEL_NEAR;
+      }
+      if(fDistanceSquare < m_fFarSquare) {
+         return LEVEL_MID;
+      }
+      return LEVEL_FAR;
+   }
+
+   /****************************************/
+   /****************************************/
+
+}
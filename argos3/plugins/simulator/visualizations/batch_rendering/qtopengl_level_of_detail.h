@@ -0,0 +1,77 @@
+/**
+ * @file <argos3/plugins/simulator/visualizations/batch_rendering/qtopengl_level_of_detail.h>
+ *
+ * @brief This file provides the distance-based level of detail of the robots.
+ *
+ * The thresholds are read once from the active visualization, <qt-opengl>
+ * or <qt-opengl-offscreen>:
+ *
+ * <pre>
+ *   <visualization>
+ *     <qt-opengl>
+ *       <lod near="4" far="10" />
+ *       ...
+ *     </qt-opengl>
+ *   </visualization>
+ * </pre>
+ *
+ * Robots closer to the camera than 'near' are drawn in full, robots
+ * farther than 'far' are drawn as a disk with their heading, and the
+ * others with a simplified model. Without the 'lod' node, every robot is
+ * drawn in full.
+ *
+ * @author Jyotsna Bellary <jyotsnabellary@gmail.com>
+ */
+
+#ifndef QTOPENGL_LEVEL_OF_DETAIL_H
+#define QTOPENGL_LEVEL_OF_DETAIL_H
+
+namespace argos {
+   class CQTOpenGLLevelOfDetail;
+}
+
+#include <argos3/core/utility/math/vector3.h>
+
+namespace argos {
+
+   class CQTOpenGLLevelOfDetail {
+
+   public:
+
+      enum ELevel {
+         LEVEL_NEAR = 0,
+         LEVEL_MID,
+         LEVEL_FAR,
+         NUM_LEVELS
+      };
+
+   public:
+
+      static CQTOpenGLLevelOfDetail& GetInstance();
+
+      /**
+       * Takes the camera position from the modelview matrix. Call it with
+       * the view matrix loaded, before GetLevel().
+       */
+      void UpdateCamera();
+
+      /**
+       * Returns the level of detail of a robot at the given position.
+       */
+      ELevel GetLevel(const CVector3& c_position) const;
+
+   private:
+
+      CQTOpenGLLevelOfDetail();
+
+   private:
+
+      bool m_bEnabled;
+      Real m_fNearSquare;
+      Real m_fFarSquare;
+      CVector3 m_cCamera;
+   };
+
+}
+
+#endif
@@ -0,0 +1,102 @@
+/**
+ * @file <argos3/plugins/simulator/visualizations/batch_rendering/qtopengl_mesh_builder.cpp>
+ *
+ * @author Jyotsna Bellary <jyotsnabellary@gmail.com>
+ */
+
+#include "qtopengl_mesh_builder.h"
+
+namespace argos {
+
+   /****************************************/
+   /****************************************/
+
+   CQTOpenGLMeshBuilder::CQTOpenGLMeshBuilder() :
+      m_ePrimitive(TRIANGLES) {
+      m_pfNormal[0] = 0.0f;
+      m_pfNormal[1] = 0.0f;
+      m_pfNormal[2] = 1.0f;
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CQTOpenGLMeshBuilder::Begin(EPrimitive e_primitive) {
+      m_ePrimitive = e_primitive;
+      m_vecPrimitive.clear();
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CQTOpenGLMeshBuilder::Normal(Real f_x, Real f_y, Real f_z) {
+      m_pfNormal[0] = f_x;
+      m_pfNormal[1] = f_y;
+      m_pfNormal[2] = f_z;
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CQTOpenGLMeshBuilder::Vertex(Real f_x, Real f_y, Real f_z) {
+      /* as in OpenGL, the vertex takes the current normal */
+      m_vecPrimitive.push_back(f_x);
+      m_vecPrimitive.push_back(f_y);
+      m_vecPrimitive.push_back(f_z);
+      m_vecPrimitive.insert(m_vecPrimitive.end(), m_pfNormal, m_pfNormal + 3);
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CQTOpenGLMeshBuilder::End() {
+      size_t unNum = m_vecPrimitive.size() / FLOATS_PER_VERTEX;
+      switch(m_ePrimitive) {
+         case TRIANGLES:
+            for(size_t i = 0; i + 2 < unNum; i += 3) {
+               Emit(i); Emit(i + 1); Emit(i + 2);
+            }
+            break;
+         case QUADS:
+            for(size_t i = 0; i + 3 < unNum; i += 4) {
+               Emit(i); Emit(i + 1); Emit(i + 2);
+               Emit(i); Emit(i + 2); Emit(i + 3);
+            }
+            break;
+         case QUAD_STRIP:
+            /* quad i is made of the vertices 2i, 2i+1, 2i+3, 2i+2 */
+            for(size_t i = 0; 2 * i + 3 < unNum; ++i) {
+               Emit(2 * i); Emit(2 * i + 1); Emit(2 * i + 3);
+               Emit(2 * i); Emit(2 * i + 3); Emit(2 * i + 2);
+            }
+            break;
+         case POLYGON:
+            /* the polygons drawn by the robots are convex, a fan is enough */
+            for(size_t i = 1; i + 1 < unNum; ++i) {
+               Emit(0); Emit(i); Emit(i + 1);
+            }
+            break;
+      }
+      m_vecPrimitive.clear();
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CQTOpenGLMeshBuilder::Clear() {
+      m_vecPrimitive.clear();
+      m_vecVertices.clear();
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CQTOpenGLMeshBuilder::Emit(size_t un_index) {
+      const GLfloat* pfVertex = &m_vecPrimitive[un_index * FLOATS_PER_VERTEX];
+      m_vecVertices.insert(m_vecVertices.end(), pfVertex, pfVertex + FLOATS_PER_VERTEX);
+   }
+
+   /****************************************/
+   /****************************************/
+
+}
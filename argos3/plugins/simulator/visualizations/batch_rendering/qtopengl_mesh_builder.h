@@ -0,0 +1,93 @@
+/**
+ * @file <argos3/plugins/simulator/visualizations/batch_rendering/qtopengl_mesh_builder.h>
+ *
+ * @brief This file provides a recorder of immediate-mode geometry.
+ *
+ * The builder takes the same sequence of calls as glBegin(), glNormal3d(),
+ * glVertex3d() and glEnd(), and turns it into a flat array of triangles
+ * that can be uploaded once into a vertex buffer. This way, the existing
+ * Render*() functions of the robots only need to write into a builder
+ * instead of a display list.
+ *
+ * @author Jyotsna Bellary <jyotsnabellary@gmail.com>
+ */
+
+#ifndef QTOPENGL_MESH_BUILDER_H
+#define QTOPENGL_MESH_BUILDER_H
+
+namespace argos {
+   class CQTOpenGLMeshBuilder;
+}
+
+#include <argos3/core/utility/datatypes/datatypes.h>
+
+#ifdef __APPLE__
+#include <gl.h>
+#else
+#include <GL/gl.h>
+#endif
+
+#include <vector>
+
+namespace argos {
+
+   class CQTOpenGLMeshBuilder {
+
+   public:
+
+      /** The supported primitives, with the same meaning as in glBegin() */
+      enum EPrimitive {
+         TRIANGLES,
+         QUADS,
+         QUAD_STRIP,
+         POLYGON
+      };
+
+      /** Number of floats per vertex: position (3) and normal (3) */
+      static const size_t FLOATS_PER_VERTEX = 6;
+
+   public:
+
+      CQTOpenGLMeshBuilder();
+
+      void Begin(EPrimitive e_primitive);
+
+      void Normal(Real f_x, Real f_y, Real f_z);
+
+      void Vertex(Real f_x, Real f_y, Real f_z);
+
+      /**
+       * Ends the primitive and appends its triangles to the mesh.
+       */
+      void End();
+
+      /**
+       * Returns the triangles, FLOATS_PER_VERTEX floats per vertex.
+       */
+      inline const std::vector<GLfloat>& GetVertices() const {
+         return m_vecVertices;
+      }
+
+      inline size_t GetNumVertices() const {
+         return m_vecVertices.size() / FLOATS_PER_VERTEX;
+      }
+
+      void Clear();
+
+   private:
+
+      void Emit(size_t un_index);
+
+   private:
+
+      EPrimitive m_ePrimitive;
+      GLfloat m_pfNormal[3];
+      /* vertices of the current primitive, FLOATS_PER_VERTEX each */
+      std::vector<GLfloat> m_vecPrimitive;
+      /* triangles of the whole mesh */
+      std::vector<GLfloat> m_vecVertices;
+   };
+
+}
+
+#endif
@@ -0,0 +1,493 @@
+/**
+ * @file <argos3/plugins/simulator/visualizations/batch_rendering/qtopengl_obj_model.cpp>
+ *
+ * @author Jyotsna Bellary <jyotsnabellary@gmail.com>
+ */
+
+#include "qtopengl_obj_model.h"
+#include "qtopengl_mesh_builder.h"
+
+#include <argos3/core/utility/configuration/argos_exception.h>
+#include <argos3/core/utility/logging/argos_log.h>
+
+#include <sys/stat.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <memory>
+#include <sstream>
+#include <unordered_map>
+
+namespace argos {
+
+   /****************************************/
+   /****************************************/
+
+   /*
+    * Cache layout, in the byte order of the machine:
+    *
+    *   char[4]  "AOBJ"
+    *   UInt32   format version
+    *   UInt64   size of the OBJ file
+    *   SInt64   modification time of the OBJ file
+    *   double   scale
+    *   UInt8    1 if the model has the Y axis up
+    *   UInt32   number of MTL files, then for each:
+    *      UInt32   length of the path, then the path
+    *      UInt64   size of the file
+    *      SInt64   modification time of the file
+    *   UInt32   number of sub-meshes, then for each:
+    *      SMaterial
+    *      UInt32   number of floats, then the floats
+    *      UInt32   number of indices, then the indices
+    */
+   static const char   CACHE_MAGIC[4] = { 'A', 'O', 'B', 'J' };
+   static const UInt32 CACHE_VERSION  = 2;
+
+   static const CQTOpenGLInstancedMesh::SMaterial DEFAULT_MATERIAL = {
+      { 0.8f, 0.8f, 0.8f, 1.0f },
+      { 0.0f, 0.0f, 0.0f, 1.0f },
+      0.0f,
+      { 0.0f, 0.0f, 0.0f, 1.0f }
+   };
+
+   /****************************************/
+   /****************************************/
+
+   template<typename T>
+   static void WriteValue(std::ostream& c_out, const T& t_value) {
+      c_out.write(reinterpret_cast<const char*>(&t_value), sizeof(T));
+   }
+
+   template<typename T>
+   static bool ReadValue(std::istream& c_in, T& t_value) {
+      return static_cast<bool>(c_in.read(reinterpret_cast<char*>(&t_value), sizeof(T)));
+   }
+
+   template<typename T>
+   static void WriteArray(std::ostream& c_out, const std::vector<T>& vec_values) {
+      WriteValue<UInt32>(c_out, vec_values.size());
+      c_out.write(reinterpret_cast<const char*>(vec_values.data()), vec_values.size() * sizeof(T));
+   }
+
+   /*
+    * The size read from a corrupt cache can be anything, so it is checked
+    * against the bytes left in the file before allocating.
+    */
+   template<typename T>
+   static bool ReadArray(std::istream& c_in, std::vector<T>& vec_values, UInt64 un_file_size) {
+      UInt32 unSize;
+      if(!ReadValue(c_in, unSize)) {
+         return false;
+      }
+      std::streamoff nPosition = c_in.tellg();
+      if(nPosition < 0 || static_cast<UInt64>(unSize) * sizeof(T) > un_file_size - nPosition) {
+         return false;
+      }
+      vec_values.resize(unSize);
+      return static_cast<bool>(c_in.read(reinterpret_cast<char*>(vec_values.data()), unSize * sizeof(T)));
+   }
+
+   static void WriteStamp(std::ostream& c_out, const CQTOpenGLObjModel::SFileStamp& s_stamp) {
+      WriteValue<UInt32>(c_out, s_stamp.Path.size());
+      c_out.write(s_stamp.Path.data(), s_stamp.Path.size());
+      WriteValue(c_out, s_stamp.Size);
+      WriteValue(c_out, s_stamp.Time);
+   }
+
+   static bool ReadStamp(std::istream& c_in, CQTOpenGLObjModel::SFileStamp& s_stamp, UInt64 un_file_size) {
+      std::vector<char> vecPath;
+      if(!ReadArray(c_in, vecPath, un_file_size)) {
+         return false;
+      }
+      s_stamp.Path.assign(vecPath.begin(), vecPath.end());
+      return ReadValue(c_in, s_stamp.Size) && ReadValue(c_in, s_stamp.Time);
+   }
+
+   /****************************************/
+   /****************************************/
+
+   /*
+    * Converts an OBJ index, which starts at 1 or counts backwards from
+    * the end when negative, into an array index.
+    */
+   static size_t ObjIndex(long n_index, size_t un_count, const std::string& str_file) {
+      long nResult = n_index > 0 ? n_index - 1 : static_cast<long>(un_count) + n_index;
+      if(n_index == 0 || nResult < 0 || nResult >= static_cast<long>(un_count)) {
+         THROW_ARGOSEXCEPTION("Index " << n_index << " out of range in \"" << str_file << "\"");
+      }
+      return nResult;
+   }
+
+   /****************************************/
+   /****************************************/
+
+   CQTOpenGLObjModel::SFileStamp::SFileStamp(const std::string& str_path) :
+      Path(str_path),
+      Size(0),
+      Time(-1) {
+      struct stat sStat;
+      if(!Path.empty() && ::stat(Path.c_str(), &sStat) == 0) {
+         Size = sStat.st_size;
+         Time = sStat.st_mtime;
+      }
+   }
+
+   /****************************************/
+   /****************************************/
+
+   const CQTOpenGLObjModel& CQTOpenGLObjModel::Load(const std::string& str_file,
+                                                    Real f_scale,
+                                                    bool b_y_up) {
+      static std::map<std::string, std::unique_ptr<CQTOpenGLObjModel> > mapModels;
+      std::ostringstream cKey;
+      cKey << str_file << '|' << f_scale << '|' << b_y_up;
+      std::unique_ptr<CQTOpenGLObjModel>& ptrModel = mapModels[cKey.str()];
+      if(!ptrModel) {
+         ptrModel.reset(new CQTOpenGLObjModel(str_file, f_scale, b_y_up));
+      }
+      return *ptrModel;
+   }
+
+   /****************************************/
+   /****************************************/
+
+   CQTOpenGLObjModel::CQTOpenGLObjModel(const std::string& str_file,
+                                        Real f_scale,
+                                        bool b_y_up) :
+      m_strFile(str_file),
+      m_fScale(f_scale),
+      m_bYUp(b_y_up),
+      m_sFileStamp(str_file) {
+      if(m_sFileStamp.Time < 0) {
+         THROW_ARGOSEXCEPTION("Can't find the model \"" << m_strFile << "\"");
+      }
+      if(ReadCache()) {
+         return;
+      }
+      Parse();
+      WriteCache();
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CQTOpenGLObjModel::Parse() {
+      std::ifstream cIn(m_strFile.c_str());
+      if(!cIn) {
+         THROW_ARGOSEXCEPTION("Can't open the model \"" << m_strFile << "\"");
+      }
+      std::string strDir;
+      size_t unSlash = m_strFile.find_last_of('/');
+      if(unSlash != std::string::npos) {
+         strDir = m_strFile.substr(0, unSlash + 1);
+      }
+      std::vector<GLfloat> vecPositions;
+      std::vector<GLfloat> vecNormals;
+      std::map<std::string, CQTOpenGLInstancedMesh::SMaterial> mapMaterials;
+      /* sub-mesh of each material, and the vertices already in each sub-mesh */
+      std::map<std::string, size_t> mapSubMeshes;
+      std::vector<std::unordered_map<UInt64, GLuint> > vecVertexMaps;
+      size_t unCurrent = 0;
+      bool bHasCurrent = false;
+      std::string strLine;
+      std::vector<size_t> vecFacePositions;
+      std::vector<long> vecFaceNormals;
+      while(std::getline(cIn, strLine)) {
+         std::istringstream cLine(strLine);
+         std::string strCommand;
+         cLine >> strCommand;
+         if(strCommand == "v" || strCommand == "vn") {
+            GLfloat pfValue[3] = { 0.0f, 0.0f, 0.0f };
+            cLine >> pfValue[0] >> pfValue[1] >> pfValue[2];
+            std::vector<GLfloat>& vecTarget = (strCommand == "v") ? vecPositions : vecNormals;
+            /* Y up to Z up is a rotation of 90 degrees around X */
+            GLfloat fY = m_bYUp ? -pfValue[2] : pfValue[1];
+            GLfloat fZ = m_bYUp ?  pfValue[1] : pfValue[2];
+            GLfloat fScale = (strCommand == "v") ? m_fScale : 1.0f;
+            vecTarget.push_back(pfValue[0] * fScale);
+            vecTarget.push_back(fY * fScale);
+            vecTarget.push_back(fZ * fScale);
+         }
+         else if(strCommand == "mtllib") {
+            std::string strMTL;
+            cLine >> strMTL;
+            ParseMaterials(strDir + strMTL, mapMaterials);
+         }
+         else if(strCommand == "usemtl" || (strCommand == "f" && !bHasCurrent)) {
+            std::string strMaterial;
+            if(strCommand == "usemtl") {
+               cLine >> strMaterial;
+            }
+            std::map<std::string, size_t>::iterator itSubMesh = mapSubMeshes.find(strMaterial);
+            if(itSubMesh == mapSubMeshes.end()) {
+               SSubMesh sSubMesh;
+               std::map<std::string, CQTOpenGLInstancedMesh::SMaterial>::iterator itMaterial =
+                  mapMaterials.find(strMaterial);
+               sSubMesh.Material = (itMaterial != mapMaterials.end()) ? itMaterial->second : DEFAULT_MATERIAL;
+               m_vecSubMeshes.push_back(sSubMesh);
+               vecVertexMaps.push_back(std::unordered_map<UInt64, GLuint>());
+               itSubMesh = mapSubMeshes.insert(std::make_pair(strMaterial, m_vecSubMeshes.size() - 1)).first;
+            }
+            unCurrent = itSubMesh->second;
+            bHasCurrent = true;
+         }
+         if(strCommand == "f") {
+            /* Read the corners as v, v/vt, v//vn or v/vt/vn */
+            vecFacePositions.clear();
+            vecFaceNormals.clear();
+            std::string strCorner;
+            while(cLine >> strCorner) {
+               long nPosition = std::strtol(strCorner.c_str(), nullptr, 10);
+               vecFacePositions.push_back(ObjIndex(nPosition, vecPositions.size() / 3, m_strFile));
+               size_t unSecond = strCorner.find('/', strCorner.find('/') + 1);
+               if(strCorner.find('/') != std::string::npos && unSecond != std::string::npos) {
+                  long nNormal = std::strtol(strCorner.c_str() + unSecond + 1, nullptr, 10);
+                  vecFaceNormals.push_back(ObjIndex(nNormal, vecNormals.size() / 3, m_strFile));
+               }
+            }
+            if(vecFacePositions.size() < 3) {
+               continue;
+            }
+            /* Faces without normals are flat shaded */
+            bool bFlat = vecFaceNormals.size() != vecFacePositions.size();
+            GLfloat pfFlatNormal[3] = { 0.0f, 0.0f, 1.0f };
+            if(bFlat) {
+               const GLfloat* pfA = &vecPositions[3 * vecFacePositions[0]];
+               const GLfloat* pfB = &vecPositions[3 * vecFacePositions[1]];
+               const GLfloat* pfC = &vecPositions[3 * vecFacePositions[2]];
+               GLfloat pfU[3] = { pfB[0] - pfA[0], pfB[1] - pfA[1], pfB[2] - pfA[2] };
+               GLfloat pfV[3] = { pfC[0] - pfA[0], pfC[1] - pfA[1], pfC[2] - pfA[2] };
+               pfFlatNormal[0] = pfU[1] * pfV[2] - pfU[2] * pfV[1];
+               pfFlatNormal[1] = pfU[2] * pfV[0] - pfU[0] * pfV[2];
+               pfFlatNormal[2] = pfU[0] * pfV[1] - pfU[1] * pfV[0];
+               GLfloat fLength = std::sqrt(pfFlatNormal[0] * pfFlatNormal[0] +
+                                           pfFlatNormal[1] * pfFlatNormal[1] +
+                                           pfFlatNormal[2] * pfFlatNormal[2]);
+               if(fLength > 0.0f) {
+                  pfFlatNormal[0] /= fLength;
+                  pfFlatNormal[1] /= fLength;
+                  pfFlatNormal[2] /= fLength;
+               }
+            }
+            SSubMesh& sSubMesh = m_vecSubMeshes[unCurrent];
+            std::unordered_map<UInt64, GLuint>& mapVertices = vecVertexMaps[unCurrent];
+            std::vector<GLuint> vecCorners(vecFacePositions.size());
+            for(size_t i = 0; i < vecFacePositions.size(); ++i) {
+               /* Smooth vertices are shared by position and normal */
+               UInt64 unKey = 0;
+               if(!bFlat) {
+                  unKey = (static_cast<UInt64>(vecFacePositions[i]) << 32) | vecFaceNormals[i];
+                  std::unordered_map<UInt64, GLuint>::iterator itVertex = mapVertices.find(unKey);
+                  if(itVertex != mapVertices.end()) {
+                     vecCorners[i] = itVertex->second;
+                     continue;
+                  }
+               }
+               vecCorners[i] = sSubMesh.Vertices.size() / CQTOpenGLMeshBuilder::FLOATS_PER_VERTEX;
+               const GLfloat* pfPosition = &vecPositions[3 * vecFacePositions[i]];
+               const GLfloat* pfNormal = bFlat ? pfFlatNormal : &vecNormals[3 * vecFaceNormals[i]];
+               sSubMesh.Vertices.insert(sSubMesh.Vertices.end(), pfPosition, pfPosition + 3);
+               sSubMesh.Vertices.insert(sSubMesh.Vertices.end(), pfNormal, pfNormal + 3);
+               if(!bFlat) {
+                  mapVertices[unKey] = vecCorners[i];
+               }
+            }
+            /* The faces are convex, a fan is enough */
+            for(size_t i = 1; i + 1 < vecCorners.size(); ++i) {
+               sSubMesh.Indices.push_back(vecCorners[0]);
+               sSubMesh.Indices.push_back(vecCorners[i]);
+               sSubMesh.Indices.push_back(vecCorners[i + 1]);
+            }
+         }
+      }
+      size_t unTriangles = 0;
+      for(size_t i = 0; i < m_vecSubMeshes.size(); ++i) {
+         unTriangles += m_vecSubMeshes[i].Indices.size() / 3;
+      }
+      LOG << "[INFO] Loaded the model \"" << m_strFile << "\": "
+          << unTriangles << " triangles, "
+          << m_vecSubMeshes.size() << " materials"
+          << std::endl;
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CQTOpenGLObjModel::ParseMaterials(const std::string& str_file,
+                                          std::map<std::string, CQTOpenGLInstancedMesh::SMaterial>& map_materials) {
+      /* A missing file is recorded too, so that the cache is dropped when it appears */
+      m_vecMaterialStamps.push_back(SFileStamp(str_file));
+      std::ifstream cIn(str_file.c_str());
+      if(!cIn) {
+         LOGERR << "[WARNING] Can't open the materials \"" << str_file << "\", using the default color" << std::endl;
+         return;
+      }
+      CQTOpenGLInstancedMesh::SMaterial* psMaterial = nullptr;
+      std::string strLine;
+      while(std::getline(cIn, strLine)) {
+         std::istringstream cLine(strLine);
+         std::string strCommand;
+         cLine >> strCommand;
+         if(strCommand == "newmtl") {
+            std::string strName;
+            cLine >> strName;
+            psMaterial = &map_materials[strName];
+            *psMaterial = DEFAULT_MATERIAL;
+         }
+         else if(psMaterial == nullptr) {
+            continue;
+         }
+         else if(strCommand == "Kd") {
+            cLine >> psMaterial->AmbientDiffuse[0] >> psMaterial->AmbientDiffuse[1] >> psMaterial->AmbientDiffuse[2];
+         }
+         else if(strCommand == "Ks") {
+            cLine >> psMaterial->Specular[0] >> psMaterial->Specular[1] >> psMaterial->Specular[2];
+         }
+         else if(strCommand == "Ke") {
+            cLine >> psMaterial->Emission[0] >> psMaterial->Emission[1] >> psMaterial->Emission[2];
+         }
+         else if(strCommand == "Ns") {
+            /* OBJ goes up to 1000, OpenGL to 128 */
+            cLine >> psMaterial->Shininess;
+            psMaterial->Shininess = std::min(psMaterial->Shininess * 0.128f, 128.0f);
+         }
+         else if(strCommand == "d") {
+            cLine >> psMaterial->AmbientDiffuse[3];
+         }
+         else if(strCommand == "Tr") {
+            GLfloat fTransparency;
+            cLine >> fTransparency;
+            psMaterial->AmbientDiffuse[3] = 1.0f - fTransparency;
+         }
+      }
+   }
+
+   /****************************************/
+   /****************************************/
+
+   bool CQTOpenGLObjModel::ReadCache() {
+      std::ifstream cIn((m_strFile + ".cache").c_str(), std::ios::binary | std::ios::ate);
+      if(!cIn) {
+         return false;
+      }
+      std::streamoff nCacheSize = cIn.tellg();
+      cIn.seekg(0);
+      if(nCacheSize < 0) {
+         return false;
+      }
+      UInt64 unCacheSize = nCacheSize;
+      char pchMagic[4];
+      UInt32 unVersion;
+      UInt64 unFileSize;
+      SInt64 nFileTime;
+      double fScale;
+      UInt8 unYUp;
+      UInt32 unMaterialFiles;
+      if(!cIn.read(pchMagic, 4) ||
+         !std::equal(pchMagic, pchMagic + 4, CACHE_MAGIC) ||
+         !ReadValue(cIn, unVersion) || unVersion != CACHE_VERSION ||
+         !ReadValue(cIn, unFileSize) || unFileSize != m_sFileStamp.Size ||
+         !ReadValue(cIn, nFileTime) || nFileTime != m_sFileStamp.Time ||
+         !ReadValue(cIn, fScale) || fScale != m_fScale ||
+         !ReadValue(cIn, unYUp) || (unYUp != 0) != m_bYUp ||
+         !ReadValue(cIn, unMaterialFiles)) {
+         return false;
+      }
+      /* The cache is stale if any MTL file changed, appeared or disappeared */
+      std::vector<SFileStamp> vecMaterialStamps;
+      for(UInt32 i = 0; i < unMaterialFiles; ++i) {
+         SFileStamp sCached;
+         if(!ReadStamp(cIn, sCached, unCacheSize)) {
+            LOGERR << "[WARNING] The cache of the model \"" << m_strFile << "\" is corrupt, parsing the model again" << std::endl;
+            return false;
+         }
+         if(!(SFileStamp(sCached.Path) == sCached)) {
+            return false;
+         }
+         vecMaterialStamps.push_back(sCached);
+      }
+      UInt32 unSubMeshes;
+      if(!ReadValue(cIn, unSubMeshes)) {
+         LOGERR << "[WARNING] The cache of the model \"" << m_strFile << "\" is corrupt, parsing the model again" << std::endl;
+         return false;
+      }
+      std::vector<SSubMesh> vecSubMeshes;
+      for(UInt32 i = 0; i < unSubMeshes; ++i) {
+         vecSubMeshes.push_back(SSubMesh());
+         SSubMesh& sSubMesh = vecSubMeshes.back();
+         if(!ReadValue(cIn, sSubMesh.Material) ||
+            !ReadArray(cIn, sSubMesh.Vertices, unCacheSize) ||
+            !ReadArray(cIn, sSubMesh.Indices, unCacheSize)) {
+            LOGERR << "[WARNING] The cache of the model \"" << m_strFile << "\" is corrupt, parsing the model again" << std::endl;
+            return false;
+         }
+         /* Every triangle must refer to vertices of its sub-mesh */
+         size_t unVertices = sSubMesh.Vertices.size() / CQTOpenGLMeshBuilder::FLOATS_PER_VERTEX;
+         bool bValid =
+            sSubMesh.Vertices.size() % CQTOpenGLMeshBuilder::FLOATS_PER_VERTEX == 0 &&
+            sSubMesh.Indices.size() % 3 == 0;
+         for(size_t j = 0; bValid && j < sSubMesh.Indices.size(); ++j) {
+            bValid = sSubMesh.Indices[j] < unVertices;
+         }
+         if(!bValid) {
+            LOGERR << "[WARNING] The cache of the model \"" << m_strFile << "\" is corrupt, parsing the model again" << std::endl;
+            return false;
+         }
+      }
+      m_vecSubMeshes.swap(vecSubMeshes);
+      m_vecMaterialStamps.swap(vecMaterialStamps);
+      return true;
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CQTOpenGLObjModel::WriteCache() const {
+      /*
+       * Write aside and rename, so that a concurrent launch never reads half
+       * a file. The temporary file has the process id in its name, so that
+       * two launches never write the same one.
+       */
+      std::string strCache = m_strFile + ".cache";
+      std::ostringstream cTemp;
+      cTemp << strCache << '.' << ::getpid() << ".tmp";
+      std::string strTemp = cTemp.str();
+      {
+         std::ofstream cOut(strTemp.c_str(), std::ios::binary | std::ios::trunc);
+         if(cOut) {
+            cOut.write(CACHE_MAGIC, 4);
+            WriteValue(cOut, CACHE_VERSION);
+            WriteValue(cOut, m_sFileStamp.Size);
+            WriteValue(cOut, m_sFileStamp.Time);
+            WriteValue(cOut, static_cast<double>(m_fScale));
+            WriteValue(cOut, static_cast<UInt8>(m_bYUp ? 1 : 0));
+            WriteValue<UInt32>(cOut, m_vecMaterialStamps.size());
+            for(size_t i = 0; i < m_vecMaterialStamps.size(); ++i) {
+               WriteStamp(cOut, m_vecMaterialStamps[i]);
+            }
+            WriteValue<UInt32>(cOut, m_vecSubMeshes.size());
+            for(size_t i = 0; i < m_vecSubMeshes.size(); ++i) {
+               WriteValue(cOut, m_vecSubMeshes[i].Material);
+               WriteArray(cOut, m_vecSubMeshes[i].Vertices);
+               WriteArray(cOut, m_vecSubMeshes[i].Indices);
+            }
+         }
+         if(cOut.good()) {
+            cOut.close();
+            if(std::rename(strTemp.c_str(), strCache.c_str()) == 0) {
+               return;
+            }
+         }
+      }
+      std::remove(strTemp.c_str());
+      LOGERR << "[WARNING] Can't write the cache \"" << strCache << "\", the model will be parsed again at the next launch" << std::endl;
+   }
+
+   /****************************************/
+   /****************************************/
+
+}
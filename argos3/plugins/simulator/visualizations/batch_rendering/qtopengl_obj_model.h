@@ -0,0 +1,112 @@
+/**
+ * @file <argos3/plugins/simulator/visualizations/batch_rendering/qtopengl_obj_model.h>
+ *
+ * @brief This file provides a loader for Wavefront OBJ/MTL models.
+ *
+ * The model is split into one indexed triangle mesh per material, with
+ * the vertices laid out as in CQTOpenGLMeshBuilder. Parsing a large OBJ
+ * file is slow, so the result is cached next to the model in a binary
+ * file (the model file name followed by ".cache"). The cache is reused
+ * as long as the size and modification time of the OBJ file and of its
+ * MTL files, and the loading parameters match. A cache that does not
+ * pass these checks, or whose contents are not consistent, is ignored and
+ * the model is parsed again.
+ *
+ * Each model is loaded once per process and shared by all the callers.
+ * Only the geometry and the colors of the materials are supported;
+ * textures are ignored.
+ *
+ * @author Jyotsna Bellary <jyotsnabellary@gmail.com>
+ */
+
+#ifndef QTOPENGL_OBJ_MODEL_H
+#define QTOPENGL_OBJ_MODEL_H
+
+namespace argos {
+   class CQTOpenGLObjModel;
+}
+
+#include <argos3/plugins/simulator/visualizations/batch_rendering/qtopengl_instanced_mesh.h>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace argos {
+
+   class CQTOpenGLObjModel {
+
+   public:
+
+      /** The triangles that share a material */
+      struct SSubMesh {
+         CQTOpenGLInstancedMesh::SMaterial Material;
+         /** CQTOpenGLMeshBuilder::FLOATS_PER_VERTEX floats per vertex */
+         std::vector<GLfloat> Vertices;
+         /** Three indices per triangle */
+         std::vector<GLuint> Indices;
+      };
+
+      /** A file the model was made from, to tell whether it changed */
+      struct SFileStamp {
+         std::string Path;
+         /** 0 if the file does not exist */
+         UInt64 Size;
+         /** -1 if the file does not exist */
+         SInt64 Time;
+
+         SFileStamp(const std::string& str_path = "");
+
+         bool operator==(const SFileStamp& s_other) const {
+            return Path == s_other.Path && Size == s_other.Size && Time == s_other.Time;
+         }
+      };
+
+   public:
+
+      /**
+       * Returns the model in the given OBJ file, loading it the first time.
+       * @param str_file the OBJ file
+       * @param f_scale the factor applied to the coordinates, e.g., 0.001 for
+       * a model in millimeters
+       * @param b_y_up true if the model has the Y axis up, as most CAD
+       * exports do; ARGoS has the Z axis up
+       * @throws CARGoSException if the model cannot be read
+       */
+      static const CQTOpenGLObjModel& Load(const std::string& str_file,
+                                           Real f_scale,
+                                           bool b_y_up);
+
+      inline const std::vector<SSubMesh>& GetSubMeshes() const {
+         return m_vecSubMeshes;
+      }
+
+   private:
+
+      CQTOpenGLObjModel(const std::string& str_file,
+                        Real f_scale,
+                        bool b_y_up);
+
+      void Parse();
+
+      void ParseMaterials(const std::string& str_file,
+                          std::map<std::string, CQTOpenGLInstancedMesh::SMaterial>& map_materials);
+
+      bool ReadCache();
+
+      void WriteCache() const;
+
+   private:
+
+      std::string m_strFile;
+      Real m_fScale;
+      bool m_bYUp;
+      /* identify the version of the OBJ and MTL files the cache was made from */
+      SFileStamp m_sFileStamp;
+      std::vector<SFileStamp> m_vecMaterialStamps;
+
+      std::vector<SSubMesh> m_vecSubMeshes;
+   };
+
+}
+
+#endif
@@ -0,0 +1,384 @@
+/**
+ * @file <argos3/plugins/simulator/visualizations/batch_rendering/qtopengl_offscreen_render.cpp>
+ *
+ * @author Jyotsna Bellary <jyotsnabellary@gmail.com>
+ */
+
+#include "qtopengl_offscreen_render.h"
+#include "qtopengl_frame_writer.h"
+
+#include <argos3/core/simulator/simulator.h>
+#include <argos3/core/simulator/space/space.h>
+#include <argos3/core/simulator/loop_functions.h>
+#include <argos3/core/simulator/entity/entity.h>
+#include <argos3/core/utility/configuration/argos_exception.h>
+#include <argos3/core/utility/logging/argos_log.h>
+#include <argos3/core/utility/string_utilities.h>
+
+#include <QGuiApplication>
+#include <QOffscreenSurface>
+#include <QOpenGLContext>
+#include <QOpenGLFramebufferObject>
+#include <QSurfaceFormat>
+
+/* Only the window-system-free part of EGL is used */
+#define EGL_NO_X11
+#define MESA_EGL_NO_X11_HEADERS
+#include <EGL/egl.h>
+
+namespace argos {
+
+   /****************************************/
+   /****************************************/
+
+   static const Real NEAR_PLANE = 0.01;
+   static const Real FAR_PLANE  = 1000.0;
+
+   static const GLfloat FLOOR_COLOR[]   = { 0.6f, 0.6f, 0.6f, 1.0f };
+   static const GLfloat LIGHT_AMBIENT[] = { 0.1f, 0.1f, 0.1f, 1.0f };
+   static const GLfloat LIGHT_DIFFUSE[] = { 0.6f, 0.6f, 0.6f, 1.0f };
+
+   /****************************************/
+   /****************************************/
+
+   /*
+    * Checks that EGL offers desktop OpenGL on pbuffer surfaces without any
+    * window system. It is checked before Qt is told to use EGL, because Qt
+    * aborts the process when its platform fails to start.
+    */
+   static bool IsHeadlessEGLAvailable() {
+      EGLDisplay tDisplay = eglGetDisplay(EGL_DEFAULT_DISPLAY);
+      if(tDisplay == EGL_NO_DISPLAY || ! eglInitialize(tDisplay, nullptr, nullptr)) {
+         return false;
+      }
+      const EGLint pnAttributes[] = {
+         EGL_SURFACE_TYPE,    EGL_PBUFFER_BIT,
+         EGL_RENDERABLE_TYPE, EGL_OPENGL_BIT,
+         EGL_DEPTH_SIZE,      24,
+         EGL_NONE
+      };
+      EGLConfig tConfig;
+      EGLint nConfigs = 0;
+      bool bAvailable =
+         eglBindAPI(EGL_OPENGL_API) &&
+         eglChooseConfig(tDisplay, pnAttributes, &tConfig, 1, &nConfigs) &&
+         nConfigs > 0;
+      eglTerminate(tDisplay);
+      return bAvailable;
+   }
+
+   /****************************************/
+   /****************************************/
+
+   /*
+    * Makes Qt render through EGL with no window system: the eglfs platform,
+    * without its device integration and input handlers, on pbuffer
+    * surfaces. With Mesa, the surfaceless platform is selected; other
+    * drivers, such as NVIDIA, give a display-free EGL display by default.
+    */
+   static void SelectHeadlessEGL() {
+      if(qEnvironmentVariableIsEmpty("EGL_PLATFORM")) {
+         qputenv("EGL_PLATFORM", "surfaceless");
+      }
+      if(! IsHeadlessEGLAvailable()) {
+         THROW_ARGOSEXCEPTION("No display is available and EGL can't render without one. "
+                              "Install an EGL driver with pbuffer support (e.g., Mesa), "
+                              "or set DISPLAY or QT_QPA_PLATFORM");
+      }
+      qputenv("QT_QPA_PLATFORM", "eglfs");
+      if(qEnvironmentVariableIsEmpty("QT_QPA_EGLFS_INTEGRATION")) {
+         qputenv("QT_QPA_EGLFS_INTEGRATION", "none");
+      }
+      qputenv("QT_QPA_EGLFS_DISABLE_INPUT", "1");
+      qputenv("QT_QPA_EGLFS_HIDECURSOR", "1");
+   }
+
+   /****************************************/
+   /****************************************/
+
+   CQTOpenGLOffscreenRender::CQTOpenGLOffscreenRender() :
+      m_strDirectory("frames"),
+      m_strPrefix("frame_"),
+      m_strFormat("png"),
+      m_nQuality(-1),
+      m_unWidth(1280),
+      m_unHeight(720),
+      m_unPeriod(1),
+      m_unQueueSize(32),
+      m_cUp(CVector3::Z),
+      m_cFieldOfView(45.0),
+      m_pcApplication(nullptr),
+      m_pcSurface(nullptr),
+      m_pcContext(nullptr),
+      m_pcFramebuffer(nullptr),
+      m_pcWriter(nullptr) {}
+
+   /****************************************/
+   /****************************************/
+
+   void CQTOpenGLOffscreenRender::Init(TConfigurationNode& t_tree) {
+      try {
+         /* Parse the output */
+         GetNodeAttributeOrDefault(t_tree, "directory", m_strDirectory, m_strDirectory);
+         ExpandEnvVariables(m_strDirectory);
+         GetNodeAttributeOrDefault(t_tree, "prefix", m_strPrefix, m_strPrefix);
+         GetNodeAttributeOrDefault(t_tree, "format", m_strFormat, m_strFormat);
+         GetNodeAttributeOrDefault(t_tree, "quality", m_nQuality, m_nQuality);
+         GetNodeAttributeOrDefault(t_tree, "width", m_unWidth, m_unWidth);
+         GetNodeAttributeOrDefault(t_tree, "height", m_unHeight, m_unHeight);
+         GetNodeAttributeOrDefault(t_tree, "period", m_unPeriod, m_unPeriod);
+         GetNodeAttributeOrDefault(t_tree, "queue", m_unQueueSize, m_unQueueSize);
+         if(m_unWidth == 0 || m_unHeight == 0) {
+            THROW_ARGOSEXCEPTION("The frame size must be positive");
+         }
+         if(m_unPeriod == 0) {
+            THROW_ARGOSEXCEPTION("The period must be at least 1");
+         }
+         if(m_unQueueSize == 0) {
+            THROW_ARGOSEXCEPTION("The queue must hold at least 1 frame");
+         }
+         /* Parse the camera */
+         TConfigurationNode& tCamera = GetNode(t_tree, "camera");
+         GetNodeAttribute(tCamera, "position", m_cPosition);
+         GetNodeAttributeOrDefault(tCamera, "look_at", m_cLookAt, m_cLookAt);
+         GetNodeAttributeOrDefault(tCamera, "up", m_cUp, m_cUp);
+         GetNodeAttributeOrDefault(tCamera, "fov", m_cFieldOfView, m_cFieldOfView);
+         CVector3 cForward = m_cLookAt - m_cPosition;
+         if(cForward.SquareLength() == 0.0 ||
+            CVector3(cForward).CrossProduct(m_cUp).SquareLength() == 0.0) {
+            THROW_ARGOSEXCEPTION("The camera must look at a point other than its position, along a direction other than its up vector");
+         }
+         /*
+          * ARGoS does not create a Qt application for this visualization.
+          * Without a display, render through EGL, which needs none.
+          */
+         if(QCoreApplication::instance() == nullptr) {
+            if(qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM") &&
+               qEnvironmentVariableIsEmpty("DISPLAY") &&
+               qEnvironmentVariableIsEmpty("WAYLAND_DISPLAY")) {
+               SelectHeadlessEGL();
+            }
+            static int nArgc = 1;
+            static char pchName[] = "argos3";
+            static char* ppchArgv[] = { pchName, nullptr };
+            m_pcApplication = new QGuiApplication(nArgc, ppchArgv);
+         }
+         /* The robot models use the fixed pipeline state */
+         QSurfaceFormat cFormat;
+         cFormat.setRenderableType(QSurfaceFormat::OpenGL);
+         cFormat.setProfile(QSurfaceFormat::CompatibilityProfile);
+         cFormat.setDepthBufferSize(24);
+         m_pcContext = new QOpenGLContext;
+         m_pcContext->setFormat(cFormat);
+         if(! m_pcContext->create()) {
+            THROW_ARGOSEXCEPTION("Can't create an OpenGL context on the \""
+                                 << QGuiApplication::platformName().toStdString()
+                                 << "\" platform");
+         }
+         m_pcSurface = new QOffscreenSurface;
+         m_pcSurface->setFormat(m_pcContext->format());
+         m_pcSurface->create();
+         if(! m_pcSurface->isValid() || ! m_pcContext->makeCurrent(m_pcSurface)) {
+            THROW_ARGOSEXCEPTION("Can't create an offscreen surface on the \""
+                                 << QGuiApplication::platformName().toStdString()
+                                 << "\" platform");
+         }
+         m_pcFramebuffer = new QOpenGLFramebufferObject(m_unWidth,
+                                                        m_unHeight,
+                                                        QOpenGLFramebufferObject::Depth);
+         if(! m_pcFramebuffer->isValid()) {
+            THROW_ARGOSEXCEPTION("Can't create a " << m_unWidth << "x" << m_unHeight << " framebuffer");
+         }
+         m_pcWriter = new CQTOpenGLFrameWriter(m_strDirectory,
+                                               m_strPrefix,
+                                               m_strFormat,
+                                               m_nQuality,
+                                               m_unWidth,
+                                               m_unHeight,
+                                               m_unQueueSize);
+         LOG << "[INFO] Recording frames in \""
+             << m_strDirectory
+             << "\" with "
+             << reinterpret_cast<const char*>(glGetString(GL_RENDERER))
+             << std::endl;
+      }
+      catch(CARGoSException& ex) {
+         THROW_ARGOSEXCEPTION_NESTED("Error initializing the offscreen Qt-OpenGL visualization", ex);
+      }
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CQTOpenGLOffscreenRender::Destroy() {
+      if(m_pcContext != nullptr && m_pcSurface != nullptr) {
+         m_pcContext->makeCurrent(m_pcSurface);
+      }
+      delete m_pcWriter;
+      m_pcWriter = nullptr;
+      delete m_pcFramebuffer;
+      m_pcFramebuffer = nullptr;
+      if(m_pcContext != nullptr) {
+         m_pcContext->doneCurrent();
+      }
+      delete m_pcContext;
+      m_pcContext = nullptr;
+      delete m_pcSurface;
+      m_pcSurface = nullptr;
+      delete m_pcApplication;
+      m_pcApplication = nullptr;
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CQTOpenGLOffscreenRender::Execute() {
+      while(! m_cSimulator.IsExperimentFinished()) {
+         m_cSimulator.UpdateSpace();
+         if(m_cSpace.GetSimulationClock() % m_unPeriod == 0) {
+            DrawFrame();
+            m_pcWriter->Capture(m_cSpace.GetSimulationClock());
+            m_pcFramebuffer->release();
+         }
+      }
+      /* The last frames are still on the GPU */
+      m_pcWriter->Flush();
+      m_cSimulator.GetLoopFunctions().PostExperiment();
+      LOG.Flush();
+      LOGERR.Flush();
+   }
+
+   /****************************************/
+   /****************************************/
+
+   CQTOpenGLOffscreenRender::TDrawFunctionMap& CQTOpenGLOffscreenRender::GetDrawFunctions() {
+      static TDrawFunctionMap tMap;
+      return tMap;
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CQTOpenGLOffscreenRender::DrawFrame() {
+      m_pcFramebuffer->bind();
+      glViewport(0, 0, m_unWidth, m_unHeight);
+      glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
+      glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+      glEnable(GL_DEPTH_TEST);
+      glEnable(GL_NORMALIZE);
+      glShadeModel(GL_SMOOTH);
+      glEnable(GL_LIGHTING);
+      SetCamera();
+      DrawFloor();
+      /* Draw the entities that have a draw function */
+      const TDrawFunctionMap& tFunctions = GetDrawFunctions();
+      CEntity::TVector& vecEntities = m_cSpace.GetRootEntityVector();
+      for(size_t i = 0; i < vecEntities.size(); ++i) {
+         TDrawFunctionMap::const_iterator it = tFunctions.find(vecEntities[i]->GetTypeDescription());
+         if(it != tFunctions.end()) {
+            it->second(*vecEntities[i]);
+         }
+      }
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CQTOpenGLOffscreenRender::SetCamera() {
+      /* Projection */
+      glMatrixMode(GL_PROJECTION);
+      glLoadIdentity();
+      Real fTop = NEAR_PLANE * Tan(ToRadians(m_cFieldOfView) * 0.5);
+      Real fRight = fTop * m_unWidth / m_unHeight;
+      glFrustum(-fRight, fRight, -fTop, fTop, NEAR_PLANE, FAR_PLANE);
+      /* View, as gluLookAt() */
+      CVector3 cForward = m_cLookAt - m_cPosition;
+      cForward.Normalize();
+      CVector3 cSide = cForward;
+      cSide.CrossProduct(m_cUp).Normalize();
+      CVector3 cUp = cSide;
+      cUp.CrossProduct(cForward);
+      const GLfloat pfView[16] = {
+         static_cast<GLfloat>(cSide.GetX()), static_cast<GLfloat>(cUp.GetX()), static_cast<GLfloat>(-cForward.GetX()), 0.0f,
+         static_cast<GLfloat>(cSide.GetY()), static_cast<GLfloat>(cUp.GetY()), static_cast<GLfloat>(-cForward.GetY()), 0.0f,
+         static_cast<GLfloat>(cSide.GetZ()), static_cast<GLfloat>(cUp.GetZ()), static_cast<GLfloat>(-cForward.GetZ()), 0.0f,
+         static_cast<GLfloat>(-cSide.DotProduct(m_cPosition)),
+         static_cast<GLfloat>(-cUp.DotProduct(m_cPosition)),
+         static_cast<GLfloat>(cForward.DotProduct(m_cPosition)),
+         1.0f
+      };
+      glMatrixMode(GL_MODELVIEW);
+      glLoadMatrixf(pfView);
+      /* Two lights above opposite corners of the arena */
+      const CVector3& cCenter = m_cSpace.GetArenaCenter();
+      CVector3 cHalfSize = m_cSpace.GetArenaSize() * 0.5;
+      const GLfloat pfLight0[] = {
+         static_cast<GLfloat>(cCenter.GetX() + cHalfSize.GetX()),
+         static_cast<GLfloat>(cCenter.GetY() + cHalfSize.GetY()),
+         static_cast<GLfloat>(cCenter.GetZ() + cHalfSize.GetZ()),
+         1.0f
+      };
+      const GLfloat pfLight1[] = {
+         static_cast<GLfloat>(cCenter.GetX() - cHalfSize.GetX()),
+         static_cast<GLfloat>(cCenter.GetY() - cHalfSize.GetY()),
+         static_cast<GLfloat>(cCenter.GetZ() + cHalfSize.GetZ()),
+         1.0f
+      };
+      glLightfv(GL_LIGHT0, GL_POSITION, pfLight0);
+      glLightfv(GL_LIGHT1, GL_POSITION, pfLight1);
+      for(GLenum eLight = GL_LIGHT0; eLight <= GL_LIGHT1; ++eLight) {
+         glLightfv(eLight, GL_AMBIENT, LIGHT_AMBIENT);
+         glLightfv(eLight, GL_DIFFUSE, LIGHT_DIFFUSE);
+         glEnable(eLight);
+      }
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CQTOpenGLOffscreenRender::DrawFloor() {
+      const CVector3& cCenter = m_cSpace.GetArenaCenter();
+      CVector3 cHalfSize = m_cSpace.GetArenaSize() * 0.5;
+      glMaterialfv(GL_FRONT_AND_BACK, GL_AMBIENT_AND_DIFFUSE, FLOOR_COLOR);
+      glNormal3f(0.0f, 0.0f, 1.0f);
+      glBegin(GL_QUADS);
+      glVertex3d(cCenter.GetX() - cHalfSize.GetX(), cCenter.GetY() - cHalfSize.GetY(), 0.0);
+      glVertex3d(cCenter.GetX() + cHalfSize.GetX(), cCenter.GetY() - cHalfSize.GetY(), 0.0);
+      glVertex3d(cCenter.GetX() + cHalfSize.GetX(), cCenter.GetY() + cHalfSize.GetY(), 0.0);
+      glVertex3d(cCenter.GetX() - cHalfSize.GetX(), cCenter.GetY() + cHalfSize.GetY(), 0.0);
+      glEnd();
+   }
+
+   /****************************************/
+   /****************************************/
+
+   REGISTER_VISUALIZATION(CQTOpenGLOffscreenRender,
+                          "qt-opengl-offscreen",
+                          "Jyotsna Bellary [jyotsnabellary@gmail.com]",
+                          "1.0",
+                          "Records the experiment without a window.",
+                          "This visualization draws the robots with the Qt-OpenGL models into an\n"
+                          "offscreen framebuffer and writes one image every 'period' steps.\n"
+                          "It needs no display, and the simulation never waits for the frames\n"
+                          "to be read back or compressed.\n\n"
+                          "REQUIRED XML CONFIGURATION\n\n"
+                          "  <visualization>\n"
+                          "    <qt-opengl-offscreen>\n"
+                          "      <camera position=\"0,-4,5\" />\n"
+                          "    </qt-opengl-offscreen>\n"
+                          "  </visualization>\n\n"
+                          "OPTIONAL XML CONFIGURATION\n\n"
+                          "The 'qt-opengl-offscreen' node accepts 'directory' (\"frames\"), 'prefix'\n"
+                          "(\"frame_\"), 'format' (\"png\"), 'quality' (-1 for the default of the\n"
+                          "format), 'width' (1280), 'height' (720), 'period' (1) and 'queue' (32),\n"
+                          "the number of frames that can wait to be written before new ones are\n"
+                          "dropped. The 'camera' node accepts 'look_at' (\"0,0,0\"), 'up'\n"
+                          "(\"0,0,1\") and 'fov' (45), the vertical field of view in degrees.\n"
+                          "The 'lod' and 'rays' nodes work as in the 'qt-opengl' node.\n\n"
+                          "If neither DISPLAY, WAYLAND_DISPLAY nor QT_QPA_PLATFORM is set, the\n"
+                          "frames are rendered through EGL on pbuffer surfaces, with no window\n"
+                          "system (with Mesa, on its surfaceless platform). Nothing has to be set\n"
+                          "by hand; setting QT_QPA_PLATFORM overrides this choice.\n",
+                          "Under development");
+
+}
@@ -0,0 +1,144 @@
+/**
+ * @file <argos3/plugins/simulator/visualizations/batch_rendering/qtopengl_offscreen_render.h>
+ *
+ * @brief This file provides a visualization that records the experiment
+ * without a window.
+ *
+ * The robots are drawn with the same models as in the Qt-OpenGL widget,
+ * into a framebuffer object of an offscreen context, and the frames are
+ * written to disk by a CQTOpenGLFrameWriter. The simulation never waits
+ * for the readback or the encoding.
+ *
+ * <pre>
+ *   <visualization>
+ *     <qt-opengl-offscreen directory="frames"
+ *                          prefix="frame_"
+ *                          format="png"
+ *                          quality="-1"
+ *                          width="1280"
+ *                          height="720"
+ *                          period="1"
+ *                          queue="32">
+ *       <camera position="0,-4,5" look_at="0,0,0" up="0,0,1" fov="45" />
+ *     </qt-opengl-offscreen>
+ *   </visualization>
+ * </pre>
+ *
+ * Only the camera position is mandatory. A frame is saved every 'period'
+ * steps as <directory>/<prefix><step>.<format>. Only the floor and the
+ * entities with an offscreen draw function are drawn. The <lod> and <rays>
+ * children are read as under <qt-opengl>.
+ *
+ * No display is needed: if DISPLAY, WAYLAND_DISPLAY and QT_QPA_PLATFORM are
+ * unset, Qt renders through EGL on pbuffer surfaces, with no window system
+ * (with Mesa, on its surfaceless platform).
+ *
+ * @author Jyotsna Bellary <jyotsnabellary@gmail.com>
+ */
+
+#ifndef QTOPENGL_OFFSCREEN_RENDER_H
+#define QTOPENGL_OFFSCREEN_RENDER_H
+
+namespace argos {
+   class CQTOpenGLOffscreenRender;
+   class CQTOpenGLFrameWriter;
+   class CEntity;
+}
+
+class QGuiApplication;
+class QOffscreenSurface;
+class QOpenGLContext;
+class QOpenGLFramebufferObject;
+
+#include <argos3/core/simulator/visualization/visualization.h>
+#include <argos3/core/utility/math/vector3.h>
+#include <argos3/core/utility/math/angles.h>
+#include <map>
+#include <string>
+
+namespace argos {
+
+   class CQTOpenGLOffscreenRender : public CVisualization {
+
+   public:
+
+      /**
+       * Draws an entity. It is called for every root entity of the type,
+       * with the view matrix loaded; the batched models draw all the
+       * robots along with the first one.
+       */
+      typedef void (*TDrawFunction)(CEntity&);
+
+      typedef std::map<std::string, TDrawFunction> TDrawFunctionMap;
+
+      /** Registers a draw function at load time */
+      class CDrawFunctionProxy {
+      public:
+         CDrawFunctionProxy(const std::string& str_type,
+                            TDrawFunction t_function) {
+            GetDrawFunctions()[str_type] = t_function;
+         }
+      };
+
+   public:
+
+      CQTOpenGLOffscreenRender();
+
+      virtual ~CQTOpenGLOffscreenRender() {}
+
+      virtual void Init(TConfigurationNode& t_tree);
+
+      virtual void Reset() {}
+
+      virtual void Destroy();
+
+      virtual void Execute();
+
+      /** The draw functions per entity type */
+      static TDrawFunctionMap& GetDrawFunctions();
+
+   private:
+
+      void DrawFrame();
+
+      void SetCamera();
+
+      void DrawFloor();
+
+   private:
+
+      /* Output */
+      std::string m_strDirectory;
+      std::string m_strPrefix;
+      std::string m_strFormat;
+      SInt32 m_nQuality;
+      UInt32 m_unWidth;
+      UInt32 m_unHeight;
+      UInt32 m_unPeriod;
+      UInt32 m_unQueueSize;
+
+      /* Camera */
+      CVector3 m_cPosition;
+      CVector3 m_cLookAt;
+      CVector3 m_cUp;
+      CDegrees m_cFieldOfView;
+
+      /* Created only if no Qt application exists */
+      QGuiApplication* m_pcApplication;
+      QOffscreenSurface* m_pcSurface;
+      QOpenGLContext* m_pcContext;
+      QOpenGLFramebufferObject* m_pcFramebuffer;
+      CQTOpenGLFrameWriter* m_pcWriter;
+   };
+
+}
+
+/**
+ * Registers the function that draws the entities of the given type in
+ * the offscreen visualization.
+ */
+#define REGISTER_QTOPENGL_OFFSCREEN_DRAW_FUNCTION(TYPE_NAME, FUNCTION)    \
+   static argos::CQTOpenGLOffscreenRender::CDrawFunctionProxy             \
+      FUNCTION ## OffscreenProxy(TYPE_NAME, FUNCTION);
+
+#endif
@@ -0,0 +1,201 @@
+/**
+ * @file <argos3/plugins/simulator/visualizations/batch_rendering/qtopengl_ray_renderer.cpp>
+ *
+ * @author Jyotsna Bellary <jyotsnabellary@gmail.com>
+ */
+
+#include "qtopengl_ray_renderer.h"
+#include "qtopengl_visualization_settings.h"
+#include "sensor_rays.h"
+
+#include <argos3/core/simulator/simulator.h>
+#include <argos3/core/simulator/entity/controllable_entity.h>
+#include <argos3/core/control_interface/ci_controller.h>
+#include <argos3/core/utility/configuration/argos_configuration.h>
+
+#include <QOpenGLContext>
+#include <QOpenGLExtraFunctions>
+
+#include <algorithm>
+#include <map>
+
+namespace argos {
+
+   /****************************************/
+   /****************************************/
+
+   /* Position and color */
+   static const UInt32 FLOATS_PER_VERTEX = 6;
+
+   static const GLfloat HIT_COLOR[]   = { 1.0f, 0.0f, 1.0f };
+   static const GLfloat MISS_COLOR[]  = { 0.0f, 1.0f, 1.0f };
+   static const GLfloat POINT_COLOR[] = { 0.0f, 0.0f, 0.0f };
+
+   /* The sensor types that can be hidden */
+   static const char* RAY_TYPES[] = { "lidar", "proximity", "light", "camera" };
+
+   /****************************************/
+   /****************************************/
+
+   static void AddVertex(std::vector<GLfloat>& vec_vertices,
+                         const CVector3& c_position,
+                         const GLfloat* pf_color) {
+      vec_vertices.push_back(c_position.GetX());
+      vec_vertices.push_back(c_position.GetY());
+      vec_vertices.push_back(c_position.GetZ());
+      vec_vertices.insert(vec_vertices.end(), pf_color, pf_color + 3);
+   }
+
+   /****************************************/
+   /****************************************/
+
+   static void Hide(std::vector<bool>& vec_hidden,
+                    size_t un_first,
+                    size_t un_num) {
+      size_t unEnd = std::min(un_first + un_num, vec_hidden.size());
+      for(size_t i = un_first; i < unEnd; ++i) {
+         vec_hidden[i] = true;
+      }
+   }
+
+   /****************************************/
+   /****************************************/
+
+   CQTOpenGLRayRenderer::CQTOpenGLRayRenderer() :
+      m_unBuffer(0) {}
+
+   /****************************************/
+   /****************************************/
+
+   CQTOpenGLRayRenderer::~CQTOpenGLRayRenderer() {
+      if(m_unBuffer != 0 && QOpenGLContext::currentContext() != nullptr) {
+         QOpenGLContext::currentContext()->extraFunctions()->glDeleteBuffers(1, &m_unBuffer);
+      }
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CQTOpenGLRayRenderer::Clear() {
+      m_vecVertices.clear();
+      m_vecPoints.clear();
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CQTOpenGLRayRenderer::Add(CControllableEntity& c_entity) {
+      std::vector<std::pair<bool, CRay3> >& vecRays = c_entity.GetCheckedRays();
+      std::vector<CVector3>& vecPoints = c_entity.GetIntersectionPoints();
+      if(vecRays.empty() && vecPoints.empty()) {
+         return;
+      }
+      /* Find the rays of the hidden sensor types */
+      m_vecHiddenRays.assign(vecRays.size(), false);
+      m_vecHiddenPoints.assign(vecPoints.size(), false);
+      if(! GetHiddenTypes().empty()) {
+         std::map<std::string, CCI_Sensor*, std::less<std::string> >& mapSensors =
+            c_entity.GetController().GetAllSensors();
+         for(std::map<std::string, CCI_Sensor*, std::less<std::string> >::iterator it = mapSensors.begin();
+             it != mapSensors.end();
+             ++it) {
+            const CSensorRays* pcSensor = dynamic_cast<const CSensorRays*>(it->second);
+            if(pcSensor != nullptr && ! IsVisible(pcSensor->GetRayType())) {
+               Hide(m_vecHiddenRays, pcSensor->GetFirstRay(), pcSensor->GetNumRays());
+               Hide(m_vecHiddenPoints, pcSensor->GetFirstPoint(), pcSensor->GetNumPoints());
+            }
+         }
+      }
+      /* Pack the rest */
+      for(size_t i = 0; i < vecRays.size(); ++i) {
+         if(! m_vecHiddenRays[i]) {
+            const GLfloat* pfColor = vecRays[i].first ? HIT_COLOR : MISS_COLOR;
+            AddVertex(m_vecVertices, vecRays[i].second.GetStart(), pfColor);
+            AddVertex(m_vecVertices, vecRays[i].second.GetEnd(), pfColor);
+         }
+      }
+      for(size_t i = 0; i < vecPoints.size(); ++i) {
+         if(! m_vecHiddenPoints[i]) {
+            AddVertex(m_vecPoints, vecPoints[i], POINT_COLOR);
+         }
+      }
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CQTOpenGLRayRenderer::Draw() {
+      GLsizei nNumRayVertices = m_vecVertices.size() / FLOATS_PER_VERTEX;
+      GLsizei nNumPoints = m_vecPoints.size() / FLOATS_PER_VERTEX;
+      if(nNumRayVertices == 0 && nNumPoints == 0) {
+         return;
+      }
+      m_vecVertices.insert(m_vecVertices.end(), m_vecPoints.begin(), m_vecPoints.end());
+      /* A new store every frame, the number of rays changes all the time */
+      QOpenGLExtraFunctions& cGL = *QOpenGLContext::currentContext()->extraFunctions();
+      if(m_unBuffer == 0) {
+         cGL.glGenBuffers(1, &m_unBuffer);
+      }
+      cGL.glBindBuffer(GL_ARRAY_BUFFER, m_unBuffer);
+      cGL.glBufferData(GL_ARRAY_BUFFER,
+                       m_vecVertices.size() * sizeof(GLfloat),
+                       m_vecVertices.data(),
+                       GL_STREAM_DRAW);
+      glDisable(GL_LIGHTING);
+      glEnableClientState(GL_VERTEX_ARRAY);
+      glEnableClientState(GL_COLOR_ARRAY);
+      glVertexPointer(3, GL_FLOAT, FLOATS_PER_VERTEX * sizeof(GLfloat), nullptr);
+      glColorPointer(3, GL_FLOAT, FLOATS_PER_VERTEX * sizeof(GLfloat),
+                     reinterpret_cast<const GLvoid*>(3 * sizeof(GLfloat)));
+      glLineWidth(1.0f);
+      glDrawArrays(GL_LINES, 0, nNumRayVertices);
+      glPointSize(5.0f);
+      glDrawArrays(GL_POINTS, nNumRayVertices, nNumPoints);
+      glPointSize(1.0f);
+      glDisableClientState(GL_COLOR_ARRAY);
+      glDisableClientState(GL_VERTEX_ARRAY);
+      cGL.glBindBuffer(GL_ARRAY_BUFFER, 0);
+      glEnable(GL_LIGHTING);
+   }
+
+   /****************************************/
+   /****************************************/
+
+   bool CQTOpenGLRayRenderer::IsVisible(const std::string& str_ray_type) {
+      return GetHiddenTypes().count(str_ray_type) == 0;
+   }
+
+   /****************************************/
+   /****************************************/
+
+   const std::set<std::string>& CQTOpenGLRayRenderer::GetHiddenTypes() {
+      static std::set<std::string> setHidden;
+      static bool bParsed = false;
+      if(bParsed) {
+         return setHidden;
+      }
+      bParsed = true;
+      try {
+         TConfigurationNode* ptRays = GetVisualizationSettings("rays");
+         if(ptRays == NULL) {
+            return setHidden;
+         }
+         TConfigurationNode& tRays = *ptRays;
+         for(size_t i = 0; i < sizeof(RAY_TYPES) / sizeof(RAY_TYPES[0]); ++i) {
+            bool bVisible = true;
+            GetNodeAttributeOrDefault(tRays, RAY_TYPES[i], bVisible, bVisible);
+            if(! bVisible) {
+               setHidden.insert(RAY_TYPES[i]);
+            }
+         }
+      }
+      catch(CARGoSException& ex) {
+         THROW_ARGOSEXCEPTION_NESTED("Error parsing the <rays> node of the visualization", ex);
+      }
+      return setHidden;
+   }
+
+   /****************************************/
+   /****************************************/
+
+}
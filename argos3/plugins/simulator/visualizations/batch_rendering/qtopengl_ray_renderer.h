@@ -0,0 +1,101 @@
+/**
+ * @file <argos3/plugins/simulator/visualizations/batch_rendering/qtopengl_ray_renderer.h>
+ *
+ * @brief This file provides batched drawing of the sensor rays.
+ *
+ * The rays and intersection points of all the robots of a type are packed
+ * into one vertex buffer per frame and drawn with one call for the rays
+ * and one for the points, with the same colors as the Qt-OpenGL widget:
+ * magenta for a ray that hit something, cyan for a ray that did not.
+ *
+ * The rays of a sensor type can be hidden in the active visualization,
+ * <qt-opengl> or <qt-opengl-offscreen>:
+ *
+ * <pre>
+ *   <visualization>
+ *     <qt-opengl>
+ *       <rays lidar="false" proximity="true" light="true" camera="true" />
+ *       ...
+ *     </qt-opengl>
+ *   </visualization>
+ * </pre>
+ *
+ * All the types are shown by default. The sensors still need
+ * show_rays="true" to produce rays at all.
+ *
+ * @author Jyotsna Bellary <jyotsnabellary@gmail.com>
+ */
+
+#ifndef QTOPENGL_RAY_RENDERER_H
+#define QTOPENGL_RAY_RENDERER_H
+
+namespace argos {
+   class CQTOpenGLRayRenderer;
+   class CControllableEntity;
+}
+
+#include <argos3/core/utility/datatypes/datatypes.h>
+
+#ifdef __APPLE__
+#include <gl.h>
+#else
+#include <GL/gl.h>
+#endif
+
+#include <set>
+#include <string>
+#include <vector>
+
+namespace argos {
+
+   class CQTOpenGLRayRenderer {
+
+   public:
+
+      CQTOpenGLRayRenderer();
+
+      ~CQTOpenGLRayRenderer();
+
+      /**
+       * Forgets the rays of the last frame.
+       */
+      void Clear();
+
+      /**
+       * Adds the rays of a robot, leaving out the hidden sensor types.
+       */
+      void Add(CControllableEntity& c_entity);
+
+      /**
+       * Uploads the rays and draws them.
+       */
+      void Draw();
+
+      /**
+       * Returns true if the rays of the given sensor type are shown.
+       */
+      static bool IsVisible(const std::string& str_ray_type);
+
+   private:
+
+      CQTOpenGLRayRenderer(const CQTOpenGLRayRenderer&);
+      CQTOpenGLRayRenderer& operator=(const CQTOpenGLRayRenderer&);
+
+      /** The sensor types whose rays are hidden */
+      static const std::set<std::string>& GetHiddenTypes();
+
+   private:
+
+      /* Position and color of each vertex, the rays first */
+      std::vector<GLfloat> m_vecVertices;
+      /* The points are kept apart until Draw() appends them */
+      std::vector<GLfloat> m_vecPoints;
+      GLuint m_unBuffer;
+      /* Scratch space of Add(): true for the rays of the hidden types */
+      std::vector<bool> m_vecHiddenRays;
+      std::vector<bool> m_vecHiddenPoints;
+   };
+
+}
+
+#endif
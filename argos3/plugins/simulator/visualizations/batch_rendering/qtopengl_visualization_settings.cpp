@@ -0,0 +1,34 @@
+/**
+ * @file <argos3/plugins/simulator/visualizations/batch_rendering/qtopengl_visualization_settings.cpp>
+ *
+ * @author Jyotsna Bellary <jyotsnabellary@gmail.com>
+ */
+
+#include "qtopengl_visualization_settings.h"
+
+#include <argos3/core/simulator/simulator.h>
+
+namespace argos {
+
+   /****************************************/
+   /****************************************/
+
+   TConfigurationNode* GetVisualizationSettings(const std::string& str_tag) {
+      TConfigurationNode& tRoot = CSimulator::GetInstance().GetConfigurationRoot();
+      if(! NodeExists(tRoot, "visualization")) {
+         return NULL;
+      }
+      /* Like CSimulator, take the first child as the active visualization */
+      TConfigurationNodeIterator itVisualization;
+      itVisualization = itVisualization.begin(&GetNode(tRoot, "visualization"));
+      if(itVisualization == itVisualization.end() ||
+         ! NodeExists(*itVisualization, str_tag)) {
+         return NULL;
+      }
+      return &GetNode(*itVisualization, str_tag);
+   }
+
+   /****************************************/
+   /****************************************/
+
+}
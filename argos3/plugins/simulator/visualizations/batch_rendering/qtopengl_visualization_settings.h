@@ -0,0 +1,42 @@
+/**
+ * @file <argos3/plugins/simulator/visualizations/batch_rendering/qtopengl_visualization_settings.h>
+ *
+ * @brief This file provides access to the drawing settings of the active
+ * visualization.
+ *
+ * Settings such as <lod> and <rays> are children of whichever visualization
+ * runs, as ARGoS starts the first child of <visualization>:
+ *
+ * <pre>
+ *   <visualization>
+ *     <qt-opengl-offscreen>
+ *       <lod near="4" far="10" />
+ *       ...
+ *     </qt-opengl-offscreen>
+ *   </visualization>
+ * </pre>
+ *
+ * so the same settings work with <qt-opengl> and <qt-opengl-offscreen>.
+ *
+ * @author Jyotsna Bellary <jyotsnabellary@gmail.com>
+ */
+
+#ifndef QTOPENGL_VISUALIZATION_SETTINGS_H
+#define QTOPENGL_VISUALIZATION_SETTINGS_H
+
+#include <argos3/core/utility/configuration/argos_configuration.h>
+#include <string>
+
+namespace argos {
+
+   /**
+    * Returns the child with the given tag of the active visualization node.
+    * @param str_tag the tag of the child, such as "lod"
+    * @return the child, or <tt>NULL</tt> if there is no visualization or the
+    * active one has no such child
+    */
+   TConfigurationNode* GetVisualizationSettings(const std::string& str_tag);
+
+}
+
+#endif
@@ -0,0 +1,105 @@
+/**
+ * @file <argos3/plugins/simulator/visualizations/batch_rendering/sensor_rays.h>
+ *
+ * @brief This file provides the bookkeeping that lets the rays be shown
+ * per sensor type.
+ *
+ * The sensors add their rays to the controllable entity of the robot,
+ * which does not record who added what. A sensor that derives from
+ * CSensorRays and creates a CSensorRays::CRecorder at the beginning of
+ * Update() remembers which of the rays and intersection points are its
+ * own, so that CQTOpenGLRayRenderer can hide them.
+ *
+ * This file does not depend on OpenGL, the sensors include it also when
+ * the Qt-OpenGL visualization is not built.
+ *
+ * @author Jyotsna Bellary <jyotsnabellary@gmail.com>
+ */
+
+#ifndef SENSOR_RAYS_H
+#define SENSOR_RAYS_H
+
+namespace argos {
+   class CSensorRays;
+}
+
+#include <argos3/core/simulator/entity/controllable_entity.h>
+#include <string>
+
+namespace argos {
+
+   class CSensorRays {
+
+   public:
+
+      /**
+       * Records the rays added by a sensor from its creation to the end
+       * of the scope, including early returns.
+       */
+      class CRecorder {
+      public:
+         CRecorder(CSensorRays& c_sensor,
+                   CControllableEntity& c_entity) :
+            m_cSensor(c_sensor),
+            m_cEntity(c_entity) {
+            m_cSensor.m_unFirstRay = m_cEntity.GetCheckedRays().size();
+            m_cSensor.m_unFirstPoint = m_cEntity.GetIntersectionPoints().size();
+         }
+         ~CRecorder() {
+            m_cSensor.m_unNumRays = m_cEntity.GetCheckedRays().size() - m_cSensor.m_unFirstRay;
+            m_cSensor.m_unNumPoints = m_cEntity.GetIntersectionPoints().size() - m_cSensor.m_unFirstPoint;
+         }
+      private:
+         CSensorRays& m_cSensor;
+         CControllableEntity& m_cEntity;
+      };
+
+   public:
+
+      /**
+       * @param str_ray_type the kind of sensor, such as "lidar" or
+       * "proximity", as used in the <rays> node of the visualization
+       */
+      CSensorRays(const std::string& str_ray_type) :
+         m_strRayType(str_ray_type),
+         m_unFirstRay(0),
+         m_unNumRays(0),
+         m_unFirstPoint(0),
+         m_unNumPoints(0) {}
+
+      virtual ~CSensorRays() {}
+
+      inline const std::string& GetRayType() const {
+         return m_strRayType;
+      }
+
+      /** Index of the first ray added in the last step */
+      inline size_t GetFirstRay() const {
+         return m_unFirstRay;
+      }
+
+      inline size_t GetNumRays() const {
+         return m_unNumRays;
+      }
+
+      /** Index of the first intersection point added in the last step */
+      inline size_t GetFirstPoint() const {
+         return m_unFirstPoint;
+      }
+
+      inline size_t GetNumPoints() const {
+         return m_unNumPoints;
+      }
+
+   private:
+
+      std::string m_strRayType;
+      size_t m_unFirstRay;
+      size_t m_unNumRays;
+      size_t m_unFirstPoint;
+      size_t m_unNumPoints;
+   };
+
+}
+
+#endif
@@ -0,0 +1,379 @@
+/**
+ * @file <argos3/plugins/utility/controller_log/controller_log.cpp>
+ *
+ * @author Jyotsna Bellary <jyotsnabellary@gmail.com>
+ */
+
+#include "controller_log.h"
+#include <argos3/core/simulator/simulator.h>
+#include <argos3/core/simulator/space/space.h>
+#include <argos3/core/utility/configuration/argos_exception.h>
+#include <argos3/core/utility/logging/argos_log.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace argos {
+
+   /****************************************/
+   /****************************************/
+
+   /* Records per ring, a power of two */
+   static const UInt64 RING_CAPACITY = 1 << 16;
+
+   /* How often the writer drains the rings */
+   static const std::chrono::milliseconds WRITER_PERIOD(10);
+
+   /****************************************/
+   /****************************************/
+
+   /*
+    * A ring of records, filled by one thread and drained by the writer.
+    * Head and Tail only grow; they are on different cache lines, so the
+    * producer and the consumer don't invalidate each other's line.
+    */
+   struct SControllerLogRing {
+      std::vector<CControllerLog::SRecord> Buffer;
+      /* Written by the producer */
+      alignas(64) std::atomic<UInt64> Head;
+      UInt64 CachedTail;
+      /* Written by the consumer */
+      alignas(64) std::atomic<UInt64> Tail;
+      /* Records lost because the ring was full */
+      std::atomic<UInt64> Dropped;
+
+      SControllerLogRing() :
+         Buffer(RING_CAPACITY),
+         Head(0),
+         CachedTail(0),
+         Tail(0),
+         Dropped(0) {}
+
+      inline void Push(const CControllerLog::SRecord& s_record) {
+         UInt64 unHead = Head.load(std::memory_order_relaxed);
+         if(unHead - CachedTail >= RING_CAPACITY) {
+            CachedTail = Tail.load(std::memory_order_acquire);
+            if(unHead - CachedTail >= RING_CAPACITY) {
+               Dropped.fetch_add(1, std::memory_order_relaxed);
+               return;
+            }
+         }
+         Buffer[unHead & (RING_CAPACITY - 1)] = s_record;
+         Head.store(unHead + 1, std::memory_order_release);
+      }
+   };
+
+   /****************************************/
+   /****************************************/
+
+   /*
+    * The log file and the writer thread, shared by all the controllers of
+    * the process.
+    */
+   class CControllerLogSink {
+
+   public:
+
+      static CControllerLogSink& GetInstance() {
+         static CControllerLogSink cSink;
+         return cSink;
+      }
+
+      ~CControllerLogSink();
+
+      void Open(const std::string& str_file_name);
+
+      void Close();
+
+      UInt32 RegisterName(CControllerLog::EBlock e_block,
+                          const std::string& str_name);
+
+      inline void Push(const CControllerLog::SRecord& s_record) {
+         static thread_local SControllerLogRing* pcRing = NULL;
+         if(pcRing == NULL) {
+            pcRing = AddRing();
+         }
+         pcRing->Push(s_record);
+      }
+
+   private:
+
+      struct SName {
+         CControllerLog::EBlock Block;
+         UInt32 Id;
+         std::string Name;
+      };
+
+   private:
+
+      CControllerLogSink() :
+         m_unUsers(0),
+         m_bStop(false) {}
+
+      SControllerLogRing* AddRing();
+
+      void Run();
+
+      void WriteNames();
+
+      void Drain(SControllerLogRing& s_ring);
+
+      void Stop();
+
+   private:
+
+      /* Protects everything but the rings' contents */
+      std::mutex m_cMutex;
+      std::condition_variable m_cWakeUp;
+      std::vector<std::unique_ptr<SControllerLogRing> > m_vecRings;
+      std::unordered_map<std::string, UInt32> m_mapRobots;
+      std::unordered_map<std::string, UInt32> m_mapKeys;
+      /* Names not written yet */
+      std::vector<SName> m_vecNewNames;
+      std::string m_strFileName;
+      std::ofstream m_cFile;
+      std::thread m_cWriter;
+      UInt32 m_unUsers;
+      bool m_bStop;
+   };
+
+   /****************************************/
+   /****************************************/
+
+   CControllerLogSink::~CControllerLogSink() {
+      /* In case some controllers were never destroyed */
+      Stop();
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CControllerLogSink::Open(const std::string& str_file_name) {
+      std::lock_guard<std::mutex> cLock(m_cMutex);
+      if(m_unUsers > 0) {
+         if(str_file_name != m_strFileName) {
+            LOGERR << "[WARNING] The controller log is already written to \""
+                   << m_strFileName << "\", ignoring \"" << str_file_name << "\"" << std::endl;
+         }
+         ++m_unUsers;
+         return;
+      }
+      m_cFile.open(str_file_name.c_str(), std::ios::out | std::ios::trunc | std::ios::binary);
+      if(m_cFile.fail()) {
+         THROW_ARGOSEXCEPTION("Can't open the controller log \"" << str_file_name << "\"");
+      }
+      UInt32 unVersion = CControllerLog::VERSION;
+      m_cFile.write(CControllerLog::MAGIC, sizeof(CControllerLog::MAGIC));
+      m_cFile.write(reinterpret_cast<const char*>(&unVersion), sizeof(UInt32));
+      /* The ids start over in each file */
+      m_mapRobots.clear();
+      m_mapKeys.clear();
+      m_vecNewNames.clear();
+      m_strFileName = str_file_name;
+      m_bStop = false;
+      m_unUsers = 1;
+      m_cWriter = std::thread(&CControllerLogSink::Run, this);
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CControllerLogSink::Close() {
+      {
+         std::lock_guard<std::mutex> cLock(m_cMutex);
+         if(m_unUsers == 0 || --m_unUsers > 0) {
+            return;
+         }
+      }
+      Stop();
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CControllerLogSink::Stop() {
+      {
+         std::lock_guard<std::mutex> cLock(m_cMutex);
+         if(! m_cWriter.joinable()) {
+            return;
+         }
+         m_bStop = true;
+      }
+      m_cWakeUp.notify_one();
+      m_cWriter.join();
+      std::lock_guard<std::mutex> cLock(m_cMutex);
+      UInt64 unDropped = 0;
+      for(size_t i = 0; i < m_vecRings.size(); ++i) {
+         unDropped += m_vecRings[i]->Dropped.exchange(0);
+      }
+      m_cFile.close();
+      if(unDropped > 0) {
+         LOGERR << "[WARNING] " << unDropped << " controller log records were dropped "
+                << "because the writer could not keep up" << std::endl;
+      }
+      LOG << "[INFO] Controller log written to \"" << m_strFileName << "\"" << std::endl;
+   }
+
+   /****************************************/
+   /****************************************/
+
+   UInt32 CControllerLogSink::RegisterName(CControllerLog::EBlock e_block,
+                                           const std::string& str_name) {
+      std::lock_guard<std::mutex> cLock(m_cMutex);
+      std::unordered_map<std::string, UInt32>& mapNames =
+         (e_block == CControllerLog::BLOCK_ROBOT) ? m_mapRobots : m_mapKeys;
+      std::unordered_map<std::string, UInt32>::iterator it = mapNames.find(str_name);
+      if(it != mapNames.end()) {
+         return it->second;
+      }
+      UInt32 unId = mapNames.size();
+      mapNames[str_name] = unId;
+      SName sName = { e_block, unId, str_name };
+      m_vecNewNames.push_back(sName);
+      return unId;
+   }
+
+   /****************************************/
+   /****************************************/
+
+   SControllerLogRing* CControllerLogSink::AddRing() {
+      std::lock_guard<std::mutex> cLock(m_cMutex);
+      m_vecRings.push_back(std::unique_ptr<SControllerLogRing>(new SControllerLogRing));
+      return m_vecRings.back().get();
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CControllerLogSink::Run() {
+      std::vector<SControllerLogRing*> vecRings;
+      std::unique_lock<std::mutex> cLock(m_cMutex);
+      while(true) {
+         /* Seen before the last drain, so that it gets every record */
+         bool bStop = m_bStop;
+         WriteNames();
+         vecRings.clear();
+         for(size_t i = 0; i < m_vecRings.size(); ++i) {
+            vecRings.push_back(m_vecRings[i].get());
+         }
+         cLock.unlock();
+         for(size_t i = 0; i < vecRings.size(); ++i) {
+            Drain(*vecRings[i]);
+         }
+         cLock.lock();
+         if(bStop) {
+            /* Names registered during the last drain */
+            WriteNames();
+            break;
+         }
+         m_cWakeUp.wait_for(cLock, WRITER_PERIOD, [this] { return m_bStop; });
+      }
+      m_cFile.flush();
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CControllerLogSink::WriteNames() {
+      for(size_t i = 0; i < m_vecNewNames.size(); ++i) {
+         const SName& sName = m_vecNewNames[i];
+         char chBlock = sName.Block;
+         UInt16 unLength = sName.Name.size();
+         m_cFile.write(&chBlock, 1);
+         m_cFile.write(reinterpret_cast<const char*>(&sName.Id), sizeof(UInt32));
+         m_cFile.write(reinterpret_cast<const char*>(&unLength), sizeof(UInt16));
+         m_cFile.write(sName.Name.data(), unLength);
+      }
+      m_vecNewNames.clear();
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CControllerLogSink::Drain(SControllerLogRing& s_ring) {
+      UInt64 unTail = s_ring.Tail.load(std::memory_order_relaxed);
+      UInt64 unHead = s_ring.Head.load(std::memory_order_acquire);
+      if(unHead == unTail) {
+         return;
+      }
+      char chBlock = CControllerLog::BLOCK_RECORDS;
+      UInt32 unCount = unHead - unTail;
+      m_cFile.write(&chBlock, 1);
+      m_cFile.write(reinterpret_cast<const char*>(&unCount), sizeof(UInt32));
+      /* The records may wrap around the end of the ring */
+      UInt64 unStart = unTail & (RING_CAPACITY - 1);
+      UInt64 unFirst = std::min<UInt64>(unCount, RING_CAPACITY - unStart);
+      m_cFile.write(reinterpret_cast<const char*>(&s_ring.Buffer[unStart]),
+                    unFirst * sizeof(CControllerLog::SRecord));
+      if(unFirst < unCount) {
+         m_cFile.write(reinterpret_cast<const char*>(&s_ring.Buffer[0]),
+                       (unCount - unFirst) * sizeof(CControllerLog::SRecord));
+      }
+      s_ring.Tail.store(unHead, std::memory_order_release);
+   }
+
+   /****************************************/
+   /****************************************/
+
+   CControllerLog::CControllerLog() :
+      m_bEnabled(false),
+      m_unRobot(0) {}
+
+   /****************************************/
+   /****************************************/
+
+   CControllerLog::~CControllerLog() {
+      if(m_bEnabled) {
+         CControllerLogSink::GetInstance().Close();
+      }
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CControllerLog::Init(const std::string& str_robot,
+                             const std::string& str_file_name) {
+      if(m_bEnabled) {
+         return;
+      }
+      CControllerLogSink& cSink = CControllerLogSink::GetInstance();
+      cSink.Open(str_file_name);
+      m_unRobot = cSink.RegisterName(BLOCK_ROBOT, str_robot);
+      m_bEnabled = true;
+   }
+
+   /****************************************/
+   /****************************************/
+
+   UInt32 CControllerLog::RegisterKey(const std::string& str_key) {
+      return CControllerLogSink::GetInstance().RegisterName(BLOCK_KEY, str_key);
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CControllerLog::Log(UInt32 un_key, Real f_value) const {
+      if(! m_bEnabled) {
+         return;
+      }
+      SRecord sRecord;
+      sRecord.Robot = m_unRobot;
+      sRecord.Tick = CSimulator::GetInstance().GetSpace().GetSimulationClock();
+      sRecord.Key = un_key;
+      sRecord.Padding = 0;
+      sRecord.Value = f_value;
+      CControllerLogSink::GetInstance().Push(sRecord);
+   }
+
+   /****************************************/
+   /****************************************/
+
+}
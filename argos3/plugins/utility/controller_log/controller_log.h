@@ -0,0 +1,127 @@
+/**
+ * @file <argos3/plugins/utility/controller_log/controller_log.h>
+ *
+ * @brief This file provides an asynchronous binary log for the controllers.
+ *
+ * Writing to std::cout or LOG from ControlStep() serializes the threads of
+ * the simulator on the stream. With CControllerLog, a controller instead
+ * appends fixed-size records (robot, tick, key, value) to a ring buffer
+ * that belongs to the calling thread. The rings are lock-free, with one
+ * producer and one consumer each, and a background thread drains them to
+ * a binary file. When a ring is full, its records are dropped and counted,
+ * so a slow disk never stalls the simulation.
+ *
+ * The robot and key names are registered once, in Init(), and the records
+ * only carry their numeric ids. The file is written when the first log is
+ * initialized and closed when the last one is destroyed, at the end of
+ * the experiment. It is decoded to CSV with argos3_controller_log_decode.
+ *
+ * Usage:
+ *
+ * <pre>
+ *   // Init()
+ *   m_cLog.Init(GetId(), "controller_log.bin");
+ *   m_unKeySpeed = m_cLog.RegisterKey("speed");
+ *   // ControlStep()
+ *   m_cLog.Log(m_unKeySpeed, fSpeed);
+ * </pre>
+ *
+ * @author Jyotsna Bellary <jyotsnabellary@gmail.com>
+ */
+
+#ifndef CONTROLLER_LOG_H
+#define CONTROLLER_LOG_H
+
+namespace argos {
+   class CControllerLog;
+}
+
+#include <argos3/core/utility/datatypes/datatypes.h>
+#include <string>
+
+namespace argos {
+
+   class CControllerLog {
+
+   public:
+
+      /**
+       * The layout of the log file. All integers are in the byte order of
+       * the machine that wrote the file.
+       *
+       * The file starts with MAGIC and VERSION (UInt32), followed by
+       * blocks. Each block starts with a one-byte tag:
+       *
+       * - BLOCK_ROBOT and BLOCK_KEY name an id: UInt32 id, UInt16 length
+       *   and the characters of the name;
+       * - BLOCK_RECORDS holds UInt32 count and count SRecord.
+       *
+       * A name can appear after the first record that uses it.
+       */
+      static constexpr char MAGIC[8] = { 'A', 'R', 'G', 'O', 'S', 'C', 'L', 'G' };
+      static constexpr UInt32 VERSION = 1;
+
+      enum EBlock {
+         BLOCK_ROBOT   = 'R',
+         BLOCK_KEY     = 'K',
+         BLOCK_RECORDS = 'D'
+      };
+
+      struct SRecord {
+         UInt32 Robot;
+         UInt32 Tick;
+         UInt32 Key;
+         UInt32 Padding;
+         double Value;
+      };
+
+   public:
+
+      CControllerLog();
+
+      /**
+       * Releases the log file. The file is closed, after all the records
+       * are written, when the last log is destroyed.
+       */
+      ~CControllerLog();
+
+      /**
+       * Enables the log of a robot.
+       * @param str_robot the id of the robot
+       * @param str_file_name the log file. Only the first robot opens it,
+       * the others use the file that is open.
+       * @throws CARGoSException if the file can't be opened
+       */
+      void Init(const std::string& str_robot,
+                const std::string& str_file_name);
+
+      /**
+       * Returns the id of a key, for Log().
+       * The key is registered in the file the first time.
+       */
+      UInt32 RegisterKey(const std::string& str_key);
+
+      /**
+       * Appends a record, at the current tick, to the ring of the calling
+       * thread. Does nothing if the log is not initialized.
+       */
+      void Log(UInt32 un_key, Real f_value) const;
+
+      inline bool IsEnabled() const {
+         return m_bEnabled;
+      }
+
+   private:
+
+      CControllerLog(const CControllerLog&);
+      CControllerLog& operator=(const CControllerLog&);
+
+   private:
+
+      bool m_bEnabled;
+      UInt32 m_unRobot;
+   };
+
+}
+
+#endif
@@ -0,0 +1,158 @@
+/**
+ * @file <argos3/plugins/utility/controller_log/controller_log_decode.cpp>
+ *
+ * @brief Decodes a controller log to CSV.
+ *
+ * <pre>
+ *   argos3_controller_log_decode controller_log.bin > controller_log.csv
+ * </pre>
+ *
+ * The CSV has the columns robot, tick, key and value. The records are
+ * sorted by tick and robot; the records of a robot in a tick keep the
+ * order in which they were logged.
+ *
+ * @author Jyotsna Bellary <jyotsnabellary@gmail.com>
+ */
+
+#include "controller_log.h"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <vector>
+
+using namespace argos;
+
+/****************************************/
+/****************************************/
+
+static bool ReadName(std::istream& c_in,
+                     std::map<UInt32, std::string>& map_names) {
+   UInt32 unId;
+   UInt16 unLength;
+   if(! c_in.read(reinterpret_cast<char*>(&unId), sizeof(UInt32)) ||
+      ! c_in.read(reinterpret_cast<char*>(&unLength), sizeof(UInt16))) {
+      return false;
+   }
+   std::string strName(unLength, '\0');
+   if(! c_in.read(&strName[0], unLength)) {
+      return false;
+   }
+   map_names[unId] = strName;
+   return true;
+}
+
+/****************************************/
+/****************************************/
+
+static bool ReadRecords(std::istream& c_in,
+                        std::vector<CControllerLog::SRecord>& vec_records) {
+   UInt32 unCount;
+   if(! c_in.read(reinterpret_cast<char*>(&unCount), sizeof(UInt32))) {
+      return false;
+   }
+   size_t unStart = vec_records.size();
+   vec_records.resize(unStart + unCount);
+   if(! c_in.read(reinterpret_cast<char*>(&vec_records[unStart]),
+                  unCount * sizeof(CControllerLog::SRecord))) {
+      vec_records.resize(unStart);
+      return false;
+   }
+   return true;
+}
+
+/****************************************/
+/****************************************/
+
+static bool CompareRecords(const CControllerLog::SRecord& s_a,
+                           const CControllerLog::SRecord& s_b) {
+   if(s_a.Tick != s_b.Tick) {
+      return s_a.Tick < s_b.Tick;
+   }
+   return s_a.Robot < s_b.Robot;
+}
+
+/****************************************/
+/****************************************/
+
+static std::string GetName(const std::map<UInt32, std::string>& map_names,
+                           UInt32 un_id) {
+   std::map<UInt32, std::string>::const_iterator it = map_names.find(un_id);
+   if(it == map_names.end()) {
+      return "#" + std::to_string(un_id);
+   }
+   return it->second;
+}
+
+/****************************************/
+/****************************************/
+
+int main(int argc, char** argv) {
+   if(argc != 2) {
+      std::cerr << "Usage: " << argv[0] << " <controller log>" << std::endl;
+      return 1;
+   }
+   std::ifstream cIn(argv[1], std::ios::in | std::ios::binary);
+   if(cIn.fail()) {
+      std::cerr << "Can't open \"" << argv[1] << "\"" << std::endl;
+      return 1;
+   }
+   char pchMagic[sizeof(CControllerLog::MAGIC)];
+   UInt32 unVersion;
+   if(! cIn.read(pchMagic, sizeof(pchMagic)) ||
+      ::memcmp(pchMagic, CControllerLog::MAGIC, sizeof(pchMagic)) != 0 ||
+      ! cIn.read(reinterpret_cast<char*>(&unVersion), sizeof(UInt32))) {
+      std::cerr << "\"" << argv[1] << "\" is not a controller log" << std::endl;
+      return 1;
+   }
+   if(unVersion != CControllerLog::VERSION) {
+      std::cerr << "\"" << argv[1] << "\" has version " << unVersion
+                << ", expected " << CControllerLog::VERSION << std::endl;
+      return 1;
+   }
+   /* The names can come after the records, so the whole file is read first */
+   std::map<UInt32, std::string> mapRobots;
+   std::map<UInt32, std::string> mapKeys;
+   std::vector<CControllerLog::SRecord> vecRecords;
+   bool bComplete = true;
+   char chBlock;
+   while(cIn.get(chBlock)) {
+      bool bRead;
+      switch(chBlock) {
+         case CControllerLog::BLOCK_ROBOT:
+            bRead = ReadName(cIn, mapRobots);
+            break;
+         case CControllerLog::BLOCK_KEY:
+            bRead = ReadName(cIn, mapKeys);
+            break;
+         case CControllerLog::BLOCK_RECORDS:
+            bRead = ReadRecords(cIn, vecRecords);
+            break;
+         default:
+            bRead = false;
+      }
+      if(! bRead) {
+         bComplete = false;
+         break;
+      }
+   }
+   std::stable_sort(vecRecords.begin(), vecRecords.end(), CompareRecords);
+   std::cout << std::setprecision(17);
+   std::cout << "robot,tick,key,value\n";
+   for(size_t i = 0; i < vecRecords.size(); ++i) {
+      const CControllerLog::SRecord& sRecord = vecRecords[i];
+      std::cout << GetName(mapRobots, sRecord.Robot) << ','
+                << sRecord.Tick << ','
+                << GetName(mapKeys, sRecord.Key) << ','
+                << sRecord.Value << '\n';
+   }
+   if(! bComplete) {
+      std::cerr << "\"" << argv[1] << "\" is truncated or corrupted, "
+                << vecRecords.size() << " records decoded" << std::endl;
+      return 2;
+   }
+   return 0;
+}
@@ -3,6 +3,7 @@
 /* Function definitions for XML parsing */
 #include <argos3/core/utility/configuration/argos_configuration.h>
 #include <argos3/core/utility/logging/argos_log.h>
+#include <argos3/core/utility/string_utilities.h>
 using namespace std;
 /****************************************/
 /****************************************/
@@ -12,7 +13,10 @@ CNewEPuckTest::CNewEPuckTest() :
    m_pcProximity(NULL),
    m_pcGround(NULL), 
    m_pcLight(NULL),
-   m_fWheelVelocity(2.5f) {}
+   m_fWheelVelocity(2.5f),
+   m_bLogging(true),
+   m_unGroundWhiteKey(0),
+   m_unLidarReadingsKey(0) {}
 
 /****************************************/
 /****************************************/
@@ -57,24 +61,35 @@ void CNewEPuckTest::Init(TConfigurationNode& t_node) {
     * have to recompile if we want to try other settings.
     */
    GetNodeAttributeOrDefault(t_node, "velocity", m_fWheelVelocity, m_fWheelVelocity);
+   GetNodeAttributeOrDefault(t_node, "logging", m_bLogging, m_bLogging);
+   /*
+    * The readings are logged to a binary file, decoded with
+    * argos3_controller_log_decode
+    */
+   if(m_bLogging) {
+      std::string strLogFile = "newepuck_test_log.bin";
+      GetNodeAttributeOrDefault(t_node, "log_file", strLogFile, strLogFile);
+      m_cLog.Init(GetId(), strLogFile);
+      for(size_t i = 0; i < m_pcLight->GetReadings().size(); ++i) {
+         m_vecLightKeys.push_back(m_cLog.RegisterKey("light_" + ToString(i)));
+      }
+      m_unGroundWhiteKey = m_cLog.RegisterKey("ground_zone_white");
+      m_unLidarReadingsKey = m_cLog.RegisterKey("lidar_readings");
+   }
 }
 
 /****************************************/
 /****************************************/
 
 void CNewEPuckTest::LogLightReadings() const {
-   static const char* kLabels[] = {"Front-Right", "Back-Right", "Back-Left", "Front-Left"};
+   /* light_0 to light_3 are Front-Right, Back-Right, Back-Left and Front-Left */
    const auto& tReadings = m_pcLight->GetReadings();
    
-   std::cout << "Light readings: ";
-   for(size_t i = 0; i < tReadings.size(); ++i) {
+   for(size_t i = 0; i < tReadings.size() && i < m_vecLightKeys.size(); ++i) {
       if(tReadings[i].Value > 0) {
-         // guard against label/readings size mismatch
-         const char* label = (i < 4 ? kLabels[i] : "Unknown");
-         std::cout << label << ": " << tReadings[i].Value << " ";
+         m_cLog.Log(m_vecLightKeys[i], tReadings[i].Value);
       }
    }
-   std::cout << std::endl;
 }
 
 /****************************************/
@@ -83,9 +98,6 @@ void CNewEPuckTest::LogLightReadings() const {
 void CNewEPuckTest::LogGroundSensorReadings() const {
     const auto& tGroundReads = m_pcGround->GetReadings();
 
-    /* Get this robot's ID */
-    const std::string& strId = GetId();
-
     /* Determine how many sensors are in "white" (close to 1.0) */
     size_t unWhiteCount = 0;
     for(size_t i = 0; i < tGroundReads.size(); ++i) {
@@ -94,17 +106,8 @@ void CNewEPuckTest::LogGroundSensorReadings() const {
         }
     }
 
-    /* Classify based on number of white sensors */
-    std::string strZone;
-    if(unWhiteCount == tGroundReads.size()) {
-        strZone = "WHITE";
-    } else {
-        strZone = "GRAY";
-    }
-
-    /* Print results */
-    std::cout << strId << " | ";
-    std::cout << "| Zone: " << strZone << std::endl;
+    /* Classify based on number of white sensors: 1 for white, 0 for gray */
+    m_cLog.Log(m_unGroundWhiteKey, (unWhiteCount == tGroundReads.size()) ? 1.0 : 0.0);
 }
 
 /****************************************/
@@ -112,7 +115,7 @@ void CNewEPuckTest::LogGroundSensorReadings() const {
 
 void CNewEPuckTest::LogLidarSensorReadings() const {
     const auto numReadings = m_pcLidar->GetNumReadings();
-   argos::LOG << numReadings << " LIDAR readings: " << numReadings << std::endl;
+   m_cLog.Log(m_unLidarReadingsKey, numReadings);
 
 }
 
@@ -177,7 +180,10 @@ void CNewEPuckTest::ControlStep() {
 
    // --- Obstacle Avoidance with proximity sensors --- 
    AvoidObstaclesWithProximitySensors();
-   
+
+   if(! m_bLogging) {
+      return;
+   }
    LogGroundSensorReadings();
    // --- Light sensor debug ---
    LogLightReadings();
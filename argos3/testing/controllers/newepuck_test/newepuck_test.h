@@ -28,6 +28,8 @@
 #include <argos3/plugins/robots/newepuck/control_interface/ci_newepuck_proximity_sensor.h>
 #include <argos3/plugins/robots/newepuck/control_interface/ci_newepuck_base_ground_sensor.h>
 #include <argos3/plugins/robots/newepuck/control_interface/ci_newepuck_lidar_sensor.h>
+/* Asynchronous log of the readings */
+#include <argos3/plugins/utility/controller_log/controller_log.h>
 
 /*
  * All the ARGoS stuff in the 'argos' namespace.
@@ -62,17 +64,17 @@ public:
    virtual void ControlStep();
 
    /*
-   * This function logs the light sensor readings to the console.
+   * This function logs the light sensor readings.
    */
    void LogLightReadings() const;
 
    /*
-   * This function logs the light sensor readings to the console.
+   * This function logs the ground sensor readings.
    */
    void LogGroundSensorReadings() const;
 
    /*
-   * This function logs the lidar sensor readings to the console.
+   * This function logs the lidar sensor readings.
    */
    void LogLidarSensorReadings() const;
 
@@ -125,6 +127,15 @@ private:
    /* Wheel speed. */
    Real m_fWheelVelocity;
 
+   /* Whether the readings are logged, true by default. */
+   bool m_bLogging;
+
+   /* Log of the readings, and the ids of its keys */
+   CControllerLog m_cLog;
+   std::vector<UInt32> m_vecLightKeys;
+   UInt32 m_unGroundWhiteKey;
+   UInt32 m_unLidarReadingsKey;
+
 };
 
 #endif
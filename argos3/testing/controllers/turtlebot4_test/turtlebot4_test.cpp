@@ -3,17 +3,43 @@
 /* Function definitions for XML parsing */
 #include <argos3/core/utility/configuration/argos_configuration.h>
 #include <argos3/core/utility/logging/argos_log.h>
+#include <argos3/core/utility/string_utilities.h>
 using namespace std;
 /****************************************/
 /****************************************/
 
+/*
+ * Registers the log keys <prefix>_0 ... <prefix>_<count-1>.
+ */
+static void RegisterLogKeys(CControllerLog& c_log,
+                            std::vector<UInt32>& vec_keys,
+                            const std::string& str_prefix,
+                            size_t un_count) {
+   vec_keys.clear();
+   for(size_t i = 0; i < un_count; ++i) {
+      vec_keys.push_back(c_log.RegisterKey(str_prefix + "_" + ToString(i)));
+   }
+}
+
+/****************************************/
+/****************************************/
+
 CTurtlebot4Test::CTurtlebot4Test() :
    m_pcWheels(NULL),
-   // m_pcProximity(NULL),
+   m_pcProximity(NULL),
    m_pcGround(NULL), 
-   m_pcCamera(NULL),
-   // m_pcLight(NULL),
-   m_fWheelVelocity(-2.5f) {}
+   m_pcLight(NULL),
+   m_pcLidar(NULL),
+   m_pcLEDs(NULL),
+   m_fWheelVelocity(-2.5f),
+   m_bLogging(true),
+   m_unObstacleKey(0),
+   m_unGroundWhiteKey(0),
+   m_unLidarReadingsKey(0),
+   m_unCameraBlobsKey(0),
+   m_unCameraCounterKey(0),
+   m_unCameraBlobColorKey(0),
+   m_pcCamera(NULL) {}
 
 /****************************************/
 /****************************************/
@@ -40,19 +66,31 @@ void CTurtlebot4Test::Init(TConfigurationNode& t_node) {
     * <controllers><turtlebot4_test><sensors> sections. If you forgot to
     * list a device in the XML and then you request it here, an error
     * occurs.
+    *
+    * Only the wheels and the proximity sensor are required, the other
+    * devices are used when they are in the XML.
     */
 
    m_pcWheels    = GetActuator<CCI_DifferentialSteeringActuator>("differential_steering");
    m_pcProximity = GetSensor  <CCI_Turtlebot4ProximitySensor             >("turtlebot4_proximity"    );
-   // m_pcLight = GetSensor  <CCI_Turtlebot4LightSensor>("turtlebot4_light");
-   m_pcCamera = GetSensor  <CCI_Turtlebot4ColoredBlobOmnidirectionalCameraSensor>("turtlebot4_colored_blob_omnidirectional_camera");
-   m_pcGround = GetSensor  <CCI_Turtlebot4BaseGroundSensor>("turtlebot4_ground");
-   m_pcLEDs   = GetActuator<CCI_LEDsActuator                          >("leds");
-   m_pcLidar = GetSensor  <CCI_Turtlebot4LIDARSensor    >("turtlebot4_lidar"  );
+   if(HasSensor("turtlebot4_light")) {
+      m_pcLight = GetSensor  <CCI_Turtlebot4LightSensor>("turtlebot4_light");
+   }
+   if(HasSensor("turtlebot4_colored_blob_omnidirectional_camera")) {
+      m_pcCamera = GetSensor  <CCI_Turtlebot4ColoredBlobOmnidirectionalCameraSensor>("turtlebot4_colored_blob_omnidirectional_camera");
+      m_pcCamera->Enable();
+   }
+   if(HasSensor("turtlebot4_ground")) {
+      m_pcGround = GetSensor  <CCI_Turtlebot4BaseGroundSensor>("turtlebot4_ground");
+   }
+   if(HasActuator("leds")) {
+      m_pcLEDs   = GetActuator<CCI_LEDsActuator                          >("leds");
+   }
+   if(HasSensor("turtlebot4_lidar")) {
+      m_pcLidar = GetSensor  <CCI_Turtlebot4LIDARSensor    >("turtlebot4_lidar"  );
+   }
    // m_pcCamera  = GetSensor  <CCI_ColoredBlobPerspectiveCameraSensor>("turtlebot4_colored_blob_perspective_camera");
-   m_pcCamera->Enable();
 
-   const auto& tReadings = m_pcGround->GetReadings();
    
    /*
     * Parse the configuration file
@@ -62,25 +100,47 @@ void CTurtlebot4Test::Init(TConfigurationNode& t_node) {
     * have to recompile if we want to try other settings.
     */
    GetNodeAttributeOrDefault(t_node, "velocity", m_fWheelVelocity, m_fWheelVelocity);
+   GetNodeAttributeOrDefault(t_node, "logging", m_bLogging, m_bLogging);
+   /*
+    * The readings are logged to a binary file, decoded with
+    * argos3_controller_log_decode
+    */
+   if(m_bLogging) {
+      std::string strLogFile = "turtlebot4_test_log.bin";
+      GetNodeAttributeOrDefault(t_node, "log_file", strLogFile, strLogFile);
+      m_cLog.Init(GetId(), strLogFile);
+      RegisterLogKeys(m_cLog, m_vecProximityKeys, "proximity", m_pcProximity->GetReadings().size());
+      m_unObstacleKey = m_cLog.RegisterKey("obstacle_ahead");
+      if(m_pcGround != NULL) {
+         RegisterLogKeys(m_cLog, m_vecGroundKeys, "ground", m_pcGround->GetReadings().size());
+         m_unGroundWhiteKey = m_cLog.RegisterKey("ground_zone_white");
+      }
+      if(m_pcLight != NULL) {
+         RegisterLogKeys(m_cLog, m_vecLightKeys, "light", m_pcLight->GetReadings().size());
+      }
+      if(m_pcLidar != NULL) {
+         m_unLidarReadingsKey = m_cLog.RegisterKey("lidar_readings");
+      }
+      if(m_pcCamera != NULL) {
+         m_unCameraBlobsKey = m_cLog.RegisterKey("camera_blobs");
+         m_unCameraCounterKey = m_cLog.RegisterKey("camera_counter");
+         m_unCameraBlobColorKey = m_cLog.RegisterKey("camera_blob_color");
+      }
+   }
 }
 
 /****************************************/
 /****************************************/
 
-// void CTurtlebot4Test::LogLightReadings() const {
-//    static const char* kLabels[] = {"Front-Right", "Back-Right", "Back-Left", "Front-Left"};
-//    const auto& tReadings = m_pcLight->GetReadings();
-   
-//    std::cout << "Light readings: ";
-//    for(size_t i = 0; i < tReadings.size(); ++i) {
-//       if(tReadings[i].Value > 0) {
-//          // guard against label/readings size mismatch
-//          const char* label = (i < 4 ? kLabels[i] : "Unknown");
-//          std::cout << label << ": " << tReadings[i].Value << " ";
-//       }
-//    }
-//    std::cout << std::endl;
-// }
+void CTurtlebot4Test::LogLightReadings() const {
+   const auto& tReadings = m_pcLight->GetReadings();
+
+   for(size_t i = 0; i < tReadings.size() && i < m_vecLightKeys.size(); ++i) {
+      if(tReadings[i].Value > 0) {
+         m_cLog.Log(m_vecLightKeys[i], tReadings[i].Value);
+      }
+   }
+}
 
 /****************************************/
 /****************************************/
@@ -88,30 +148,19 @@ void CTurtlebot4Test::Init(TConfigurationNode& t_node) {
 void CTurtlebot4Test::LogGroundSensorReadings() const {
     const auto& tGroundReads = m_pcGround->GetReadings();
 
-    /* Get this robot's ID */
-    const std::string& strId = GetId();
-
     /* Determine how many sensors are in "white" (close to 1.0) */
     size_t unWhiteCount = 0;
-    cout << "Number of Ground Readings: " << tGroundReads.size() << endl;
     for(size_t i = 0; i < tGroundReads.size(); ++i) {
         if(tGroundReads[i].Value > 0.8f) {   // 0.8 threshold for "white"
-            std::cout << "not white detected at sensor " << i << " with value " << tGroundReads[i].Value << std::endl;
             ++unWhiteCount;
         }
+        if(i < m_vecGroundKeys.size()) {
+            m_cLog.Log(m_vecGroundKeys[i], tGroundReads[i].Value);
+        }
     }
 
-    /* Classify based on number of white sensors */
-    std::string strZone;
-    if(unWhiteCount == tGroundReads.size()) {
-        strZone = "WHITE";
-    } else {
-        strZone = "GRAY";
-    }
-
-    /* Print results */
-    std::cout << strId << " | ";
-    std::cout << "| Zone: " << strZone << std::endl;
+    /* Classify based on number of white sensors: 1 for white, 0 for gray */
+    m_cLog.Log(m_unGroundWhiteKey, (unWhiteCount == tGroundReads.size()) ? 1.0 : 0.0);
 }
 
 /****************************************/
@@ -119,7 +168,7 @@ void CTurtlebot4Test::LogGroundSensorReadings() const {
 
 void CTurtlebot4Test::LogLidarSensorReadings() const {
     const auto numReadings = m_pcLidar->GetNumReadings();
-   argos::LOG << numReadings << " LIDAR readings: " << numReadings << std::endl;
+   m_cLog.Log(m_unLidarReadingsKey, numReadings);
 
 }
 
@@ -129,12 +178,13 @@ void CTurtlebot4Test::LogLidarSensorReadings() const {
 void CTurtlebot4Test::LogLightUsingCameraSensorReadings() const {
     /* Perspective Camera */
    const CCI_Turtlebot4ColoredBlobOmnidirectionalCameraSensor::SReadings& sReadings = m_pcCamera->GetReadings();
-   LOG << CCI_Controller::GetId() << "> Camera: " << std::endl;
-   LOG << "Number of blobs detected: " << sReadings.BlobList.size() << std::endl;
-   LOG << "Counter: " << sReadings.Counter << std::endl;
+   m_cLog.Log(m_unCameraBlobsKey, sReadings.BlobList.size());
+   m_cLog.Log(m_unCameraCounterKey, sReadings.Counter);
    for (size_t i = 0; i < sReadings.BlobList.size(); i++) {
          CCI_Turtlebot4ColoredBlobOmnidirectionalCameraSensor::SBlob* sBlob = sReadings.BlobList[i];
-      LOG << "Color = " << sBlob->Color << std::endl;
+      /* One record per blob, the color packed as 0xRRGGBB */
+      m_cLog.Log(m_unCameraBlobColorKey,
+                 (sBlob->Color.GetRed() << 16) | (sBlob->Color.GetGreen() << 8) | sBlob->Color.GetBlue());
    }
 }
 
@@ -144,7 +194,6 @@ void CTurtlebot4Test::LogLightUsingCameraSensorReadings() const {
 
 void CTurtlebot4Test::AvoidObstaclesWithProximitySensors() {
    const auto& readings = m_pcProximity->GetReadings();
-   std::cout << "Avoiding obstacles with proximity sensors..." << std::endl;
    if(readings.empty()) {
       THROW_ARGOSEXCEPTION("Proximity sensor returned no readings");
    }
@@ -157,9 +206,6 @@ void CTurtlebot4Test::AvoidObstaclesWithProximitySensors() {
 
    /* Get the highest reading in front of the robot, which corresponds to the closest object */
    // Start with index 0
-   const std::string& strId = GetId();
-   std::cout << strId << " | " << endl;
-
    Real IRvalue_0 = readings[0].Value;
    Real IRvalue_1 = readings[1].Value;
    Real IRvalue_2 = readings[2].Value;
@@ -170,13 +216,9 @@ void CTurtlebot4Test::AvoidObstaclesWithProximitySensors() {
    Real fMaxReadVal = 0.0f;
    UInt32 unMaxReadIdx = 0;
 
-   argos::LOG << "IRvalue_0: " << IRvalue_0 << std::endl;
-   argos::LOG << "IRvalue_1: " << IRvalue_1 << std::endl;
-   argos::LOG << "IRvalue_2: " << IRvalue_2 << std::endl;
-   argos::LOG << "IRvalue_3: " << IRvalue_3 << std::endl;
-   argos::LOG << "IRvalue_4: " << IRvalue_4 << std::endl;
-   argos::LOG << "IRvalue_5: " << IRvalue_5 << std::endl;
-   argos::LOG << "IRvalue_6: " << IRvalue_6 << std::endl;
+   for(size_t i = 0; i < readings.size() && i < m_vecProximityKeys.size(); ++i) {
+      m_cLog.Log(m_vecProximityKeys[i], readings[i].Value);
+   }
 
    // Check indices 1, 7, and 6 (front left and right sensors)
    // if(fMaxReadVal < IRvalue_2 || fMaxReadVal < IRvalue_3 || fMaxReadVal < IRvalue_4) {
@@ -195,6 +237,7 @@ void CTurtlebot4Test::AvoidObstaclesWithProximitySensors() {
    /* Do we have an obstacle in front? */
    if(IRvalue_2 > 0.0f || IRvalue_3 > 0.0f || IRvalue_4 > 0.0f || IRvalue_5 > 0.0f || IRvalue_6 > 0.0f) {
      /* Yes, we do: avoid it */
+     m_cLog.Log(m_unObstacleKey, 1.0);
    //   if(unMaxReadIdx == 1 || unMaxReadIdx == 3) {
        /* The obstacle is straight, turn left */
        m_pcWheels->SetLinearVelocity(m_fWheelVelocity, 0.0f);
@@ -206,7 +249,7 @@ void CTurtlebot4Test::AvoidObstaclesWithProximitySensors() {
    }
    else {
      /* No, we don't: go straight */
-       argos::LOG << "obj straight unMaxReadIdx set to both wheels: " << m_fWheelVelocity << std::endl;
+      m_cLog.Log(m_unObstacleKey, 0.0);
       m_pcWheels->SetLinearVelocity(m_fWheelVelocity, m_fWheelVelocity);
       // Real angularVel = m_pcWheels-
    }
@@ -219,13 +262,23 @@ void CTurtlebot4Test::ControlStep() {
 
    // --- Obstacle Avoidance with proximity sensors --- 
    AvoidObstaclesWithProximitySensors();
-   
-   LogGroundSensorReadings();
-   // --- Light sensor debug ---
-   // LogLightReadings();
-   LogLightUsingCameraSensorReadings();
 
-   // LogLidarSensorReadings();
+   if(! m_bLogging) {
+      return;
+   }
+   if(m_pcGround != NULL) {
+      LogGroundSensorReadings();
+   }
+   // --- Light sensor debug ---
+   if(m_pcLight != NULL) {
+      LogLightReadings();
+   }
+   if(m_pcCamera != NULL) {
+      LogLightUsingCameraSensorReadings();
+   }
+   if(m_pcLidar != NULL) {
+      LogLidarSensorReadings();
+   }
 }
 
 /****************************************/
@@ -233,9 +286,13 @@ void CTurtlebot4Test::ControlStep() {
 
 void CTurtlebot4Test::Reset() {
    /* Enable camera filtering */
-   m_pcCamera->Enable();
+   if(m_pcCamera != NULL) {
+      m_pcCamera->Enable();
+   }
    /* Set beacon color to all red to be visible for other robots */
-   m_pcLEDs->SetSingleColor(12, CColor::RED);
+   if(m_pcLEDs != NULL) {
+      m_pcLEDs->SetSingleColor(12, CColor::RED);
+   }
 
 }
 
@@ -24,13 +24,15 @@
 #include <argos3/plugins/robots/generic/control_interface/ci_differential_steering_actuator.h>
 /* Definition of proximity sensor */
 // #include <argos3/plugins/robots/generic/control_interface/ci_proximity_sensor.h>
-// #include <argos3/plugins/robots/turtlebot4/control_interface/ci_turtlebot4_light_sensor.h>
+#include <argos3/plugins/robots/turtlebot4/control_interface/ci_turtlebot4_light_sensor.h>
 #include <argos3/plugins/robots/turtlebot4/control_interface/ci_turtlebot4_proximity_sensor.h>
 #include <argos3/plugins/robots/turtlebot4/control_interface/ci_turtlebot4_base_ground_sensor.h>
 #include <argos3/plugins/robots/turtlebot4/control_interface/ci_turtlebot4_lidar_sensor.h>
 #include <argos3/plugins/robots/turtlebot4/control_interface/ci_turtlebot4_colored_blob_omnidirectional_camera_sensor.h>
 // #include <argos3/plugins/robots/turtlebot4/simulator/turtlebot4_colored_blob_perspective_camera_default_sensor.h>
 #include <argos3/plugins/robots/generic/control_interface/ci_leds_actuator.h>
+/* Asynchronous log of the readings */
+#include <argos3/plugins/utility/controller_log/controller_log.h>
 
 /*
  * All the ARGoS stuff in the 'argos' namespace.
@@ -65,22 +67,22 @@ public:
    virtual void ControlStep();
 
    /*
-   * This function logs the light sensor readings to the console.
+   * This function logs the light sensor readings.
    */
    void LogLightReadings() const;
 
    /*
-   * This function logs the light sensor readings to the console.
+   * This function logs the ground sensor readings.
    */
    void LogGroundSensorReadings() const;
 
    /*
-   * This function logs the lidar sensor readings to the console.
+   * This function logs the lidar sensor readings.
    */
    void LogLidarSensorReadings() const;
 
    /*
-   * This function logs the color of the light using Camera sensor to the console.
+   * This function logs the color of the light using Camera sensor.
    */
    void LogLightUsingCameraSensorReadings() const;
 
@@ -124,7 +126,7 @@ private:
    CCI_Turtlebot4BaseGroundSensor* m_pcGround;
 
    /* Pointer to the new turtlebot4 light sensor*/
-   // CCI_Turtlebot4LightSensor* m_pcLight;
+   CCI_Turtlebot4LightSensor* m_pcLight;
 
    /* Pointer to the new turtlebot4 Lidar sensor*/
    CCI_Turtlebot4LIDARSensor* m_pcLidar;
@@ -140,6 +142,21 @@ private:
    /* Wheel speed. */
    Real m_fWheelVelocity;
 
+   /* Whether the readings are logged, true by default. */
+   bool m_bLogging;
+
+   /* Log of the readings, and the ids of its keys */
+   CControllerLog m_cLog;
+   std::vector<UInt32> m_vecProximityKeys;
+   std::vector<UInt32> m_vecGroundKeys;
+   std::vector<UInt32> m_vecLightKeys;
+   UInt32 m_unObstacleKey;
+   UInt32 m_unGroundWhiteKey;
+   UInt32 m_unLidarReadingsKey;
+   UInt32 m_unCameraBlobsKey;
+   UInt32 m_unCameraCounterKey;
+   UInt32 m_unCameraBlobColorKey;
+
    /* Pointer to the omnidirectional camera sensor */
    CCI_Turtlebot4ColoredBlobOmnidirectionalCameraSensor* m_pcCamera;
 